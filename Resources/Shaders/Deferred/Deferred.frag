@@ -13,6 +13,10 @@ layout(binding = 0) uniform UniformScene {
 	vec4 fogColour;
 	float fogDensity;
 	float fogGradient;
+
+	ivec3 clusterGrid;
+	float clusterScale;
+	float clusterBias;
 } scene;
 
 struct Light {
@@ -34,6 +38,11 @@ layout(binding = 7) uniform sampler2D samplerBRDF;
 layout(binding = 8) uniform samplerCube samplerIrradiance;
 layout(binding = 9) uniform samplerCube samplerPrefiltered;
 
+// The offset and light count of each cluster, then the light indices of every cluster.
+layout(binding = 10) buffer BufferClusters {
+	uint clusters[];
+} bufferClusters;
+
 layout(location = 0) in vec2 inUV;
 
 layout(location = 0) out vec4 outColour;
@@ -63,8 +72,15 @@ void main() {
 		F0 = mix(F0, diffuse.rgb, metallic);
 		vec3 Lo = vec3(0.0f);
 
-		for (int i = 0; i < scene.lightsCount; i++) {
-			Light light = bufferLights.lights[i];
+		// Only lights that reach the cluster of this pixel are shaded with.
+		ivec3 cluster = ivec3(inUV * vec2(scene.clusterGrid.xy), log(max(-screenPosition.z, 1e-4f)) * scene.clusterScale + scene.clusterBias);
+		cluster = clamp(cluster, ivec3(0), scene.clusterGrid - 1);
+		uint clusterIndex = uint((cluster.z * scene.clusterGrid.y + cluster.y) * scene.clusterGrid.x + cluster.x);
+		uint lightsOffset = bufferClusters.clusters[2u * clusterIndex];
+		uint lightsCount = bufferClusters.clusters[2u * clusterIndex + 1u];
+
+		for (uint i = 0u; i < lightsCount; i++) {
+			Light light = bufferLights.lights[bufferClusters.clusters[lightsOffset + i]];
 			vec3 L = light.position - worldPosition;
 			float Dl = length(L);
 			L /= Dl;
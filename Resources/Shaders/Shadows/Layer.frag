@@ -0,0 +1,11 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(binding = 0) uniform sampler2D samplerStatic;
+
+layout(location = 0) out vec4 outShadow;
+
+void main() {
+	outShadow = texelFetch(samplerStatic, ivec2(gl_FragCoord.xy), 0);
+}
@@ -19,11 +19,16 @@
 #include "Audio/Opus/OpusSoundBuffer.hpp"
 #include "Audio/Sound.hpp"
 #include "Audio/SoundBuffer.hpp"
+#include "Audio/SoundDecoder.hpp"
+#include "Audio/SoundStream.hpp"
 #include "Audio/Wave/WaveSoundBuffer.hpp"
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/BlockCompression.hpp"
 #include "Bitmaps/Dng/DngBitmap.hpp"
 #include "Bitmaps/Exr/ExrBitmap.hpp"
 #include "Bitmaps/Jpg/JpgBitmap.hpp"
+#include "Bitmaps/Ktx2/Ktx2Texture.hpp"
+#include "Bitmaps/Mipmaps.hpp"
 #include "Bitmaps/Png/PngBitmap.hpp"
 #include "Devices/Instance.hpp"
 #include "Devices/Joysticks.hpp"
@@ -59,6 +64,7 @@
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Graphics/Buffers/InstanceBuffer.hpp"
 #include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Buffers/StagingBuffer.hpp"
 #include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/StorageHandler.hpp"
 #include "Graphics/Buffers/UniformBuffer.hpp"
@@ -104,6 +110,7 @@
 #include "Inputs/InputScheme.hpp"
 #include "Lights/Fog.hpp"
 #include "Lights/Light.hpp"
+#include "Lights/LightClusters.hpp"
 #include "Materials/DefaultMaterial.hpp"
 #include "Materials/Material.hpp"
 #include "Materials/MaterialPipeline.hpp"
@@ -133,20 +140,31 @@
 #include "Models/Shapes/SphereModel.hpp"
 #include "Models/Vertex2d.hpp"
 #include "Models/Vertex3d.hpp"
+#include "Network/BitStream.hpp"
 #include "Network/Ftp/Ftp.hpp"
 #include "Network/Ftp/FtpDataChannel.hpp"
 #include "Network/Ftp/FtpResponse.hpp"
 #include "Network/Ftp/FtpResponseDirectory.hpp"
 #include "Network/Ftp/FtpResponseListing.hpp"
+#include "Network/Ftp/FtpTransfer.hpp"
 #include "Network/Http/Http.hpp"
 #include "Network/Http/HttpRequest.hpp"
 #include "Network/Http/HttpResponse.hpp"
 #include "Network/IpAddress.hpp"
+#include "Network/LatencyHistogram.hpp"
+#include "Network/NetworkMetrics.hpp"
 #include "Network/Packet.hpp"
+#include "Network/PacketPool.hpp"
+#include "Network/Reactor.hpp"
+#include "Network/Replication/EntitySnapshot.hpp"
+#include "Network/Replication/ReplicationClient.hpp"
+#include "Network/Replication/ReplicationServer.hpp"
 #include "Network/Socket.hpp"
+#include "Network/SocketMetrics.hpp"
 #include "Network/SocketSelector.hpp"
 #include "Network/Tcp/TcpListener.hpp"
 #include "Network/Tcp/TcpSocket.hpp"
+#include "Network/Udp/UdpConnection.hpp"
 #include "Network/Udp/UdpSocket.hpp"
 #include "Particles/Emitters/CircleEmitter.hpp"
 #include "Particles/Emitters/Emitter.hpp"
@@ -165,13 +183,18 @@
 #include "Physics/Colliders/CubeCollider.hpp"
 #include "Physics/Colliders/CylinderCollider.hpp"
 #include "Physics/Colliders/HeightfieldCollider.hpp"
+#include "Physics/Colliders/MeshCollider.hpp"
 #include "Physics/Colliders/SphereCollider.hpp"
+#include "Physics/CollisionCache.hpp"
 #include "Physics/CollisionObject.hpp"
+#include "Physics/ContactPairTable.hpp"
 #include "Physics/Force.hpp"
 #include "Physics/Frustum.hpp"
+#include "Physics/HeightTileFile.hpp"
 #include "Physics/KinematicCharacter.hpp"
 #include "Physics/Ray.hpp"
 #include "Physics/Rigidbody.hpp"
+#include "Physics/TiledHeightfield.hpp"
 #include "Post/Deferred/DeferredSubrender.hpp"
 #include "Post/Filters/BlitFilter.hpp"
 #include "Post/Filters/BlurFilter.hpp"
@@ -206,6 +229,7 @@
 #include "Scenes/Scenes.hpp"
 #include "Scenes/SceneStructure.hpp"
 #include "Shadows/ShadowBox.hpp"
+#include "Shadows/ShadowCascades.hpp"
 #include "Shadows/ShadowRender.hpp"
 #include "Shadows/Shadows.hpp"
 #include "Shadows/ShadowsSubrender.hpp"
@@ -244,6 +268,7 @@
 #include "Utils/Enumerate.hpp"
 #include "Utils/Factory.hpp"
 #include "Utils/Future.hpp"
+#include "Utils/LockFreeQueue.hpp"
 #include "Utils/NonCopyable.hpp"
 #include "Utils/RingBuffer.hpp"
 #include "Utils/StreamFactory.hpp"
@@ -10,6 +10,7 @@
 #endif
 
 #include "Scenes/Scenes.hpp"
+#include "SoundStream.hpp"
 
 namespace acid {
 struct Audio::_intern {
@@ -47,6 +48,9 @@ Audio::~Audio() {
 }
 
 void Audio::Update() {
+	for (auto &stream : streams)
+		stream->Update();
+
 	auto camera = Scenes::Get()->GetCamera();
 
 	if (!camera) return;
@@ -116,4 +120,12 @@ void Audio::SetGain(Type type, float volume) {
 	gains.emplace(type, volume);
 	onGain(type, volume);
 }
+
+void Audio::AddStream(SoundStream *stream) {
+	streams.emplace_back(stream);
+}
+
+void Audio::RemoveStream(SoundStream *stream) {
+	streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+}
 }
@@ -4,6 +4,8 @@
 #include "Utils/Delegate.hpp"
 
 namespace acid {
+class SoundStream;
+
 /**
  * @brief Module used for loading, managing and playing a variety of different sound types.
  */
@@ -31,6 +33,18 @@ public:
 	 */
 	Delegate<void(Type, float)> &OnGain() { return onGain; }
 
+	/**
+	 * Adds a stream that will have its buffers refilled each update.
+	 * @param stream The stream to add.
+	 */
+	void AddStream(SoundStream *stream);
+
+	/**
+	 * Removes a stream, so it is no longer updated.
+	 * @param stream The stream to remove.
+	 */
+	void RemoveStream(SoundStream *stream);
+
 private:
 	// TODO: Only using p-impl because of signature differences from OpenAL and OpenALSoft.
 	struct _intern;
@@ -39,5 +53,7 @@ private:
 	std::map<Type, float> gains;
 
 	Delegate<void(Type, float)> onGain;
+
+	std::vector<SoundStream *> streams;
 };
 }
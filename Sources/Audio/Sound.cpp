@@ -9,13 +9,21 @@
 #include "Scenes/Entity.hpp"
 
 namespace acid {
-Sound::Sound(const std::string &filename, const Audio::Type &type, bool begin, bool loop, float gain, float pitch) :
-	buffer(SoundBuffer::Create(filename)),
+Sound::Sound(const std::string &filename, const Audio::Type &type, bool begin, bool loop, float gain, float pitch, bool stream) :
+	filename(filename),
 	type(type),
 	gain(gain),
 	pitch(pitch) {
 	alGenSources(1, &source);
-	alSourcei(source, AL_BUFFER, buffer->GetBuffer());
+
+	if (stream) {
+		// Streamed sounds queue their own buffers, so no shared buffer is loaded.
+		if (auto decoder = SoundDecoder::Create(filename))
+			this->stream = std::make_unique<SoundStream>(std::move(decoder), source);
+	} else {
+		buffer = SoundBuffer::Create(filename);
+		alSourcei(source, AL_BUFFER, buffer->GetBuffer());
+	}
 
 	Audio::CheckAl(alGetError());
 
@@ -32,6 +40,7 @@ Sound::Sound(const std::string &filename, const Audio::Type &type, bool begin, b
 }
 
 Sound::~Sound() {
+	stream = nullptr;
 	alDeleteSources(1, &source);
 	Audio::CheckAl(alGetError());
 }
@@ -46,9 +55,14 @@ void Sound::Update() {
 }
 
 void Sound::Play(bool loop) {
-	alSourcei(source, AL_LOOPING, loop);
-	alSourcePlay(source);
-	Audio::CheckAl(alGetError());
+	if (stream) {
+		// Streams loop by rewinding the decoder, the source itself never loops.
+		stream->Play(loop);
+	} else {
+		alSourcei(source, AL_LOOPING, loop);
+		alSourcePlay(source);
+		Audio::CheckAl(alGetError());
+	}
 
 	SetGain(gain);
 }
@@ -72,6 +86,11 @@ void Sound::Resume() {
 }
 
 void Sound::Stop() {
+	if (stream) {
+		stream->Stop();
+		return;
+	}
+
 	if (!IsPlaying())
 		return;
 
@@ -116,7 +135,20 @@ void Sound::SetPitch(float pitch) {
 }
 
 const Node &operator>>(const Node &node, Sound &sound) {
-	node["buffer"].Get(sound.buffer);
+	bool stream = false;
+	node["stream"].Get(stream);
+
+	if (stream) {
+		node["buffer"]["filename"].Get(sound.filename);
+
+		if (sound.source == 0)
+			alGenSources(1, &sound.source);
+		if (auto decoder = SoundDecoder::Create(sound.filename))
+			sound.stream = std::make_unique<SoundStream>(std::move(decoder), sound.source);
+	} else {
+		node["buffer"].Get(sound.buffer);
+	}
+
 	node["type"].Get(sound.type);
 	node["gain"].Get(sound.gain);
 	node["pitch"].Get(sound.pitch);
@@ -124,7 +156,11 @@ const Node &operator>>(const Node &node, Sound &sound) {
 }
 
 Node &operator<<(Node &node, const Sound &sound) {
-	node["buffer"].Set(sound.buffer);
+	if (sound.IsStreaming())
+		node["buffer"]["filename"].Set(sound.filename);
+	else
+		node["buffer"].Set(sound.buffer);
+	node["stream"].Set(sound.IsStreaming());
 	node["type"].Set(sound.type);
 	node["gain"].Set(sound.gain);
 	node["pitch"].Set(sound.pitch);
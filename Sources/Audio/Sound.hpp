@@ -3,6 +3,7 @@
 #include "Maths/Vector3.hpp"
 #include "Scenes/Component.hpp"
 #include "SoundBuffer.hpp"
+#include "SoundStream.hpp"
 #include "Audio.hpp"
 
 namespace acid {
@@ -13,8 +14,18 @@ class ACID_EXPORT Sound : public Component::Registrar<Sound> {
 	inline static const bool Registered = Register("sound");
 public:
 	Sound() = default;
+	/**
+	 * Creates a new sound.
+	 * @param filename The file to load the sound from.
+	 * @param type The type of sound, used to look up the gain.
+	 * @param begin If the sound will start playing immediately.
+	 * @param loop If the sound will loop when it starts playing.
+	 * @param gain The gain of the sound.
+	 * @param pitch The pitch of the sound.
+	 * @param stream If the sound will be decoded while it plays instead of loaded into one buffer, for long sounds such as music.
+	 */
 	explicit Sound(const std::string &filename, const Audio::Type &type = Audio::Type::General, bool begin = false,
-		bool loop = false, float gain = 1.0f, float pitch = 1.0f);
+		bool loop = false, float gain = 1.0f, float pitch = 1.0f, bool stream = false);
 	~Sound();
 
 	void Start() override;
@@ -26,6 +37,7 @@ public:
 	void Stop();
 
 	bool IsPlaying() const;
+	bool IsStreaming() const { return stream != nullptr; }
 
 	void SetPosition(const Vector3f &position);
 	void SetDirection(const Vector3f &direction);
@@ -45,6 +57,9 @@ public:
 
 private:
 	std::shared_ptr<SoundBuffer> buffer;
+	std::unique_ptr<SoundStream> stream;
+	/// The file a streamed sound decodes from, written in place of the buffer filename.
+	std::filesystem::path filename;
 	uint32_t source = 0;
 
 	Vector3f position;
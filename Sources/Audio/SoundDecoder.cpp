@@ -0,0 +1,171 @@
+#include "SoundDecoder.hpp"
+
+#include <dr_libs/dr_flac.h>
+#include <dr_libs/dr_mp3.h>
+#include <dr_libs/dr_wav.h>
+#include <stb/stb_vorbis.h>
+
+#include "Engine/Log.hpp"
+#include "Files/Files.hpp"
+
+namespace acid {
+class OggSoundDecoder : public SoundDecoder {
+public:
+	explicit OggSoundDecoder(std::string data) :
+		SoundDecoder(std::move(data)) {
+		int32_t error = 0;
+		vorbis = stb_vorbis_open_memory(reinterpret_cast<const uint8_t *>(this->data.data()), static_cast<int32_t>(this->data.size()), &error, nullptr);
+		if (!vorbis)
+			return;
+
+		auto info = stb_vorbis_get_info(vorbis);
+		channels = static_cast<uint32_t>(info.channels);
+		sampleRate = info.sample_rate;
+	}
+
+	~OggSoundDecoder() {
+		if (vorbis)
+			stb_vorbis_close(vorbis);
+	}
+
+	std::size_t Read(int16_t *samples, std::size_t frameCount) override {
+		std::size_t framesRead = 0;
+
+		// Vorbis decodes a packet at a time, so reads are repeated until the request is filled.
+		while (framesRead < frameCount) {
+			auto frames = stb_vorbis_get_samples_short_interleaved(vorbis, static_cast<int32_t>(channels), samples + framesRead * channels,
+				static_cast<int32_t>((frameCount - framesRead) * channels));
+			if (frames <= 0)
+				break;
+			framesRead += static_cast<std::size_t>(frames);
+		}
+
+		return framesRead;
+	}
+
+	bool Rewind() override {
+		return stb_vorbis_seek_start(vorbis) != 0;
+	}
+
+	stb_vorbis *vorbis = nullptr;
+};
+
+class Mp3SoundDecoder : public SoundDecoder {
+public:
+	explicit Mp3SoundDecoder(std::string data) :
+		SoundDecoder(std::move(data)) {
+		if (!drmp3_init_memory(&mp3, this->data.data(), this->data.size(), nullptr))
+			return;
+
+		initialized = true;
+		channels = mp3.channels;
+		sampleRate = mp3.sampleRate;
+	}
+
+	~Mp3SoundDecoder() {
+		if (initialized)
+			drmp3_uninit(&mp3);
+	}
+
+	std::size_t Read(int16_t *samples, std::size_t frameCount) override {
+		return static_cast<std::size_t>(drmp3_read_pcm_frames_s16(&mp3, frameCount, samples));
+	}
+
+	bool Rewind() override {
+		return drmp3_seek_to_pcm_frame(&mp3, 0);
+	}
+
+	drmp3 mp3 = {};
+	bool initialized = false;
+};
+
+class WaveSoundDecoder : public SoundDecoder {
+public:
+	explicit WaveSoundDecoder(std::string data) :
+		SoundDecoder(std::move(data)) {
+		if (!drwav_init_memory(&wav, this->data.data(), this->data.size(), nullptr))
+			return;
+
+		initialized = true;
+		channels = wav.channels;
+		sampleRate = wav.sampleRate;
+	}
+
+	~WaveSoundDecoder() {
+		if (initialized)
+			drwav_uninit(&wav);
+	}
+
+	std::size_t Read(int16_t *samples, std::size_t frameCount) override {
+		return static_cast<std::size_t>(drwav_read_pcm_frames_s16(&wav, frameCount, samples));
+	}
+
+	bool Rewind() override {
+		return drwav_seek_to_pcm_frame(&wav, 0);
+	}
+
+	drwav wav = {};
+	bool initialized = false;
+};
+
+class FlacSoundDecoder : public SoundDecoder {
+public:
+	explicit FlacSoundDecoder(std::string data) :
+		SoundDecoder(std::move(data)) {
+		flac = drflac_open_memory(this->data.data(), this->data.size(), nullptr);
+		if (!flac)
+			return;
+
+		channels = flac->channels;
+		sampleRate = flac->sampleRate;
+	}
+
+	~FlacSoundDecoder() {
+		if (flac)
+			drflac_close(flac);
+	}
+
+	std::size_t Read(int16_t *samples, std::size_t frameCount) override {
+		return static_cast<std::size_t>(drflac_read_pcm_frames_s16(flac, frameCount, samples));
+	}
+
+	bool Rewind() override {
+		return drflac_seek_to_pcm_frame(flac, 0);
+	}
+
+	drflac *flac = nullptr;
+};
+
+std::unique_ptr<SoundDecoder> SoundDecoder::Create(const std::filesystem::path &filename) {
+	auto fileLoaded = Files::Read(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Sound could not be loaded: ", filename, '\n');
+		return nullptr;
+	}
+
+	auto decoder = Create(std::move(*fileLoaded), filename.extension().string());
+
+	if (!decoder)
+		Log::Error("Sound could not be decoded: ", filename, '\n');
+	return decoder;
+}
+
+std::unique_ptr<SoundDecoder> SoundDecoder::Create(std::string data, const std::string &extension) {
+	std::unique_ptr<SoundDecoder> decoder;
+
+	if (extension == ".ogg")
+		decoder = std::make_unique<OggSoundDecoder>(std::move(data));
+	else if (extension == ".mp3")
+		decoder = std::make_unique<Mp3SoundDecoder>(std::move(data));
+	else if (extension == ".wav")
+		decoder = std::make_unique<WaveSoundDecoder>(std::move(data));
+	else if (extension == ".flac")
+		decoder = std::make_unique<FlacSoundDecoder>(std::move(data));
+
+	// Decoders that failed to open have no channels.
+	if (decoder && (decoder->channels == 0 || decoder->channels > 2))
+		return nullptr;
+	return decoder;
+}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief Class that incrementally decodes a compressed sound into 16 bit PCM.
+ * Only the encoded file is held in memory, so long sounds can be decoded a little at a time. This does not require an audio device.
+ */
+class ACID_EXPORT SoundDecoder {
+public:
+	/**
+	 * Creates a decoder for a sound file, the decoder is chosen from the file extension.
+	 * @param filename The file to decode.
+	 * @return The decoder, or null if the file could not be read or decoded.
+	 */
+	static std::unique_ptr<SoundDecoder> Create(const std::filesystem::path &filename);
+
+	/**
+	 * Creates a decoder for an encoded sound in memory.
+	 * @param data The encoded sound, the decoder takes ownership of it.
+	 * @param extension The extension of the encoding, such as ".ogg".
+	 * @return The decoder, or null if the sound could not be decoded.
+	 */
+	static std::unique_ptr<SoundDecoder> Create(std::string data, const std::string &extension);
+
+	virtual ~SoundDecoder() = default;
+
+	/**
+	 * Decodes the next frames of the sound.
+	 * @param samples Where to write interleaved samples, with space for frameCount * channels samples.
+	 * @param frameCount The maximum number of frames to decode.
+	 * @return The number of frames decoded, less than frameCount when the end of the sound is reached.
+	 */
+	virtual std::size_t Read(int16_t *samples, std::size_t frameCount) = 0;
+
+	/**
+	 * Seeks back to the first frame of the sound.
+	 * @return If the seek succeeded.
+	 */
+	virtual bool Rewind() = 0;
+
+	uint32_t GetChannels() const { return channels; }
+	uint32_t GetSampleRate() const { return sampleRate; }
+
+protected:
+	explicit SoundDecoder(std::string data) :
+		data(std::move(data)) {
+	}
+
+	std::string data;
+	uint32_t channels = 0;
+	uint32_t sampleRate = 0;
+};
+}
@@ -0,0 +1,199 @@
+#include "SoundStream.hpp"
+
+#if defined(ACID_BUILD_MACOS)
+#include <OpenAL/al.h>
+#else
+#include <al.h>
+#endif
+
+#include "Audio.hpp"
+
+namespace acid {
+SoundStream::SoundStream(std::unique_ptr<SoundDecoder> &&decoder, uint32_t source) :
+	decoder(std::move(decoder)),
+	source(source),
+	format(this->decoder->GetChannels() == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16),
+	chunkFrames(static_cast<std::size_t>(this->decoder->GetSampleRate() * BufferDuration)) {
+	alGenBuffers(static_cast<ALsizei>(buffers.size()), buffers.data());
+	Audio::CheckAl(alGetError());
+
+	freeBuffers.assign(buffers.begin(), buffers.end());
+	decoderThread = std::thread(&SoundStream::Decode, this);
+	Audio::Get()->AddStream(this);
+}
+
+SoundStream::~SoundStream() {
+	Audio::Get()->RemoveStream(this);
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		running = false;
+	}
+
+	condition.notify_all();
+	decoderThread.join();
+
+	Stop();
+	alDeleteBuffers(static_cast<ALsizei>(buffers.size()), buffers.data());
+}
+
+void SoundStream::Update() {
+	if (finished)
+		return;
+
+	UnqueueBuffers();
+
+	while (!freeBuffers.empty() && QueueBuffer(freeBuffers.back()))
+		freeBuffers.pop_back();
+
+	ALint state, queued;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+
+	if (queued == 0 && endOfStream) {
+		finished = true;
+		return;
+	}
+
+	// The source stops if it plays every queued buffer before they are refilled.
+	if (state == AL_STOPPED && queued > 0)
+		alSourcePlay(source);
+
+	Audio::CheckAl(alGetError());
+}
+
+void SoundStream::Play(bool loop) {
+	Stop();
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		this->loop = loop;
+		generation++;
+		rewind = true;
+		decoding = true;
+		endOfStream = false;
+
+		for (auto &chunk : chunks)
+			freeSamples.emplace_back(std::move(chunk));
+		chunks.clear();
+
+		// The first chunk is waited for, so the source starts playing straight away.
+		condition.notify_all();
+		condition.wait(lock, [this]() {
+			return !chunks.empty();
+		});
+	}
+
+	finished = false;
+
+	while (!freeBuffers.empty() && QueueBuffer(freeBuffers.back()))
+		freeBuffers.pop_back();
+
+	alSourcePlay(source);
+	Audio::CheckAl(alGetError());
+}
+
+void SoundStream::Stop() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		decoding = false;
+	}
+
+	finished = true;
+	alSourceStop(source);
+	UnqueueBuffers();
+	Audio::CheckAl(alGetError());
+}
+
+void SoundStream::Decode() {
+	std::unique_lock<std::mutex> lock(mutex);
+	auto channels = decoder->GetChannels();
+
+	while (true) {
+		condition.wait(lock, [this]() {
+			return !running || (decoding && chunks.size() < ChunkCount);
+		});
+
+		if (!running)
+			return;
+
+		// The decoder is only used from this thread, so it is rewound here when a play is requested.
+		auto rewound = rewind;
+		if (rewind) {
+			decoder->Rewind();
+			rewind = false;
+		}
+
+		auto chunkGeneration = generation;
+		std::vector<int16_t> samples;
+		if (!freeSamples.empty()) {
+			samples = std::move(freeSamples.back());
+			freeSamples.pop_back();
+		}
+
+		lock.unlock();
+		samples.resize(chunkFrames * channels);
+		auto frames = decoder->Read(samples.data(), chunkFrames);
+		samples.resize(frames * channels);
+		lock.lock();
+
+		if (chunkGeneration != generation) {
+			freeSamples.emplace_back(std::move(samples));
+			continue;
+		}
+
+		if (frames > 0)
+			chunks.emplace_back(std::move(samples));
+
+		if (frames < chunkFrames) {
+			// Looping rewinds for the next chunk, unless nothing could be read right after a rewind.
+			if (loop && !(rewound && frames == 0)) {
+				rewind = true;
+			} else {
+				chunks.emplace_back();
+				decoding = false;
+			}
+		}
+
+		condition.notify_all();
+	}
+}
+
+bool SoundStream::QueueBuffer(uint32_t buffer) {
+	std::vector<int16_t> samples;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (chunks.empty() || endOfStream)
+			return false;
+
+		samples = std::move(chunks.front());
+		chunks.pop_front();
+		condition.notify_all();
+
+		if (samples.empty()) {
+			endOfStream = true;
+			return false;
+		}
+	}
+
+	alBufferData(buffer, format, samples.data(), static_cast<ALsizei>(samples.size() * sizeof(int16_t)),
+		static_cast<ALsizei>(decoder->GetSampleRate()));
+	alSourceQueueBuffers(source, 1, &buffer);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	freeSamples.emplace_back(std::move(samples));
+	return true;
+}
+
+void SoundStream::UnqueueBuffers() {
+	ALint processed;
+	alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+
+	while (processed-- > 0) {
+		ALuint buffer;
+		alSourceUnqueueBuffers(source, 1, &buffer);
+		freeBuffers.emplace_back(buffer);
+	}
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SoundDecoder.hpp"
+
+namespace acid {
+/**
+ * @brief Class that streams a sound into a source through a queue of small buffers.
+ * A decoder thread keeps a few chunks of PCM ready, and {@link SoundStream#Update} refills buffers the source has finished playing.
+ */
+class ACID_EXPORT SoundStream {
+public:
+	/// Number of buffers queued on the source.
+	static constexpr std::size_t BufferCount = 4;
+	/// Number of decoded chunks the decoder thread keeps ready.
+	static constexpr std::size_t ChunkCount = 4;
+	/// Length of each buffer in seconds.
+	static constexpr float BufferDuration = 0.25f;
+
+	/**
+	 * Creates a new sound stream.
+	 * @param decoder The decoder to stream from.
+	 * @param source The source to queue buffers on.
+	 */
+	SoundStream(std::unique_ptr<SoundDecoder> &&decoder, uint32_t source);
+	~SoundStream();
+
+	/**
+	 * Refills and queues buffers the source has finished with, called from the audio module each update.
+	 */
+	void Update();
+
+	/**
+	 * Starts the stream from the beginning.
+	 * @param loop If the stream will rewind when it reaches the end.
+	 */
+	void Play(bool loop);
+
+	/**
+	 * Stops the source and unqueues all buffers.
+	 */
+	void Stop();
+
+	bool IsLooping() const { return loop; }
+	bool IsFinished() const { return finished; }
+
+private:
+	void Decode();
+	/**
+	 * Fills a buffer with the next decoded chunk and queues it.
+	 * @param buffer The buffer to fill.
+	 * @return If a chunk was available.
+	 */
+	bool QueueBuffer(uint32_t buffer);
+	void UnqueueBuffers();
+
+	std::unique_ptr<SoundDecoder> decoder;
+	uint32_t source;
+	std::array<uint32_t, BufferCount> buffers = {};
+	/// Buffers that are not queued on the source.
+	std::vector<uint32_t> freeBuffers;
+	int32_t format;
+	std::size_t chunkFrames;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	/// Decoded PCM ready to be queued, an empty chunk marks the end of the sound.
+	std::deque<std::vector<int16_t>> chunks;
+	/// Emptied chunks that are reused to avoid allocating while streaming.
+	std::vector<std::vector<int16_t>> freeSamples;
+	/// Incremented on each play, so chunks decoded before the play are dropped.
+	uint32_t generation = 0;
+	bool rewind = false;
+	bool decoding = false;
+	bool running = true;
+	bool loop = false;
+	bool endOfStream = false;
+	bool finished = true;
+	std::thread decoderThread;
+};
+}
@@ -25,7 +25,11 @@ Bitmap::Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, uint32_
 }
 
 void Bitmap::Load(const std::filesystem::path &filename) {
-	//Registry()[filename.extension().string()].first(this, filename);
+	// Formats with a registered codec are decoded by it, anything else falls back to stb. Only implemented codecs are registered.
+	if (auto it = Registry().find(filename.extension().string()); it != Registry().end()) {
+		it->second.first(this, filename);
+		if (data) return;
+	}
 
 	auto fileLoaded = Files::Read(filename);
 
@@ -43,7 +47,10 @@ void Bitmap::Write(const std::filesystem::path &filename) const {
 	if (auto parentPath = filename.parent_path(); !parentPath.empty())
 		std::filesystem::create_directories(parentPath);
 
-	//Registry()[filename.extension().string()].second(this, filename);
+	if (auto it = Registry().find(filename.extension().string()); it != Registry().end()) {
+		it->second.second(this, filename);
+		return;
+	}
 
 	std::ofstream os(filename, std::ios::binary | std::ios::out);
 	int32_t len;
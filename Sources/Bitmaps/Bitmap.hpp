@@ -38,8 +38,11 @@ public:
 	explicit Bitmap(std::filesystem::path filename);
 	explicit Bitmap(const Vector2ui &size, uint32_t bytesPerPixel = 4);
 	Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, uint32_t bytesPerPixel = 4);
+	Bitmap(Bitmap &&) noexcept = default;
 	~Bitmap() = default;
 
+	Bitmap &operator=(Bitmap &&) noexcept = default;
+
 	void Load(const std::filesystem::path &filename);
 	void Write(const std::filesystem::path &filename) const;
 
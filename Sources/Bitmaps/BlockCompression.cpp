@@ -0,0 +1,647 @@
+#include "BlockCompression.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace acid {
+/// The 16 texels of a block in RGBA, row by row.
+using Texels = std::array<std::array<uint8_t, 4>, 16>;
+
+static constexpr uint8_t BC7_WEIGHTS[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/**
+ * Writes a 128 bit block from the least significant bit up.
+ */
+class BitWriter {
+public:
+	void Write(uint64_t value, uint32_t bits) {
+		for (uint32_t i = 0; i < bits; i++, offset++)
+			data[offset / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (offset % 8));
+	}
+
+	std::array<uint8_t, 16> data = {};
+	uint32_t offset = 0;
+};
+
+/**
+ * Reads a 128 bit block from the least significant bit up.
+ */
+class BitReader {
+public:
+	explicit BitReader(const uint8_t *data) :
+		data(data) {
+	}
+
+	uint32_t Read(uint32_t bits) {
+		uint32_t value = 0;
+		for (uint32_t i = 0; i < bits; i++, offset++)
+			value |= ((data[offset / 8] >> (offset % 8)) & 1) << i;
+		return value;
+	}
+
+	const uint8_t *data;
+	uint32_t offset = 0;
+};
+
+static void ExpandTexel(const uint8_t *src, uint32_t bytesPerPixel, std::array<uint8_t, 4> &texel) {
+	switch (bytesPerPixel) {
+	case 1:
+		texel = {src[0], src[0], src[0], 255};
+		break;
+	case 2:
+		texel = {src[0], src[0], src[0], src[1]};
+		break;
+	case 3:
+		texel = {src[0], src[1], src[2], 255};
+		break;
+	default:
+		texel = {src[0], src[1], src[2], src[3]};
+		break;
+	}
+}
+
+static void FetchBlock(const Bitmap &bitmap, uint32_t blockX, uint32_t blockY, Texels &texels) {
+	auto size = bitmap.GetSize();
+	auto bytesPerPixel = bitmap.GetBytesPerPixel();
+
+	for (uint32_t i = 0; i < 16; i++) {
+		auto x = std::min(blockX * 4 + i % 4, size.x - 1);
+		auto y = std::min(blockY * 4 + i / 4, size.y - 1);
+		ExpandTexel(bitmap.GetData().get() + (static_cast<std::size_t>(y) * size.x + x) * bytesPerPixel, bytesPerPixel, texels[i]);
+	}
+}
+
+/**
+ * Fits a line through the masked texels along their principal axis.
+ * @tparam N The number of channels to fit, starting from red.
+ * @param texels The texels to fit.
+ * @param mask Which texels to include.
+ * @param start The start of the line, where texels project the least.
+ * @param end The end of the line, where texels project the most.
+ */
+template<uint32_t N>
+static void FitLine(const Texels &texels, const std::array<bool, 16> &mask, std::array<float, N> &start, std::array<float, N> &end) {
+	std::array<float, N> mean = {};
+	float count = 0.0f;
+
+	for (uint32_t i = 0; i < 16; i++) {
+		if (!mask[i])
+			continue;
+		for (uint32_t c = 0; c < N; c++)
+			mean[c] += texels[i][c];
+		count++;
+	}
+
+	for (uint32_t c = 0; c < N; c++)
+		mean[c] /= std::max(count, 1.0f);
+
+	std::array<std::array<float, N>, N> covariance = {};
+
+	for (uint32_t i = 0; i < 16; i++) {
+		if (!mask[i])
+			continue;
+		for (uint32_t a = 0; a < N; a++) {
+			for (uint32_t b = 0; b < N; b++)
+				covariance[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+		}
+	}
+
+	// Power iteration converges on the axis with the most variance. It starts from the covariance of the channel that varies most,
+	// a fixed start such as the diagonal can be orthogonal to the axis when channels are anticorrelated.
+	uint32_t largest = 0;
+	for (uint32_t c = 1; c < N; c++) {
+		if (covariance[c][c] > covariance[largest][largest])
+			largest = c;
+	}
+
+	auto axis = covariance[largest];
+	if (covariance[largest][largest] < 1e-6f)
+		axis.fill(1.0f);
+
+	for (uint32_t iteration = 0; iteration < 8; iteration++) {
+		std::array<float, N> next = {};
+		float length = 0.0f;
+
+		for (uint32_t a = 0; a < N; a++) {
+			for (uint32_t b = 0; b < N; b++)
+				next[a] += covariance[a][b] * axis[b];
+			length = std::max(length, std::abs(next[a]));
+		}
+
+		if (length < 1e-6f)
+			break;
+
+		for (uint32_t a = 0; a < N; a++)
+			axis[a] = next[a] / length;
+	}
+
+	float axisLength = 0.0f;
+	for (uint32_t c = 0; c < N; c++)
+		axisLength += axis[c] * axis[c];
+	axisLength = std::sqrt(axisLength);
+
+	for (uint32_t c = 0; c < N; c++)
+		axis[c] /= axisLength;
+
+	auto minProjection = std::numeric_limits<float>::max();
+	auto maxProjection = std::numeric_limits<float>::lowest();
+
+	for (uint32_t i = 0; i < 16; i++) {
+		if (!mask[i])
+			continue;
+
+		float projection = 0.0f;
+		for (uint32_t c = 0; c < N; c++)
+			projection += (texels[i][c] - mean[c]) * axis[c];
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	if (count == 0.0f)
+		minProjection = maxProjection = 0.0f;
+
+	for (uint32_t c = 0; c < N; c++) {
+		start[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+		end[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+	}
+}
+
+/**
+ * Solves for the endpoints that best fit the texels with their chosen interpolation weights.
+ * @tparam N The number of channels to fit, starting from red.
+ * @param texels The texels to fit.
+ * @param weights How far along the line each texel is, or negative to exclude a texel.
+ * @param start The fitted start of the line, unchanged if the system is singular.
+ * @param end The fitted end of the line, unchanged if the system is singular.
+ */
+template<uint32_t N>
+static void RefitLine(const Texels &texels, const std::array<float, 16> &weights, std::array<float, N> &start, std::array<float, N> &end) {
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	std::array<float, N> ax = {}, bx = {};
+
+	for (uint32_t i = 0; i < 16; i++) {
+		if (weights[i] < 0.0f)
+			continue;
+
+		auto b = weights[i];
+		auto a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+
+		for (uint32_t c = 0; c < N; c++) {
+			ax[c] += a * texels[i][c];
+			bx[c] += b * texels[i][c];
+		}
+	}
+
+	auto determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f)
+		return;
+
+	for (uint32_t c = 0; c < N; c++) {
+		start[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+		end[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+	}
+}
+
+static uint16_t To565(const std::array<float, 3> &colour) {
+	auto r = static_cast<uint16_t>(std::lround(colour[0] * 31.0f / 255.0f));
+	auto g = static_cast<uint16_t>(std::lround(colour[1] * 63.0f / 255.0f));
+	auto b = static_cast<uint16_t>(std::lround(colour[2] * 31.0f / 255.0f));
+	return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+static std::array<int32_t, 4> From565(uint16_t colour) {
+	auto r = (colour >> 11) & 31;
+	auto g = (colour >> 5) & 63;
+	auto b = colour & 31;
+	return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+}
+
+/**
+ * Gets the palette of a BC1 colour block.
+ * @param colour0 The first endpoint.
+ * @param colour1 The second endpoint.
+ * @param fourColour If the block always uses four colours, as in BC3. Otherwise blocks where colour0 <= colour1 use three colours and transparent black.
+ * @return The four palette entries.
+ */
+static std::array<std::array<int32_t, 4>, 4> GetBc1Palette(uint16_t colour0, uint16_t colour1, bool fourColour) {
+	std::array<std::array<int32_t, 4>, 4> palette;
+	palette[0] = From565(colour0);
+	palette[1] = From565(colour1);
+
+	if (fourColour || colour0 > colour1) {
+		for (uint32_t c = 0; c < 3; c++) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		palette[2][3] = palette[3][3] = 255;
+	} else {
+		for (uint32_t c = 0; c < 3; c++)
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+		palette[2][3] = 255;
+		palette[3] = {0, 0, 0, 0};
+	}
+
+	return palette;
+}
+
+static void EncodeBc1Colour(const Texels &texels, bool punchThrough, uint8_t *dst) {
+	// Texels with low alpha are written as transparent black when punch through alpha is used.
+	std::array<bool, 16> mask;
+	for (uint32_t i = 0; i < 16; i++)
+		mask[i] = !punchThrough || texels[i][3] >= 128;
+	auto transparent = std::find(mask.begin(), mask.end(), false) != mask.end();
+
+	uint16_t bestColour0 = 0, bestColour1 = 0;
+	uint32_t bestIndices = 0xFFFFFFFF;
+	auto bestError = std::numeric_limits<uint32_t>::max();
+	std::array<float, 16> bestWeights;
+
+	auto tryEndpoints = [&](const std::array<float, 3> &start, const std::array<float, 3> &end) {
+		auto colour0 = To565(end);
+		auto colour1 = To565(start);
+
+		// The order of the endpoints selects between three and four colour blocks.
+		if (transparent ? colour0 > colour1 : colour0 < colour1)
+			std::swap(colour0, colour1);
+
+		auto palette = GetBc1Palette(colour0, colour1, false);
+		auto colours = transparent || colour0 == colour1 ? 3u : 4u;
+		static constexpr float fourWeights[] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+		static constexpr float threeWeights[] = {0.0f, 1.0f, 0.5f, -1.0f};
+
+		uint32_t indices = 0;
+		uint32_t error = 0;
+		std::array<float, 16> weights;
+
+		for (uint32_t i = 0; i < 16; i++) {
+			uint32_t bestIndex = 3;
+			auto bestTexelError = std::numeric_limits<uint32_t>::max();
+
+			if (mask[i]) {
+				for (uint32_t p = 0; p < colours; p++) {
+					uint32_t texelError = 0;
+					for (uint32_t c = 0; c < 3; c++) {
+						auto d = palette[p][c] - texels[i][c];
+						texelError += d * d;
+					}
+					if (texelError < bestTexelError) {
+						bestTexelError = texelError;
+						bestIndex = p;
+					}
+				}
+				error += bestTexelError;
+			}
+
+			indices |= bestIndex << (2 * i);
+			weights[i] = colours == 4 ? fourWeights[bestIndex] : threeWeights[bestIndex];
+		}
+
+		if (error < bestError) {
+			bestError = error;
+			bestColour0 = colour0;
+			bestColour1 = colour1;
+			bestIndices = indices;
+			bestWeights = weights;
+		}
+	};
+
+	if (std::find(mask.begin(), mask.end(), true) != mask.end()) {
+		std::array<float, 3> start, end;
+		FitLine<3>(texels, mask, start, end);
+		tryEndpoints(start, end);
+
+		// The refitted line runs from colour0 to colour1, the order is resolved again when the endpoints are tried.
+		RefitLine<3>(texels, bestWeights, start, end);
+		tryEndpoints(start, end);
+	}
+
+	std::memcpy(dst, &bestColour0, 2);
+	std::memcpy(dst + 2, &bestColour1, 2);
+	std::memcpy(dst + 4, &bestIndices, 4);
+}
+
+static void EncodeBc4Alpha(const Texels &texels, uint8_t *dst) {
+	uint8_t alpha0 = 0, alpha1 = 255;
+	for (const auto &texel : texels) {
+		alpha0 = std::max(alpha0, texel[3]);
+		alpha1 = std::min(alpha1, texel[3]);
+	}
+
+	dst[0] = alpha0;
+	dst[1] = alpha1;
+	uint64_t indices = 0;
+
+	if (alpha0 != alpha1) {
+		std::array<int32_t, 8> palette = {alpha0, alpha1};
+		for (int32_t i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1 + 3) / 7;
+
+		for (uint32_t i = 0; i < 16; i++) {
+			uint64_t bestIndex = 0;
+			for (uint32_t p = 1; p < 8; p++) {
+				if (std::abs(palette[p] - texels[i][3]) < std::abs(palette[bestIndex] - texels[i][3]))
+					bestIndex = p;
+			}
+			indices |= bestIndex << (3 * i);
+		}
+	}
+
+	for (uint32_t i = 0; i < 6; i++)
+		dst[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+static void EncodeBc7(const Texels &texels, uint8_t *dst) {
+	// Mode 6 has a single subset with 7 bit RGBA endpoints, a shared low bit per endpoint, and 4 bit indices.
+	class Endpoints {
+	public:
+		std::array<std::array<uint32_t, 4>, 2> quantized;
+		std::array<uint32_t, 2> pbits;
+		std::array<uint8_t, 16> indices;
+		uint64_t error = std::numeric_limits<uint64_t>::max();
+	} best;
+
+	auto quantize = [](const std::array<float, 4> &endpoint, std::array<uint32_t, 4> &quantized, uint32_t &pbit) {
+		auto bestError = std::numeric_limits<float>::max();
+		for (uint32_t p = 0; p < 2; p++) {
+			float error = 0.0f;
+			std::array<uint32_t, 4> values;
+			for (uint32_t c = 0; c < 4; c++) {
+				values[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - p) / 2.0f), 0l, 127l));
+				auto d = static_cast<float>(values[c] * 2 + p) - endpoint[c];
+				error += d * d;
+			}
+			if (error < bestError) {
+				bestError = error;
+				quantized = values;
+				pbit = p;
+			}
+		}
+	};
+
+	auto tryEndpoints = [&](const std::array<float, 4> &start, const std::array<float, 4> &end) {
+		Endpoints candidate;
+		quantize(start, candidate.quantized[0], candidate.pbits[0]);
+		quantize(end, candidate.quantized[1], candidate.pbits[1]);
+
+		std::array<std::array<int32_t, 4>, 16> palette;
+		for (uint32_t p = 0; p < 16; p++) {
+			for (uint32_t c = 0; c < 4; c++) {
+				auto e0 = static_cast<int32_t>(candidate.quantized[0][c] << 1 | candidate.pbits[0]);
+				auto e1 = static_cast<int32_t>(candidate.quantized[1][c] << 1 | candidate.pbits[1]);
+				palette[p][c] = ((64 - BC7_WEIGHTS[p]) * e0 + BC7_WEIGHTS[p] * e1 + 32) >> 6;
+			}
+		}
+
+		candidate.error = 0;
+		for (uint32_t i = 0; i < 16; i++) {
+			auto bestTexelError = std::numeric_limits<uint32_t>::max();
+			for (uint8_t p = 0; p < 16; p++) {
+				uint32_t texelError = 0;
+				for (uint32_t c = 0; c < 4; c++) {
+					auto d = palette[p][c] - texels[i][c];
+					texelError += d * d;
+				}
+				if (texelError < bestTexelError) {
+					bestTexelError = texelError;
+					candidate.indices[i] = p;
+				}
+			}
+			candidate.error += bestTexelError;
+		}
+
+		if (candidate.error < best.error)
+			best = candidate;
+	};
+
+	std::array<bool, 16> mask;
+	mask.fill(true);
+	std::array<float, 4> start, end;
+	FitLine<4>(texels, mask, start, end);
+	tryEndpoints(start, end);
+
+	std::array<float, 16> weights;
+	for (uint32_t i = 0; i < 16; i++)
+		weights[i] = BC7_WEIGHTS[best.indices[i]] / 64.0f;
+	RefitLine<4>(texels, weights, start, end);
+	tryEndpoints(start, end);
+
+	// The high bit of the first index is implied to be zero.
+	if (best.indices[0] & 8) {
+		std::swap(best.quantized[0], best.quantized[1]);
+		std::swap(best.pbits[0], best.pbits[1]);
+		for (auto &index : best.indices)
+			index = 15 - index;
+	}
+
+	BitWriter writer;
+	writer.Write(1 << 6, 7);
+	for (uint32_t c = 0; c < 4; c++) {
+		writer.Write(best.quantized[0][c], 7);
+		writer.Write(best.quantized[1][c], 7);
+	}
+	writer.Write(best.pbits[0], 1);
+	writer.Write(best.pbits[1], 1);
+	writer.Write(best.indices[0], 3);
+	for (uint32_t i = 1; i < 16; i++)
+		writer.Write(best.indices[i], 4);
+
+	std::memcpy(dst, writer.data.data(), writer.data.size());
+}
+
+static void DecodeBc1Colour(const uint8_t *src, bool fourColour, Texels &texels) {
+	uint16_t colour0, colour1;
+	uint32_t indices;
+	std::memcpy(&colour0, src, 2);
+	std::memcpy(&colour1, src + 2, 2);
+	std::memcpy(&indices, src + 4, 4);
+
+	auto palette = GetBc1Palette(colour0, colour1, fourColour);
+	for (uint32_t i = 0; i < 16; i++) {
+		auto &entry = palette[(indices >> (2 * i)) & 3];
+		texels[i] = {static_cast<uint8_t>(entry[0]), static_cast<uint8_t>(entry[1]), static_cast<uint8_t>(entry[2]), static_cast<uint8_t>(entry[3])};
+	}
+}
+
+static void DecodeBc4Alpha(const uint8_t *src, Texels &texels) {
+	int32_t alpha0 = src[0], alpha1 = src[1];
+	std::array<int32_t, 8> palette = {alpha0, alpha1};
+
+	if (alpha0 > alpha1) {
+		for (int32_t i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1 + 3) / 7;
+	} else {
+		for (int32_t i = 2; i < 6; i++)
+			palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1 + 2) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint64_t indices = 0;
+	for (uint32_t i = 0; i < 6; i++)
+		indices |= static_cast<uint64_t>(src[2 + i]) << (8 * i);
+
+	for (uint32_t i = 0; i < 16; i++)
+		texels[i][3] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+}
+
+static void DecodeBc7(const uint8_t *src, Texels &texels) {
+	// Only mode 6 is decoded, other modes decode to transparent black.
+	if ((src[0] & 0x7F) != 0x40) {
+		for (auto &texel : texels)
+			texel = {0, 0, 0, 0};
+		return;
+	}
+
+	BitReader reader(src);
+	reader.Read(7);
+
+	std::array<std::array<int32_t, 4>, 2> endpoints;
+	for (uint32_t c = 0; c < 4; c++) {
+		endpoints[0][c] = static_cast<int32_t>(reader.Read(7));
+		endpoints[1][c] = static_cast<int32_t>(reader.Read(7));
+	}
+
+	for (auto &endpoint : endpoints) {
+		auto pbit = static_cast<int32_t>(reader.Read(1));
+		for (auto &channel : endpoint)
+			channel = channel << 1 | pbit;
+	}
+
+	for (uint32_t i = 0; i < 16; i++) {
+		auto weight = BC7_WEIGHTS[reader.Read(i == 0 ? 3 : 4)];
+		for (uint32_t c = 0; c < 4; c++)
+			texels[i][c] = static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+	}
+}
+
+uint32_t BlockCompression::GetBlockDimension(Format format) {
+	return format == Format::RGBA8 ? 1 : 4;
+}
+
+uint32_t BlockCompression::GetBlockLength(Format format) {
+	switch (format) {
+	case Format::RGBA8:
+		return 4;
+	case Format::BC1:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+std::size_t BlockCompression::GetLength(Format format, const Vector2ui &size) {
+	auto dimension = GetBlockDimension(format);
+	return static_cast<std::size_t>((size.x + dimension - 1) / dimension) * ((size.y + dimension - 1) / dimension) * GetBlockLength(format);
+}
+
+std::vector<uint8_t> BlockCompression::Encode(const Bitmap &bitmap, Format format, uint32_t threadCount) {
+	auto size = bitmap.GetSize();
+	auto bytesPerPixel = bitmap.GetBytesPerPixel();
+
+	if (!bitmap.GetData() || bytesPerPixel < 1 || bytesPerPixel > 4 || size.x == 0 || size.y == 0)
+		return {};
+
+	std::vector<uint8_t> result(GetLength(format, size));
+	auto dimension = GetBlockDimension(format);
+	auto blockLength = GetBlockLength(format);
+	auto blocksX = (size.x + dimension - 1) / dimension;
+	auto blocksY = (size.y + dimension - 1) / dimension;
+
+	auto encodeRows = [&](uint32_t firstRow, uint32_t lastRow) {
+		Texels texels;
+
+		for (auto blockY = firstRow; blockY < lastRow; blockY++) {
+			for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+				auto dst = result.data() + (static_cast<std::size_t>(blockY) * blocksX + blockX) * blockLength;
+
+				if (format == Format::RGBA8) {
+					ExpandTexel(bitmap.GetData().get() + (static_cast<std::size_t>(blockY) * size.x + blockX) * bytesPerPixel, bytesPerPixel, texels[0]);
+					std::memcpy(dst, texels[0].data(), 4);
+					continue;
+				}
+
+				FetchBlock(bitmap, blockX, blockY, texels);
+
+				switch (format) {
+				case Format::BC1:
+					EncodeBc1Colour(texels, true, dst);
+					break;
+				case Format::BC3:
+					EncodeBc4Alpha(texels, dst);
+					EncodeBc1Colour(texels, false, dst + 8);
+					break;
+				case Format::BC7:
+					EncodeBc7(texels, dst);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	};
+
+	auto jobCount = std::clamp(blocksY / 16, 1u, std::max(threadCount, 1u));
+	auto rowsPerJob = (blocksY + jobCount - 1) / jobCount;
+
+	std::vector<std::thread> workers;
+	workers.reserve(jobCount - 1);
+
+	for (uint32_t job = 1; job < jobCount; job++)
+		workers.emplace_back(encodeRows, std::min(job * rowsPerJob, blocksY), std::min((job + 1) * rowsPerJob, blocksY));
+
+	encodeRows(0, std::min(rowsPerJob, blocksY));
+
+	for (auto &worker : workers)
+		worker.join();
+
+	return result;
+}
+
+Bitmap BlockCompression::Decode(const uint8_t *data, const Vector2ui &size, Format format) {
+	Bitmap result(size, 4);
+
+	if (format == Format::RGBA8) {
+		std::memcpy(result.GetData().get(), data, result.GetLength());
+		return result;
+	}
+
+	auto blockLength = GetBlockLength(format);
+	auto blocksX = (size.x + 3) / 4;
+	auto blocksY = (size.y + 3) / 4;
+	Texels texels;
+
+	for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+		for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+			auto src = data + (static_cast<std::size_t>(blockY) * blocksX + blockX) * blockLength;
+
+			switch (format) {
+			case Format::BC1:
+				DecodeBc1Colour(src, false, texels);
+				break;
+			case Format::BC3:
+				DecodeBc1Colour(src + 8, true, texels);
+				DecodeBc4Alpha(src, texels);
+				break;
+			case Format::BC7:
+				DecodeBc7(src, texels);
+				break;
+			default:
+				break;
+			}
+
+			// Texels past the edge of the image are dropped.
+			for (uint32_t i = 0; i < 16; i++) {
+				auto x = blockX * 4 + i % 4;
+				auto y = blockY * 4 + i / 4;
+				if (x < size.x && y < size.y)
+					std::memcpy(result.GetData().get() + (static_cast<std::size_t>(y) * size.x + x) * 4, texels[i].data(), 4);
+			}
+		}
+	}
+
+	return result;
+}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <thread>
+
+#include "Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that encodes bitmaps into GPU block compressed formats on the CPU.
+ * Each 4x4 block of texels is encoded independently, so rows of blocks are encoded in parallel.
+ */
+class ACID_EXPORT BlockCompression {
+public:
+	enum class Format {
+		/// Uncompressed 8 bit RGBA, stored as 1x1 blocks.
+		RGBA8,
+		/// 565 colour endpoints with 1 bit alpha, 8 bytes per block.
+		BC1,
+		/// BC1 colour with interpolated 8 bit alpha, 16 bytes per block.
+		BC3,
+		/// High quality RGBA, 16 bytes per block. Blocks are encoded with mode 6.
+		BC7
+	};
+
+	BlockCompression() = delete;
+
+	/**
+	 * Gets the width and height of a block in texels.
+	 * @param format The format.
+	 * @return The block dimension.
+	 */
+	static uint32_t GetBlockDimension(Format format);
+
+	/**
+	 * Gets the number of bytes in a block.
+	 * @param format The format.
+	 * @return The block size in bytes.
+	 */
+	static uint32_t GetBlockLength(Format format);
+
+	/**
+	 * Gets the number of bytes needed to encode an image.
+	 * @param format The format.
+	 * @param size The size of the image in texels.
+	 * @return The encoded size in bytes.
+	 */
+	static std::size_t GetLength(Format format, const Vector2ui &size);
+
+	/**
+	 * Encodes a bitmap, partial blocks at the edges are padded by clamping.
+	 * @param bitmap The bitmap to encode, with 1 to 4 bytes per pixel.
+	 * @param format The format to encode to.
+	 * @param threadCount The maximum number of threads to encode with.
+	 * @return The encoded blocks in row order, empty if the bitmap could not be encoded.
+	 */
+	static std::vector<uint8_t> Encode(const Bitmap &bitmap, Format format, uint32_t threadCount = std::thread::hardware_concurrency());
+
+	/**
+	 * Decodes blocks into a RGBA bitmap, BC7 blocks must be encoded with mode 6.
+	 * @param data The encoded blocks.
+	 * @param size The size of the image in texels.
+	 * @param format The format the blocks are encoded with.
+	 * @return The decoded bitmap with 4 bytes per pixel.
+	 */
+	static Bitmap Decode(const uint8_t *data, const Vector2ui &size, Format format);
+};
+}
@@ -4,7 +4,8 @@
 
 namespace acid {
 class ACID_EXPORT DngBitmap : public Bitmap::Registrar<DngBitmap> {
-	inline static const bool Registered = Register(".dng", ".tiff");
+	// Not registered until Load and Write are implemented, these files are loaded and written with stb until then.
+	//inline static const bool Registered = Register(".dng", ".tiff");
 public:
 	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
 	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
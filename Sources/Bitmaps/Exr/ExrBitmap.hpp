@@ -4,7 +4,8 @@
 
 namespace acid {
 class ACID_EXPORT ExrBitmap : public Bitmap::Registrar<ExrBitmap> {
-	inline static const bool Registered = Register(".exr");
+	// Not registered until Load and Write are implemented, these files are loaded and written with stb until then.
+	//inline static const bool Registered = Register(".exr");
 public:
 	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
 	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
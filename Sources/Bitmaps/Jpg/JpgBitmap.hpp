@@ -4,7 +4,8 @@
 
 namespace acid {
 class ACID_EXPORT JpgBitmap : public Bitmap::Registrar<JpgBitmap> {
-	inline static const bool Registered = Register(".jpg", ".jpeg");
+	// Not registered until Load and Write are implemented, these files are loaded and written with stb until then.
+	//inline static const bool Registered = Register(".jpg", ".jpeg");
 public:
 	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
 	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
@@ -0,0 +1,260 @@
+#include "Ktx2Texture.hpp"
+
+#include <cstring>
+
+#include "Engine/Log.hpp"
+#include "Files/Files.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid {
+static constexpr uint8_t KTX2_IDENTIFIER[] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+/// Identifier, header and index, the level index follows.
+static constexpr std::size_t KTX2_HEADER_LENGTH = 80;
+static constexpr std::size_t KTX2_LEVEL_LENGTH = 24;
+
+/**
+ * A format that can be stored, with the values used to describe it in the container.
+ */
+class Ktx2Format {
+public:
+	BlockCompression::Format format;
+	bool srgb;
+	/// The VkFormat value.
+	uint32_t vkFormat;
+	/// The Khronos data format colour model.
+	uint8_t colourModel;
+};
+
+static constexpr Ktx2Format KTX2_FORMATS[] = {
+	{BlockCompression::Format::RGBA8, false, 37, 1},
+	{BlockCompression::Format::RGBA8, true, 43, 1},
+	{BlockCompression::Format::BC1, false, 133, 128},
+	{BlockCompression::Format::BC1, true, 134, 128},
+	{BlockCompression::Format::BC3, false, 137, 130},
+	{BlockCompression::Format::BC3, true, 138, 130},
+	{BlockCompression::Format::BC7, false, 145, 134},
+	{BlockCompression::Format::BC7, true, 146, 134}
+};
+
+static void WriteUint32(std::vector<uint8_t> &data, uint32_t value) {
+	for (uint32_t i = 0; i < 4; i++)
+		data.emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static void WriteUint64(std::vector<uint8_t> &data, uint64_t value) {
+	for (uint32_t i = 0; i < 8; i++)
+		data.emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static uint64_t ReadUint(const std::string &data, std::size_t offset, uint32_t length) {
+	uint64_t value = 0;
+	for (uint32_t i = 0; i < length; i++)
+		value |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+	return value;
+}
+
+/**
+ * Writes a sample of the basic data format descriptor.
+ * @param data The descriptor to append to.
+ * @param bitOffset The first bit of the sample in a block.
+ * @param bitLength The number of bits in the sample.
+ * @param channel The channel the sample is for, with qualifier bits in the high nibble.
+ * @param upper The value of the sample that represents 1.
+ */
+static void WriteDfdSample(std::vector<uint8_t> &data, uint32_t bitOffset, uint32_t bitLength, uint32_t channel, uint32_t upper) {
+	WriteUint32(data, bitOffset | (bitLength - 1) << 16 | channel << 24);
+	WriteUint32(data, 0);
+	WriteUint32(data, 0);
+	WriteUint32(data, upper);
+}
+
+static std::vector<uint8_t> GetDfd(const Ktx2Format &format) {
+	static constexpr uint32_t LINEAR = 0x10;
+	static constexpr uint32_t ALPHA = 15;
+
+	auto dimension = BlockCompression::GetBlockDimension(format.format) - 1;
+	auto blockLength = BlockCompression::GetBlockLength(format.format);
+	// Alpha is always linear, even when colour is in sRGB.
+	auto alphaQualifier = format.srgb ? LINEAR : 0;
+
+	std::vector<uint8_t> samples;
+	switch (format.format) {
+	case BlockCompression::Format::RGBA8:
+		for (uint32_t c = 0; c < 3; c++)
+			WriteDfdSample(samples, 8 * c, 8, c, 255);
+		WriteDfdSample(samples, 24, 8, ALPHA | alphaQualifier, 255);
+		break;
+	case BlockCompression::Format::BC1:
+		// The alpha present channel, as BC1 blocks may use punch through alpha.
+		WriteDfdSample(samples, 0, 64, 1, 0xFFFFFFFF);
+		break;
+	case BlockCompression::Format::BC3:
+		WriteDfdSample(samples, 0, 64, ALPHA | alphaQualifier, 0xFFFFFFFF);
+		WriteDfdSample(samples, 64, 64, 0, 0xFFFFFFFF);
+		break;
+	case BlockCompression::Format::BC7:
+		WriteDfdSample(samples, 0, 128, 0, 0xFFFFFFFF);
+		break;
+	}
+
+	auto blockSize = static_cast<uint32_t>(24 + samples.size());
+
+	std::vector<uint8_t> dfd;
+	WriteUint32(dfd, 4 + blockSize);
+	// Khronos vendor, basic descriptor type.
+	WriteUint32(dfd, 0);
+	WriteUint32(dfd, 2 | blockSize << 16);
+	// BT709 primaries, with a linear or sRGB transfer function.
+	WriteUint32(dfd, format.colourModel | 1 << 8 | (format.srgb ? 2 : 1) << 16);
+	WriteUint32(dfd, dimension | dimension << 8);
+	WriteUint32(dfd, blockLength);
+	WriteUint32(dfd, 0);
+	dfd.insert(dfd.end(), samples.begin(), samples.end());
+	return dfd;
+}
+
+Ktx2Texture::Ktx2Texture(const std::filesystem::path &filename) {
+	Load(filename);
+}
+
+Ktx2Texture::Ktx2Texture(const Bitmap &bitmap, BlockCompression::Format format, bool srgb, bool mipmap, Mipmaps::Filter filter) :
+	format(format),
+	srgb(srgb) {
+	auto mipmaps = Mipmaps::Generate(bitmap, filter, mipmap ? std::numeric_limits<uint32_t>::max() : 1);
+
+	levels.reserve(mipmaps.size() + 1);
+	levels.emplace_back(Level{bitmap.GetSize(), BlockCompression::Encode(bitmap, format)});
+	for (const auto &mipmap : mipmaps)
+		levels.emplace_back(Level{mipmap.GetSize(), BlockCompression::Encode(mipmap, format)});
+}
+
+void Ktx2Texture::Load(const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	levels.clear();
+	auto fileLoaded = Files::Read(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Texture could not be loaded: ", filename, '\n');
+		return;
+	}
+
+	const auto &data = *fileLoaded;
+
+	if (data.size() < KTX2_HEADER_LENGTH || std::memcmp(data.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+		Log::Error("Texture is not a KTX2 file: ", filename, '\n');
+		return;
+	}
+
+	auto vkFormat = static_cast<uint32_t>(ReadUint(data, 12, 4));
+	Vector2ui size(static_cast<uint32_t>(ReadUint(data, 20, 4)), static_cast<uint32_t>(ReadUint(data, 24, 4)));
+	auto layerCount = ReadUint(data, 32, 4);
+	auto faceCount = ReadUint(data, 36, 4);
+	auto levelCount = std::max<uint64_t>(ReadUint(data, 40, 4), 1);
+	auto supercompressionScheme = ReadUint(data, 44, 4);
+
+	auto it = std::find_if(std::begin(KTX2_FORMATS), std::end(KTX2_FORMATS), [vkFormat](const auto &format) {
+		return format.vkFormat == vkFormat;
+	});
+
+	if (it == std::end(KTX2_FORMATS) || layerCount > 1 || faceCount != 1 || supercompressionScheme != 0 ||
+		data.size() < KTX2_HEADER_LENGTH + levelCount * KTX2_LEVEL_LENGTH) {
+		Log::Error("Texture has an unsupported KTX2 layout: ", filename, ", format ", vkFormat, '\n');
+		return;
+	}
+
+	format = it->format;
+	srgb = it->srgb;
+	levels.resize(levelCount);
+
+	for (uint32_t level = 0; level < levelCount; level++) {
+		auto offset = ReadUint(data, KTX2_HEADER_LENGTH + level * KTX2_LEVEL_LENGTH, 8);
+		auto length = ReadUint(data, KTX2_HEADER_LENGTH + level * KTX2_LEVEL_LENGTH + 8, 8);
+		auto levelSize = Mipmaps::GetLevelSize(size, level);
+
+		if (offset + length > data.size() || length != BlockCompression::GetLength(format, levelSize)) {
+			Log::Error("Texture level ", level, " is out of range: ", filename, '\n');
+			levels.clear();
+			return;
+		}
+
+		levels[level].size = levelSize;
+		levels[level].data.assign(data.begin() + offset, data.begin() + offset + length);
+	}
+
+#if defined(ACID_DEBUG)
+	Log::Out("Texture ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+
+void Ktx2Texture::Write(const std::filesystem::path &filename) const {
+	if (levels.empty())
+		return;
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	auto ktx2Format = *std::find_if(std::begin(KTX2_FORMATS), std::end(KTX2_FORMATS), [this](const auto &ktx2Format) {
+		return ktx2Format.format == format && ktx2Format.srgb == srgb;
+	});
+	auto dfd = GetDfd(ktx2Format);
+
+	// Levels are stored smallest first, each aligned to the block size.
+	auto alignment = BlockCompression::GetBlockLength(format);
+	auto offset = KTX2_HEADER_LENGTH + levels.size() * KTX2_LEVEL_LENGTH + dfd.size();
+	std::vector<uint64_t> offsets(levels.size());
+
+	for (auto level = levels.size(); level-- > 0;) {
+		offset = (offset + alignment - 1) / alignment * alignment;
+		offsets[level] = offset;
+		offset += levels[level].data.size();
+	}
+
+	std::vector<uint8_t> ktx2(std::begin(KTX2_IDENTIFIER), std::end(KTX2_IDENTIFIER));
+	ktx2.reserve(offset);
+	WriteUint32(ktx2, ktx2Format.vkFormat);
+	WriteUint32(ktx2, 1);
+	WriteUint32(ktx2, GetSize().x);
+	WriteUint32(ktx2, GetSize().y);
+	WriteUint32(ktx2, 0);
+	WriteUint32(ktx2, 0);
+	WriteUint32(ktx2, 1);
+	WriteUint32(ktx2, static_cast<uint32_t>(levels.size()));
+	WriteUint32(ktx2, 0);
+
+	auto dfdOffset = KTX2_HEADER_LENGTH + levels.size() * KTX2_LEVEL_LENGTH;
+	WriteUint32(ktx2, static_cast<uint32_t>(dfdOffset));
+	WriteUint32(ktx2, static_cast<uint32_t>(dfd.size()));
+	WriteUint32(ktx2, 0);
+	WriteUint32(ktx2, 0);
+	WriteUint64(ktx2, 0);
+	WriteUint64(ktx2, 0);
+
+	for (std::size_t level = 0; level < levels.size(); level++) {
+		WriteUint64(ktx2, offsets[level]);
+		WriteUint64(ktx2, levels[level].data.size());
+		WriteUint64(ktx2, levels[level].data.size());
+	}
+
+	ktx2.insert(ktx2.end(), dfd.begin(), dfd.end());
+
+	for (auto level = levels.size(); level-- > 0;) {
+		ktx2.resize(offsets[level]);
+		ktx2.insert(ktx2.end(), levels[level].data.begin(), levels[level].data.end());
+	}
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(reinterpret_cast<const char *>(ktx2.data()), static_cast<std::streamsize>(ktx2.size()));
+}
+
+uint32_t Ktx2Texture::GetVkFormat() const {
+	for (const auto &ktx2Format : KTX2_FORMATS) {
+		if (ktx2Format.format == format && ktx2Format.srgb == srgb)
+			return ktx2Format.vkFormat;
+	}
+
+	return 0;
+}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Bitmaps/BlockCompression.hpp"
+#include "Bitmaps/Mipmaps.hpp"
+
+namespace acid {
+/**
+ * @brief Class that holds a mipmapped texture in a KTX2 container, so textures can be compressed and mipmapped offline and uploaded as is.
+ */
+class ACID_EXPORT Ktx2Texture {
+public:
+	/**
+	 * A mip level of the texture, encoded in the textures format.
+	 */
+	class Level {
+	public:
+		Vector2ui size;
+		std::vector<uint8_t> data;
+	};
+
+	Ktx2Texture() = default;
+
+	/**
+	 * Creates a new texture from a KTX2 file.
+	 * @param filename The file to load the texture from.
+	 */
+	explicit Ktx2Texture(const std::filesystem::path &filename);
+
+	/**
+	 * Creates a new texture by generating mipmaps from a bitmap and encoding each level.
+	 * @param bitmap The bitmap to use as the first level.
+	 * @param format The format to encode levels with.
+	 * @param srgb If the texels are in sRGB space.
+	 * @param mipmap If mipmaps will be generated.
+	 * @param filter The filter to generate mipmaps with.
+	 */
+	Ktx2Texture(const Bitmap &bitmap, BlockCompression::Format format, bool srgb = false, bool mipmap = true, Mipmaps::Filter filter = Mipmaps::Filter::Kaiser);
+
+	void Load(const std::filesystem::path &filename);
+	void Write(const std::filesystem::path &filename) const;
+
+	explicit operator bool() const noexcept { return !levels.empty(); }
+
+	BlockCompression::Format GetFormat() const { return format; }
+	bool IsSrgb() const { return srgb; }
+
+	/**
+	 * Gets the Vulkan format of the texels, as stored in the container.
+	 * @return The VkFormat value.
+	 */
+	uint32_t GetVkFormat() const;
+
+	const Vector2ui &GetSize() const { return levels.front().size; }
+	const std::vector<Level> &GetLevels() const { return levels; }
+
+private:
+	BlockCompression::Format format = BlockCompression::Format::RGBA8;
+	bool srgb = false;
+	std::vector<Level> levels;
+};
+}
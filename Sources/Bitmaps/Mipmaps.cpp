@@ -0,0 +1,162 @@
+#include "Mipmaps.hpp"
+
+#include "Maths/Maths.hpp"
+
+namespace acid {
+/// Radius of the Kaiser filter in destination texels.
+static constexpr float KAISER_RADIUS = 1.5f;
+static constexpr float KAISER_BETA = 4.0f;
+
+/**
+ * A source texel and its weight in a destination texel.
+ */
+class Contributor {
+public:
+	uint32_t index;
+	float weight;
+};
+
+static float BesselI0(float x) {
+	// Power series, converges quickly for the small arguments used by the window.
+	float sum = 1.0f;
+	float term = 1.0f;
+	for (uint32_t k = 1; k < 32 && term > sum * 1e-7f; k++) {
+		term *= (x * x) / (4.0f * static_cast<float>(k * k));
+		sum += term;
+	}
+	return sum;
+}
+
+static float Kaiser(float x) {
+	if (std::abs(x) >= KAISER_RADIUS)
+		return 0.0f;
+
+	auto sinc = x == 0.0f ? 1.0f : std::sin(Maths::PI<float> * x) / (Maths::PI<float> * x);
+	auto t = x / KAISER_RADIUS;
+	return sinc * BesselI0(KAISER_BETA * std::sqrt(1.0f - t * t)) / BesselI0(KAISER_BETA);
+}
+
+/**
+ * Finds the source texels that contribute to each destination texel along one axis.
+ * @param srcLength The number of source texels.
+ * @param dstLength The number of destination texels.
+ * @param filter The filter to weight texels with.
+ * @return The normalized contributors for each destination texel.
+ */
+static std::vector<std::vector<Contributor>> GetContributors(uint32_t srcLength, uint32_t dstLength, Mipmaps::Filter filter) {
+	std::vector<std::vector<Contributor>> contributors(dstLength);
+	auto scale = static_cast<float>(srcLength) / static_cast<float>(dstLength);
+
+	for (uint32_t i = 0; i < dstLength; i++) {
+		auto &texel = contributors[i];
+
+		if (filter == Mipmaps::Filter::Box) {
+			// Weights each source texel by how much of it the destination texel covers.
+			auto start = static_cast<float>(i) * scale;
+			auto end = start + scale;
+
+			for (auto j = static_cast<uint32_t>(start); j < std::min(srcLength, static_cast<uint32_t>(std::ceil(end))); j++) {
+				auto weight = std::min(end, static_cast<float>(j + 1)) - std::max(start, static_cast<float>(j));
+				if (weight > 0.0f)
+					texel.emplace_back(Contributor{j, weight});
+			}
+		} else {
+			auto filterScale = std::max(scale, 1.0f);
+			auto center = (static_cast<float>(i) + 0.5f) * scale;
+			auto first = static_cast<int32_t>(std::floor(center - KAISER_RADIUS * filterScale));
+			auto last = static_cast<int32_t>(std::ceil(center + KAISER_RADIUS * filterScale));
+
+			for (auto j = first; j <= last; j++) {
+				auto weight = Kaiser((static_cast<float>(j) + 0.5f - center) / filterScale);
+				if (weight == 0.0f)
+					continue;
+
+				// Texels past the edge are clamped, so their weight is given to the edge texel.
+				auto index = static_cast<uint32_t>(std::clamp(j, 0, static_cast<int32_t>(srcLength) - 1));
+				if (!texel.empty() && texel.back().index == index)
+					texel.back().weight += weight;
+				else
+					texel.emplace_back(Contributor{index, weight});
+			}
+		}
+
+		float total = 0.0f;
+		for (const auto &contributor : texel)
+			total += contributor.weight;
+		for (auto &contributor : texel)
+			contributor.weight /= total;
+	}
+
+	return contributors;
+}
+
+uint32_t Mipmaps::GetLevelCount(const Vector2ui &size) {
+	return static_cast<uint32_t>(std::floor(std::log2(std::max(std::max(size.x, size.y), 1u)))) + 1;
+}
+
+Vector2ui Mipmaps::GetLevelSize(const Vector2ui &size, uint32_t level) {
+	return {std::max(size.x >> level, 1u), std::max(size.y >> level, 1u)};
+}
+
+Bitmap Mipmaps::Downsample(const Bitmap &bitmap, const Vector2ui &size, Filter filter) {
+	auto srcSize = bitmap.GetSize();
+	auto bytesPerPixel = bitmap.GetBytesPerPixel();
+	auto src = bitmap.GetData().get();
+
+	auto columns = GetContributors(srcSize.x, size.x, filter);
+	auto rows = GetContributors(srcSize.y, size.y, filter);
+
+	// Filters horizontally into floats, then vertically. The vertical pass scales and adds whole rows, which vectorizes well.
+	auto rowLength = static_cast<std::size_t>(size.x) * bytesPerPixel;
+	std::vector<float> horizontal(rowLength * srcSize.y);
+
+	for (uint32_t y = 0; y < srcSize.y; y++) {
+		auto srcRow = src + static_cast<std::size_t>(y) * srcSize.x * bytesPerPixel;
+		auto dstRow = horizontal.data() + y * rowLength;
+
+		for (uint32_t x = 0; x < size.x; x++) {
+			auto dst = dstRow + x * bytesPerPixel;
+			for (const auto &contributor : columns[x]) {
+				auto texel = srcRow + contributor.index * bytesPerPixel;
+				for (uint32_t c = 0; c < bytesPerPixel; c++)
+					dst[c] += contributor.weight * static_cast<float>(texel[c]);
+			}
+		}
+	}
+
+	Bitmap result(size, bytesPerPixel);
+	auto dst = result.GetData().get();
+	std::vector<float> accumulator(rowLength);
+
+	for (uint32_t y = 0; y < size.y; y++) {
+		std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+
+		for (const auto &contributor : rows[y]) {
+			auto srcRow = horizontal.data() + contributor.index * rowLength;
+			auto weight = contributor.weight;
+			for (std::size_t i = 0; i < rowLength; i++)
+				accumulator[i] += weight * srcRow[i];
+		}
+
+		auto dstRow = dst + y * rowLength;
+		for (std::size_t i = 0; i < rowLength; i++)
+			dstRow[i] = static_cast<uint8_t>(std::clamp(accumulator[i] + 0.5f, 0.0f, 255.0f));
+	}
+
+	return result;
+}
+
+std::vector<Bitmap> Mipmaps::Generate(const Bitmap &bitmap, Filter filter, uint32_t levelCount) {
+	levelCount = std::clamp(levelCount, 1u, GetLevelCount(bitmap.GetSize()));
+
+	std::vector<Bitmap> levels;
+	levels.reserve(levelCount - 1);
+
+	for (uint32_t level = 1; level < levelCount; level++) {
+		const auto &previous = level == 1 ? bitmap : levels.back();
+		levels.emplace_back(Downsample(previous, GetLevelSize(bitmap.GetSize(), level), filter));
+	}
+
+	return levels;
+}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Bitmap.hpp"
+
+namespace acid {
+/**
+ * @brief Class that generates mipmap chains from bitmaps on the CPU.
+ * Levels are resampled with a separable filter, so non power of two sizes are handled without skipping texels.
+ */
+class ACID_EXPORT Mipmaps {
+public:
+	enum class Filter {
+		/// Averages the texels covered by each destination texel.
+		Box,
+		/// Kaiser windowed sinc, sharper than a box filter with less aliasing.
+		Kaiser
+	};
+
+	Mipmaps() = delete;
+
+	/**
+	 * Gets the number of levels in a full mipmap chain.
+	 * @param size The size of the first level.
+	 * @return The number of levels, down to and including 1x1.
+	 */
+	static uint32_t GetLevelCount(const Vector2ui &size);
+
+	/**
+	 * Gets the size of a level in a mipmap chain.
+	 * @param size The size of the first level.
+	 * @param level The level to get the size of.
+	 * @return The size of the level.
+	 */
+	static Vector2ui GetLevelSize(const Vector2ui &size, uint32_t level);
+
+	/**
+	 * Resamples a bitmap to a smaller size.
+	 * @param bitmap The bitmap to resample, with 8 bits per component.
+	 * @param size The size to resample to.
+	 * @param filter The filter to resample with.
+	 * @return The resampled bitmap, with the same bytes per pixel.
+	 */
+	static Bitmap Downsample(const Bitmap &bitmap, const Vector2ui &size, Filter filter = Filter::Box);
+
+	/**
+	 * Generates a mipmap chain from a bitmap, each level is resampled from the one before it.
+	 * @param bitmap The first level of the chain.
+	 * @param filter The filter to resample with.
+	 * @param levelCount The maximum number of levels to generate, including the first.
+	 * @return The levels after the first.
+	 */
+	static std::vector<Bitmap> Generate(const Bitmap &bitmap, Filter filter = Filter::Box, uint32_t levelCount = std::numeric_limits<uint32_t>::max());
+};
+}
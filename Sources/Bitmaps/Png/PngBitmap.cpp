@@ -1,37 +1,152 @@
 #include "PngBitmap.hpp"
 
 #include <cstring>
+#include <thread>
 
 #include <libspng/spng.h>
+#include <miniz/miniz.h>
 
 #include "Files/Files.hpp"
 #include "Maths/Time.hpp"
 
 namespace acid {
+static constexpr uint8_t PNG_SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+/// Rows below this count are not worth splitting across threads when encoding.
+static constexpr uint32_t MIN_ROWS_PER_JOB = 64;
+
+static int ReadStream(spng_ctx *, void *user, void *dest, size_t length) {
+	auto stream = static_cast<std::istream *>(user);
+	stream->read(static_cast<char *>(dest), static_cast<std::streamsize>(length));
+	return static_cast<std::size_t>(stream->gcount()) == length ? SPNG_OK : SPNG_IO_EOF;
+}
+
+static uint8_t PaethPredictor(uint8_t a, uint8_t b, uint8_t c) {
+	int32_t p = a + b - c;
+	auto pa = std::abs(p - a);
+	auto pb = std::abs(p - b);
+	auto pc = std::abs(p - c);
+	if (pa <= pb && pa <= pc)
+		return a;
+	if (pb <= pc)
+		return b;
+	return c;
+}
+
+/**
+ * Filters a row with each of the five PNG filters and keeps the one with the smallest sum of absolute differences.
+ * @param row The row to filter.
+ * @param prior The row above, or null for the first row.
+ * @param stride The bytes in a row.
+ * @param bytesPerPixel The bytes in a pixel.
+ * @param dst Where to write the filter type followed by the filtered row.
+ * @param scratch Space for stride bytes used to try filters.
+ */
+static void FilterRow(const uint8_t *row, const uint8_t *prior, std::size_t stride, uint32_t bytesPerPixel, uint8_t *dst, uint8_t *scratch) {
+	uint64_t bestSum = std::numeric_limits<uint64_t>::max();
+
+	for (uint8_t filter = 0; filter < 5; filter++) {
+		// The up, average and paeth filters need a prior row.
+		if (!prior && (filter == 2 || filter == 4))
+			continue;
+
+		auto out = filter == 0 ? dst + 1 : scratch;
+		uint64_t sum = 0;
+
+		for (std::size_t i = 0; i < stride; i++) {
+			uint8_t a = i >= bytesPerPixel ? row[i - bytesPerPixel] : 0;
+			uint8_t b = prior ? prior[i] : 0;
+			uint8_t c = prior && i >= bytesPerPixel ? prior[i - bytesPerPixel] : 0;
+			uint8_t predictor = 0;
+
+			switch (filter) {
+			case 1:
+				predictor = a;
+				break;
+			case 2:
+				predictor = b;
+				break;
+			case 3:
+				predictor = static_cast<uint8_t>((a + b) / 2);
+				break;
+			case 4:
+				predictor = PaethPredictor(a, b, c);
+				break;
+			}
+
+			out[i] = static_cast<uint8_t>(row[i] - predictor);
+			sum += static_cast<uint64_t>(std::abs(static_cast<int8_t>(out[i])));
+		}
+
+		if (sum < bestSum) {
+			bestSum = sum;
+			dst[0] = filter;
+			if (filter != 0)
+				std::memcpy(dst + 1, scratch, stride);
+		}
+	}
+}
+
+static void WriteUint32(std::vector<uint8_t> &png, uint32_t value) {
+	png.emplace_back(static_cast<uint8_t>(value >> 24));
+	png.emplace_back(static_cast<uint8_t>(value >> 16));
+	png.emplace_back(static_cast<uint8_t>(value >> 8));
+	png.emplace_back(static_cast<uint8_t>(value));
+}
+
+static void WriteChunk(std::vector<uint8_t> &png, const char type[4], const std::vector<uint8_t> &data) {
+	WriteUint32(png, static_cast<uint32_t>(data.size()));
+	auto typeOffset = png.size();
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data.begin(), data.end());
+	WriteUint32(png, static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, png.data() + typeOffset, png.size() - typeOffset)));
+}
+
 void PngBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
 #if defined(ACID_DEBUG)
 	auto debugStart = Time::Now();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	// The file is streamed into the decoder, files outside of the search path are read from the filesystem.
+	std::unique_ptr<std::istream> inStream;
+
+	if (Files::ExistsInPath(filename))
+		inStream = std::make_unique<IFStream>(filename);
+	else if (std::filesystem::exists(filename))
+		inStream = std::make_unique<std::ifstream>(filename, std::ios::binary);
 
-	if (!fileLoaded) {
+	if (!inStream) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
-	
-	/*uint8_t *buffer;
-	uint32_t width = 0, height = 0;
-	auto error = lodepng_decode_memory(&buffer, &width, &height, reinterpret_cast<const uint8_t *>(fileLoaded->data()), fileLoaded->length(), LCT_RGBA, 8);
-	if (buffer && !error) {
-		LodePNGColorMode color = {LCT_RGBA, 8};
-		auto buffersize = lodepng_get_raw_size(width, height, &color);
-		bitmap->SetData(std::make_unique<uint8_t[]>(buffersize));
-		std::memcpy(bitmap->GetData().get(), buffer, buffersize);
-		bitmap->SetSize({ width, height });
-		bitmap->SetBytesPerPixel(buffersize / (width * height));
-		free(buffer); // lodepng_free
-	}*/
+
+	std::unique_ptr<spng_ctx, decltype(&spng_ctx_free)> ctx(spng_ctx_new(0), spng_ctx_free);
+	spng_set_png_stream(ctx.get(), ReadStream, inStream.get());
+
+	// Always decodes to RGBA8, the same as the stb fallback.
+	spng_ihdr ihdr = {};
+	std::size_t length = 0;
+
+	if (auto error = spng_get_ihdr(ctx.get(), &ihdr); error != SPNG_OK) {
+		Log::Error("Bitmap could not be decoded: ", filename, ", ", spng_strerror(error), '\n');
+		return;
+	}
+
+	if (auto error = spng_decoded_image_size(ctx.get(), SPNG_FMT_RGBA8, &length); error != SPNG_OK) {
+		Log::Error("Bitmap could not be decoded: ", filename, ", ", spng_strerror(error), '\n');
+		return;
+	}
+
+	// Decodes directly into the bitmaps storage.
+	auto data = std::make_unique<uint8_t[]>(length);
+
+	if (auto error = spng_decode_image(ctx.get(), data.get(), length, SPNG_FMT_RGBA8, SPNG_DECODE_TRNS); error != SPNG_OK) {
+		Log::Error("Bitmap could not be decoded: ", filename, ", ", spng_strerror(error), '\n');
+		return;
+	}
+
+	bitmap->SetData(std::move(data));
+	bitmap->SetSize({ihdr.width, ihdr.height});
+	bitmap->SetBytesPerPixel(4);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
@@ -43,18 +158,116 @@ void PngBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 	auto debugStart = Time::Now();
 #endif
 
-	/*LodePNGColorType colorType = LCT_GREY;
-	if (bitmap->GetBytesPerPixel() == 4)
-		colorType = LCT_RGBA;
-	else if (bitmap->GetBytesPerPixel() == 3)
-		colorType = LCT_RGB;
-	else
-		Log::Error("Cannot write PNG with ", bitmap->GetBytesPerPixel(), " bytes per pixel\n");
+	auto png = Encode(*bitmap);
+
+	if (png.empty()) {
+		Log::Error("Bitmap could not be encoded: ", filename, '\n');
+		return;
+	}
 
-	lodepng::encode(filename.string(), bitmap->GetData().get(), bitmap->GetSize().x, bitmap->GetSize().y, colorType);*/
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
 #endif
 }
+
+std::vector<uint8_t> PngBitmap::Encode(const Bitmap &bitmap, uint32_t threadCount) {
+	static constexpr uint8_t COLOUR_TYPES[] = {0, 0, 4, 2, 6};
+
+	auto bytesPerPixel = bitmap.GetBytesPerPixel();
+	auto size = bitmap.GetSize();
+
+	if (!bitmap.GetData() || bytesPerPixel < 1 || bytesPerPixel > 4 || size.x == 0 || size.y == 0)
+		return {};
+
+	auto stride = static_cast<std::size_t>(size.x) * bytesPerPixel;
+	auto pixels = bitmap.GetData().get();
+
+	// Rows are split into jobs that are filtered and deflated independently, each job ends on a byte aligned sync flush
+	// so the compressed jobs can be joined into one zlib stream.
+	auto jobCount = std::clamp(size.y / MIN_ROWS_PER_JOB, 1u, std::max(threadCount, 1u));
+	auto rowsPerJob = (size.y + jobCount - 1) / jobCount;
+	std::vector<std::vector<uint8_t>> filtered(jobCount);
+	std::vector<std::vector<uint8_t>> compressed(jobCount);
+	std::vector<bool> failed(jobCount);
+
+	auto encodeJob = [&](uint32_t job) {
+		auto firstRow = job * rowsPerJob;
+		auto lastRow = std::min(firstRow + rowsPerJob, size.y);
+
+		auto &jobFiltered = filtered[job];
+		jobFiltered.resize((lastRow - firstRow) * (stride + 1));
+		std::vector<uint8_t> scratch(stride);
+
+		for (auto y = firstRow; y < lastRow; y++) {
+			auto row = pixels + y * stride;
+			FilterRow(row, y > 0 ? row - stride : nullptr, stride, bytesPerPixel, jobFiltered.data() + (y - firstRow) * (stride + 1), scratch.data());
+		}
+
+		mz_stream stream = {};
+		if (mz_deflateInit2(&stream, MZ_DEFAULT_LEVEL, MZ_DEFLATED, -MZ_DEFAULT_WINDOW_BITS, 9, MZ_DEFAULT_STRATEGY) != MZ_OK) {
+			failed[job] = true;
+			return;
+		}
+
+		auto &jobCompressed = compressed[job];
+		// A sync flush adds a few bytes past the deflate bound.
+		jobCompressed.resize(mz_deflateBound(&stream, static_cast<mz_ulong>(jobFiltered.size())) + 16);
+		stream.next_in = jobFiltered.data();
+		stream.avail_in = static_cast<uint32_t>(jobFiltered.size());
+		stream.next_out = jobCompressed.data();
+		stream.avail_out = static_cast<uint32_t>(jobCompressed.size());
+
+		auto result = mz_deflate(&stream, job + 1 == jobCount ? MZ_FINISH : MZ_SYNC_FLUSH);
+		failed[job] = job + 1 == jobCount ? result != MZ_STREAM_END : result != MZ_OK;
+		jobCompressed.resize(stream.total_out);
+		mz_deflateEnd(&stream);
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(jobCount - 1);
+
+	for (uint32_t job = 1; job < jobCount; job++)
+		workers.emplace_back(encodeJob, job);
+
+	encodeJob(0);
+
+	for (auto &worker : workers)
+		worker.join();
+
+	if (std::find(failed.begin(), failed.end(), true) != failed.end())
+		return {};
+
+	// The adler checksum covers the filtered data in order, it is far cheaper than deflate so is run after the jobs.
+	auto adler = mz_adler32(MZ_ADLER32_INIT, nullptr, 0);
+	std::size_t compressedSize = 0;
+
+	for (uint32_t job = 0; job < jobCount; job++) {
+		adler = mz_adler32(adler, filtered[job].data(), filtered[job].size());
+		compressedSize += compressed[job].size();
+	}
+
+	std::vector<uint8_t> ihdr;
+	WriteUint32(ihdr, size.x);
+	WriteUint32(ihdr, size.y);
+	ihdr.insert(ihdr.end(), {8, COLOUR_TYPES[bytesPerPixel], 0, 0, 0});
+
+	// zlib header for a 32K window and default compression.
+	std::vector<uint8_t> idat = {0x78, 0x9C};
+	idat.reserve(compressedSize + 6);
+
+	for (const auto &jobCompressed : compressed)
+		idat.insert(idat.end(), jobCompressed.begin(), jobCompressed.end());
+
+	WriteUint32(idat, static_cast<uint32_t>(adler));
+
+	std::vector<uint8_t> png(std::begin(PNG_SIGNATURE), std::end(PNG_SIGNATURE));
+	png.reserve(idat.size() + 64);
+	WriteChunk(png, "IHDR", ihdr);
+	WriteChunk(png, "IDAT", idat);
+	WriteChunk(png, "IEND", {});
+	return png;
+}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <thread>
+
 #include "Bitmaps/Bitmap.hpp"
 
 namespace acid {
@@ -8,5 +10,13 @@ class ACID_EXPORT PngBitmap : public Bitmap::Registrar<PngBitmap> {
 public:
 	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
 	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
+
+	/**
+	 * Encodes a bitmap into a PNG file in memory, rows are filtered and compressed in parallel.
+	 * @param bitmap The bitmap to encode, with 1 to 4 bytes per pixel.
+	 * @param threadCount The maximum number of threads to encode with.
+	 * @return The PNG file, empty if the bitmap could not be encoded.
+	 */
+	static std::vector<uint8_t> Encode(const Bitmap &bitmap, uint32_t threadCount = std::thread::hardware_concurrency());
 };
 }
@@ -19,11 +19,16 @@ set(_temp_acid_headers
 		Audio/Opus/OpusSoundBuffer.hpp
 		Audio/Sound.hpp
 		Audio/SoundBuffer.hpp
+		Audio/SoundDecoder.hpp
+		Audio/SoundStream.hpp
 		Audio/Wave/WaveSoundBuffer.hpp
 		Bitmaps/Bitmap.hpp
+		Bitmaps/BlockCompression.hpp
 		Bitmaps/Dng/DngBitmap.hpp
 		Bitmaps/Exr/ExrBitmap.hpp
 		Bitmaps/Jpg/JpgBitmap.hpp
+		Bitmaps/Ktx2/Ktx2Texture.hpp
+		Bitmaps/Mipmaps.hpp
 		Bitmaps/Png/PngBitmap.hpp
 		Devices/Instance.hpp
 		Devices/Joysticks.hpp
@@ -62,6 +67,7 @@ set(_temp_acid_headers
 		Graphics/Buffers/Buffer.hpp
 		Graphics/Buffers/InstanceBuffer.hpp
 		Graphics/Buffers/PushHandler.hpp
+		Graphics/Buffers/StagingBuffer.hpp
 		Graphics/Buffers/StorageBuffer.hpp
 		Graphics/Buffers/StorageHandler.hpp
 		Graphics/Buffers/UniformBuffer.hpp
@@ -107,6 +113,7 @@ set(_temp_acid_headers
 		Inputs/InputScheme.hpp
 		Lights/Fog.hpp
 		Lights/Light.hpp
+		Lights/LightClusters.hpp
 		Materials/DefaultMaterial.hpp
 		Materials/Material.hpp
 		Materials/MaterialPipeline.hpp
@@ -141,20 +148,31 @@ set(_temp_acid_headers
 		Models/Shapes/SphereModel.hpp
 		Models/Vertex2d.hpp
 		Models/Vertex3d.hpp
+		Network/BitStream.hpp
 		Network/Ftp/Ftp.hpp
 		Network/Ftp/FtpDataChannel.hpp
 		Network/Ftp/FtpResponse.hpp
 		Network/Ftp/FtpResponseDirectory.hpp
 		Network/Ftp/FtpResponseListing.hpp
+		Network/Ftp/FtpTransfer.hpp
 		Network/Http/Http.hpp
 		Network/Http/HttpRequest.hpp
 		Network/Http/HttpResponse.hpp
 		Network/IpAddress.hpp
+		Network/LatencyHistogram.hpp
+		Network/NetworkMetrics.hpp
 		Network/Packet.hpp
+		Network/PacketPool.hpp
+		Network/Reactor.hpp
+		Network/Replication/EntitySnapshot.hpp
+		Network/Replication/ReplicationClient.hpp
+		Network/Replication/ReplicationServer.hpp
 		Network/Socket.hpp
+		Network/SocketMetrics.hpp
 		Network/SocketSelector.hpp
 		Network/Tcp/TcpListener.hpp
 		Network/Tcp/TcpSocket.hpp
+		Network/Udp/UdpConnection.hpp
 		Network/Udp/UdpSocket.hpp
 		Particles/Emitters/CircleEmitter.hpp
 		Particles/Emitters/Emitter.hpp
@@ -173,13 +191,18 @@ set(_temp_acid_headers
 		Physics/Colliders/CubeCollider.hpp
 		Physics/Colliders/CylinderCollider.hpp
 		Physics/Colliders/HeightfieldCollider.hpp
+		Physics/Colliders/MeshCollider.hpp
 		Physics/Colliders/SphereCollider.hpp
+		Physics/CollisionCache.hpp
 		Physics/CollisionObject.hpp
+		Physics/ContactPairTable.hpp
 		Physics/Force.hpp
 		Physics/Frustum.hpp
+		Physics/HeightTileFile.hpp
 		Physics/KinematicCharacter.hpp
 		Physics/Ray.hpp
 		Physics/Rigidbody.hpp
+		Physics/TiledHeightfield.hpp
 		Post/Deferred/DeferredSubrender.hpp
 		Post/Filters/BlitFilter.hpp
 		Post/Filters/BlurFilter.hpp
@@ -214,6 +237,7 @@ set(_temp_acid_headers
 		Scenes/Scenes.hpp
 		Scenes/SceneStructure.hpp
 		Shadows/ShadowBox.hpp
+		Shadows/ShadowCascades.hpp
 		Shadows/ShadowRender.hpp
 		Shadows/Shadows.hpp
 		Shadows/ShadowsSubrender.hpp
@@ -252,6 +276,7 @@ set(_temp_acid_headers
 		Utils/Enumerate.hpp
 		Utils/Factory.hpp
 		Utils/Future.hpp
+		Utils/LockFreeQueue.hpp
 		Utils/NonCopyable.hpp
 		Utils/RingBuffer.hpp
 		Utils/StreamFactory.hpp
@@ -300,11 +325,16 @@ set(_temp_acid_sources
 		Audio/Opus/OpusSoundBuffer.cpp
 		Audio/Sound.cpp
 		Audio/SoundBuffer.cpp
+		Audio/SoundDecoder.cpp
+		Audio/SoundStream.cpp
 		Audio/Wave/WaveSoundBuffer.cpp
 		Bitmaps/Bitmap.cpp
+		Bitmaps/BlockCompression.cpp
 		Bitmaps/Dng/DngBitmap.cpp
 		Bitmaps/Exr/ExrBitmap.cpp
 		Bitmaps/Jpg/JpgBitmap.cpp
+		Bitmaps/Ktx2/Ktx2Texture.cpp
+		Bitmaps/Mipmaps.cpp
 		Bitmaps/Png/PngBitmap.cpp
 		Devices/Instance.cpp
 		Devices/Joysticks.cpp
@@ -337,6 +367,7 @@ set(_temp_acid_sources
 		Graphics/Buffers/Buffer.cpp
 		Graphics/Buffers/InstanceBuffer.cpp
 		Graphics/Buffers/PushHandler.cpp
+		Graphics/Buffers/StagingBuffer.cpp
 		Graphics/Buffers/StorageBuffer.cpp
 		Graphics/Buffers/StorageHandler.cpp
 		Graphics/Buffers/UniformBuffer.cpp
@@ -376,6 +407,7 @@ set(_temp_acid_sources
 		Inputs/InputScheme.cpp
 		Lights/Fog.cpp
 		Lights/Light.cpp
+		Lights/LightClusters.cpp
 		Materials/DefaultMaterial.cpp
 		Materials/MaterialPipeline.cpp
 		Maths/Colour.cpp
@@ -401,20 +433,31 @@ set(_temp_acid_sources
 		Models/Shapes/RectangleModel.cpp
 		Models/Shapes/SimpleMesh.cpp
 		Models/Shapes/SphereModel.cpp
+		Network/BitStream.cpp
 		Network/Ftp/Ftp.cpp
 		Network/Ftp/FtpDataChannel.cpp
 		Network/Ftp/FtpResponse.cpp
 		Network/Ftp/FtpResponseDirectory.cpp
 		Network/Ftp/FtpResponseListing.cpp
+		Network/Ftp/FtpTransfer.cpp
 		Network/Http/Http.cpp
 		Network/Http/HttpRequest.cpp
 		Network/Http/HttpResponse.cpp
 		Network/IpAddress.cpp
+		Network/LatencyHistogram.cpp
+		Network/NetworkMetrics.cpp
 		Network/Packet.cpp
+		Network/PacketPool.cpp
+		Network/Reactor.cpp
+		Network/Replication/EntitySnapshot.cpp
+		Network/Replication/ReplicationClient.cpp
+		Network/Replication/ReplicationServer.cpp
 		Network/Socket.cpp
+		Network/SocketMetrics.cpp
 		Network/SocketSelector.cpp
 		Network/Tcp/TcpListener.cpp
 		Network/Tcp/TcpSocket.cpp
+		Network/Udp/UdpConnection.cpp
 		Network/Udp/UdpSocket.cpp
 		Particles/Emitters/CircleEmitter.cpp
 		Particles/Emitters/LineEmitter.cpp
@@ -432,13 +475,17 @@ set(_temp_acid_sources
 		Physics/Colliders/CubeCollider.cpp
 		Physics/Colliders/CylinderCollider.cpp
 		Physics/Colliders/HeightfieldCollider.cpp
+		Physics/Colliders/MeshCollider.cpp
 		Physics/Colliders/SphereCollider.cpp
+		Physics/CollisionCache.cpp
 		Physics/CollisionObject.cpp
 		Physics/Force.cpp
 		Physics/Frustum.cpp
+		Physics/HeightTileFile.cpp
 		Physics/KinematicCharacter.cpp
 		Physics/Ray.cpp
 		Physics/Rigidbody.cpp
+		Physics/TiledHeightfield.cpp
 		Post/Deferred/DeferredSubrender.cpp
 		Post/Filters/BlitFilter.cpp
 		Post/Filters/BlurFilter.cpp
@@ -468,6 +515,7 @@ set(_temp_acid_sources
 		Scenes/Scenes.cpp
 		Scenes/SceneStructure.cpp
 		Shadows/ShadowBox.cpp
+		Shadows/ShadowCascades.cpp
 		Shadows/ShadowRender.cpp
 		Shadows/Shadows.cpp
 		Shadows/ShadowsSubrender.cpp
@@ -44,8 +44,7 @@ void GizmoType::Update(const std::vector<std::unique_ptr<Gizmo>> &gizmos) {
 	if (gizmos.empty())
 		return;
 
-	Instance *instances;
-	instanceBuffer.MapMemory(reinterpret_cast<void **>(&instances));
+	auto instances = static_cast<Instance *>(instanceBuffer.GetMapped());
 
 	for (const auto &gizmo : gizmos) {
 		if (this->instances >= maxInstances)
@@ -60,8 +59,6 @@ void GizmoType::Update(const std::vector<std::unique_ptr<Gizmo>> &gizmos) {
 		instance->colour = gizmo->colour;
 		this->instances++;
 	}
-
-	instanceBuffer.UnmapMemory();
 }
 
 bool GizmoType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene) {
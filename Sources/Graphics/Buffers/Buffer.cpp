@@ -6,7 +6,8 @@
 
 namespace acid {
 Buffer::Buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, const void *data) :
-	size(size) {
+	size(size),
+	usage(usage) {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
 	auto graphicsFamily = logicalDevice->GetGraphicsFamily();
@@ -61,6 +62,12 @@ Buffer::Buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlag
 Buffer::~Buffer() {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
+	// Staged copies into the buffer may not have been submitted or completed yet.
+	if (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) {
+		if (auto stagingBuffer = Graphics::Get()->FindStagingBuffer())
+			stagingBuffer->WaitForBufferCopies(buffer);
+	}
+
 	vkDestroyBuffer(*logicalDevice, buffer, nullptr);
 	vkFreeMemory(*logicalDevice, bufferMemory, nullptr);
 }
@@ -27,6 +27,7 @@ public:
 	void UnmapMemory() const;
 
 	VkDeviceSize GetSize() const { return size; }
+	VkBufferUsageFlags GetUsage() const { return usage; }
 	const VkBuffer &GetBuffer() const { return buffer; }
 	const VkDeviceMemory &GetBufferMemory() const { return bufferMemory; }
 
@@ -37,6 +38,7 @@ public:
 
 protected:
 	VkDeviceSize size;
+	VkBufferUsageFlags usage;
 	VkBuffer buffer = VK_NULL_HANDLE;
 	VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
 };
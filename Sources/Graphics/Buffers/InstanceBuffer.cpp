@@ -6,13 +6,15 @@
 
 namespace acid {
 InstanceBuffer::InstanceBuffer(VkDeviceSize size) :
-	Buffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+	Buffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+	MapMemory(&mapped);
 }
 
-void InstanceBuffer::Update(const CommandBuffer &commandBuffer, const void *newData) {
-	void *data;
-	MapMemory(&data);
-	std::memcpy(data, newData, static_cast<std::size_t>(size));
+InstanceBuffer::~InstanceBuffer() {
 	UnmapMemory();
 }
+
+void InstanceBuffer::Update(const CommandBuffer &commandBuffer, const void *newData) {
+	std::memcpy(mapped, newData, static_cast<std::size_t>(size));
+}
 }
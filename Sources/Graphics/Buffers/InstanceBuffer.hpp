@@ -3,10 +3,24 @@
 #include "Buffer.hpp"
 
 namespace acid {
+/**
+ * @brief Host visible vertex buffer for per instance data, it stays mapped so updates are a single copy.
+ */
 class ACID_EXPORT InstanceBuffer : public Buffer {
 public:
 	explicit InstanceBuffer(VkDeviceSize size);
 
+	~InstanceBuffer();
+
 	void Update(const CommandBuffer &commandBuffer, const void *newData);
+
+	/**
+	 * Gets the memory the buffer stays mapped to, instances can be written to it directly.
+	 * @return The mapped memory.
+	 */
+	void *GetMapped() const { return mapped; }
+
+private:
+	void *mapped = nullptr;
 };
 }
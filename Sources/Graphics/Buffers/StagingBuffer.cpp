@@ -0,0 +1,229 @@
+#include "StagingBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Images/Image.hpp"
+
+namespace acid {
+StagingBuffer::StagingBuffer(VkDeviceSize size) :
+	Buffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+	alignment(std::max<VkDeviceSize>(16, Graphics::Get()->GetPhysicalDevice()->GetProperties().limits.optimalBufferCopyOffsetAlignment)),
+	commandPool(std::make_shared<CommandPool>()) {
+	MapMemory(&mapped);
+}
+
+StagingBuffer::~StagingBuffer() {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	WaitIdle();
+
+	for (auto &[commandBuffer, fence] : freeSubmits)
+		vkDestroyFence(*logicalDevice, fence, nullptr);
+
+	freeSubmits.clear();
+	UnmapMemory();
+}
+
+void StagingBuffer::CopyToBuffer(const void *data, VkDeviceSize size, const VkBuffer &dstBuffer, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask,
+	VkDeviceSize dstOffset) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto [srcBuffer, srcOffset] = Stage(data, size);
+	auto &region = GetRecordingRegion();
+	region.dstBuffers.emplace_back(dstBuffer);
+
+	VkBufferCopy copyRegion = {};
+	copyRegion.srcOffset = srcOffset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(*region.commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+
+	// Barriers in this batch also apply to later submissions, so the buffer is visible to any frame submitted after it.
+	InsertBufferMemoryBarrier(*region.commandBuffer, dstBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, dstAccessMask, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask,
+		dstOffset, size);
+}
+
+void StagingBuffer::CopyToImage(const void *data, VkDeviceSize size, const VkImage &dstImage, const VkExtent3D &extent, uint32_t mipLevels, uint32_t layerCount,
+	uint32_t baseArrayLayer, VkImageLayout dstImageLayout, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask) {
+	VkBufferImageCopy copyRegion = {};
+	copyRegion.bufferOffset = 0;
+	copyRegion.bufferRowLength = 0;
+	copyRegion.bufferImageHeight = 0;
+	copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	copyRegion.imageSubresource.mipLevel = 0;
+	copyRegion.imageSubresource.baseArrayLayer = baseArrayLayer;
+	copyRegion.imageSubresource.layerCount = layerCount;
+	copyRegion.imageOffset = {0, 0, 0};
+	copyRegion.imageExtent = extent;
+	CopyToImage(data, size, dstImage, {copyRegion}, mipLevels, layerCount, baseArrayLayer, dstImageLayout, dstStageMask, dstAccessMask);
+}
+
+void StagingBuffer::CopyToImage(const void *data, VkDeviceSize size, const VkImage &dstImage, const std::vector<VkBufferImageCopy> &copyRegions,
+	uint32_t mipLevels, uint32_t layerCount, uint32_t baseArrayLayer, VkImageLayout dstImageLayout, VkPipelineStageFlags dstStageMask,
+	VkAccessFlags dstAccessMask) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto [srcBuffer, srcOffset] = Stage(data, size);
+	auto &region = GetRecordingRegion();
+	region.dstImages.emplace_back(dstImage);
+
+	Image::InsertImageMemoryBarrier(*region.commandBuffer, dstImage, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0,
+		layerCount, baseArrayLayer);
+
+	auto stagedRegions = copyRegions;
+	for (auto &copyRegion : stagedRegions)
+		copyRegion.bufferOffset += srcOffset;
+	vkCmdCopyBufferToImage(*region.commandBuffer, srcBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(stagedRegions.size()),
+		stagedRegions.data());
+
+	// The barrier is needed even when the layout is unchanged, so the copy is visible to the stages that use the image.
+	Image::InsertImageMemoryBarrier(*region.commandBuffer, dstImage, VK_ACCESS_TRANSFER_WRITE_BIT, dstAccessMask, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		dstImageLayout, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, layerCount, baseArrayLayer);
+}
+
+void StagingBuffer::Submit() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (recording)
+		SubmitRecording();
+
+	// Frees up regions of the ring that have already been copied from.
+	while (!regions.empty() && vkGetFenceStatus(*logicalDevice, regions.front().fence) == VK_SUCCESS)
+		RetireRegion();
+}
+
+void StagingBuffer::WaitIdle() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (recording)
+		SubmitRecording();
+
+	while (!regions.empty())
+		RetireRegion();
+}
+
+void StagingBuffer::WaitForBufferCopies(const VkBuffer &dstBuffer) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// The newest batch copying into the buffer is waited on, which also waits on every batch before it.
+	for (auto i = regions.size(); i-- > 0;) {
+		if (std::find(regions[i].dstBuffers.begin(), regions[i].dstBuffers.end(), dstBuffer) != regions[i].dstBuffers.end()) {
+			RetireRegions(i + 1);
+			return;
+		}
+	}
+}
+
+void StagingBuffer::WaitForImageCopies(const VkImage &dstImage) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for (auto i = regions.size(); i-- > 0;) {
+		if (std::find(regions[i].dstImages.begin(), regions[i].dstImages.end(), dstImage) != regions[i].dstImages.end()) {
+			RetireRegions(i + 1);
+			return;
+		}
+	}
+}
+
+std::pair<VkBuffer, VkDeviceSize> StagingBuffer::Stage(const void *data, VkDeviceSize dataSize) {
+	// Uploads larger than the whole ring get a temporary buffer that lives as long as the batch.
+	if (dataSize > size) {
+		auto &region = GetRecordingRegion();
+		auto &overflowBuffer = region.overflowBuffers.emplace_back(std::make_unique<Buffer>(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, data));
+		return {overflowBuffer->GetBuffer(), 0};
+	}
+
+	while (true) {
+		if (used == 0)
+			head = 0;
+
+		auto offset = (head + alignment - 1) / alignment * alignment;
+		auto tail = (head + size - used) % size;
+		std::optional<VkDeviceSize> allocation;
+
+		if (used == 0 || tail < head) {
+			// Used bytes are contiguous, the free space is after the head or wraps around to before the tail.
+			if (offset + dataSize <= size)
+				allocation = offset;
+			else if (dataSize <= tail)
+				allocation = 0;
+		} else if (offset + dataSize <= tail) {
+			// Used bytes wrap around the end, the free space is between the head and the tail.
+			allocation = offset;
+		}
+
+		if (allocation) {
+			auto consumed = *allocation + dataSize + (*allocation < head ? size : 0) - head;
+			used += consumed;
+			head = *allocation + dataSize;
+			GetRecordingRegion().used += consumed;
+
+			std::memcpy(static_cast<char *>(mapped) + *allocation, data, static_cast<std::size_t>(dataSize));
+			return {buffer, *allocation};
+		}
+
+		// The ring is full, wait for the oldest batch to finish reading from it.
+		if (recording && regions.size() == 1)
+			SubmitRecording();
+
+		RetireRegion();
+	}
+}
+
+StagingBuffer::Region &StagingBuffer::GetRecordingRegion() {
+	if (recording)
+		return regions.back();
+
+	auto &region = regions.emplace_back();
+
+	if (!freeSubmits.empty()) {
+		region.commandBuffer = std::move(freeSubmits.back().first);
+		region.fence = freeSubmits.back().second;
+		freeSubmits.pop_back();
+	} else {
+		auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+		VkFenceCreateInfo fenceCreateInfo = {};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		Graphics::CheckVk(vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &region.fence));
+
+		region.commandBuffer = std::make_unique<CommandBuffer>(commandPool, false);
+	}
+
+	region.commandBuffer->Begin();
+	recording = true;
+	return region;
+}
+
+void StagingBuffer::SubmitRecording() {
+	regions.back().commandBuffer->Submit(VK_NULL_HANDLE, VK_NULL_HANDLE, regions.back().fence);
+	recording = false;
+}
+
+void StagingBuffer::RetireRegion() {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto &region = regions.front();
+
+	Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &region.fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+
+	used -= region.used;
+	freeSubmits.emplace_back(std::move(region.commandBuffer), region.fence);
+	regions.pop_front();
+}
+
+void StagingBuffer::RetireRegions(std::size_t count) {
+	if (recording && count == regions.size())
+		SubmitRecording();
+
+	for (std::size_t i = 0; i < count; i++)
+		RetireRegion();
+}
+}
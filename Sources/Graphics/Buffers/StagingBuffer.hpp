@@ -0,0 +1,142 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "Graphics/Commands/CommandBuffer.hpp"
+#include "Buffer.hpp"
+
+namespace acid {
+/**
+ * @brief Persistently mapped host visible buffer that uploads are staged through as a ring.
+ * Copies are recorded into a single batch that is submitted without waiting, either explicitly or before the next frame is submitted.
+ * Each submitted batch holds a fence so its region of the ring is only reused once the device has finished reading from it.
+ */
+class ACID_EXPORT StagingBuffer : public Buffer {
+public:
+	/**
+	 * Creates a new staging ring buffer.
+	 * @param size Size of the ring in bytes, uploads larger than this are staged through a temporary buffer.
+	 */
+	explicit StagingBuffer(VkDeviceSize size = 32 * 1024 * 1024);
+
+	~StagingBuffer();
+
+	/**
+	 * Stages data and records a copy into a buffer, {@link StagingBuffer#Submit} must be called before the buffer is used outside of a frame.
+	 * @param data The data to upload.
+	 * @param size The size of the data in bytes.
+	 * @param dstBuffer The buffer to copy into.
+	 * @param dstStageMask The pipeline stages that will read the buffer after the copy.
+	 * @param dstAccessMask The types of access those stages will make to the buffer.
+	 * @param dstOffset The offset into the buffer to copy to.
+	 */
+	void CopyToBuffer(const void *data, VkDeviceSize size, const VkBuffer &dstBuffer, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask,
+		VkDeviceSize dstOffset = 0);
+
+	/**
+	 * Stages pixels and records a copy into the first mip level of an image, {@link StagingBuffer#Submit} must be called before the image is used outside of a frame.
+	 * The image is transitioned from a undefined layout, so any previous contents are discarded.
+	 * @param data The pixels to upload, tightly packed layer after layer.
+	 * @param size The size of the pixels in bytes.
+	 * @param dstImage The image to copy into.
+	 * @param extent The extent of the first mip level.
+	 * @param mipLevels The number of mip levels in the image, all are transitioned.
+	 * @param layerCount The number of array layers to copy.
+	 * @param baseArrayLayer The first array layer to copy.
+	 * @param dstImageLayout The layout the image will be in after the copy.
+	 * @param dstStageMask The pipeline stages that will use the image after the copy.
+	 * @param dstAccessMask The types of access those stages will make to the image.
+	 */
+	void CopyToImage(const void *data, VkDeviceSize size, const VkImage &dstImage, const VkExtent3D &extent, uint32_t mipLevels, uint32_t layerCount,
+		uint32_t baseArrayLayer, VkImageLayout dstImageLayout, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask);
+
+	/**
+	 * Stages pixels and records copies into several regions of an image, {@link StagingBuffer#Submit} must be called before the image is used outside of a frame.
+	 * This is used to upload prebuilt mip levels, the image is transitioned from a undefined layout so any previous contents are discarded.
+	 * @param data The pixels to upload.
+	 * @param size The size of the pixels in bytes.
+	 * @param dstImage The image to copy into.
+	 * @param copyRegions The regions to copy, buffer offsets are relative to the start of the data.
+	 * @param mipLevels The number of mip levels in the image, all are transitioned.
+	 * @param layerCount The number of array layers to transition.
+	 * @param baseArrayLayer The first array layer to transition.
+	 * @param dstImageLayout The layout the image will be in after the copy.
+	 * @param dstStageMask The pipeline stages that will use the image after the copy.
+	 * @param dstAccessMask The types of access those stages will make to the image.
+	 */
+	void CopyToImage(const void *data, VkDeviceSize size, const VkImage &dstImage, const std::vector<VkBufferImageCopy> &copyRegions, uint32_t mipLevels,
+		uint32_t layerCount, uint32_t baseArrayLayer, VkImageLayout dstImageLayout, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask);
+
+	/**
+	 * Submits all copies recorded since the last submit as a single batch, this does not wait for the copies to complete.
+	 */
+	void Submit();
+
+	/**
+	 * Submits any recorded copies and holds the current thread idle until all copies have completed.
+	 */
+	void WaitIdle();
+
+	/**
+	 * Holds the current thread idle until every copy recorded into a buffer has completed, buffers call this before they are destroyed.
+	 * @param dstBuffer The buffer that may have been copied into.
+	 */
+	void WaitForBufferCopies(const VkBuffer &dstBuffer);
+
+	/**
+	 * Holds the current thread idle until every copy recorded into an image has completed, images call this before they are destroyed.
+	 * @param dstImage The image that may have been copied into.
+	 */
+	void WaitForImageCopies(const VkImage &dstImage);
+
+private:
+	/**
+	 * A batch of copies and the bytes of the ring it reads from.
+	 */
+	class Region {
+	public:
+		std::unique_ptr<CommandBuffer> commandBuffer;
+		VkFence fence = VK_NULL_HANDLE;
+		/// Bytes of the ring used by this batch, including alignment padding.
+		VkDeviceSize used = 0;
+		/// Temporary staging buffers for uploads that don't fit in the ring.
+		std::vector<std::unique_ptr<Buffer>> overflowBuffers;
+		/// Buffers and images copied into by this batch, they must not be destroyed until it completes.
+		std::vector<VkBuffer> dstBuffers;
+		std::vector<VkImage> dstImages;
+	};
+
+	/**
+	 * Copies data into the ring, waiting for older batches to complete if the ring is full.
+	 * @param data The data to stage.
+	 * @param dataSize The size of the data in bytes.
+	 * @return The buffer and offset the data was staged at.
+	 */
+	std::pair<VkBuffer, VkDeviceSize> Stage(const void *data, VkDeviceSize dataSize);
+	Region &GetRecordingRegion();
+	void SubmitRecording();
+	void RetireRegion();
+	/**
+	 * Submits the recording region if it is one of the regions, then waits for the oldest regions to complete.
+	 * @param count The number of regions to retire, from the oldest.
+	 */
+	void RetireRegions(std::size_t count);
+
+	std::mutex mutex;
+	void *mapped = nullptr;
+	VkDeviceSize alignment;
+	/// Offset that the next upload will be written at.
+	VkDeviceSize head = 0;
+	/// Bytes of the ring used by all regions, the oldest used byte is this far behind the head.
+	VkDeviceSize used = 0;
+	/// Regions that are being read by the device, in submission order. The last is still recording when recording is true.
+	std::deque<Region> regions;
+	bool recording = false;
+
+	/// Uploads are recorded from any thread, so they are allocated from a pool owned by this buffer.
+	std::shared_ptr<CommandPool> commandPool;
+	/// Retired command buffers and fences that can be reused.
+	std::vector<std::pair<std::unique_ptr<CommandBuffer>, VkFence>> freeSubmits;
+};
+}
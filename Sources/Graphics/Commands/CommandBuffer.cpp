@@ -4,13 +4,17 @@
 
 namespace acid {
 CommandBuffer::CommandBuffer(bool begin, VkQueueFlagBits queueType, VkCommandBufferLevel bufferLevel) :
-	commandPool(Graphics::Get()->GetCommandPool()),
+	CommandBuffer(Graphics::Get()->GetCommandPool(), begin, queueType, bufferLevel) {
+}
+
+CommandBuffer::CommandBuffer(std::shared_ptr<CommandPool> commandPool, bool begin, VkQueueFlagBits queueType, VkCommandBufferLevel bufferLevel) :
+	commandPool(std::move(commandPool)),
 	queueType(queueType) {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
 	VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
 	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	commandBufferAllocateInfo.commandPool = *commandPool;
+	commandBufferAllocateInfo.commandPool = *this->commandPool;
 	commandBufferAllocateInfo.level = bufferLevel;
 	commandBufferAllocateInfo.commandBufferCount = 1;
 	Graphics::CheckVk(vkAllocateCommandBuffers(*logicalDevice, &commandBufferAllocateInfo, &commandBuffer));
@@ -25,13 +29,14 @@ CommandBuffer::~CommandBuffer() {
 	vkFreeCommandBuffers(*logicalDevice, commandPool->GetCommandPool(), 1, &commandBuffer);
 }
 
-void CommandBuffer::Begin(VkCommandBufferUsageFlags usage) {
+void CommandBuffer::Begin(VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo *inheritanceInfo) {
 	if (running)
 		return;
 
 	VkCommandBufferBeginInfo beginInfo = {};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = usage;
+	beginInfo.pInheritanceInfo = inheritanceInfo;
 	Graphics::CheckVk(vkBeginCommandBuffer(commandBuffer, &beginInfo));
 	running = true;
 }
@@ -16,13 +16,24 @@ public:
 	 */
 	explicit CommandBuffer(bool begin = true, VkQueueFlagBits queueType = VK_QUEUE_GRAPHICS_BIT, VkCommandBufferLevel bufferLevel = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
+	/**
+	 * Creates a new command buffer from a command pool that is not owned by the current thread.
+	 * @param commandPool The command pool to allocate from, the caller must synchronize access to this pool.
+	 * @param begin If recording will start right away, if true {@link CommandBuffer#Begin} is called.
+	 * @param queueType The queue to run this command buffer on.
+	 * @param bufferLevel The buffer level.
+	 */
+	CommandBuffer(std::shared_ptr<CommandPool> commandPool, bool begin, VkQueueFlagBits queueType = VK_QUEUE_GRAPHICS_BIT,
+		VkCommandBufferLevel bufferLevel = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
 	~CommandBuffer();
 
 	/**
 	 * Begins the recording state for this command buffer.
 	 * @param usage How this command buffer will be used.
+	 * @param inheritanceInfo The renderpass state a secondary command buffer inherits, ignored for primary command buffers.
 	 */
-	void Begin(VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	void Begin(VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, const VkCommandBufferInheritanceInfo *inheritanceInfo = nullptr);
 
 	/**
 	 * Ends the recording state for this command buffer.
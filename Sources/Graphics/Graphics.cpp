@@ -33,6 +33,9 @@ Graphics::~Graphics() {
 		vkDestroySemaphore(*logicalDevice, renderCompletes[i], nullptr);
 		vkDestroySemaphore(*logicalDevice, presentCompletes[i], nullptr);
 	}
+	stagingBuffer = nullptr;
+	recordingThreads = nullptr;
+	secondaryCommandBuffers.clear();
 	commandPools.clear ();
 	commandBuffers.clear ();
 	swapchain = nullptr;
@@ -64,6 +67,12 @@ void Graphics::Update() {
 
 	Pipeline::Stage stage;
 
+	// Secondary command buffers used by this swapchain image are free to be recorded again.
+	for (auto &[threadId, threadCommandBuffers] : secondaryCommandBuffers[swapchain->GetActiveImageIndex()])
+		threadCommandBuffers.used = 0;
+
+	auto subpassContents = recordingThreads ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+
 	for (auto &renderStage : renderer->renderStages) {
 		renderStage->Update();
 
@@ -76,10 +85,10 @@ void Graphics::Update() {
 			stage.second = subpass.GetBinding();
 
 			// Renders subpass subrender pipelines.
-			renderer->subrenderHolder.RenderStage(stage, *commandBuffer);
+			RecordSubpass(*renderStage, stage, *commandBuffer);
 
 			if (subpass.GetBinding() != renderStage->GetSubpasses().back().GetBinding())
-				vkCmdNextSubpass(*commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+				vkCmdNextSubpass(*commandBuffer, subpassContents);
 		}
 
 		EndRenderpass(*renderStage);
@@ -88,6 +97,7 @@ void Graphics::Update() {
 
 	// Purges unused command pools.
 	if (elapsedPurge.GetElapsed() != 0) {
+		std::unique_lock<std::mutex> lock(commandPoolsMutex);
 		for (auto it = commandPools.begin(); it != commandPools.end();) {
 			if ((*it).second.use_count() <= 1) {
 				it = commandPools.erase(it);
@@ -215,12 +225,36 @@ const Descriptor *Graphics::GetAttachment(const std::string &name) const {
 }
 
 const std::shared_ptr<CommandPool> &Graphics::GetCommandPool(const std::thread::id &threadId) {
+	std::unique_lock<std::mutex> lock(commandPoolsMutex);
+
 	if (auto it = commandPools.find(threadId); it != commandPools.end())
 		return it->second;
 	// TODO: Cleanup and fix crashes
 	return commandPools.emplace(threadId, std::make_shared<CommandPool>(threadId)).first->second;
 }
 
+StagingBuffer *Graphics::GetStagingBuffer() {
+	std::unique_lock<std::mutex> lock(stagingBufferMutex);
+
+	if (!stagingBuffer)
+		stagingBuffer = std::make_unique<StagingBuffer>();
+	return stagingBuffer.get();
+}
+
+StagingBuffer *Graphics::FindStagingBuffer() {
+	std::unique_lock<std::mutex> lock(stagingBufferMutex);
+	return stagingBuffer.get();
+}
+
+void Graphics::SetMultithreadedRecording(uint32_t threadCount) {
+	// Secondary command buffers may still be in flight, and their recording threads are about to be replaced.
+	CheckVk(vkDeviceWaitIdle(*logicalDevice));
+
+	recordingThreads = threadCount > 0 ? std::make_unique<ThreadPool>(threadCount) : nullptr;
+	secondaryCommandBuffers.clear();
+	secondaryCommandBuffers.resize(commandBuffers.size());
+}
+
 void Graphics::CreatePipelineCache() {
 	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
 	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
@@ -262,6 +296,8 @@ void Graphics::RecreateCommandBuffers() {
 	renderCompletes.resize(swapchain->GetImageCount());
 	flightFences.resize(swapchain->GetImageCount());
 	commandBuffers.resize(swapchain->GetImageCount());
+	secondaryCommandBuffers.clear();
+	secondaryCommandBuffers.resize(swapchain->GetImageCount());
 
 	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
 	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -340,7 +376,7 @@ bool Graphics::StartRenderpass(RenderStage &renderStage) {
 	renderPassBeginInfo.renderArea = renderArea;
 	renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 	renderPassBeginInfo.pClearValues = clearValues.data();
-	vkCmdBeginRenderPass(*commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(*commandBuffer, &renderPassBeginInfo, recordingThreads ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 
 	return true;
 }
@@ -355,6 +391,11 @@ void Graphics::EndRenderpass(RenderStage &renderStage) {
 		return;
 
 	commandBuffer->End();
+
+	// Every upload recorded so far is submitted first, including ones recorded on other threads after this frame's command buffers.
+	// Each copy ends with a barrier to the stages its resource is used in, and barriers apply to later submissions, so the frame sees them.
+	GetStagingBuffer()->Submit();
+
 	commandBuffer->Submit(presentCompletes[currentFrame], renderCompletes[currentFrame], flightFences[currentFrame]);
 
 	auto presentResult = swapchain->QueuePresent(presentQueue, renderCompletes[currentFrame]);
@@ -368,4 +409,75 @@ void Graphics::EndRenderpass(RenderStage &renderStage) {
 
 	currentFrame = (currentFrame + 1) % swapchain->GetImageCount();
 }
+
+void Graphics::RecordSubpass(RenderStage &renderStage, const Pipeline::Stage &stage, const CommandBuffer &commandBuffer) {
+	if (!recordingThreads) {
+		renderer->subrenderHolder.RenderStage(stage, commandBuffer);
+		return;
+	}
+
+	auto imageIndex = swapchain->GetActiveImageIndex();
+
+	VkCommandBufferInheritanceInfo inheritanceInfo = {};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = *renderStage.GetRenderpass();
+	inheritanceInfo.subpass = stage.second;
+	inheritanceInfo.framebuffer = renderStage.GetActiveFramebuffer(imageIndex);
+
+	// Dynamic state is not inherited from the primary command buffer.
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(renderStage.GetRenderArea().GetExtent().x);
+	viewport.height = static_cast<float>(renderStage.GetRenderArea().GetExtent().y);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+
+	VkRect2D scissor = {};
+	scissor.offset = {renderStage.GetRenderArea().GetOffset().x, renderStage.GetRenderArea().GetOffset().y};
+	scissor.extent = {renderStage.GetRenderArea().GetExtent().x, renderStage.GetRenderArea().GetExtent().y};
+
+	std::vector<std::future<VkCommandBuffer>> recordings;
+
+	for (auto subrender : renderer->subrenderHolder.GetStageSubrenders(stage)) {
+		recordings.emplace_back(recordingThreads->Enqueue([this, subrender, imageIndex, &inheritanceInfo, &viewport, &scissor]() {
+			auto &secondaryCommandBuffer = GetSecondaryCommandBuffer(imageIndex);
+			secondaryCommandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT, &inheritanceInfo);
+			vkCmdSetViewport(secondaryCommandBuffer, 0, 1, &viewport);
+			vkCmdSetScissor(secondaryCommandBuffer, 0, 1, &scissor);
+			subrender->Render(secondaryCommandBuffer);
+			secondaryCommandBuffer.End();
+			return secondaryCommandBuffer.GetCommandBuffer();
+		}));
+	}
+
+	// Every recording must finish before leaving this scope, even if one has thrown.
+	for (auto &recording : recordings)
+		recording.wait();
+
+	std::vector<VkCommandBuffer> secondaryHandles;
+	secondaryHandles.reserve(recordings.size());
+
+	// Executed in the same order the subrenders would have been recorded inline.
+	for (auto &recording : recordings)
+		secondaryHandles.emplace_back(recording.get());
+
+	if (!secondaryHandles.empty())
+		vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaryHandles.size()), secondaryHandles.data());
+}
+
+CommandBuffer &Graphics::GetSecondaryCommandBuffer(std::size_t imageIndex) {
+	SecondaryCommandBuffers *threadCommandBuffers;
+
+	{
+		std::unique_lock<std::mutex> lock(secondaryCommandBuffersMutex);
+		threadCommandBuffers = &secondaryCommandBuffers[imageIndex][std::this_thread::get_id()];
+	}
+
+	// Only this thread uses these command buffers, and they are allocated from this thread's command pool.
+	if (threadCommandBuffers->used == threadCommandBuffers->commandBuffers.size())
+		threadCommandBuffers->commandBuffers.emplace_back(std::make_unique<CommandBuffer>(false, VK_QUEUE_GRAPHICS_BIT, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+
+	return *threadCommandBuffers->commandBuffers[threadCommandBuffers->used++];
+}
 }
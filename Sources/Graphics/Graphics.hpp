@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Engine/Engine.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Buffers/StagingBuffer.hpp"
 #include "Commands/CommandBuffer.hpp"
 #include "Commands/CommandPool.hpp"
 #include "Devices/Instance.hpp"
@@ -34,6 +36,31 @@ public:
 
 	const std::shared_ptr<CommandPool> &GetCommandPool(const std::thread::id &threadId = std::this_thread::get_id());
 
+	/**
+	 * Gets the ring buffer that uploads to device local memory are staged through.
+	 * @return The staging buffer.
+	 */
+	StagingBuffer *GetStagingBuffer();
+
+	/**
+	 * Gets the staging buffer without creating it, for buffers and images being destroyed.
+	 * @return The staging buffer, or null if it has not been created or has been destroyed.
+	 */
+	StagingBuffer *FindStagingBuffer();
+
+	/**
+	 * Gets if subrenders are recorded into secondary command buffers on worker threads.
+	 * @return If recording is multithreaded.
+	 */
+	bool IsMultithreadedRecording() const { return recordingThreads != nullptr; }
+
+	/**
+	 * Sets if subrenders are recorded into secondary command buffers on worker threads, subrenders in the same subpass
+	 * will have {@link Subrender#Render} called concurrently so must not share mutable state.
+	 * @param threadCount The number of recording threads, 0 will record every subrender on the main thread.
+	 */
+	void SetMultithreadedRecording(uint32_t threadCount = std::thread::hardware_concurrency());
+
 	/**
 	 * Gets the current renderer.
 	 * @return The renderer.
@@ -65,12 +92,18 @@ private:
 	void RecreateAttachmentsMap();
 	bool StartRenderpass(RenderStage &renderStage);
 	void EndRenderpass(RenderStage &renderStage);
+	void RecordSubpass(RenderStage &renderStage, const Pipeline::Stage &stage, const CommandBuffer &commandBuffer);
+	CommandBuffer &GetSecondaryCommandBuffer(std::size_t imageIndex);
 
 	std::unique_ptr<Renderer> renderer;
 	std::map<std::string, const Descriptor *> attachments;
 	std::unique_ptr<Swapchain> swapchain;
 
 	std::map<std::thread::id, std::shared_ptr<CommandPool>> commandPools;
+	std::mutex commandPoolsMutex;
+
+	std::unique_ptr<StagingBuffer> stagingBuffer;
+	std::mutex stagingBufferMutex;
 	/// Timer used to remove unused command pools.
 	ElapsedTime elapsedPurge;
 
@@ -83,6 +116,20 @@ private:
 
 	std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
 
+	/**
+	 * Secondary command buffers allocated by a single recording thread, reused in order every time a swapchain image is rendered.
+	 */
+	struct SecondaryCommandBuffers {
+		std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
+		std::size_t used = 0;
+	};
+
+	/// Threads that record subrenders, null when recording on the main thread.
+	std::unique_ptr<ThreadPool> recordingThreads;
+	/// Secondary command buffers for each swapchain image, each recording thread allocates from its own command pool.
+	std::vector<std::map<std::thread::id, SecondaryCommandBuffers>> secondaryCommandBuffers;
+	std::mutex secondaryCommandBuffersMutex;
+
 	std::unique_ptr<Instance> instance;
 	std::unique_ptr<PhysicalDevice> physicalDevice;
 	std::unique_ptr<Surface> surface;
@@ -25,6 +25,12 @@ Image::Image(VkFilter filter, VkSamplerAddressMode addressMode, VkSampleCountFla
 
 Image::~Image() {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// Staged copies into the image may not have been submitted or completed yet.
+	if (usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+		if (auto stagingBuffer = Graphics::Get()->FindStagingBuffer())
+			stagingBuffer->WaitForImageCopies(image);
+	}
 
 	vkDestroyImageView(*logicalDevice, view, nullptr);
 	vkDestroySampler(*logicalDevice, sampler, nullptr);
@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/Ktx2/Ktx2Texture.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
@@ -10,6 +11,36 @@
 #include "Image.hpp"
 
 namespace acid {
+/**
+ * Gets the pipeline stages and access types that use an image with the given usage after it is uploaded.
+ * @param usage The usage of the image.
+ * @return The destination stage mask and access mask for the upload's barrier.
+ */
+static std::pair<VkPipelineStageFlags, VkAccessFlags> GetUploadDstMasks(VkImageUsageFlags usage) {
+	VkPipelineStageFlags dstStageMask = 0;
+	VkAccessFlags dstAccessMask = 0;
+
+	if (usage & (VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT)) {
+		dstStageMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
+	}
+	if (usage & VK_IMAGE_USAGE_STORAGE_BIT)
+		dstAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+	if (usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) {
+		dstStageMask |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	}
+	if (usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+		dstStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+	}
+
+	// An image with none of these usages is never read after the upload, the barrier only has to transition its layout.
+	if (dstStageMask == 0)
+		dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	return {dstStageMask, dstAccessMask};
+}
+
 std::shared_ptr<Image2d> Image2d::Create(const Node &node) {
 	if (auto resource = Resources::Get()->Find<Image2d>(node))
 		return resource;
@@ -93,9 +124,14 @@ Node &operator<<(Node &node, const Image2d &image) {
 }
 
 void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap) {
+	if (filename.extension() == ".ktx2" && !loadBitmap) {
+		LoadKtx2();
+		return;
+	}
+
 	if (!filename.empty() && !loadBitmap) {
 		loadBitmap = std::make_unique<Bitmap>(filename);
-		extent = {loadBitmap->GetSize().y, loadBitmap->GetSize().y, 1};
+		extent = {loadBitmap->GetSize().x, loadBitmap->GetSize().y, 1};
 		components = loadBitmap->GetBytesPerPixel();
 	}
 		
@@ -109,28 +145,86 @@ void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap) {
 	CreateImageSampler(sampler, filter, addressMode, anisotropic, mipLevels);
 	CreateImageView(image, view, VK_IMAGE_VIEW_TYPE_2D, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 
-	if (loadBitmap || mipmap) {
+	if (loadBitmap) {
+		auto [dstStageMask, dstAccessMask] = GetUploadDstMasks(usage);
+
+		// When mipmapping the first level is next read by the blits.
+		if (mipmap) {
+			dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		}
+
+		// The staging batch transitions the image around the copy, and is submitted before the next frame.
+		auto stagingBuffer = Graphics::Get()->GetStagingBuffer();
+		stagingBuffer->CopyToImage(loadBitmap->GetData().get(), loadBitmap->GetLength(), image, extent, mipLevels, arrayLayers, 0,
+			mipmap ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : layout, dstStageMask, dstAccessMask);
+
+		if (mipmap) {
+			// Mipmaps are blitted in a separate submission, which must come after the copy.
+			stagingBuffer->Submit();
+			CreateMipmaps(image, extent, format, layout, mipLevels, 0, arrayLayers);
+		}
+	} else if (mipmap) {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+		CreateMipmaps(image, extent, format, layout, mipLevels, 0, arrayLayers);
+	} else {
+		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	}
+}
 
-	if (loadBitmap) {
-		Buffer bufferStaging(loadBitmap->GetLength(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+void Image2d::LoadKtx2() {
+	Ktx2Texture texture(filename);
+
+	if (!texture)
+		return;
+
+	extent = {texture.GetSize().x, texture.GetSize().y, 1};
+	format = static_cast<VkFormat>(texture.GetVkFormat());
+	components = 4;
+	// Prebuilt mip levels can't be blitted in block compressed formats, so only the levels in the file are used.
+	mipLevels = mipmap ? static_cast<uint32_t>(texture.GetLevels().size()) : 1;
 
-		uint8_t *data;
-		bufferStaging.MapMemory(reinterpret_cast<void **>(&data));
-		std::memcpy(data, loadBitmap->GetData().get(), bufferStaging.GetSize());
-		bufferStaging.UnmapMemory();
+	// Devices without support for the format are given the levels decoded to RGBA.
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(*Graphics::Get()->GetPhysicalDevice(), format, &formatProperties);
+	auto decode = !(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
-		CopyBufferToImage(bufferStaging.GetBuffer(), image, extent, arrayLayers, 0);
+	if (decode) {
+		Log::Warning("Texture format ", format, " is not supported, decoding ", filename, '\n');
+		format = texture.IsSrgb() ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
 	}
 
-	if (mipmap) {
-		CreateMipmaps(image, extent, format, layout, mipLevels, 0, arrayLayers);
-	} else if (loadBitmap) {
-		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
-	} else {
-		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	std::vector<uint8_t> data;
+	std::vector<VkBufferImageCopy> copyRegions;
+
+	for (uint32_t level = 0; level < mipLevels; level++) {
+		const auto &textureLevel = texture.GetLevels()[level];
+
+		VkBufferImageCopy copyRegion = {};
+		copyRegion.bufferOffset = data.size();
+		copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copyRegion.imageSubresource.mipLevel = level;
+		copyRegion.imageSubresource.baseArrayLayer = 0;
+		copyRegion.imageSubresource.layerCount = arrayLayers;
+		copyRegion.imageExtent = {textureLevel.size.x, textureLevel.size.y, 1};
+		copyRegions.emplace_back(copyRegion);
+
+		if (decode) {
+			auto bitmap = BlockCompression::Decode(textureLevel.data.data(), textureLevel.size, texture.GetFormat());
+			data.insert(data.end(), bitmap.GetData().get(), bitmap.GetData().get() + bitmap.GetLength());
+		} else {
+			// Levels are a whole number of blocks, so each offset stays aligned to the block size.
+			data.insert(data.end(), textureLevel.data.begin(), textureLevel.data.end());
+		}
 	}
+
+	CreateImage(image, memory, extent, format, samples, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		mipLevels, arrayLayers, VK_IMAGE_TYPE_2D);
+	CreateImageSampler(sampler, filter, addressMode, anisotropic, mipLevels);
+	CreateImageView(image, view, VK_IMAGE_VIEW_TYPE_2D, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+
+	auto [dstStageMask, dstAccessMask] = GetUploadDstMasks(usage);
+	Graphics::Get()->GetStagingBuffer()->CopyToImage(data.data(), data.size(), image, copyRegions, mipLevels, arrayLayers, 0, layout, dstStageMask,
+		dstAccessMask);
 }
 }
@@ -7,6 +7,7 @@
 namespace acid {
 /**
  * @brief Resource that represents a 2D image.
+ * KTX2 files are uploaded with the format and mip levels they were built with, other files are decoded to RGBA and mipmapped on the device.
  */
 class ACID_EXPORT Image2d : public Image, public Resource {
 public:
@@ -97,6 +98,7 @@ public:
 
 private:
 	void Load(std::unique_ptr<Bitmap> loadBitmap = nullptr);
+	void LoadKtx2();
 
 	std::filesystem::path filename;
 
@@ -113,6 +113,31 @@ std::optional<Attachment> RenderStage::GetAttachment(uint32_t binding) const {
 	return std::nullopt;
 }
 
+std::optional<uint32_t> RenderStage::GetColourAttachmentIndex(uint32_t subpass, uint32_t binding) const {
+	auto it = std::find_if(subpasses.begin(), subpasses.end(), [subpass](const SubpassType &s) {
+		return s.GetBinding() == subpass;
+	});
+
+	if (it == subpasses.end())
+		return std::nullopt;
+
+	// Colour attachments are numbered in the order the subpass binds them, skipping depth like the renderpass does.
+	uint32_t index = 0;
+
+	for (const auto &attachmentBinding : it->GetAttachmentBindings()) {
+		auto attachment = GetAttachment(attachmentBinding);
+
+		if (!attachment || attachment->GetType() == Attachment::Type::Depth)
+			continue;
+		if (attachmentBinding == binding)
+			return index;
+
+		index++;
+	}
+
+	return std::nullopt;
+}
+
 const Descriptor *RenderStage::GetDescriptor(const std::string &name) const {
 	auto it = descriptors.find(name);
 
@@ -25,15 +25,17 @@ public:
 	 * @param multisampled If this attachment is multisampled.
 	 * @param format The format that will be created (only applies to type ATTACHMENT_IMAGE).
 	 * @param clearColour The colour to clear to before rendering to it.
+	 * @param persistent If the image keeps what was rendered to it last frame instead of being cleared (only applies to type ATTACHMENT_IMAGE).
 	 */
 	Attachment(uint32_t binding, std::string name, Type type, bool multisampled = false, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM,
-		const Colour &clearColour = Colour::Black) :
+		const Colour &clearColour = Colour::Black, bool persistent = false) :
 		binding(binding),
 		name(std::move(name)),
 		type(type),
 		multisampled(multisampled),
 		format(format),
-		clearColour(clearColour) {
+		clearColour(clearColour),
+		persistent(persistent) {
 	}
 
 	uint32_t GetBinding() const { return binding; }
@@ -42,6 +44,7 @@ public:
 	bool IsMultisampled() const { return multisampled; }
 	VkFormat GetFormat() const { return format; }
 	const Colour &GetClearColour() const { return clearColour; }
+	bool IsPersistent() const { return persistent; }
 
 private:
 	uint32_t binding;
@@ -50,6 +53,7 @@ private:
 	bool multisampled;
 	VkFormat format;
 	Colour clearColour;
+	bool persistent;
 };
 
 class ACID_EXPORT SubpassType {
@@ -135,6 +139,14 @@ public:
 	std::optional<Attachment> GetAttachment(const std::string &name) const;
 	std::optional<Attachment> GetAttachment(uint32_t binding) const;
 
+	/**
+	 * Gets the index of an attachment within the colour attachments of a subpass, as used when clearing attachments.
+	 * @param subpass The subpass binding.
+	 * @param binding The attachment binding.
+	 * @return The colour attachment index, or nothing if the subpass doesn't write the attachment as a colour.
+	 */
+	std::optional<uint32_t> GetColourAttachmentIndex(uint32_t subpass, uint32_t binding) const;
+
 	const Descriptor *GetDescriptor(const std::string &name) const;
 	const VkFramebuffer &GetActiveFramebuffer(uint32_t activeSwapchainImage) const;
 
@@ -36,6 +36,12 @@ Renderpass::Renderpass(const RenderStage &renderStage, VkFormat depthFormat, VkF
 			break;
 		}
 
+		// Attachment images are created in their final layout, and every pass after leaves them in it.
+		if (attachment.IsPersistent() && attachment.GetType() == Attachment::Type::Image) {
+			attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			attachmentDescription.initialLayout = attachmentDescription.finalLayout;
+		}
+
 		attachmentDescriptions.emplace_back(attachmentDescription);
 	}
 
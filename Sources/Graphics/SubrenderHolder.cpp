@@ -28,4 +28,22 @@ void SubrenderHolder::RenderStage(const Pipeline::Stage &stage, const CommandBuf
 		}
 	}
 }
+
+std::vector<Subrender *> SubrenderHolder::GetStageSubrenders(const Pipeline::Stage &stage) {
+	std::vector<Subrender *> stageSubrenders;
+
+	for (const auto &[stageIndex, typeId] : stages) {
+		if (stageIndex.first != stage) {
+			continue;
+		}
+
+		if (auto &subrender = subrenders[typeId]) {
+			if (subrender->IsEnabled()) {
+				stageSubrenders.emplace_back(subrender.get());
+			}
+		}
+	}
+
+	return stageSubrenders;
+}
 }
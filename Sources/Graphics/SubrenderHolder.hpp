@@ -81,6 +81,13 @@ private:
 	 */
 	void RenderStage(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer);
 
+	/**
+	 * Gets all enabled Subrenders in a stage, in the order they would be rendered.
+	 * @param stage The Subrender stage.
+	 * @return The enabled Subrenders.
+	 */
+	std::vector<Subrender *> GetStageSubrenders(const Pipeline::Stage &stage);
+
 	/// List of all Subrenders.
 	std::unordered_map<TypeId, std::unique_ptr<Subrender>> subrenders;
 	/// List of subrender stages.
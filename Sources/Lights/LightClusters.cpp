@@ -0,0 +1,235 @@
+#include "LightClusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace acid {
+/**
+ * Gets the tile a normalized device coordinate is in, coordinates off the screen are in the tile at its edge.
+ */
+static uint32_t GetTile(float coordinate, uint32_t tiles) {
+	return static_cast<uint32_t>(std::clamp((0.5f * coordinate + 0.5f) * static_cast<float>(tiles), 0.0f, static_cast<float>(tiles - 1)));
+}
+
+LightClusters::LightClusters(const Vector3ui &gridSize) :
+	gridSize(gridSize) {
+}
+
+void LightClusters::Update(const Matrix4 &viewMatrix, float fieldOfView, float aspectRatio, float nearPlane, float farPlane,
+	const std::vector<Vector4f> &lights, ThreadPool *threadPool) {
+	this->nearPlane = nearPlane;
+	this->farPlane = farPlane;
+	tanY = std::tan(0.5f * fieldOfView);
+	tanX = tanY * aspectRatio;
+
+	auto depthRange = std::log(farPlane / nearPlane);
+	depthScale = static_cast<float>(gridSize.z) / depthRange;
+	depthBias = -static_cast<float>(gridSize.z) * std::log(nearPlane) / depthRange;
+
+	sliceDepths.resize(gridSize.z + 1);
+	for (uint32_t z = 0; z <= gridSize.z; z++)
+		sliceDepths[z] = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / static_cast<float>(gridSize.z));
+
+	// Lights are moved into view space as arrays of each value, so the loops over them can be vectorized.
+	auto lightCount = lights.size();
+	lightX.resize(lightCount);
+	lightY.resize(lightCount);
+	lightDepth.resize(lightCount);
+	lightRadius.resize(lightCount);
+	lightMinSlice.resize(lightCount);
+	lightMaxSlice.resize(lightCount);
+
+	for (std::size_t i = 0; i < lightCount; i++) {
+		const auto &light = lights[i];
+		lightX[i] = viewMatrix[0][0] * light.x + viewMatrix[1][0] * light.y + viewMatrix[2][0] * light.z + viewMatrix[3][0];
+		lightY[i] = viewMatrix[0][1] * light.x + viewMatrix[1][1] * light.y + viewMatrix[2][1] * light.z + viewMatrix[3][1];
+		lightDepth[i] = -(viewMatrix[0][2] * light.x + viewMatrix[1][2] * light.y + viewMatrix[2][2] * light.z + viewMatrix[3][2]);
+		lightRadius[i] = light.w;
+	}
+
+	for (std::size_t i = 0; i < lightCount; i++) {
+		auto minDepth = std::clamp(lightDepth[i] - lightRadius[i], nearPlane, farPlane);
+		auto maxDepth = std::clamp(lightDepth[i] + lightRadius[i], nearPlane, farPlane);
+		lightMinSlice[i] = static_cast<int32_t>(std::log(minDepth) * depthScale + depthBias);
+		lightMaxSlice[i] = static_cast<int32_t>(std::log(maxDepth) * depthScale + depthBias);
+	}
+
+	// Lights are culled against the sides of the view, using the distance of the centre from each side plane.
+	auto sideX = std::sqrt(1.0f + tanX * tanX), sideY = std::sqrt(1.0f + tanY * tanY);
+
+	for (std::size_t i = 0; i < lightCount; i++) {
+		auto outsideX = std::abs(lightX[i]) - lightDepth[i] * tanX > lightRadius[i] * sideX;
+		auto outsideY = std::abs(lightY[i]) - lightDepth[i] * tanY > lightRadius[i] * sideY;
+		auto outsideDepth = lightDepth[i] + lightRadius[i] < nearPlane || lightDepth[i] - lightRadius[i] > farPlane;
+
+		if (lightRadius[i] <= 0.0f) {
+			lightMinSlice[i] = 0;
+			lightMaxSlice[i] = static_cast<int32_t>(gridSize.z) - 1;
+		} else if (outsideX || outsideY || outsideDepth) {
+			lightMinSlice[i] = 0;
+			lightMaxSlice[i] = -1;
+		} else {
+			lightMinSlice[i] = std::clamp(lightMinSlice[i], 0, static_cast<int32_t>(gridSize.z) - 1);
+			lightMaxSlice[i] = std::clamp(lightMaxSlice[i], 0, static_cast<int32_t>(gridSize.z) - 1);
+		}
+	}
+
+	// Lights are binned by the slices they reach, so each slice only looks at its own lights.
+	sliceOffsets.assign(gridSize.z + 1, 0);
+
+	for (std::size_t i = 0; i < lightCount; i++) {
+		for (auto z = lightMinSlice[i]; z <= lightMaxSlice[i]; z++)
+			sliceOffsets[z + 1]++;
+	}
+
+	for (uint32_t z = 0; z < gridSize.z; z++)
+		sliceOffsets[z + 1] += sliceOffsets[z];
+
+	sliceLights.resize(sliceOffsets.back());
+	std::vector<uint32_t> sliceEnds(sliceOffsets.begin(), sliceOffsets.end() - 1);
+
+	for (std::size_t i = 0; i < lightCount; i++) {
+		for (auto z = lightMinSlice[i]; z <= lightMaxSlice[i]; z++)
+			sliceLights[sliceEnds[z]++] = static_cast<uint32_t>(i);
+	}
+
+	// Each job finds lights for every nth slice, so near slices with more lights are shared out, and writes the range of their clusters.
+	auto jobCount = threadPool ? std::min<std::size_t>(threadPool->GetWorkers().size() + 1, gridSize.z) : 1;
+	jobs.resize(jobCount);
+	buffer.resize(2 * static_cast<std::size_t>(GetClusterCount()));
+
+	if (jobCount == 1) {
+		FindLights(0, 1);
+	} else {
+		// The last job runs on this thread while the others are on the pool.
+		std::vector<std::future<void>> findings;
+		findings.reserve(jobCount - 1);
+
+		for (std::size_t job = 0; job + 1 < jobCount; job++)
+			findings.emplace_back(threadPool->Enqueue([this](std::size_t job, std::size_t jobCount) { FindLights(job, jobCount); }, job, jobCount));
+
+		FindLights(jobCount - 1, jobCount);
+
+		for (auto &finding : findings)
+			finding.get();
+	}
+
+	// Light indices of each job follow the indices of the job before it.
+	auto clustersPerSlice = gridSize.x * gridSize.y;
+	auto offset = buffer.size();
+	std::vector<std::size_t> jobOffsets(jobCount);
+
+	for (std::size_t job = 0; job < jobCount; job++) {
+		jobOffsets[job] = offset;
+		offset += jobs[job].indices.size();
+	}
+
+	buffer.resize(offset);
+
+	for (std::size_t job = 0; job < jobCount; job++) {
+		const auto &indices = jobs[job].indices;
+		if (!indices.empty())
+			std::memcpy(buffer.data() + jobOffsets[job], indices.data(), indices.size() * sizeof(uint32_t));
+
+		for (auto z = static_cast<uint32_t>(job); z < gridSize.z; z += static_cast<uint32_t>(jobCount)) {
+			for (uint32_t cluster = z * clustersPerSlice; cluster < (z + 1) * clustersPerSlice; cluster++)
+				buffer[2 * cluster] += static_cast<uint32_t>(jobOffsets[job]);
+		}
+	}
+}
+
+uint32_t LightClusters::GetSlice(float depth) const {
+	if (depth <= nearPlane)
+		return 0;
+
+	auto slice = static_cast<int32_t>(std::log(depth) * depthScale + depthBias);
+	return static_cast<uint32_t>(std::clamp(slice, 0, static_cast<int32_t>(gridSize.z) - 1));
+}
+
+void LightClusters::FindLights(std::size_t job, std::size_t jobCount) {
+	auto &[rects, counts, indices] = jobs[job];
+	auto clustersPerSlice = gridSize.x * gridSize.y;
+	indices.clear();
+
+	for (auto z = static_cast<uint32_t>(job); z < gridSize.z; z += static_cast<uint32_t>(jobCount)) {
+		rects.clear();
+
+		for (auto i = sliceOffsets[z]; i < sliceOffsets[z + 1]; i++) {
+			Rect rect;
+			if (FindRect(sliceLights[i], z, rect))
+				rects.emplace_back(rect);
+		}
+
+		// Lights are counted for each cluster in the slice, then written in order after the clusters before them.
+		counts.assign(clustersPerSlice, 0);
+
+		for (const auto &rect : rects) {
+			for (auto y = rect.minY; y <= rect.maxY; y++) {
+				for (auto x = rect.minX; x <= rect.maxX; x++)
+					counts[y * gridSize.x + x]++;
+			}
+		}
+
+		auto first = static_cast<uint32_t>(indices.size());
+
+		for (uint32_t i = 0; i < clustersPerSlice; i++) {
+			auto cluster = z * clustersPerSlice + i;
+			buffer[2 * cluster] = first;
+			buffer[2 * cluster + 1] = counts[i];
+			counts[i] = first;
+			first += buffer[2 * cluster + 1];
+		}
+
+		indices.resize(first);
+
+		for (const auto &rect : rects) {
+			for (auto y = rect.minY; y <= rect.maxY; y++) {
+				for (auto x = rect.minX; x <= rect.maxX; x++)
+					indices[counts[y * gridSize.x + x]++] = rect.light;
+			}
+		}
+	}
+}
+
+bool LightClusters::FindRect(uint32_t light, uint32_t slice, Rect &rect) const {
+	rect.light = light;
+	auto radius = lightRadius[light];
+
+	if (radius <= 0.0f) {
+		rect.minX = 0;
+		rect.maxX = gridSize.x - 1;
+		rect.minY = 0;
+		rect.maxY = gridSize.y - 1;
+		return true;
+	}
+
+	// The depths of the slice the sphere reaches, and the radius of its widest circle between them.
+	auto depth = lightDepth[light];
+	auto minDepth = std::max(sliceDepths[slice], depth - radius);
+	auto maxDepth = std::min(sliceDepths[slice + 1], depth + radius);
+
+	if (minDepth > maxDepth)
+		return false;
+
+	auto offset = std::clamp(depth, minDepth, maxDepth) - depth;
+	auto sliceRadius = std::sqrt(std::max(radius * radius - offset * offset, 0.0f));
+
+	// The circles fit in a box between the depths, which projects furthest from the centre of the screen at one of its corners.
+	auto left = lightX[light] - sliceRadius, right = lightX[light] + sliceRadius;
+	auto bottom = lightY[light] - sliceRadius, top = lightY[light] + sliceRadius;
+	auto minX = std::min(left / minDepth, left / maxDepth) / tanX;
+	auto maxX = std::max(right / minDepth, right / maxDepth) / tanX;
+	auto minY = std::min(bottom / minDepth, bottom / maxDepth) / tanY;
+	auto maxY = std::max(top / minDepth, top / maxDepth) / tanY;
+
+	if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+		return false;
+
+	rect.minX = GetTile(minX, gridSize.x);
+	rect.maxX = GetTile(maxX, gridSize.x);
+	rect.minY = GetTile(minY, gridSize.y);
+	rect.maxY = GetTile(maxY, gridSize.y);
+	return true;
+}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+
+#include "Maths/Matrix4.hpp"
+#include "Maths/Vector4.hpp"
+#include "Utils/ThreadPool.hpp"
+
+namespace acid {
+/**
+ * @brief Class that splits the camera's view frustum into a grid of clusters and finds the lights that reach each cluster.
+ * Clusters are screen tiles split into depth slices, slices get exponentially deeper so clusters stay close to cubes.
+ * The lists are packed into one buffer for the deferred shader: two values for each cluster, the offset of its first light
+ * index from the start of the buffer and its light count, followed by the light indices of every cluster.
+ */
+class ACID_EXPORT LightClusters {
+public:
+	/**
+	 * Creates a new cluster grid.
+	 * @param gridSize The screen tiles across, the screen tiles down, and the depth slices.
+	 */
+	explicit LightClusters(const Vector3ui &gridSize = Vector3ui(16, 9, 24));
+
+	/**
+	 * Finds the lights that reach each cluster of a camera's view frustum, slices are split between threads when a thread pool is given.
+	 * @param viewMatrix The camera's view matrix.
+	 * @param fieldOfView The camera's vertical field of view.
+	 * @param aspectRatio The camera's aspect ratio.
+	 * @param nearPlane The camera's near plane.
+	 * @param farPlane The camera's far plane.
+	 * @param lights The lights in world space, with the radius in w. Lights without a positive radius reach every cluster.
+	 * @param threadPool The thread pool to find lights on.
+	 */
+	void Update(const Matrix4 &viewMatrix, float fieldOfView, float aspectRatio, float nearPlane, float farPlane, const std::vector<Vector4f> &lights,
+		ThreadPool *threadPool = nullptr);
+
+	/**
+	 * Gets the depth slice a view space depth is in.
+	 * @param depth The distance in front of the camera.
+	 * @return The depth slice.
+	 */
+	uint32_t GetSlice(float depth) const;
+
+	uint32_t GetClusterIndex(uint32_t x, uint32_t y, uint32_t z) const { return (z * gridSize.y + y) * gridSize.x + x; }
+	uint32_t GetClusterCount() const { return gridSize.x * gridSize.y * gridSize.z; }
+
+	uint32_t GetLightCount(uint32_t cluster) const { return buffer[2 * cluster + 1]; }
+	const uint32_t *GetLights(uint32_t cluster) const { return buffer.data() + buffer[2 * cluster]; }
+
+	const Vector3ui &GetGridSize() const { return gridSize; }
+	void SetGridSize(const Vector3ui &gridSize) { this->gridSize = gridSize; }
+
+	/**
+	 * Gets the scale of the log of a depth, the depth slice is {@code log(depth) * scale + bias}.
+	 * @return The depth scale.
+	 */
+	float GetDepthScale() const { return depthScale; }
+	float GetDepthBias() const { return depthBias; }
+
+	/**
+	 * Gets the cluster buffer, with the range of each cluster followed by the light indices.
+	 * @return The cluster buffer.
+	 */
+	const std::vector<uint32_t> &GetBuffer() const { return buffer; }
+
+	/**
+	 * Gets the light indices written last update, summed over clusters.
+	 * @return The light index count.
+	 */
+	std::size_t GetIndexCount() const { return buffer.empty() ? 0 : buffer.size() - 2 * GetClusterCount(); }
+
+private:
+	/// The tiles a light reaches in one depth slice.
+	class Rect {
+	public:
+		uint32_t light;
+		uint32_t minX, maxX;
+		uint32_t minY, maxY;
+	};
+
+	/// The lists of the slices one thread finds lights for.
+	class Job {
+	public:
+		std::vector<Rect> rects;
+		std::vector<uint32_t> counts;
+		std::vector<uint32_t> indices;
+	};
+
+	void FindLights(std::size_t job, std::size_t jobCount);
+	bool FindRect(uint32_t light, uint32_t slice, Rect &rect) const;
+
+	Vector3ui gridSize;
+	float tanX = 0.0f, tanY = 0.0f;
+	float nearPlane = 0.0f, farPlane = 0.0f;
+	float depthScale = 0.0f, depthBias = 0.0f;
+	/// The depth each slice starts at, and where the last slice ends.
+	std::vector<float> sliceDepths;
+
+	/// The view space position and radius of each light, and the first and last slice it reaches.
+	std::vector<float> lightX, lightY, lightDepth, lightRadius;
+	std::vector<int32_t> lightMinSlice, lightMaxSlice;
+	/// The lights that reach each slice, starting at the offset of the slice.
+	std::vector<uint32_t> sliceOffsets, sliceLights;
+
+	std::vector<Job> jobs;
+	std::vector<uint32_t> buffer;
+};
+}
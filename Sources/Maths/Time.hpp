@@ -47,7 +47,7 @@ public:
 	 */
 	template<typename Rep = int32_t>
 	static constexpr Time Milliseconds(const Rep &milliseconds) {
-		return Time(std::chrono::duration<Rep, std::micro>(milliseconds));
+		return Time(std::chrono::duration<Rep, std::milli>(milliseconds));
 	}
 
 	/**
@@ -1,5 +1,6 @@
 #include "Model.hpp"
 
+#include "Graphics/Graphics.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Resources/Resources.hpp"
 
@@ -25,69 +26,114 @@ bool Model::CmdRender(const CommandBuffer &commandBuffer, uint32_t instances) co
 }
 
 std::vector<uint32_t> Model::GetIndices(std::size_t offset) const {
-	Buffer indexStaging(indexBuffer->GetSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-	CommandBuffer commandBuffer;
-
-	VkBufferCopy copyRegion = {};
-	copyRegion.size = indexStaging.GetSize();
-	vkCmdCopyBuffer(commandBuffer, indexBuffer->GetBuffer(), indexStaging.GetBuffer(), 1, &copyRegion);
+	if (offset == 0 && !cachedIndices.empty())
+		return cachedIndices;
 
-	commandBuffer.SubmitIdle();
-
-	void *indicesMemory;
-	indexStaging.MapMemory(&indicesMemory);
+	auto indicesMemory = ReadBuffer(*indexBuffer);
 	std::vector<uint32_t> indices(indexCount);
 
-	auto sizeOfSrcT = indexStaging.GetSize() / indexCount;
+	auto sizeOfSrcT = indicesMemory.size() / indexCount;
 
 	for (uint32_t i = 0; i < indexCount; i++) {
-		std::memcpy(&indices[i], static_cast<char *>(indicesMemory) + (i * sizeOfSrcT) + offset, sizeof(uint32_t));
+		std::memcpy(&indices[i], indicesMemory.data() + (i * sizeOfSrcT) + offset, sizeof(uint32_t));
 	}
 
-	indexStaging.UnmapMemory();
 	return indices;
 }
 
 void Model::SetIndices(const std::vector<uint32_t> &indices) {
 	indexBuffer = nullptr;
 	indexCount = static_cast<uint32_t>(indices.size());
+	cachedIndices = GeometryCached ? indices : std::vector<uint32_t>();
+
+	if (!indices.empty())
+		indexBuffer = CreateBuffer(indices.data(), sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+std::vector<float> Model::GetPointCloud() const {
+	std::vector<float> pointCloud;
+	auto addPoint = [&pointCloud](const Vector3f &vertex) {
+		pointCloud.emplace_back(vertex.x);
+		pointCloud.emplace_back(vertex.y);
+		pointCloud.emplace_back(vertex.z);
+	};
+
+	if (HasCachedGeometry()) {
+		if (cachedIndices.empty()) {
+			pointCloud.reserve(cachedPositions.size() * 3);
+			for (const auto &vertex : cachedPositions)
+				addPoint(vertex);
+		} else {
+			pointCloud.reserve(cachedIndices.size() * 3);
+			for (const auto &index : cachedIndices)
+				addPoint(cachedPositions[index]);
+		}
+
+		return pointCloud;
+	}
+
+	if (!vertexBuffer || !indexBuffer) return {};
+
+	// This assumes a Vector3f attribute is the first vertex attribute.
+	auto indices = GetIndices();
+	auto vertices = GetVertices<Vector3f>();
+	pointCloud.reserve(indices.size() * 3);
+
+	for (const auto &index : indices)
+		addPoint(vertices[index]);
+
+	return pointCloud;
+}
 
-	if (indices.empty())
-		return;
-	
-	Buffer indexStaging(sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		indices.data());
-	indexBuffer = std::make_unique<Buffer>(indexStaging.GetSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+std::vector<char> Model::ReadBuffer(const Buffer &buffer) {
+	Buffer staging(buffer.GetSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	// Uploads to the buffer may still be waiting in the staging batch.
+	Graphics::Get()->GetStagingBuffer()->Submit();
 
 	CommandBuffer commandBuffer;
 
+	// Submission order alone doesn't make the upload visible to the copy.
+	VkBufferMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = buffer.GetBuffer();
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
 	VkBufferCopy copyRegion = {};
-	copyRegion.size = indexStaging.GetSize();
-	vkCmdCopyBuffer(commandBuffer, indexStaging.GetBuffer(), indexBuffer->GetBuffer(), 1, &copyRegion);
+	copyRegion.size = staging.GetSize();
+	vkCmdCopyBuffer(commandBuffer, buffer.GetBuffer(), staging.GetBuffer(), 1, &copyRegion);
 
 	commandBuffer.SubmitIdle();
-}
 
-std::vector<float> Model::GetPointCloud() const {
-	if (!vertexBuffer) return {};
+	void *memory;
+	staging.MapMemory(&memory);
+	std::vector<char> data(static_cast<char *>(memory), static_cast<char *>(memory) + staging.GetSize());
+	staging.UnmapMemory();
+	return data;
+}
 
-	// This assumes a Vector3f attribute is the first vertex attribute.
-	auto indices = GetIndices();
-	auto vertices = GetVertices<Vector3f>();
+std::unique_ptr<Buffer> Model::CreateBuffer(const void *data, std::size_t size, VkBufferUsageFlags usage) {
+	// Without graphics, when running headless, only the geometry kept in memory is used.
+	if (!Graphics::Get())
+		return nullptr;
 
-	std::vector<float> pointCloud;
-	pointCloud.reserve(indices.size());
+	auto buffer = std::make_unique<Buffer>(size, usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-	for (const auto &index : indices) {
-		const auto &vertex = vertices[index];
-		pointCloud.emplace_back(vertex.x);
-		pointCloud.emplace_back(vertex.y);
-		pointCloud.emplace_back(vertex.z);
-	}
+	VkAccessFlags dstAccessMask = 0;
+	if (usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+		dstAccessMask |= VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	if (usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+		dstAccessMask |= VK_ACCESS_INDEX_READ_BIT;
 
-	return pointCloud;
+	// The copy is batched with other uploads and submitted before the next frame.
+	Graphics::Get()->GetStagingBuffer()->CopyToBuffer(data, buffer->GetSize(), buffer->GetBuffer(), VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, dstAccessMask);
+	return buffer;
 }
 }
@@ -136,8 +136,33 @@ public:
 	std::vector<uint32_t> GetIndices(std::size_t offset = 0) const;
 	void SetIndices(const std::vector<uint32_t> &indices);
 
+	/**
+	 * Gets the position of the vertex of each index, from the geometry kept in memory when there is some.
+	 * @return The positions, three floats for each index.
+	 */
 	std::vector<float> GetPointCloud() const;
 
+	/**
+	 * Gets if models keep a copy of their positions and indices in memory when they are created.
+	 * @return If geometry is kept.
+	 */
+	static bool IsGeometryCached() { return GeometryCached; }
+
+	/**
+	 * Sets if models keep a copy of their positions and indices in memory when they are created, so physics shapes are
+	 * made from them without reading the buffers back from the GPU. Models created before are not changed.
+	 * @param geometryCached If geometry is kept.
+	 */
+	static void SetGeometryCached(bool geometryCached) { GeometryCached = geometryCached; }
+
+	/**
+	 * Gets if this model kept its geometry in memory.
+	 * @return If the positions and indices are kept.
+	 */
+	bool HasCachedGeometry() const { return !cachedPositions.empty(); }
+	const std::vector<Vector3f> &GetCachedPositions() const { return cachedPositions; }
+	const std::vector<uint32_t> &GetCachedIndices() const { return cachedIndices; }
+
 	const Vector3f &GetMinExtents() const { return minExtents; }
 	const Vector3f &GetMaxExtents() const { return maxExtents; }
 	float GetWidth() const { return maxExtents.x - minExtents.x; }
@@ -155,6 +180,23 @@ protected:
 	void Initialize(const std::vector<T> &vertices, const std::vector<uint32_t> &indices = {});
 
 private:
+	/**
+	 * Reads a model buffer back from the GPU, after any uploads to it still waiting in the staging batch.
+	 * A barrier orders the read after earlier transfers, and the calling thread waits until the copy is done.
+	 * @param buffer The buffer to read.
+	 * @return The contents of the buffer.
+	 */
+	static std::vector<char> ReadBuffer(const Buffer &buffer);
+
+	/**
+	 * Creates a device local model buffer and batches the upload of its contents.
+	 * @param data The contents of the buffer.
+	 * @param size The size of the contents.
+	 * @param usage How the buffer is used, as well as a transfer source and destination.
+	 * @return The buffer, null when running without graphics.
+	 */
+	static std::unique_ptr<Buffer> CreateBuffer(const void *data, std::size_t size, VkBufferUsageFlags usage);
+
 	std::unique_ptr<Buffer> vertexBuffer;
 	std::unique_ptr<Buffer> indexBuffer;
 	uint32_t vertexCount = 0;
@@ -163,6 +205,12 @@ private:
 	Vector3f minExtents;
 	Vector3f maxExtents;
 	float radius = 0.0f;
+
+	/// The positions and indices the model was created with, only kept when geometry is cached.
+	std::vector<Vector3f> cachedPositions;
+	std::vector<uint32_t> cachedIndices;
+
+	inline static bool GeometryCached = true;
 };
 
 template<typename T>
@@ -173,28 +221,15 @@ Model::Model(const std::vector<T> &vertices, const std::vector<uint32_t> &indice
 
 template<typename T>
 std::vector<T> Model::GetVertices(std::size_t offset) const {
-	Buffer vertexStaging(vertexBuffer->GetSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-	CommandBuffer commandBuffer;
-
-	VkBufferCopy copyRegion = {};
-	copyRegion.size = vertexStaging.GetSize();
-	vkCmdCopyBuffer(commandBuffer, vertexBuffer->GetBuffer(), vertexStaging.GetBuffer(), 1, &copyRegion);
-
-	commandBuffer.SubmitIdle();
-
-	void *verticesMemory;
-	vertexStaging.MapMemory(&verticesMemory);
+	auto verticesMemory = ReadBuffer(*vertexBuffer);
 	std::vector<T> vertices(vertexCount);
 
-	auto sizeOfSrcT = vertexStaging.GetSize() / vertexCount;
+	auto sizeOfSrcT = verticesMemory.size() / vertexCount;
 
 	for (uint32_t i = 0; i < vertexCount; i++) {
-		std::memcpy(&vertices[i], static_cast<char *>(verticesMemory) + (i * sizeOfSrcT) + offset, sizeof(T));
+		std::memcpy(&vertices[i], verticesMemory.data() + (i * sizeOfSrcT) + offset, sizeof(T));
 	}
 
-	vertexStaging.UnmapMemory();
 	return vertices;
 }
 
@@ -202,22 +237,11 @@ template<typename T>
 void Model::SetVertices(const std::vector<T> &vertices) {
 	vertexBuffer = nullptr;
 	vertexCount = static_cast<uint32_t>(vertices.size());
+	// Vertices set on their own may not have positions, the cache is filled again by Initialize.
+	cachedPositions.clear();
 
-	if (vertices.empty())
-		return;
-
-	Buffer vertexStaging(sizeof(T) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		vertices.data());
-	vertexBuffer = std::make_unique<Buffer>(vertexStaging.GetSize(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-	CommandBuffer commandBuffer;
-
-	VkBufferCopy copyRegion = {};
-	copyRegion.size = vertexStaging.GetSize();
-	vkCmdCopyBuffer(commandBuffer, vertexStaging.GetBuffer(), vertexBuffer->GetBuffer(), 1, &copyRegion);
-
-	commandBuffer.SubmitIdle();
+	if (!vertices.empty())
+		vertexBuffer = CreateBuffer(vertices.data(), sizeof(T) * vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 }
 
 template<typename T>
@@ -228,10 +252,16 @@ void Model::Initialize(const std::vector<T> &vertices, const std::vector<uint32_
 	minExtents = Vector3f::Infinity;
 	maxExtents = -Vector3f::Infinity;
 
+	if (GeometryCached)
+		cachedPositions.reserve(vertices.size());
+
 	for (const auto &vertex : vertices) {
 		Vector3f position(vertex.position);
 		minExtents = minExtents.Min(position);
 		maxExtents = maxExtents.Max(position);
+
+		if (GeometryCached)
+			cachedPositions.emplace_back(position);
 	}
 
 	radius = std::max(minExtents.Length(), maxExtents.Length());
@@ -0,0 +1,256 @@
+#include "BitStream.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Packet.hpp"
+
+namespace acid {
+/// Largest value of the three smallest components of a normalized quaternion.
+static constexpr float QuaternionComponentRange = 0.707107f;
+
+uint32_t BitStream::GetSteps(float min, float max, float precision) {
+	// Values are rounded to the nearest step, so steps can be twice the precision apart.
+	auto steps = std::ceil((max - min) / (2.0f * precision));
+	return static_cast<uint32_t>(std::clamp(steps, 1.0f, 4294967040.0f));
+}
+
+BitWriter::BitWriter(Packet &packet) :
+	packet(&packet) {
+}
+
+BitWriter::~BitWriter() {
+	Flush();
+}
+
+void BitWriter::WriteBits(uint32_t value, uint32_t bitCount) {
+	if (bitCount == 0)
+		return;
+
+	auto mask = bitCount < 32 ? (1u << bitCount) - 1 : ~0u;
+	scratch |= static_cast<uint64_t>(value & mask) << scratchBits;
+	scratchBits += bitCount;
+	this->bitCount += bitCount;
+
+	// Whole words are moved into the packet, bytes are written lowest first so streams are the same on every platform.
+	if (scratchBits >= 32) {
+		char bytes[4] = {static_cast<char>(scratch), static_cast<char>(scratch >> 8), static_cast<char>(scratch >> 16), static_cast<char>(scratch >> 24)};
+		packet->data.insert(packet->data.end(), bytes, bytes + 4);
+		scratch >>= 32;
+		scratchBits -= 32;
+	}
+}
+
+void BitWriter::WriteBool(bool value) {
+	WriteBits(value ? 1 : 0, 1);
+}
+
+void BitWriter::WriteVarint(uint64_t value) {
+	while (value >= 0x80) {
+		WriteBits(static_cast<uint32_t>(value & 0x7F) | 0x80, 8);
+		value >>= 7;
+	}
+
+	WriteBits(static_cast<uint32_t>(value), 8);
+}
+
+void BitWriter::WriteSignedVarint(int64_t value) {
+	// Zigzag encoding interleaves negative and positive values, so -1 becomes 1 and 1 becomes 2.
+	WriteVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void BitWriter::WriteRanged(int32_t value, int32_t min, int32_t max) {
+	auto range = static_cast<uint64_t>(static_cast<int64_t>(max) - min);
+	WriteBits(static_cast<uint32_t>(static_cast<int64_t>(std::clamp(value, min, max)) - min), BitsRequired(range));
+}
+
+void BitWriter::WriteFloat(float value, float min, float max, float precision) {
+	auto steps = GetSteps(min, max, precision);
+	auto normalized = (std::clamp(value, min, max) - min) / (max - min);
+	WriteBits(static_cast<uint32_t>(std::round(normalized * steps)), BitsRequired(steps));
+}
+
+void BitWriter::WriteVector(const Vector3f &value, float min, float max, float precision) {
+	WriteFloat(value.x, min, max, precision);
+	WriteFloat(value.y, min, max, precision);
+	WriteFloat(value.z, min, max, precision);
+}
+
+void BitWriter::WriteQuaternion(const Quaternion &value, uint32_t bitsPerComponent) {
+	uint32_t largest = 0;
+	for (uint32_t i = 1; i < 4; i++) {
+		if (std::abs(value[i]) > std::abs(value[largest]))
+			largest = i;
+	}
+
+	// q and -q are the same rotation, so the largest component is made positive and not sent.
+	auto sign = value[largest] < 0.0f ? -1.0f : 1.0f;
+	auto steps = (1u << bitsPerComponent) - 1;
+	WriteBits(largest, 2);
+
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+
+		auto normalized = (std::clamp(value[i] * sign, -QuaternionComponentRange, QuaternionComponentRange) + QuaternionComponentRange) /
+			(2.0f * QuaternionComponentRange);
+		WriteBits(static_cast<uint32_t>(std::round(normalized * steps)), bitsPerComponent);
+	}
+}
+
+void BitWriter::WriteString(const std::string &value) {
+	WriteVarint(value.size());
+
+	for (auto c : value)
+		WriteBits(static_cast<uint8_t>(c), 8);
+}
+
+void BitWriter::Flush() {
+	while (scratchBits > 0) {
+		packet->data.emplace_back(static_cast<char>(scratch));
+		scratch >>= 8;
+		scratchBits = scratchBits > 8 ? scratchBits - 8 : 0;
+	}
+
+	// Padding bits are counted, so the count matches the bytes in the packet.
+	bitCount = (bitCount + 7) & ~static_cast<std::size_t>(7);
+}
+
+BitReader::BitReader(Packet &packet) :
+	packet(&packet) {
+}
+
+bool BitReader::ReadBits(uint32_t &value, uint32_t bitCount) {
+	value = 0;
+
+	if (!valid)
+		return false;
+	if (bitCount == 0)
+		return true;
+
+	// Bytes are taken from the packet as needed, moving its read position.
+	while (scratchBits < bitCount) {
+		if (packet->readPos >= packet->data.size())
+			return valid = false;
+
+		scratch |= static_cast<uint64_t>(static_cast<uint8_t>(packet->data[packet->readPos++])) << scratchBits;
+		scratchBits += 8;
+	}
+
+	auto mask = bitCount < 32 ? (1u << bitCount) - 1 : ~0u;
+	value = static_cast<uint32_t>(scratch) & mask;
+	scratch >>= bitCount;
+	scratchBits -= bitCount;
+	return true;
+}
+
+bool BitReader::ReadBool(bool &value) {
+	uint32_t bit;
+	if (!ReadBits(bit, 1))
+		return false;
+
+	value = bit != 0;
+	return true;
+}
+
+bool BitReader::ReadVarint(uint64_t &value) {
+	value = 0;
+
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		uint32_t byte;
+		if (!ReadBits(byte, 8))
+			return false;
+
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+
+	// More than ten bytes can't come from a 64 bit value.
+	return valid = false;
+}
+
+bool BitReader::ReadSignedVarint(int64_t &value) {
+	uint64_t zigzag;
+	if (!ReadVarint(zigzag))
+		return false;
+
+	value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+	return true;
+}
+
+bool BitReader::ReadRanged(int32_t &value, int32_t min, int32_t max) {
+	auto range = static_cast<uint64_t>(static_cast<int64_t>(max) - min);
+	uint32_t read;
+	if (!ReadBits(read, BitsRequired(range)))
+		return false;
+
+	if (read > range)
+		return valid = false;
+
+	value = static_cast<int32_t>(static_cast<int64_t>(read) + min);
+	return true;
+}
+
+bool BitReader::ReadFloat(float &value, float min, float max, float precision) {
+	auto steps = GetSteps(min, max, precision);
+	uint32_t read;
+	if (!ReadBits(read, BitsRequired(steps)))
+		return false;
+
+	if (read > steps)
+		return valid = false;
+
+	value = min + (max - min) * (static_cast<float>(read) / steps);
+	return true;
+}
+
+bool BitReader::ReadVector(Vector3f &value, float min, float max, float precision) {
+	return ReadFloat(value.x, min, max, precision) && ReadFloat(value.y, min, max, precision) && ReadFloat(value.z, min, max, precision);
+}
+
+bool BitReader::ReadQuaternion(Quaternion &value, uint32_t bitsPerComponent) {
+	uint32_t largest;
+	if (!ReadBits(largest, 2))
+		return false;
+
+	auto steps = (1u << bitsPerComponent) - 1;
+	auto sum = 0.0f;
+
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+
+		uint32_t read;
+		if (!ReadBits(read, bitsPerComponent))
+			return false;
+
+		value[i] = (static_cast<float>(read) / steps) * 2.0f * QuaternionComponentRange - QuaternionComponentRange;
+		sum += value[i] * value[i];
+	}
+
+	value[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+	return true;
+}
+
+bool BitReader::ReadString(std::string &value) {
+	uint64_t length;
+	if (!ReadVarint(length))
+		return false;
+
+	// A corrupt length must not allocate more than the packet could hold.
+	if (length > packet->data.size() - packet->readPos + scratchBits / 8)
+		return valid = false;
+
+	value.resize(length);
+
+	for (auto &c : value) {
+		uint32_t byte;
+		if (!ReadBits(byte, 8))
+			return false;
+		c = static_cast<char>(byte);
+	}
+
+	return true;
+}
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+
+#include "Maths/Quaternion.hpp"
+#include "Maths/Vector3.hpp"
+
+namespace acid {
+class Packet;
+
+/**
+ * @brief Helpers shared by bit writers and readers.
+ */
+class ACID_EXPORT BitStream {
+public:
+	/**
+	 * Gets the number of bits needed to store every value from zero to range.
+	 * @param range The largest value.
+	 * @return The number of bits.
+	 */
+	static constexpr uint32_t BitsRequired(uint64_t range) {
+		uint32_t bits = 0;
+		while (range > 0) {
+			bits++;
+			range >>= 1;
+		}
+		return bits;
+	}
+
+	/**
+	 * Gets the number of steps a quantized float is stored with.
+	 * @param min The smallest value.
+	 * @param max The largest value.
+	 * @param precision The largest error allowed.
+	 * @return The number of steps.
+	 */
+	static uint32_t GetSteps(float min, float max, float precision);
+};
+
+/**
+ * @brief Class that writes values into a packet with as few bits as they need.
+ * Booleans take one bit, integers can be written in a range or as variable length integers, and floats and vectors are quantized
+ * to a range and precision. Bits are appended to the packet when the writer is flushed or destroyed, padded to the next byte.
+ *
+ * Schemas can be written once for both writing and reading, as a template on the stream using the Serialize functions:
+ * <code>
+ * template<typename Stream>
+ * bool Serialize(Stream &stream, EntityState &state) {
+ *     return stream.SerializeVarint(state.id) && stream.template SerializeRanged<0, 100>(state.health) &&
+ *         stream.SerializeVector(state.position, -1000.0f, 1000.0f, 0.01f);
+ * }
+ * </code>
+ */
+class ACID_EXPORT BitWriter : public BitStream {
+public:
+	static constexpr bool IsWriting = true;
+	static constexpr bool IsReading = false;
+
+	/**
+	 * Creates a new bit writer.
+	 * @param packet The packet to append to.
+	 */
+	explicit BitWriter(Packet &packet);
+	~BitWriter();
+
+	/**
+	 * Writes the low bits of a value.
+	 * @param value The value to write.
+	 * @param bitCount The number of bits to write, up to 32.
+	 */
+	void WriteBits(uint32_t value, uint32_t bitCount);
+	void WriteBool(bool value);
+
+	/**
+	 * Writes an integer with 7 bits per byte, small values take fewer bytes.
+	 * @param value The value to write.
+	 */
+	void WriteVarint(uint64_t value);
+
+	/**
+	 * Writes a signed integer as a variable length integer, small values of either sign take fewer bytes.
+	 * @param value The value to write.
+	 */
+	void WriteSignedVarint(int64_t value);
+
+	/**
+	 * Writes an integer with just enough bits for a range.
+	 * @param value The value to write, clamped to the range.
+	 * @param min The smallest value.
+	 * @param max The largest value.
+	 */
+	void WriteRanged(int32_t value, int32_t min, int32_t max);
+
+	/**
+	 * Writes a float quantized to a range.
+	 * @param value The value to write, clamped to the range.
+	 * @param min The smallest value.
+	 * @param max The largest value.
+	 * @param precision The largest error allowed.
+	 */
+	void WriteFloat(float value, float min, float max, float precision);
+	void WriteVector(const Vector3f &value, float min, float max, float precision);
+
+	/**
+	 * Writes a rotation with its three smallest components, the largest is recalculated when read.
+	 * @param value The rotation to write, which must be normalized.
+	 * @param bitsPerComponent The bits of each smallest component.
+	 */
+	void WriteQuaternion(const Quaternion &value, uint32_t bitsPerComponent = 10);
+
+	/**
+	 * Writes a string with a variable length integer length.
+	 * @param value The string to write.
+	 */
+	void WriteString(const std::string &value);
+
+	/**
+	 * Appends all written bits to the packet, padded to a byte.
+	 */
+	void Flush();
+
+	/**
+	 * Gets the number of bits written, including those already flushed.
+	 * @return The number of bits.
+	 */
+	std::size_t GetBitCount() const { return bitCount; }
+
+	bool Serialize(bool &value) { WriteBool(value); return true; }
+	bool SerializeBits(uint32_t &value, uint32_t bitCount) { WriteBits(value, bitCount); return true; }
+	template<typename T>
+	bool SerializeVarint(T &value) { WriteVarint(static_cast<uint64_t>(value)); return true; }
+	template<typename T>
+	bool SerializeSignedVarint(T &value) { WriteSignedVarint(static_cast<int64_t>(value)); return true; }
+	template<int32_t Min, int32_t Max, typename T>
+	bool SerializeRanged(T &value) {
+		static_assert(Min < Max, "Range must not be empty");
+		WriteBits(static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(value), Min, Max) - Min), BitsRequired(static_cast<uint64_t>(static_cast<int64_t>(Max) - Min)));
+		return true;
+	}
+	bool SerializeFloat(float &value, float min, float max, float precision) { WriteFloat(value, min, max, precision); return true; }
+	bool SerializeVector(Vector3f &value, float min, float max, float precision) { WriteVector(value, min, max, precision); return true; }
+	bool SerializeQuaternion(Quaternion &value, uint32_t bitsPerComponent = 10) { WriteQuaternion(value, bitsPerComponent); return true; }
+	bool SerializeString(std::string &value) { WriteString(value); return true; }
+
+private:
+	Packet *packet;
+	/// Bits that have not been appended to the packet, from the lowest bit.
+	uint64_t scratch = 0;
+	uint32_t scratchBits = 0;
+	std::size_t bitCount = 0;
+};
+
+/**
+ * @brief Class that reads values written by a acid::BitWriter from a packet.
+ * Reading starts at the read position of the packet, which is moved past the bits read.
+ * Reads past the end of the packet fail and leave the reader invalid, like packets themselves.
+ */
+class ACID_EXPORT BitReader : public BitStream {
+public:
+	static constexpr bool IsWriting = false;
+	static constexpr bool IsReading = true;
+
+	/**
+	 * Creates a new bit reader.
+	 * @param packet The packet to read from.
+	 */
+	explicit BitReader(Packet &packet);
+
+	bool ReadBits(uint32_t &value, uint32_t bitCount);
+	bool ReadBool(bool &value);
+	bool ReadVarint(uint64_t &value);
+	bool ReadSignedVarint(int64_t &value);
+	bool ReadRanged(int32_t &value, int32_t min, int32_t max);
+	bool ReadFloat(float &value, float min, float max, float precision);
+	bool ReadVector(Vector3f &value, float min, float max, float precision);
+	bool ReadQuaternion(Quaternion &value, uint32_t bitsPerComponent = 10);
+	bool ReadString(std::string &value);
+
+	/**
+	 * Gets if every read so far has succeeded.
+	 * @return If the reader is valid.
+	 */
+	bool IsValid() const { return valid; }
+
+	bool Serialize(bool &value) { return ReadBool(value); }
+	bool SerializeBits(uint32_t &value, uint32_t bitCount) { return ReadBits(value, bitCount); }
+	template<typename T>
+	bool SerializeVarint(T &value) {
+		uint64_t read;
+		if (!ReadVarint(read))
+			return false;
+		value = static_cast<T>(read);
+		return true;
+	}
+	template<typename T>
+	bool SerializeSignedVarint(T &value) {
+		int64_t read;
+		if (!ReadSignedVarint(read))
+			return false;
+		value = static_cast<T>(read);
+		return true;
+	}
+	template<int32_t Min, int32_t Max, typename T>
+	bool SerializeRanged(T &value) {
+		static_assert(Min < Max, "Range must not be empty");
+		uint32_t read;
+		if (!ReadBits(read, BitsRequired(static_cast<uint64_t>(static_cast<int64_t>(Max) - Min))) || static_cast<int64_t>(read) > static_cast<int64_t>(Max) - Min)
+			return valid = false;
+		value = static_cast<T>(static_cast<int64_t>(read) + Min);
+		return true;
+	}
+	bool SerializeFloat(float &value, float min, float max, float precision) { return ReadFloat(value, min, max, precision); }
+	bool SerializeVector(Vector3f &value, float min, float max, float precision) { return ReadVector(value, min, max, precision); }
+	bool SerializeQuaternion(Quaternion &value, uint32_t bitsPerComponent = 10) { return ReadQuaternion(value, bitsPerComponent); }
+	bool SerializeString(std::string &value) { return ReadString(value); }
+
+private:
+	Packet *packet;
+	uint64_t scratch = 0;
+	uint32_t scratchBits = 0;
+	bool valid = true;
+};
+}
@@ -1,9 +1,14 @@
 #include "Ftp.hpp"
 
+#include <atomic>
+#include <filesystem>
 #include <sstream>
 #include <fstream>
+#include <thread>
 
+#include "Engine/Log.hpp"
 #include "Network/IpAddress.hpp"
+#include "Utils/String.hpp"
 
 namespace acid {
 Ftp::Ftp() {
@@ -14,6 +19,10 @@ Ftp::~Ftp() {
 }
 
 FtpResponse Ftp::Connect(const IpAddress &server, uint16_t port, const Time &timeout) {
+	this->server = server;
+	this->port = port;
+	this->timeout = timeout;
+
 	// Connect to the server.
 	if (commandSocket.Connect(server, port, timeout) != Socket::Status::Done)
 		return {FtpResponse::Status::ConnectionFailed};
@@ -32,6 +41,9 @@ FtpResponse Ftp::Login(const std::string &name, const std::string &password) {
 	if (response.IsOk())
 		response = SendCommand("PASS", password);
 
+	if (response.IsOk())
+		credentials = std::make_pair(name, password);
+
 	return response;
 }
 
@@ -104,93 +116,60 @@ FtpResponse Ftp::DeleteRemoteFile(const std::string &name) {
 	return SendCommand("DELE", name);
 }
 
-FtpResponse Ftp::Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode) {
-	// Open a data channel using the given transfer mode.
-	FtpDataChannel data(*this);
-	auto response = data.Open(mode);
-
-	if (response.IsOk()) {
-		// Tell the server to start the transfer.
-		response = SendCommand("RETR", remoteFile);
-
-		if (response.IsOk()) {
-			// Extract the filename from the file path
-			auto filename = remoteFile;
-			auto pos = filename.find_last_of("/\\");
-
-			if (pos != std::string::npos)
-				filename = filename.substr(pos + 1);
+FtpResponse Ftp::Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode, bool resume) {
+	FtpTransfer transfer(FtpTransfer::Direction::Download, remoteFile, localPath, mode, resume);
+	Run(transfer);
+	return transfer.GetResponse();
+}
 
-			// Make sure the destination path ends with a slash.
-			auto path = localPath;
+FtpResponse Ftp::Upload(const std::string &localFile, const std::string &remotePath, const FtpDataChannel::Mode &mode, bool append, bool resume) {
+	FtpTransfer transfer(FtpTransfer::Direction::Upload, localFile, remotePath, mode, resume);
+	Run(transfer, append);
+	return transfer.GetResponse();
+}
 
-			if (!path.empty() && (path[path.size() - 1] != '\\') && (path[path.size() - 1] != '/')) {
-				path += "/";
-			}
+std::vector<FtpTransfer> Ftp::Transfer(std::vector<FtpTransfer> transfers, uint32_t connections) {
+	connections = static_cast<uint32_t>(std::min<std::size_t>(connections, transfers.size()));
 
-			// Create the file and truncate it if necessary.
-			std::ofstream file((path + filename).c_str(), std::ios_base::binary | std::ios_base::trunc);
+	// Open the other connections in the same state as this one.
+	std::vector<std::unique_ptr<Ftp>> sessions;
+	auto directory = connections > 1 ? GetWorkingDirectory() : FtpResponseDirectory({});
 
-			if (!file)
-				return {FtpResponse::Status::InvalidFile};
+	for (uint32_t i = 1; i < connections; i++) {
+		auto session = std::make_unique<Ftp>();
+		auto response = session->Connect(server, port, timeout);
 
-			// Receive the file data.
-			data.Receive(file);
+		if (response.IsOk() && credentials)
+			response = session->Login(credentials->first, credentials->second);
+		if (response.IsOk() && directory.IsOk())
+			response = session->ChangeDirectory(directory.GetDirectory());
 
-			// Close the file.
-			file.close();
-
-			// Get the response from the server.
-			response = GetResponse();
-
-			// If the download was unsuccessful, delete the partial file.
-			if (!response.IsOk())
-				std::remove((path + filename).c_str());
+		if (!response.IsOk()) {
+			Log::Warning("FTP Warning: Could only open ", i, " of ", connections, " connections\n");
+			break;
 		}
-	}
-
-	return response;
-}
 
-FtpResponse Ftp::Upload(const std::string &localFile, const std::string &remotePath, const FtpDataChannel::Mode &mode, bool append) {
-	// Get the contents of the file to send.
-	std::ifstream file(localFile.c_str(), std::ios_base::binary);
-
-	if (!file) {
-		return {FtpResponse::Status::InvalidFile};
+		sessions.emplace_back(std::move(session));
 	}
 
-	// Extract the filename from the file path.
-	auto filename = localFile;
-	auto pos = filename.find_last_of("/\\");
+	std::atomic<std::size_t> next = 0;
+	auto work = [&transfers, &next](Ftp &session) {
+		for (std::size_t i; (i = next++) < transfers.size();)
+			session.Run(transfers[i]);
+	};
 
-	if (pos != std::string::npos)
-		filename = filename.substr(pos + 1);
+	std::vector<std::thread> threads;
+	threads.reserve(sessions.size());
 
-	// Make sure the destination path ends with a slash.
-	auto path = remotePath;
+	for (auto &session : sessions)
+		threads.emplace_back(work, std::ref(*session));
 
-	if (!path.empty() && (path[path.size() - 1] != '\\') && (path[path.size() - 1] != '/'))
-		path += "/";
-
-	// Open a data channel using the given transfer mode.
-	FtpDataChannel data(*this);
-	auto response = data.Open(mode);
-
-	if (response.IsOk()) {
-		// Tell the server to start the transfer.
-		response = SendCommand(append ? "APPE" : "STOR", path + filename);
-
-		if (response.IsOk()) {
-			// Send the file data.
-			data.Send(file);
+	work(*this);
 
-			// Get the response from the server.
-			response = GetResponse();
-		}
-	}
+	for (auto &thread : threads)
+		thread.join();
 
-	return response;
+	return transfers;
 }
 
 FtpResponse Ftp::SendCommand(const std::string &command, const std::string &parameter) {
@@ -325,4 +304,137 @@ FtpResponse Ftp::GetResponse() {
 
 	// We never reach there.
 }
+
+void Ftp::Run(FtpTransfer &transfer, bool append) {
+	auto start = Time::Now();
+
+	transfer.offset = 0;
+	transfer.transferred = 0;
+	transfer.response = transfer.direction == FtpTransfer::Direction::Download ? RunDownload(transfer) : RunUpload(transfer, append);
+	transfer.elapsedTime = Time::Now() - start;
+}
+
+FtpResponse Ftp::RunDownload(FtpTransfer &transfer) {
+	// Extract the filename from the file path
+	auto filename = transfer.file;
+	auto pos = filename.find_last_of("/\\");
+
+	if (pos != std::string::npos)
+		filename = filename.substr(pos + 1);
+
+	// Make sure the destination path ends with a slash.
+	auto path = transfer.path;
+
+	if (!path.empty() && (path[path.size() - 1] != '\\') && (path[path.size() - 1] != '/'))
+		path += "/";
+
+	path += filename;
+
+	// Resuming continues from the end of what was already downloaded.
+	std::error_code error;
+	auto resume = transfer.resume && transfer.mode == FtpDataChannel::Mode::Binary;
+	uint64_t offset = resume && std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+
+	if (error)
+		offset = 0;
+
+	// Open a data channel using the given transfer mode.
+	FtpDataChannel data(*this);
+	auto response = data.Open(transfer.mode);
+
+	if (response.IsOk() && offset != 0)
+		response = SendCommand("REST", String::To(offset));
+
+	if (response.IsOk()) {
+		// Tell the server to start the transfer.
+		response = SendCommand("RETR", transfer.file);
+
+		if (response.IsOk()) {
+			// Create the file and truncate it if necessary, or write after the data already there.
+			auto file = std::fopen(path.c_str(), offset != 0 ? "r+b" : "wb");
+
+			if (!file)
+				return {FtpResponse::Status::InvalidFile};
+
+			if (offset != 0)
+				std::fseek(file, 0, SEEK_END);
+
+			// Receive the file data straight into the file.
+			transfer.offset = offset;
+			transfer.transferred = data.ReceiveFile(file);
+
+			// Close the file.
+			std::fclose(file);
+
+			// Get the response from the server.
+			response = GetResponse();
+
+			// If the download was unsuccessful, delete the partial file, unless it can be resumed.
+			if (!response.IsOk() && !resume)
+				std::remove(path.c_str());
+		}
+	}
+
+	return response;
+}
+
+FtpResponse Ftp::RunUpload(FtpTransfer &transfer, bool append) {
+	// Get the contents of the file to send.
+	auto file = std::fopen(transfer.file.c_str(), "rb");
+
+	if (!file)
+		return {FtpResponse::Status::InvalidFile};
+
+	// Extract the filename from the file path.
+	auto filename = transfer.file;
+	auto pos = filename.find_last_of("/\\");
+
+	if (pos != std::string::npos)
+		filename = filename.substr(pos + 1);
+
+	// Make sure the destination path ends with a slash.
+	auto path = transfer.path;
+
+	if (!path.empty() && (path[path.size() - 1] != '\\') && (path[path.size() - 1] != '/'))
+		path += "/";
+
+	// Open a data channel using the given transfer mode.
+	FtpDataChannel data(*this);
+	auto response = data.Open(transfer.mode);
+	uint64_t offset = 0;
+
+	// Resuming continues from the end of what the server already has.
+	if (response.IsOk() && transfer.resume && transfer.mode == FtpDataChannel::Mode::Binary) {
+		auto size = SendCommand("SIZE", path + filename);
+
+		if (size.GetStatus() == FtpResponse::Status::FileStatus) {
+			std::error_code error;
+			auto localSize = std::filesystem::file_size(transfer.file, error);
+			offset = String::From<std::optional<uint64_t>>(std::string(String::Trim(size.GetFullMessage()))).value_or(0);
+
+			if (error || offset > localSize)
+				offset = 0;
+		}
+
+		if (offset != 0)
+			response = SendCommand("REST", String::To(offset));
+	}
+
+	if (response.IsOk()) {
+		// Tell the server to start the transfer.
+		response = SendCommand(append ? "APPE" : "STOR", path + filename);
+
+		if (response.IsOk()) {
+			// Send the file data.
+			transfer.offset = offset;
+			transfer.transferred = data.SendFile(file, offset);
+
+			// Get the response from the server.
+			response = GetResponse();
+		}
+	}
+
+	std::fclose(file);
+	return response;
+}
 }
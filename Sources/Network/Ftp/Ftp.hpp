@@ -1,11 +1,14 @@
 #pragma once
 
+#include <optional>
+
 #include "Network/Tcp/TcpSocket.hpp"
 #include "Network/IpAddress.hpp"
 #include "FtpDataChannel.hpp"
 #include "FtpResponse.hpp"
 #include "FtpResponseDirectory.hpp"
 #include "FtpResponseListing.hpp"
+#include "FtpTransfer.hpp"
 
 namespace acid {
 /**
@@ -159,13 +162,15 @@ public:
 	 * The filename of the distant file is relative to the current working directory of the server,
 	 * and the local destination path is relative to the current directory of your application.
 	 * If a file with the same filename as the distant file already exists in the local destination path,
-	 * it will be overwritten.
+	 * it will be overwritten, unless resuming where the download continues from the end of that file.
 	 * @param remoteFile Filename of the distant file to download.
 	 * @param localPath The directory in which to put the file on the local computer.
 	 * @param mode Transfer mode.
+	 * @param resume Pass true to continue a partial download with REST, a failed download then keeps its partial file.
 	 * @return Server response to the request.
 	 */
-	FtpResponse Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary);
+	FtpResponse Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary,
+		bool resume = false);
 
 	/**
 	 * Upload a file to the server.
@@ -176,9 +181,21 @@ public:
 	 * @param remotePath The directory in which to put the file on the server.
 	 * @param mode Transfer mode.
 	 * @param append Pass true to append to or false to overwrite the remote file if it already exists.
+	 * @param resume Pass true to continue a partial upload with REST, from the size of the remote file.
 	 * @return Server response to the request.
 	 */
-	FtpResponse Upload(const std::string &localFile, const std::string &remotePath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary, bool append = false);
+	FtpResponse Upload(const std::string &localFile, const std::string &remotePath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary,
+		bool append = false, bool resume = false);
+
+	/**
+	 * Transfer many files over several connections at once.
+	 * Extra connections to the server are opened, logged in the same way and moved to the same working directory as this one.
+	 * Each connection takes the next file waiting until every file is transferred, so large files don't hold up small ones.
+	 * @param transfers The files to transfer.
+	 * @param connections The number of connections to transfer over, including this one.
+	 * @return The transfers, with their responses and throughput.
+	 */
+	std::vector<FtpTransfer> Transfer(std::vector<FtpTransfer> transfers, uint32_t connections = 4);
 
 	/**
 	 * Send a command to the FTP server.
@@ -193,6 +210,15 @@ public:
 	FtpResponse SendCommand(const std::string &command, const std::string &parameter = "");
 
 private:
+	/**
+	 * Runs a transfer, filling in its result.
+	 * @param transfer The transfer.
+	 * @param append Pass true to append uploads to the remote file.
+	 */
+	void Run(FtpTransfer &transfer, bool append = false);
+	FtpResponse RunDownload(FtpTransfer &transfer);
+	FtpResponse RunUpload(FtpTransfer &transfer, bool append);
+
 	/**
 	 * Receive a response from the server.
 	 * This function must be called after each call to SendCommand that expects a response.
@@ -204,5 +230,11 @@ private:
 	TcpSocket commandSocket;
 	/// Received command data that is yet to be processed.
 	std::string receiveBuffer;
+
+	/// Where the server was connected to and logged in with, to open more connections in the same way.
+	IpAddress server;
+	uint16_t port = 21;
+	Time timeout;
+	std::optional<std::pair<std::string, std::string>> credentials;
 };
 }
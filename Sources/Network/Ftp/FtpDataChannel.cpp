@@ -67,11 +67,11 @@ FtpResponse FtpDataChannel::Open(Mode mode) {
 
 void FtpDataChannel::Receive(std::ostream &stream) {
 	// Receive data.
-	char buffer[1024];
+	std::vector<char> buffer(BufferSize);
 	std::size_t received;
 
-	while (dataSocket.Receive(buffer, sizeof(buffer), received) == Socket::Status::Done) {
-		stream.write(buffer, static_cast<std::streamsize>(received));
+	while (dataSocket.Receive(buffer.data(), buffer.size(), received) == Socket::Status::Done) {
+		stream.write(buffer.data(), static_cast<std::streamsize>(received));
 
 		if (!stream.good()) {
 			Log::Error("FTP Error: Writing to the file has failed\n");
@@ -85,12 +85,12 @@ void FtpDataChannel::Receive(std::ostream &stream) {
 
 void FtpDataChannel::Send(std::istream &stream) {
 	// Send data.
-	char buffer[1024];
+	std::vector<char> buffer(BufferSize);
 	std::size_t count;
 
 	for (;;) {
 		// Read some data from the stream.
-		stream.read(buffer, sizeof(buffer));
+		stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 
 		if (!stream.good() && !stream.eof()) {
 			Log::Error("FTP Error: Reading from the file has failed\n");
@@ -101,7 +101,7 @@ void FtpDataChannel::Send(std::istream &stream) {
 
 		if (count > 0) {
 			// We could read more data from the stream: send them.
-			if (dataSocket.Send(buffer, count) != Socket::Status::Done) {
+			if (dataSocket.Send(buffer.data(), count) != Socket::Status::Done) {
 				break;
 			}
 		} else {
@@ -113,4 +113,36 @@ void FtpDataChannel::Send(std::istream &stream) {
 	// Close the data socket.
 	dataSocket.Disconnect();
 }
+
+uint64_t FtpDataChannel::SendFile(std::FILE *file, uint64_t offset) {
+	uint64_t total = 0;
+	std::size_t sent;
+
+	// Sent in blocks, so very large files don't overflow the size of a single send.
+	while (dataSocket.SendFile(file, offset + total, BufferSize * 16, sent) == Socket::Status::Done && sent > 0)
+		total += sent;
+
+	// Close the data socket.
+	dataSocket.Disconnect();
+	return total;
+}
+
+uint64_t FtpDataChannel::ReceiveFile(std::FILE *file) {
+	std::vector<char> buffer(BufferSize);
+	uint64_t total = 0;
+	std::size_t received;
+
+	while (dataSocket.Receive(buffer.data(), buffer.size(), received) == Socket::Status::Done) {
+		if (std::fwrite(buffer.data(), 1, received, file) != received) {
+			Log::Error("FTP Error: Writing to the file has failed\n");
+			break;
+		}
+
+		total += received;
+	}
+
+	// Close the data socket.
+	dataSocket.Disconnect();
+	return total;
+}
 }
@@ -23,6 +23,9 @@ public:
 		Ebcdic
 	};
 
+	/// Size of the fixed buffer data is streamed through.
+	static constexpr std::size_t BufferSize = 64 * 1024;
+
 	explicit FtpDataChannel(Ftp &owner);
 
 	FtpResponse Open(Mode mode);
@@ -31,6 +34,21 @@ public:
 
 	void Receive(std::ostream &stream);
 
+	/**
+	 * Sends a file from an offset to its end, without reading it into memory where the system allows.
+	 * @param file The file to send.
+	 * @param offset Offset in the file to start from.
+	 * @return The number of bytes sent.
+	 */
+	uint64_t SendFile(std::FILE *file, uint64_t offset);
+
+	/**
+	 * Receives data straight into a file at its current position.
+	 * @param file The file to write to.
+	 * @return The number of bytes received.
+	 */
+	uint64_t ReceiveFile(std::FILE *file);
+
 private:
 	/// Reference to the owner Ftp instance.
 	Ftp &ftp;
@@ -0,0 +1,16 @@
+#include "FtpTransfer.hpp"
+
+namespace acid {
+FtpTransfer::FtpTransfer(Direction direction, std::string file, std::string path, FtpDataChannel::Mode mode, bool resume) :
+	direction(direction),
+	file(std::move(file)),
+	path(std::move(path)),
+	mode(mode),
+	resume(resume) {
+}
+
+double FtpTransfer::GetThroughput() const {
+	auto seconds = elapsedTime.AsSeconds<double>();
+	return seconds > 0.0 ? static_cast<double>(transferred) / seconds : 0.0;
+}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Maths/Time.hpp"
+#include "FtpDataChannel.hpp"
+#include "FtpResponse.hpp"
+
+namespace acid {
+/**
+ * @brief Define a file to download or upload with {@link Ftp#Transfer}, and the result of transferring it.
+ */
+class ACID_EXPORT FtpTransfer {
+	friend class Ftp;
+public:
+	/**
+	 * @brief Enumeration of transfer directions.
+	 */
+	enum class Direction {
+		/// The remote file is downloaded into the local directory.
+		Download,
+		/// The local file is uploaded into the remote directory.
+		Upload
+	};
+
+	/**
+	 * Default constructor.
+	 * @param direction Direction of the transfer.
+	 * @param file Filename of the file to transfer, remote for downloads and local for uploads.
+	 * @param path The directory in which to put the file, local for downloads and remote for uploads.
+	 * @param mode Transfer mode.
+	 * @param resume Pass true to continue from the end of a partial destination file, only with binary mode.
+	 */
+	FtpTransfer(Direction direction, std::string file, std::string path, FtpDataChannel::Mode mode = FtpDataChannel::Mode::Binary,
+		bool resume = false);
+
+	Direction GetDirection() const { return direction; }
+	const std::string &GetFile() const { return file; }
+	const std::string &GetPath() const { return path; }
+	FtpDataChannel::Mode GetMode() const { return mode; }
+	bool IsResume() const { return resume; }
+
+	/**
+	 * Get the server response to the transfer.
+	 * @return Server response, with status FtpResponse::Status::InvalidResponse before the transfer ran.
+	 */
+	const FtpResponse &GetResponse() const { return response; }
+
+	/**
+	 * Get the offset the transfer resumed from.
+	 * @return The bytes that were already in the destination file.
+	 */
+	uint64_t GetOffset() const { return offset; }
+
+	/**
+	 * Get the number of bytes sent over the data connection.
+	 * @return The bytes transferred.
+	 */
+	uint64_t GetTransferred() const { return transferred; }
+
+	/**
+	 * Get the time taken by the transfer, from opening the data connection to the final response.
+	 * @return The time taken.
+	 */
+	const Time &GetElapsedTime() const { return elapsedTime; }
+
+	/**
+	 * Get the rate data was transferred at.
+	 * @return The throughput in bytes per second.
+	 */
+	double GetThroughput() const;
+
+private:
+	Direction direction;
+	std::string file;
+	std::string path;
+	FtpDataChannel::Mode mode;
+	bool resume;
+
+	FtpResponse response;
+	uint64_t offset = 0;
+	uint64_t transferred = 0;
+	Time elapsedTime;
+};
+}
@@ -1,9 +1,36 @@
 #include "Http.hpp"
 
+#include <algorithm>
+#include <fstream>
+
 #include "Engine/Log.hpp"
+#include "Network/NetworkMetrics.hpp"
 #include "Utils/String.hpp"
 
 namespace acid {
+/// Bytes received from a connection at once.
+static constexpr std::size_t ReceiveSize = 65536;
+/// Longest status line and fields, or chunk line, accepted from a server.
+static constexpr std::size_t MaxHeaderSize = 65536;
+
+/**
+ * Gets if a request can be sent again without changing its outcome, if the server may have already acted on it.
+ * @param method The method of the request.
+ * @return If requests with the method are idempotent.
+ */
+static bool IsIdempotent(HttpRequest::Method method) {
+	switch (method) {
+	case HttpRequest::Method::Get:
+	case HttpRequest::Method::Head:
+	case HttpRequest::Method::Put:
+	case HttpRequest::Method::Delete:
+	case HttpRequest::Method::Options:
+		return true;
+	default:
+		return false;
+	}
+}
+
 Http::Http() {
 }
 
@@ -12,6 +39,11 @@ Http::Http(const std::string &host, uint16_t port) :
 	SetHost(host, port);
 }
 
+Http::~Http() {
+	// Asynchronous requests are finished before the connections they use are closed.
+	worker = nullptr;
+}
+
 void Http::SetHost(const std::string &host, uint16_t port) {
 	// Check the protocol.
 	if (String::Lowercase(host.substr(0, 7)) == "http://") {
@@ -34,9 +66,54 @@ void Http::SetHost(const std::string &host, uint16_t port) {
 		hostName.erase(hostName.size() - 1);
 
 	this->host = {hostName};
+
+	// Connections to the previous host can't be used again.
+	std::unique_lock<std::mutex> lock(connectionMutex);
+	idleConnections.clear();
 }
 
 HttpResponse Http::SendRequest(const HttpRequest &request, const Time &timeout) {
+	return Send({request}, nullptr, timeout).front();
+}
+
+HttpResponse Http::SendRequest(const HttpRequest &request, const BodyCallback &onBody, const Time &timeout) {
+	return Send({request}, onBody, timeout).front();
+}
+
+HttpResponse Http::Download(const HttpRequest &request, const std::filesystem::path &filename, const Time &timeout) {
+	std::ofstream file;
+
+	return SendRequest(request, [&](const HttpResponse &response, const char *data, std::size_t size) {
+		auto status = static_cast<int>(response.GetStatus());
+		if (status < 200 || status >= 300)
+			return;
+
+		if (!file.is_open())
+			file.open(filename, std::ios::binary);
+		file.write(data, size);
+	}, timeout);
+}
+
+std::vector<HttpResponse> Http::SendRequests(const std::vector<HttpRequest> &requests, const Time &timeout) {
+	return Send(requests, nullptr, timeout);
+}
+
+std::future<HttpResponse> Http::SendRequestAsync(const HttpRequest &request, const CompleteCallback &onComplete, const Time &timeout) {
+	std::unique_lock<std::mutex> lock(workerMutex);
+
+	// One worker keeps requests in order and shares the pooled connections with other requests.
+	if (!worker)
+		worker = std::make_unique<ThreadPool>(1);
+
+	return worker->Enqueue([this, request, onComplete, timeout]() {
+		auto response = SendRequest(request, timeout);
+		if (onComplete)
+			onComplete(response);
+		return response;
+	});
+}
+
+std::string Http::Prepare(const HttpRequest &request) const {
 	// First make sure that the request is valid -- add missing mandatory fields.
 	HttpRequest toSend(request);
 
@@ -58,37 +135,239 @@ HttpResponse Http::SendRequest(const HttpRequest &request, const Time &timeout)
 	if (toSend.method == HttpRequest::Method::Post && !toSend.HasField("Content-Type"))
 		toSend.SetField("Content-Type", "application/x-www-form-urlencoded");
 
-	if (toSend.majorVersion * 10 + toSend.minorVersion >= 11 && !toSend.HasField("Connection"))
-		toSend.SetField("Connection", "close");
+	// HTTP/1.1 connections are persistent unless closed, HTTP/1.0 ones have to ask.
+	if (toSend.majorVersion * 10 + toSend.minorVersion < 11 && !toSend.HasField("Connection"))
+		toSend.SetField("Connection", "keep-alive");
+
+	return toSend.Prepare();
+}
+
+std::vector<HttpResponse> Http::Send(const std::vector<HttpRequest> &requests, const BodyCallback &onBody, const Time &timeout) {
+	std::vector<HttpResponse> responses(requests.size());
+	std::size_t next = 0;
+
+	while (next < requests.size()) {
+		auto connection = AcquireConnection(timeout);
+		if (!connection)
+			break;
+
+		// The remaining requests are sent together, then their responses are read in order.
+		std::string requestStr;
+		for (auto i = next; i < requests.size(); i++)
+			requestStr += Prepare(requests[i]);
+
+		auto keepAlive = false;
+		auto closed = false;
+		auto sendTime = Time::Now();
+		auto dropped = connection->socket.Send(requestStr.c_str(), requestStr.size()) != Socket::Status::Done;
+
+		while (!dropped && next < requests.size()) {
+			auto result = ReadResponse(*connection, requests[next], responses[next], onBody);
+			dropped = result == ReadResult::Dropped;
+
+			// Requests are never sent again after a failed response, it may have been acted on.
+			if (result == ReadResult::Failed || result == ReadResult::Dropped)
+				break;
+
+			// Pipelined responses are timed from when the requests were sent together.
+			auto elapsed = Time::Now() - sendTime;
+			latency.Record(elapsed);
+			NetworkMetrics::GetHttpLatency().Record(elapsed);
+
+			next++;
+			keepAlive = result == ReadResult::KeepAlive;
+			closed = result == ReadResult::Close;
+
+			if (!keepAlive)
+				break;
+		}
+
+		if (keepAlive && next == requests.size()) {
+			ReleaseConnection(std::move(connection));
+			break;
+		}
+
+		// The server ended the connection cleanly after a response, so the requests after it were not acted on.
+		if (closed)
+			continue;
+
+		// A pooled connection may have been closed by the server while idle, then the requests are sent again on another one.
+		// Only idempotent requests are sent again, the server may have acted on the others before closing.
+		auto retry = dropped && connection->reused && std::all_of(requests.begin() + next, requests.end(), [](const HttpRequest &request) {
+			return IsIdempotent(request.method);
+		});
+
+		if (!retry)
+			break;
+	}
+
+	return responses;
+}
 
-	// Prepare the response.
-	HttpResponse received;
+Http::ReadResult Http::ReadResponse(Connection &connection, const HttpRequest &request, HttpResponse &response, const BodyCallback &onBody) {
+	// Interim 1xx responses come before the final response and are skipped, except 101 which switches protocols.
+	auto interim = false;
+	int status;
 
-	// Connect the socket to the host.
-	if (connection.Connect(host, port, timeout) == Socket::Status::Done) {
-		// Convert the request to string and send it through the connected socket.
-		auto requestStr = toSend.Prepare();
+	do {
+		response = HttpResponse();
 
-		if (!requestStr.empty()) {
-			// Send it through the socket.
-			if (connection.Send(requestStr.c_str(), requestStr.size()) == Socket::Status::Done) {
-				// Wait for the server's response.
-				std::string receivedStr;
-				std::size_t size = 0;
-				char buffer[1024];
+		// Receive until the end of the status line and fields.
+		std::size_t headerEnd;
 
-				while (connection.Receive(buffer, sizeof(buffer), size) == Socket::Status::Done)
-					receivedStr.append(buffer, buffer + size);
+		while ((headerEnd = connection.buffer.find("\r\n\r\n", connection.bufferPos)) == std::string::npos) {
+			auto started = interim || connection.bufferPos != connection.buffer.size();
 
-				// Build the Response object from the received data.
-				received.Parse(receivedStr);
+			if (connection.buffer.size() - connection.bufferPos > MaxHeaderSize) {
+				response.status = HttpResponse::Status::InvalidResponse;
+				return ReadResult::Failed;
 			}
+
+			if (!connection.Fill())
+				return started ? ReadResult::Failed : ReadResult::Dropped;
+		}
+
+		std::istringstream in(connection.buffer.substr(connection.bufferPos, headerEnd + 4 - connection.bufferPos));
+		connection.bufferPos = headerEnd + 4;
+
+		if (!response.ParseHeader(in))
+			return ReadResult::Failed;
+
+		status = static_cast<int>(response.status);
+		interim = true;
+	} while (status >= 100 && status < 200 && status != 101);
+
+	auto onData = [&](const char *data, std::size_t size) {
+		if (onBody)
+			onBody(response, data, size);
+		else
+			response.body.append(data, size);
+	};
+
+	auto connectionField = String::Lowercase(response.GetField("connection"));
+	auto requestConnection = request.fields.find("connection");
+	auto keepAlive = connectionField != "close" && (response.majorVersion * 10 + response.minorVersion >= 11 || connectionField == "keep-alive") &&
+		(requestConnection == request.fields.end() || String::Lowercase(requestConnection->second) != "close");
+	auto result = keepAlive ? ReadResult::KeepAlive : ReadResult::Close;
+
+	// Responses to HEAD requests, and 1xx, 204 and 304 responses never have a body.
+	if (request.method == HttpRequest::Method::Head || (status >= 100 && status < 200) || status == 204 || status == 304)
+		return result;
+
+	if (String::Lowercase(response.GetField("transfer-encoding")) == "chunked") {
+		std::string line;
+
+		// Read all chunks, identified by a chunk-size not being 0, chunk extensions after the size are ignored.
+		while (true) {
+			if (!connection.ReadLine(line))
+				return ReadResult::Failed;
+
+			auto length = std::strtoull(line.c_str(), nullptr, 16);
+			if (length == 0)
+				break;
+
+			if (!connection.Read(length, onData) || !connection.ReadLine(line))
+				return ReadResult::Failed;
+		}
+
+		// Read all trailers (if present), up to the empty line that ends the response.
+		std::string trailers;
+
+		while (true) {
+			if (!connection.ReadLine(line))
+				return ReadResult::Failed;
+			if (line.empty())
+				break;
+			trailers += line + "\r\n";
+		}
+
+		std::istringstream trailerIn(trailers);
+		response.ParseFields(trailerIn);
+	} else if (auto contentLength = response.GetField("content-length"); !contentLength.empty()) {
+		if (!connection.Read(std::strtoull(contentLength.c_str(), nullptr, 10), onData))
+			return ReadResult::Failed;
+	} else {
+		// Without a length the body ends when the server closes the connection.
+		do {
+			onData(connection.buffer.data() + connection.bufferPos, connection.buffer.size() - connection.bufferPos);
+			connection.bufferPos = connection.buffer.size();
+		} while (connection.Fill());
+
+		return ReadResult::Close;
+	}
+
+	return result;
+}
+
+std::unique_ptr<Http::Connection> Http::AcquireConnection(const Time &timeout) {
+	{
+		std::unique_lock<std::mutex> lock(connectionMutex);
+
+		if (!idleConnections.empty()) {
+			auto connection = std::move(idleConnections.back());
+			idleConnections.pop_back();
+			return connection;
 		}
+	}
+
+	auto connection = std::make_unique<Connection>();
+	if (connection->socket.Connect(host, port, timeout) != Socket::Status::Done)
+		return nullptr;
+
+	return connection;
+}
+
+void Http::ReleaseConnection(std::unique_ptr<Connection> &&connection) {
+	connection->reused = true;
+
+	std::unique_lock<std::mutex> lock(connectionMutex);
+	if (idleConnections.size() < MaxIdleConnections)
+		idleConnections.emplace_back(std::move(connection));
+}
+
+bool Http::Connection::Fill() {
+	// Data that has been read is dropped first, so the buffer doesn't grow with the body.
+	if (bufferPos == buffer.size()) {
+		buffer.clear();
+		bufferPos = 0;
+	} else if (bufferPos > buffer.size() / 2) {
+		buffer.erase(0, bufferPos);
+		bufferPos = 0;
+	}
+
+	auto offset = buffer.size();
+	buffer.resize(offset + ReceiveSize);
+
+	std::size_t received = 0;
+	auto status = socket.Receive(&buffer[offset], ReceiveSize, received);
+	buffer.resize(offset + received);
+	return status == Socket::Status::Done && received > 0;
+}
+
+bool Http::Connection::ReadLine(std::string &line) {
+	std::size_t end;
+
+	while ((end = buffer.find("\r\n", bufferPos)) == std::string::npos) {
+		if (buffer.size() - bufferPos > MaxHeaderSize || !Fill())
+			return false;
+	}
+
+	line.assign(buffer, bufferPos, end - bufferPos);
+	bufferPos = end + 2;
+	return true;
+}
+
+bool Http::Connection::Read(uint64_t size, const std::function<void(const char *data, std::size_t size)> &onData) {
+	while (size > 0) {
+		if (bufferPos == buffer.size() && !Fill())
+			return false;
 
-		// Close the connection.
-		connection.Disconnect();
+		auto available = std::min<uint64_t>(size, buffer.size() - bufferPos);
+		onData(buffer.data() + bufferPos, static_cast<std::size_t>(available));
+		bufferPos += static_cast<std::size_t>(available);
+		size -= available;
 	}
 
-	return received;
+	return true;
 }
 }
@@ -1,7 +1,15 @@
 #pragma once
 
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+
 #include "Network/Tcp/TcpSocket.hpp"
 #include "Network/IpAddress.hpp"
+#include "Network/LatencyHistogram.hpp"
+#include "Utils/NonCopyable.hpp"
+#include "Utils/ThreadPool.hpp"
 #include "HttpRequest.hpp"
 #include "HttpResponse.hpp"
 
@@ -31,13 +39,26 @@ namespace acid {
  * acid::Http provides a simple function, SendRequest, to send a acid::HttpRequest and
  * return the corresponding acid::HttpResponse
  * from the server.
+ *
+ * Connections are kept alive and pooled, so repeated requests to the same host don't reconnect. Several requests can be
+ * pipelined on one connection with SendRequests, bodies can be streamed to a callback or a file as they arrive, and
+ * SendRequestAsync completes requests on a worker thread. Chunked responses are decoded.
  */
-class ACID_EXPORT Http {
+class ACID_EXPORT Http : NonCopyable {
 public:
+	/// Called with each part of a body as it is received, after the status and fields of the response are known.
+	using BodyCallback = std::function<void(const HttpResponse &response, const char *data, std::size_t size)>;
+	/// Called with the response of an asynchronous request, on the worker thread.
+	using CompleteCallback = std::function<void(const HttpResponse &response)>;
+
+	/// Number of idle connections kept open to the host.
+	static constexpr std::size_t MaxIdleConnections = 4;
+
 	/**
 	 * Default constructor.
 	 */
 	Http();
+	~Http();
 
 	/**
 	 * Construct the HTTP client with the target host.
@@ -74,14 +95,116 @@ public:
 	 */
 	HttpResponse SendRequest(const HttpRequest &request, const Time &timeout = 0s);
 
+	/**
+	 * Send a HTTP request, passing the body to a callback as it arrives instead of storing it in the response.
+	 * @param request Request to send.
+	 * @param onBody Callback for each part of the body.
+	 * @param timeout Maximum time to wait when connecting.
+	 * @return Server's response, without a body.
+	 */
+	HttpResponse SendRequest(const HttpRequest &request, const BodyCallback &onBody, const Time &timeout = 0s);
+
+	/**
+	 * Send a HTTP request, writing the body of a successful response to a file as it arrives.
+	 * @param request Request to send.
+	 * @param filename The file to write to, it is only created if the response has a 2xx status.
+	 * @param timeout Maximum time to wait when connecting.
+	 * @return Server's response, without a body.
+	 */
+	HttpResponse Download(const HttpRequest &request, const std::filesystem::path &filename, const Time &timeout = 0s);
+
+	/**
+	 * Send several HTTP requests pipelined on one connection, without waiting for each response before sending the next.
+	 * @param requests Requests to send.
+	 * @param timeout Maximum time to wait when connecting.
+	 * @return Server's responses, in the order of the requests.
+	 */
+	std::vector<HttpResponse> SendRequests(const std::vector<HttpRequest> &requests, const Time &timeout = 0s);
+
+	/**
+	 * Send a HTTP request from a worker thread, requests are completed in the order they were sent.
+	 * @param request Request to send.
+	 * @param onComplete Optional callback, called on the worker thread with the response.
+	 * @param timeout Maximum time to wait when connecting.
+	 * @return A future of the server's response.
+	 */
+	std::future<HttpResponse> SendRequestAsync(const HttpRequest &request, const CompleteCallback &onComplete = nullptr, const Time &timeout = 0s);
+
+	/**
+	 * Gets the time from sending requests to reading their whole response, these are also added to NetworkMetrics::GetHttpLatency.
+	 * @return The latency histogram.
+	 */
+	const LatencyHistogram &GetLatency() const { return latency; }
+
 private:
-	/// Connection to the host.
-	TcpSocket connection;
+	/**
+	 * @brief A connection to the host, with data received after the response being read.
+	 */
+	class Connection {
+	public:
+		/**
+		 * Receives more data into the buffer, dropping data that has been read.
+		 * @return If data was received.
+		 */
+		bool Fill();
+
+		/**
+		 * Reads a line ending with CRLF, without the line ending.
+		 * @param line The line.
+		 * @return If a line was read.
+		 */
+		bool ReadLine(std::string &line);
+
+		/**
+		 * Reads a number of bytes, passing each part to a callback as it is received.
+		 * @param size The number of bytes.
+		 * @param onData Callback for each part.
+		 * @return If all bytes were read.
+		 */
+		bool Read(uint64_t size, const std::function<void(const char *data, std::size_t size)> &onData);
+
+		TcpSocket socket;
+		std::string buffer;
+		std::size_t bufferPos = 0;
+		/// If a response has been read from this connection, so it came from the pool.
+		bool reused = false;
+	};
+
+	/**
+	 * @brief The result of reading a response.
+	 */
+	enum class ReadResult {
+		/// The response was read and the connection can be used again.
+		KeepAlive,
+		/// The response was read and the connection must be closed.
+		Close,
+		/// The response was incomplete or invalid.
+		Failed,
+		/// The connection was closed before any of the response was received.
+		Dropped
+	};
+
+	std::string Prepare(const HttpRequest &request) const;
+	ReadResult ReadResponse(Connection &connection, const HttpRequest &request, HttpResponse &response, const BodyCallback &onBody);
+	std::vector<HttpResponse> Send(const std::vector<HttpRequest> &requests, const BodyCallback &onBody, const Time &timeout);
+	std::unique_ptr<Connection> AcquireConnection(const Time &timeout);
+	void ReleaseConnection(std::unique_ptr<Connection> &&connection);
+
 	/// Web host address.
 	IpAddress host;
 	/// Web host name.
 	std::string hostName;
 	/// Port used for connection with host.
 	uint16_t port = 0;
+
+	/// Idle connections to the host, kept alive by the server.
+	std::vector<std::unique_ptr<Connection>> idleConnections;
+	std::mutex connectionMutex;
+
+	/// Worker for asynchronous requests, created on first use and destroyed first so it finishes while the pool exists.
+	std::unique_ptr<ThreadPool> worker;
+	std::mutex workerMutex;
+
+	LatencyHistogram latency;
 };
 }
@@ -6,7 +6,7 @@ namespace acid {
 HttpRequest::HttpRequest(const std::string &uri, Method method, const std::string &body) :
 	method(method),
 	majorVersion(1),
-	minorVersion(0) {
+	minorVersion(1) {
 	SetUri(uri);
 	SetBody(body);
 }
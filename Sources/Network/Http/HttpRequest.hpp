@@ -71,7 +71,7 @@ public:
 	void SetUri(const std::string &uri);
 
 	/**
-	 * Set the HTTP version for the request. The HTTP version is 1.0 by default.
+	 * Set the HTTP version for the request. The HTTP version is 1.1 by default, which keeps connections alive.
 	 * @param major Major HTTP version number.
 	 * @param minor Minor HTTP version number.
 	 */
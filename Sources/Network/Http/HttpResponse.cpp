@@ -18,9 +18,7 @@ std::string HttpResponse::GetField(const std::string &field) const {
 	return {};
 }
 
-void HttpResponse::Parse(const std::string &data) {
-	std::istringstream in(data);
-
+bool HttpResponse::ParseHeader(std::istream &in) {
 	// Extract the HTTP version from the first line.
 	std::string version;
 
@@ -31,7 +29,7 @@ void HttpResponse::Parse(const std::string &data) {
 		} else {
 			// Invalid HTTP version.
 			status = Status::InvalidResponse;
-			return;
+			return false;
 		}
 	}
 
@@ -43,7 +41,7 @@ void HttpResponse::Parse(const std::string &data) {
 	} else {
 		// Invalid status code.
 		this->status = Status::InvalidResponse;
-		return;
+		return false;
 	}
 
 	// Ignore the end of the first line.
@@ -51,36 +49,7 @@ void HttpResponse::Parse(const std::string &data) {
 
 	// Parse the other lines, which contain fields, one by one.
 	ParseFields(in);
-
-	body.clear();
-
-	// Determine whether the transfer is chunked.
-	if (String::Lowercase(GetField("transfer-encoding")) != "chunked") {
-		// Not chunked - just read everything at once.
-		std::copy(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(), std::back_inserter(body));
-	} else {
-		// Chunked - have to read chunk by chunk.
-		std::size_t length;
-
-		// Read all chunks, identified by a chunk-size not being 0.
-		while (in >> std::hex >> length) {
-			// Drop the rest of the line (chunk-extension).
-			in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-			// Copy the actual content data.
-			std::istreambuf_iterator<char> it = in;
-			std::istreambuf_iterator<char> itEnd;
-
-			for (std::size_t i = 0; i < length && it != itEnd; i++)
-				body.push_back(*it++);
-		}
-
-		// Drop the rest of the line (chunk-extension).
-		in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-		// Read all trailers (if present).
-		ParseFields(in);
-	}
+	return true;
 }
 
 void HttpResponse::ParseFields(std::istream &in) {
@@ -127,11 +127,11 @@ private:
 	using FieldTable = std::map<std::string, std::string>;
 
 	/**
-	 * Construct the header from a response string.
-	 * This function is used by Http to build the response of a request.
-	 * @param data Content of the response to parse.
+	 * Parses the status line and fields of a response.
+	 * @param in The stream to read from.
+	 * @return If the status line was valid.
 	 */
-	void Parse(const std::string &data);
+	bool ParseHeader(std::istream &in);
 
 	/**
 	 * Read values passed in the answer header.
@@ -0,0 +1,61 @@
+#include "LatencyHistogram.hpp"
+
+#include <sstream>
+
+namespace acid {
+void LatencyHistogram::Record(const Time &duration) {
+	auto microseconds = static_cast<uint64_t>(std::max<int64_t>(duration.AsMicroseconds<int64_t>(), 0));
+
+	// The bucket is the number of bits needed for the duration.
+	std::size_t index = 0;
+	while (index < BucketCount - 1 && (microseconds >> index) != 0)
+		index++;
+
+	buckets[index].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	total.fetch_add(microseconds, std::memory_order_relaxed);
+
+	for (auto longest = max.load(std::memory_order_relaxed); microseconds > longest && !max.compare_exchange_weak(longest, microseconds);) {
+	}
+}
+
+void LatencyHistogram::Reset() {
+	for (auto &bucket : buckets)
+		bucket = 0;
+
+	count = 0;
+	total = 0;
+	max = 0;
+}
+
+Time LatencyHistogram::GetMean() const {
+	auto recorded = GetCount();
+	return recorded ? Time::Microseconds(total.load(std::memory_order_relaxed) / recorded) : Time();
+}
+
+Time LatencyHistogram::GetPercentile(double fraction) const {
+	auto recorded = GetCount();
+	if (recorded == 0)
+		return {};
+
+	auto target = static_cast<uint64_t>(fraction * static_cast<double>(recorded));
+	uint64_t cumulative = 0;
+
+	for (std::size_t i = 0; i < BucketCount; i++) {
+		cumulative += GetBucket(i);
+
+		if (cumulative > target || cumulative == recorded)
+			return std::min(GetBucketLimit(i), GetMax());
+	}
+
+	return GetMax();
+}
+
+std::string LatencyHistogram::ToString() const {
+	std::stringstream stream;
+	stream << GetCount() << " recorded, mean " << GetMean().AsMilliseconds<float>() << "ms, 50% under "
+		<< GetPercentile(0.5).AsMilliseconds<float>() << "ms, 99% under " << GetPercentile(0.99).AsMilliseconds<float>() << "ms, max "
+		<< GetMax().AsMilliseconds<float>() << "ms";
+	return stream.str();
+}
+}
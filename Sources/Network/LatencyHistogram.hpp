@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+
+#include "Maths/Time.hpp"
+
+namespace acid {
+/**
+ * @brief A histogram of durations, such as the time taken to answer requests, that can be recorded into from any thread.
+ * Buckets double in width, bucket i holds durations under 2^i microseconds, so percentiles are within a factor of two.
+ */
+class ACID_EXPORT LatencyHistogram {
+public:
+	/// Number of buckets, the last holds every duration over about 18 minutes.
+	static constexpr std::size_t BucketCount = 31;
+
+	LatencyHistogram() = default;
+
+	/**
+	 * Records a duration.
+	 * @param duration The duration.
+	 */
+	void Record(const Time &duration);
+
+	void Reset();
+
+	uint64_t GetCount() const { return count.load(std::memory_order_relaxed); }
+	Time GetMean() const;
+	Time GetMax() const { return Time::Microseconds(max.load(std::memory_order_relaxed)); }
+
+	/**
+	 * Gets a duration that a fraction of the recorded durations are under.
+	 * @param fraction The fraction, 0.5 for the median.
+	 * @return The upper limit of the bucket the fraction falls in, or the longest duration if that is shorter.
+	 */
+	Time GetPercentile(double fraction) const;
+
+	uint64_t GetBucket(std::size_t index) const { return buckets[index].load(std::memory_order_relaxed); }
+
+	/**
+	 * Gets the duration the bucket at an index holds durations under.
+	 * @param index The index of the bucket.
+	 * @return The upper limit of the bucket.
+	 */
+	static Time GetBucketLimit(std::size_t index) { return Time::Microseconds(int64_t(1) << index); }
+
+	std::string ToString() const;
+
+private:
+	std::array<std::atomic<uint64_t>, BucketCount> buckets = {};
+	std::atomic<uint64_t> count = 0;
+	/// Sum and longest of the recorded durations in microseconds.
+	std::atomic<uint64_t> total = 0;
+	std::atomic<uint64_t> max = 0;
+};
+}
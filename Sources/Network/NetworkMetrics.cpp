@@ -0,0 +1,49 @@
+#include "NetworkMetrics.hpp"
+
+#include "Packet.hpp"
+
+namespace acid {
+NetworkMetrics::NetworkMetrics() :
+	lastDump(Time::Now()),
+	lastAllocations(Packet::GetAllocationCount()) {
+}
+
+void NetworkMetrics::Update() {
+	if (dumpInterval != 0s && Time::Now() - lastDump >= dumpInterval)
+		Dump();
+}
+
+LatencyHistogram &NetworkMetrics::GetHttpLatency() {
+	static LatencyHistogram httpLatency;
+	return httpLatency;
+}
+
+void NetworkMetrics::Dump() {
+	auto now = Time::Now();
+	auto elapsed = std::max((now - lastDump).AsSeconds<double>(), 0.001);
+	SocketMetrics sockets(SocketMetrics::Global());
+	auto changed = sockets - lastSockets;
+	auto allocations = Packet::GetAllocationCount();
+
+	Log::Out("Network: ", sockets.ToString(), '\n');
+	Log::Out("Network: ", static_cast<uint64_t>(changed.bytesSent / elapsed), " bytes/s sent, ",
+		static_cast<uint64_t>(changed.bytesReceived / elapsed), " bytes/s received, ",
+		static_cast<uint64_t>((changed.sendCalls + changed.receiveCalls) / elapsed), " calls/s, ",
+		static_cast<uint64_t>((allocations - lastAllocations) / elapsed), " packet allocations/s\n");
+
+	if (GetHttpLatency().GetCount() > 0)
+		Log::Out("Network: HTTP latency ", GetHttpLatency().ToString(), '\n');
+
+	lastDump = now;
+	lastSockets = sockets;
+	lastAllocations = allocations;
+}
+
+void NetworkMetrics::Reset() {
+	SocketMetrics::Global().Reset();
+	GetHttpLatency().Reset();
+	lastDump = Time::Now();
+	lastSockets.Reset();
+	lastAllocations = Packet::GetAllocationCount();
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Engine/Engine.hpp"
+#include "LatencyHistogram.hpp"
+#include "SocketMetrics.hpp"
+
+namespace acid {
+/**
+ * @brief Module that gathers the metrics of networking, and periodically writes them to the log.
+ * Socket counters are kept by each socket and totalled in SocketMetrics::Global, HTTP request latency is kept in a
+ * histogram, and Packet counts how often it allocates. These are available without the module, which only adds the dump.
+ */
+class ACID_EXPORT NetworkMetrics : public Module::Registrar<NetworkMetrics> {
+	inline static const bool Registered = Register(Stage::Post);
+public:
+	NetworkMetrics();
+
+	void Update() override;
+
+	/**
+	 * Gets the time from sending HTTP requests to reading their whole response, over every acid::Http.
+	 * @return The latency histogram.
+	 */
+	static LatencyHistogram &GetHttpLatency();
+
+	/**
+	 * Writes every metric, with the rates since the last dump.
+	 */
+	void Dump();
+
+	/**
+	 * Resets every metric, and the rates since the last dump.
+	 */
+	void Reset();
+
+	const Time &GetDumpInterval() const { return dumpInterval; }
+
+	/**
+	 * Sets how often metrics are written to the log.
+	 * @param dumpInterval The time between dumps, 0s to never dump.
+	 */
+	void SetDumpInterval(const Time &dumpInterval) { this->dumpInterval = dumpInterval; }
+
+private:
+	Time dumpInterval;
+	Time lastDump;
+	SocketMetrics lastSockets;
+	uint64_t lastAllocations = 0;
+};
+}
@@ -1,5 +1,6 @@
 #include "Packet.hpp"
 
+#include <atomic>
 #include <cstring>
 #include <cwchar>
 #if defined(ACID_BUILD_WINDOWS)
@@ -11,6 +12,9 @@
 #include "Socket.hpp"
 
 namespace acid {
+/// Number of times the data of any packet has been allocated.
+static std::atomic<uint64_t> allocationCount = 0;
+
 Packet::Packet() :
 	isValid(true) {
 }
@@ -18,6 +22,10 @@ Packet::Packet() :
 void Packet::Append(const void *data, std::size_t sizeInBytes) {
 	if (data && (sizeInBytes > 0)) {
 		auto start = this->data.size();
+
+		if (start + sizeInBytes > this->data.capacity())
+			allocationCount.fetch_add(1, std::memory_order_relaxed);
+
 		this->data.resize(start + sizeInBytes);
 		std::memcpy(&this->data[start], data, sizeInBytes);
 	}
@@ -29,6 +37,17 @@ void Packet::Clear() {
 	isValid = true;
 }
 
+void Packet::Reserve(std::size_t sizeInBytes) {
+	if (sizeInBytes > data.capacity())
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	data.reserve(sizeInBytes);
+}
+
+uint64_t Packet::GetAllocationCount() {
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
 const void *Packet::GetData() const {
 	return !data.empty() ? &data[0] : nullptr;
 }
@@ -25,7 +25,10 @@ namespace acid {
  * corrupted if that happens.
  */
 class ACID_EXPORT Packet {
+	friend class BitReader;
+	friend class BitWriter;
 	friend class TcpSocket;
+	friend class UdpConnection;
 	friend class UdpSocket;
 
 public:
@@ -47,9 +50,22 @@ public:
 
 	/**
 	 * Clear the packet, after calling Clear, the packet is empty.
+	 * The memory used by the data is kept, so the packet can be refilled without allocating.
 	 */
 	void Clear();
 
+	/**
+	 * Reserves memory for data, so appending up to this many bytes will not allocate.
+	 * @param sizeInBytes Number of bytes to reserve.
+	 */
+	void Reserve(std::size_t sizeInBytes);
+
+	/**
+	 * Gets the number of times the data of any packet has grown into new memory, to find code that appends without reserving.
+	 * @return The number of allocations.
+	 */
+	static uint64_t GetAllocationCount();
+
 	/**
 	 * Get a pointer to the data contained in the packet.
 	 * Warning: the returned pointer may become invalid after  you append data to the packet,
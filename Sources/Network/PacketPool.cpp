@@ -0,0 +1,44 @@
+#include "PacketPool.hpp"
+
+namespace acid {
+PacketPool::PacketPool(std::size_t capacity, std::size_t count) :
+	capacity(capacity) {
+	packets.reserve(count);
+
+	for (std::size_t i = 0; i < count; i++) {
+		auto packet = std::make_unique<Packet>();
+		packet->Reserve(capacity);
+		packets.emplace_back(std::move(packet));
+	}
+}
+
+std::unique_ptr<Packet> PacketPool::Acquire() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (!packets.empty()) {
+			auto packet = std::move(packets.back());
+			packets.pop_back();
+			return packet;
+		}
+	}
+
+	auto packet = std::make_unique<Packet>();
+	packet->Reserve(capacity);
+	return packet;
+}
+
+void PacketPool::Release(std::unique_ptr<Packet> &&packet) {
+	if (!packet)
+		return;
+
+	packet->Clear();
+	std::unique_lock<std::mutex> lock(mutex);
+	packets.emplace_back(std::move(packet));
+}
+
+std::size_t PacketPool::GetFreeCount() const {
+	std::unique_lock<std::mutex> lock(mutex);
+	return packets.size();
+}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Packet.hpp"
+
+namespace acid {
+/**
+ * @brief Class that recycles packets with a fixed amount of reserved memory.
+ * Packets acquired from the pool can be filled up to the capacity without allocating,
+ * and released packets are cleared and kept for reuse, so sending and receiving each tick does not allocate.
+ */
+class ACID_EXPORT PacketPool {
+public:
+	/// Capacity that fits the payload of a UDP datagram in one Ethernet frame.
+	static constexpr std::size_t DefaultCapacity = 1472;
+
+	/**
+	 * Creates a new packet pool.
+	 * @param capacity The number of bytes reserved in each packet.
+	 * @param count The number of packets to create up front.
+	 */
+	explicit PacketPool(std::size_t capacity = DefaultCapacity, std::size_t count = 0);
+
+	/**
+	 * Takes an empty packet from the pool, a new packet is created if the pool is empty.
+	 * @return The packet.
+	 */
+	std::unique_ptr<Packet> Acquire();
+
+	/**
+	 * Clears a packet and returns it to the pool.
+	 * @param packet The packet to return.
+	 */
+	void Release(std::unique_ptr<Packet> &&packet);
+
+	std::size_t GetCapacity() const { return capacity; }
+
+	/**
+	 * Gets the number of packets waiting in the pool.
+	 * @return The number of free packets.
+	 */
+	std::size_t GetFreeCount() const;
+
+private:
+	std::size_t capacity;
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<Packet>> packets;
+};
+}
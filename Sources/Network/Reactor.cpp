@@ -0,0 +1,464 @@
+#include "Reactor.hpp"
+
+namespace acid {
+/// Longest the reactor waits on the selector with nothing to do.
+static constexpr Time MaxWait = 100ms;
+/// How often queued writes are retried, the selector only reports when sockets can be read.
+static constexpr Time WriteRetry = 1ms;
+/// Wait used while connections have packets buffered, a timeout of 0s would wait forever.
+static constexpr Time BufferedWait = 1us;
+
+Reactor::Reactor() :
+	events(EventCapacity) {
+	wakeSocket.Bind(0, IpAddress::LocalHost);
+	wakeSocket.SetBlocking(false);
+	selector.Add(wakeSocket);
+
+	worker = std::thread(std::bind(&Reactor::ThreadRun, this));
+}
+
+Reactor::~Reactor() {
+	stop = true;
+
+	Wake();
+	worker.join();
+
+	for (auto &[socket, connection] : sockets)
+		connection->socket.Disconnect();
+}
+
+void Reactor::Update() {
+	Event event;
+
+	while (Poll(event)) {
+		switch (event.type) {
+		case EventType::Accepted:
+			onAccepted(event.connection, event.port);
+			break;
+		case EventType::Received:
+			onReceived(event.connection, *event.packet);
+			break;
+		case EventType::Writable:
+			onWritable(event.connection);
+			break;
+		case EventType::Timeout:
+			onTimeout(event.connection);
+			break;
+		case EventType::Disconnected:
+			onDisconnected(event.connection);
+			break;
+		}
+
+		Release(event);
+	}
+}
+
+uint16_t Reactor::Listen(uint16_t port, const IpAddress &address) {
+	auto listener = std::make_shared<TcpListener>();
+	if (listener->Listen(port, address) != Socket::Status::Done)
+		return 0;
+
+	listener->SetBlocking(false);
+	auto localPort = listener->GetLocalPort();
+
+	Queue([this, listener, localPort]() {
+		auto &instance = listeners[localPort];
+		if (instance)
+			selector.Remove(*instance);
+
+		instance = listener;
+		selector.Add(*instance);
+	});
+	return localPort;
+}
+
+void Reactor::StopListening(uint16_t port) {
+	Queue([this, port]() {
+		auto it = listeners.find(port);
+		if (it == listeners.end())
+			return;
+
+		selector.Remove(*it->second);
+		listeners.erase(it);
+	});
+}
+
+Reactor::ConnectionId Reactor::Connect(const IpAddress &remoteAddress, uint16_t remotePort, const Time &timeout) {
+	auto connection = std::make_shared<Connection>();
+	if (connection->socket.Connect(remoteAddress, remotePort, timeout) != Socket::Status::Done)
+		return 0;
+
+	connection->id = nextConnectionId++;
+	connection->socket.SetBlocking(false);
+
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		connections[connection->id] = connection;
+	}
+
+	Queue([this, connection]() {
+		AddConnection(connection);
+	});
+	return connection->id;
+}
+
+bool Reactor::Send(ConnectionId connection, const Packet &packet) {
+	auto instance = Find(connection);
+	if (!instance)
+		return false;
+
+	{
+		std::unique_lock<std::mutex> lock(instance->writeMutex);
+
+		if (instance->closing)
+			return false;
+
+		if (instance->queuedBytes + packet.GetDataSize() > writeLimit && !instance->writeQueue.empty()) {
+			instance->refused = true;
+			return false;
+		}
+
+		auto queued = packetPool.Acquire();
+		*queued = packet;
+		instance->queuedBytes += queued->GetDataSize();
+		instance->writeQueue.emplace_back(std::move(queued));
+
+		// The connection is already waiting to be written.
+		if (instance->flushing)
+			return true;
+
+		instance->flushing = true;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(commandsMutex);
+		writable.emplace_back(std::move(instance));
+	}
+
+	Wake();
+	return true;
+}
+
+void Reactor::Disconnect(ConnectionId connection) {
+	auto instance = Find(connection);
+	if (!instance)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(instance->writeMutex);
+		instance->closing = true;
+	}
+
+	Queue([this, instance]() {
+		// The connection is closed by the reactor once its queue is written.
+		if (std::find(flushing.begin(), flushing.end(), instance) == flushing.end())
+			flushing.emplace_back(instance);
+	});
+}
+
+void Reactor::SetTimeout(ConnectionId connection, const Time &timeout) {
+	Queue([this, connection, timeout]() {
+		if (auto instance = Find(connection)) {
+			instance->timeout = timeout;
+			instance->lastReceived = Time::Now();
+		}
+	});
+}
+
+std::size_t Reactor::GetQueuedBytes(ConnectionId connection) const {
+	auto instance = Find(connection);
+	return instance ? instance->queuedBytes.load() : 0;
+}
+
+bool Reactor::Poll(Event &event) {
+	return events.pop(event);
+}
+
+void Reactor::Release(Event &event) {
+	if (event.packet)
+		packetPool.Release(std::move(event.packet));
+}
+
+void Reactor::ThreadRun() {
+	std::vector<std::function<void()>> runCommands;
+	std::vector<std::shared_ptr<Connection>> newWritable;
+
+	while (!stop) {
+		// Events that did not fit are posted before anything new.
+		while (!backlog.empty() && events.push(std::move(backlog.front())))
+			backlog.pop_front();
+
+		auto wait = CheckTimeouts();
+
+		if (!flushing.empty() || !backlog.empty())
+			wait = std::min(wait, WriteRetry);
+
+		if (backlog.empty() && !events.full()) {
+			// Buffered packets are not reported by the selector, so it is only polled while they are waiting to be read.
+			selector.Wait(buffered.empty() ? wait : BufferedWait);
+		} else {
+			// Sockets that can be read are left unread until the game thread catches up.
+			std::this_thread::sleep_for(std::chrono::microseconds(wait));
+		}
+
+		if (selector.IsReady(wakeSocket)) {
+			woken = false;
+			char data[16];
+			std::size_t received;
+			IpAddress address;
+			uint16_t port;
+
+			while (wakeSocket.Receive(data, sizeof(data), received, address, port) == Socket::Status::Done) {
+			}
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(commandsMutex);
+			runCommands.swap(commands);
+			newWritable.swap(writable);
+		}
+
+		flushing.insert(flushing.end(), newWritable.begin(), newWritable.end());
+		newWritable.clear();
+
+		for (auto &command : runCommands)
+			command();
+
+		runCommands.clear();
+
+		if (backlog.empty()) {
+			for (auto &[port, listener] : listeners) {
+				if (selector.IsReady(*listener))
+					Accept(*listener);
+			}
+
+			// Reading may close connections, which removes them from the map.
+			std::vector<std::shared_ptr<Connection>> ready;
+			ready.swap(buffered);
+
+			for (auto socket : selector.GetReadySockets()) {
+				if (auto it = sockets.find(socket); it != sockets.end() && std::find(ready.begin(), ready.end(), it->second) == ready.end())
+					ready.emplace_back(it->second);
+			}
+
+			for (const auto &connection : ready)
+				Read(connection);
+		}
+
+		std::vector<std::shared_ptr<Connection>> closing;
+
+		for (auto it = flushing.begin(); it != flushing.end();) {
+			if (Flush(**it)) {
+				if ((*it)->closing)
+					closing.emplace_back(*it);
+
+				it = flushing.erase(it);
+				continue;
+			}
+
+			++it;
+		}
+
+		for (const auto &connection : closing)
+			Close(connection);
+	}
+}
+
+void Reactor::Wake() {
+	if (woken.exchange(true))
+		return;
+
+	uint8_t data = 0;
+	wakeSocket.Send(&data, sizeof(data), IpAddress::LocalHost, wakeSocket.GetLocalPort());
+}
+
+void Reactor::Queue(std::function<void()> &&command) {
+	{
+		std::unique_lock<std::mutex> lock(commandsMutex);
+		commands.emplace_back(std::move(command));
+	}
+
+	Wake();
+}
+
+void Reactor::Post(Event &&event) {
+	if (!backlog.empty() || !events.push(std::move(event)))
+		backlog.emplace_back(std::move(event));
+}
+
+void Reactor::AddConnection(const std::shared_ptr<Connection> &connection) {
+	connection->lastReceived = Time::Now();
+	sockets[&connection->socket] = connection;
+	selector.Add(connection->socket);
+}
+
+void Reactor::Accept(TcpListener &listener) {
+	while (true) {
+		auto connection = std::make_shared<Connection>();
+		if (listener.Accept(connection->socket) != Socket::Status::Done)
+			break;
+
+		connection->id = nextConnectionId++;
+		connection->socket.SetBlocking(false);
+
+		{
+			std::unique_lock<std::mutex> lock(connectionsMutex);
+			connections[connection->id] = connection;
+		}
+
+		AddConnection(connection);
+
+		Event event;
+		event.type = EventType::Accepted;
+		event.connection = connection->id;
+		event.port = listener.GetLocalPort();
+		Post(std::move(event));
+	}
+}
+
+void Reactor::Read(const std::shared_ptr<Connection> &connection) {
+	// Packets are only read while they fit in the queue, the rest are left in the socket or its receive buffer.
+	while (true) {
+		if (!backlog.empty() || events.full()) {
+			// Whole packets left in the receive buffer are read again once there is room, the selector won't report them.
+			if (connection->socket.HasBufferedPacket())
+				buffered.emplace_back(connection);
+			return;
+		}
+
+		auto packet = packetPool.Acquire();
+
+		switch (connection->socket.Receive(*packet)) {
+		case Socket::Status::Done: {
+			connection->lastReceived = Time::Now();
+
+			Event event;
+			event.type = EventType::Received;
+			event.connection = connection->id;
+			event.packet = std::move(packet);
+			Post(std::move(event));
+			break;
+		}
+		case Socket::Status::NotReady:
+		case Socket::Status::Partial:
+			connection->lastReceived = Time::Now();
+			packetPool.Release(std::move(packet));
+			return;
+		default:
+			packetPool.Release(std::move(packet));
+			Close(connection);
+			return;
+		}
+	}
+}
+
+bool Reactor::Flush(Connection &connection) {
+	std::unique_lock<std::mutex> lock(connection.writeMutex);
+
+	while (!connection.writeQueue.empty()) {
+		auto &packet = connection.writeQueue.front();
+		auto status = connection.socket.Send(*packet);
+
+		if (status == Socket::Status::NotReady || status == Socket::Status::Partial)
+			break;
+
+		if (status != Socket::Status::Done) {
+			// The connection is closed by the next read, the rest of its queue can't be written.
+			for (auto &queued : connection.writeQueue)
+				packetPool.Release(std::move(queued));
+
+			connection.writeQueue.clear();
+			connection.queuedBytes = 0;
+			break;
+		}
+
+		connection.queuedBytes -= packet->GetDataSize();
+		packetPool.Release(std::move(packet));
+		connection.writeQueue.pop_front();
+	}
+
+	if (connection.refused && connection.queuedBytes <= writeLimit / 2) {
+		connection.refused = false;
+
+		Event event;
+		event.type = EventType::Writable;
+		event.connection = connection.id;
+		Post(std::move(event));
+	}
+
+	if (!connection.writeQueue.empty())
+		return false;
+
+	connection.flushing = false;
+	return true;
+}
+
+void Reactor::Close(const std::shared_ptr<Connection> &connection) {
+	if (sockets.erase(&connection->socket) == 0)
+		return;
+
+	selector.Remove(connection->socket);
+	connection->socket.Disconnect();
+
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		connections.erase(connection->id);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(connection->writeMutex);
+		connection->closing = true;
+
+		for (auto &queued : connection->writeQueue)
+			packetPool.Release(std::move(queued));
+
+		connection->writeQueue.clear();
+		connection->queuedBytes = 0;
+	}
+
+	flushing.erase(std::remove(flushing.begin(), flushing.end(), connection), flushing.end());
+	buffered.erase(std::remove(buffered.begin(), buffered.end(), connection), buffered.end());
+
+	Event event;
+	event.type = EventType::Disconnected;
+	event.connection = connection->id;
+	Post(std::move(event));
+}
+
+Time Reactor::CheckTimeouts() {
+	auto now = Time::Now();
+	auto wait = MaxWait;
+	std::vector<std::shared_ptr<Connection>> timedOut;
+
+	for (auto &[socket, connection] : sockets) {
+		if (connection->timeout == 0s)
+			continue;
+
+		auto deadline = connection->lastReceived + connection->timeout;
+
+		if (deadline <= now) {
+			timedOut.emplace_back(connection);
+			continue;
+		}
+
+		wait = std::min(wait, deadline - now);
+	}
+
+	for (const auto &connection : timedOut) {
+		Event event;
+		event.type = EventType::Timeout;
+		event.connection = connection->id;
+		Post(std::move(event));
+
+		Close(connection);
+	}
+
+	return wait;
+}
+
+std::shared_ptr<Reactor::Connection> Reactor::Find(ConnectionId connection) const {
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	auto it = connections.find(connection);
+	return it != connections.end() ? it->second : nullptr;
+}
+}
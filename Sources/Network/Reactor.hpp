@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Engine/Engine.hpp"
+#include "Utils/Delegate.hpp"
+#include "Utils/LockFreeQueue.hpp"
+#include "Tcp/TcpListener.hpp"
+#include "Tcp/TcpSocket.hpp"
+#include "Udp/UdpSocket.hpp"
+#include "PacketPool.hpp"
+#include "SocketSelector.hpp"
+
+namespace acid {
+/**
+ * @brief Module that owns TCP listeners and connections, and serves them from its own thread.
+ * The reactor thread accepts connections, reads whole packets, writes queued packets and times out idle connections.
+ * What it completes is posted to the game thread through a acid::LockFreeQueue, and dispatched to the delegates in
+ * {@link Reactor#Update}, so the game thread never waits on a socket.
+ *
+ * Each connection has a queue of packets to write, {@link Reactor#Send} refuses packets once the queue holds more than the
+ * write limit, and {@link Reactor#OnWritable} is called once it has drained. When the game thread falls behind and the
+ * queue of events is full the reactor stops reading, so slow consumers push back on the peers sending to them.
+ */
+class ACID_EXPORT Reactor : public Module::Registrar<Reactor> {
+	inline static const bool Registered = Register(Stage::Pre);
+public:
+	using ConnectionId = uint32_t;
+
+	enum class EventType : uint8_t {
+		/// A listener accepted the connection.
+		Accepted,
+		/// A whole packet was received.
+		Received,
+		/// The write queue drained after a send was refused.
+		Writable,
+		/// The connection was idle for longer than its timeout, it is disconnected next.
+		Timeout,
+		/// The connection was closed, by either side.
+		Disconnected
+	};
+
+	class Event {
+	public:
+		EventType type = EventType::Disconnected;
+		ConnectionId connection = 0;
+		/// The port of the listener that accepted the connection.
+		uint16_t port = 0;
+		/// The packet received, taken from {@link Reactor#GetPacketPool}.
+		std::unique_ptr<Packet> packet;
+	};
+
+	/// Number of events that can wait for the game thread before the reactor stops reading.
+	static constexpr std::size_t EventCapacity = 4096;
+	/// Default bytes a connection may have queued before sends are refused.
+	static constexpr std::size_t DefaultWriteLimit = 1024 * 1024;
+
+	Reactor();
+	~Reactor();
+
+	/**
+	 * Dispatches every event waiting in the queue to the delegates.
+	 */
+	void Update() override;
+
+	/**
+	 * Starts listening for connections, accepted connections are reported with {@link Reactor#OnAccepted}.
+	 * @param port The port to listen on, 0 for any free port.
+	 * @param address The address of the interface to listen on.
+	 * @return The port listened on, 0 if the listener could not be bound.
+	 */
+	uint16_t Listen(uint16_t port, const IpAddress &address = IpAddress::Any);
+
+	/**
+	 * Stops listening on a port, connections already accepted are kept.
+	 * @param port The port listened on.
+	 */
+	void StopListening(uint16_t port);
+
+	/**
+	 * Connects to a remote peer on the calling thread, then hands the connection to the reactor.
+	 * @param remoteAddress The address of the remote peer.
+	 * @param remotePort The port of the remote peer.
+	 * @param timeout Maximum time to wait, (use 0s for infinity).
+	 * @return The id of the connection, 0 if it could not connect.
+	 */
+	ConnectionId Connect(const IpAddress &remoteAddress, uint16_t remotePort, const Time &timeout = 0s);
+
+	/**
+	 * Queues a copy of a packet to be written to a connection, can be called from any thread.
+	 * @param connection The id of the connection.
+	 * @param packet The packet to send.
+	 * @return If the packet was queued, false if the connection is closed or its write queue is over the limit.
+	 */
+	bool Send(ConnectionId connection, const Packet &packet);
+
+	/**
+	 * Closes a connection once the packets queued for it are written, or could not be.
+	 * @param connection The id of the connection.
+	 */
+	void Disconnect(ConnectionId connection);
+
+	/**
+	 * Sets how long a connection may go without receiving before it times out.
+	 * @param connection The id of the connection.
+	 * @param timeout The idle time, 0s to never time out.
+	 */
+	void SetTimeout(ConnectionId connection, const Time &timeout);
+
+	/**
+	 * Gets the number of bytes queued to be written to a connection.
+	 * @param connection The id of the connection.
+	 * @return The bytes queued, 0 if the connection is closed.
+	 */
+	std::size_t GetQueuedBytes(ConnectionId connection) const;
+
+	/**
+	 * Takes the next event from the queue, for use instead of the delegates when the module is not updated by the engine.
+	 * The packet of the event should be given back with {@link Reactor#Release}.
+	 * @param event The event to fill.
+	 * @return If there was an event.
+	 */
+	bool Poll(Event &event);
+
+	/**
+	 * Returns the packet of an event taken with {@link Reactor#Poll} to the pool.
+	 * @param event The event.
+	 */
+	void Release(Event &event);
+
+	std::size_t GetWriteLimit() const { return writeLimit; }
+	void SetWriteLimit(std::size_t writeLimit) { this->writeLimit = writeLimit; }
+
+	PacketPool &GetPacketPool() { return packetPool; }
+
+	Delegate<void(ConnectionId, uint16_t)> &OnAccepted() { return onAccepted; }
+	Delegate<void(ConnectionId, Packet &)> &OnReceived() { return onReceived; }
+	Delegate<void(ConnectionId)> &OnWritable() { return onWritable; }
+	Delegate<void(ConnectionId)> &OnTimeout() { return onTimeout; }
+	Delegate<void(ConnectionId)> &OnDisconnected() { return onDisconnected; }
+
+private:
+	class Connection {
+	public:
+		ConnectionId id = 0;
+		TcpSocket socket;
+
+		/// Guards the write queue, which is filled from any thread and written by the reactor.
+		std::mutex writeMutex;
+		std::deque<std::unique_ptr<Packet>> writeQueue;
+		std::atomic<std::size_t> queuedBytes = 0;
+		/// If the connection is waiting on the reactor to write its queue.
+		bool flushing = false;
+		/// If a send was refused, so the reactor posts an event once the queue drains.
+		bool refused = false;
+		/// If the connection is closed once its queue is written.
+		std::atomic<bool> closing = false;
+
+		/// Only used by the reactor thread.
+		Time lastReceived;
+		Time timeout;
+	};
+
+	void ThreadRun();
+	void Wake();
+	void Queue(std::function<void()> &&command);
+	void Post(Event &&event);
+
+	void AddConnection(const std::shared_ptr<Connection> &connection);
+	void Accept(TcpListener &listener);
+	void Read(const std::shared_ptr<Connection> &connection);
+	/**
+	 * Writes as much of the queue of a connection as the socket takes.
+	 * @param connection The connection.
+	 * @return If the queue was written, or can't be.
+	 */
+	bool Flush(Connection &connection);
+	void Close(const std::shared_ptr<Connection> &connection);
+	Time CheckTimeouts();
+	std::shared_ptr<Connection> Find(ConnectionId connection) const;
+
+	PacketPool packetPool;
+	std::atomic<std::size_t> writeLimit = DefaultWriteLimit;
+	std::atomic<ConnectionId> nextConnectionId = 1;
+
+	/// Events waiting for the game thread, and the events that did not fit in the queue.
+	LockFreeQueue<Event> events;
+	std::deque<Event> backlog;
+
+	/// Connections by id, for finding from any thread. Only the reactor thread erases from this map.
+	mutable std::mutex connectionsMutex;
+	std::unordered_map<ConnectionId, std::shared_ptr<Connection>> connections;
+
+	/// Commands run on the reactor thread, and the connections waiting to be written.
+	std::mutex commandsMutex;
+	std::vector<std::function<void()>> commands;
+	std::vector<std::shared_ptr<Connection>> writable;
+
+	/// Only used by the reactor thread.
+	SocketSelector selector;
+	std::unordered_map<uint16_t, std::shared_ptr<TcpListener>> listeners;
+	std::unordered_map<const Socket *, std::shared_ptr<Connection>> sockets;
+	std::vector<std::shared_ptr<Connection>> flushing;
+	/// Connections with whole packets in their receive buffer that did not fit in the queue.
+	std::vector<std::shared_ptr<Connection>> buffered;
+
+	/// A datagram sent to this socket wakes the reactor from waiting on the selector.
+	UdpSocket wakeSocket;
+	std::atomic<bool> woken = false;
+
+	std::atomic<bool> stop = false;
+	std::thread worker;
+
+	Delegate<void(ConnectionId, uint16_t)> onAccepted;
+	Delegate<void(ConnectionId, Packet &)> onReceived;
+	Delegate<void(ConnectionId)> onWritable;
+	Delegate<void(ConnectionId)> onTimeout;
+	Delegate<void(ConnectionId)> onDisconnected;
+};
+}
@@ -0,0 +1,252 @@
+#include "EntitySnapshot.hpp"
+
+#include <cstring>
+
+#include "Network/BitStream.hpp"
+#include "Scenes/Entity.hpp"
+
+namespace acid {
+/// Deepest node that will be read, so a corrupt packet can't recurse forever.
+static constexpr uint32_t MaxNodeDepth = 64;
+
+static void Flatten(const Node &node, std::vector<const Node *> &fields, uint64_t &layout) {
+	layout = String::fnv1a_64(node.GetName(), layout);
+	layout = (layout ^ static_cast<uint64_t>(node.GetType())) * 0x100000001b3;
+	layout = (layout ^ node.GetProperties().size()) * 0x100000001b3;
+
+	if (node.GetProperties().empty()) {
+		fields.emplace_back(&node);
+		return;
+	}
+
+	for (const auto &property : node.GetProperties())
+		Flatten(property, fields, layout);
+}
+
+static void GetLeaves(Node &node, std::vector<Node *> &leaves) {
+	if (node.GetProperties().empty()) {
+		leaves.emplace_back(&node);
+		return;
+	}
+
+	for (auto &property : node.GetProperties())
+		GetLeaves(property, leaves);
+}
+
+static void WriteValue(BitWriter &writer, const Node &field) {
+	switch (field.GetType()) {
+	case Node::Type::Object:
+	case Node::Type::Array:
+	case Node::Type::Null:
+		break;
+	case Node::Type::Boolean:
+		writer.WriteBool(String::From<bool>(field.GetValue()));
+		break;
+	case Node::Type::Integer:
+		writer.WriteSignedVarint(String::From<int64_t>(field.GetValue()));
+		break;
+	case Node::Type::Decimal: {
+		// Components store decimals from floats, so 32 bits keep all of their precision.
+		auto value = String::From<float>(field.GetValue());
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		writer.WriteBits(bits, 32);
+		break;
+	}
+	default:
+		writer.WriteString(field.GetValue());
+		break;
+	}
+}
+
+static bool ReadValue(BitReader &reader, Node &field) {
+	switch (field.GetType()) {
+	case Node::Type::Object:
+	case Node::Type::Array:
+	case Node::Type::Null:
+		return true;
+	case Node::Type::Boolean: {
+		bool value;
+		if (!reader.ReadBool(value))
+			return false;
+		field.SetValue(String::To(value));
+		return true;
+	}
+	case Node::Type::Integer: {
+		int64_t value;
+		if (!reader.ReadSignedVarint(value))
+			return false;
+		field.SetValue(String::To(value));
+		return true;
+	}
+	case Node::Type::Decimal: {
+		uint32_t bits;
+		if (!reader.ReadBits(bits, 32))
+			return false;
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		field.SetValue(String::To(value));
+		return true;
+	}
+	default: {
+		std::string value;
+		if (!reader.ReadString(value))
+			return false;
+		field.SetValue(std::move(value));
+		return true;
+	}
+	}
+}
+
+static void WriteNode(BitWriter &writer, const Node &node) {
+	writer.WriteString(node.GetName());
+	writer.WriteBits(static_cast<uint32_t>(node.GetType()), 4);
+	WriteValue(writer, node);
+	writer.WriteVarint(node.GetProperties().size());
+
+	for (const auto &property : node.GetProperties())
+		WriteNode(writer, property);
+}
+
+static bool ReadNode(BitReader &reader, Node &node, uint32_t depth) {
+	std::string name;
+	uint32_t type;
+	if (depth > MaxNodeDepth || !reader.ReadString(name) || !reader.ReadBits(type, 4) || type > static_cast<uint32_t>(Node::Type::Unknown))
+		return false;
+
+	node.SetName(std::move(name));
+	node.SetType(static_cast<Node::Type>(type));
+
+	uint64_t propertyCount;
+	if (!ReadValue(reader, node) || !reader.ReadVarint(propertyCount))
+		return false;
+
+	// Every property takes at least a byte, so a corrupt count fails when the packet runs out.
+	for (uint64_t i = 0; i < propertyCount; i++) {
+		if (!ReadNode(reader, node.AddProperty(), depth + 1))
+			return false;
+	}
+
+	return true;
+}
+
+EntitySnapshot::EntitySnapshot(Node &&node) :
+	node(std::move(node)) {
+	Flatten(this->node, fields, layout);
+}
+
+std::shared_ptr<EntitySnapshot> EntitySnapshot::Capture(const Entity &entity) {
+	Node node;
+
+	for (const auto &component : entity.GetComponents()) {
+		auto componentName = component->GetTypeName();
+
+		if (componentName.empty())
+			continue;
+
+		node.AddProperty(componentName) << *component;
+	}
+
+	return std::make_shared<EntitySnapshot>(std::move(node));
+}
+
+std::shared_ptr<EntitySnapshot> EntitySnapshot::ReadFull(BitReader &reader) {
+	Node node;
+	if (!ReadNode(reader, node, 0))
+		return nullptr;
+
+	return std::make_shared<EntitySnapshot>(std::move(node));
+}
+
+std::shared_ptr<EntitySnapshot> EntitySnapshot::ReadDelta(BitReader &reader, const EntitySnapshot &baseline) {
+	Node node(baseline.node);
+	std::vector<Node *> leaves;
+	GetLeaves(node, leaves);
+
+	bool mask;
+	if (!reader.ReadBool(mask))
+		return nullptr;
+
+	std::vector<uint32_t> changed;
+
+	if (mask) {
+		for (uint32_t i = 0; i < leaves.size(); i++) {
+			bool fieldChanged;
+			if (!reader.ReadBool(fieldChanged))
+				return nullptr;
+			if (fieldChanged)
+				changed.emplace_back(i);
+		}
+	} else {
+		uint64_t changedCount;
+		if (!reader.ReadVarint(changedCount) || changedCount > leaves.size())
+			return nullptr;
+
+		uint64_t index = 0;
+
+		for (uint64_t i = 0; i < changedCount; i++) {
+			uint64_t gap;
+			if (!reader.ReadVarint(gap) || gap >= leaves.size() - index)
+				return nullptr;
+
+			index += gap;
+			changed.emplace_back(static_cast<uint32_t>(index++));
+		}
+	}
+
+	for (auto index : changed) {
+		if (!ReadValue(reader, *leaves[index]))
+			return nullptr;
+	}
+
+	return std::make_shared<EntitySnapshot>(std::move(node));
+}
+
+void EntitySnapshot::WriteFull(BitWriter &writer) const {
+	WriteNode(writer, node);
+}
+
+void EntitySnapshot::WriteDelta(BitWriter &writer, const EntitySnapshot &baseline) const {
+	std::vector<uint32_t> changed;
+
+	for (uint32_t i = 0; i < fields.size(); i++) {
+		if (fields[i]->GetValue() != baseline.fields[i]->GetValue())
+			changed.emplace_back(i);
+	}
+
+	// Changed fields are flagged with a bit each, or listed by the gaps between them when only a few of many have changed.
+	auto mask = fields.size() <= 8 * (changed.size() + 1);
+	writer.WriteBool(mask);
+
+	if (mask) {
+		auto it = changed.begin();
+
+		for (uint32_t i = 0; i < fields.size(); i++) {
+			auto fieldChanged = it != changed.end() && *it == i;
+			writer.WriteBool(fieldChanged);
+			if (fieldChanged)
+				++it;
+		}
+	} else {
+		writer.WriteVarint(changed.size());
+		uint32_t index = 0;
+
+		for (auto i : changed) {
+			writer.WriteVarint(i - index);
+			index = i + 1;
+		}
+	}
+
+	for (auto i : changed)
+		WriteValue(writer, *fields[i]);
+}
+
+bool EntitySnapshot::HasChanged(const EntitySnapshot &baseline) const {
+	for (uint32_t i = 0; i < fields.size(); i++) {
+		if (fields[i]->GetValue() != baseline.fields[i]->GetValue())
+			return true;
+	}
+
+	return false;
+}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Files/Node.hpp"
+#include "Utils/NonCopyable.hpp"
+
+namespace acid {
+class BitReader;
+class BitWriter;
+class Entity;
+
+/**
+ * @brief Class that holds the serialized state of an entity at one tick, used for replication.
+ * The state is the node each component writes itself to, named by the component type. The leaves of the node are the fields
+ * that deltas are made of, in depth first order. Two snapshots with the same layout have the same fields in the same order.
+ */
+class ACID_EXPORT EntitySnapshot : NonCopyable {
+public:
+	/**
+	 * @brief How an entity is written in a snapshot.
+	 */
+	enum class Record : uint8_t {
+		Full, Delta, Removed
+	};
+
+	/**
+	 * Creates a new snapshot from a node of components.
+	 * @param node The node to take.
+	 */
+	explicit EntitySnapshot(Node &&node);
+
+	/**
+	 * Creates a snapshot of the components of an entity.
+	 * @param entity The entity to serialize.
+	 * @return The snapshot.
+	 */
+	static std::shared_ptr<EntitySnapshot> Capture(const Entity &entity);
+
+	/**
+	 * Reads a snapshot written with {@link EntitySnapshot#WriteFull}.
+	 * @param reader The reader to read from.
+	 * @return The snapshot, or null if the reader ran out of data.
+	 */
+	static std::shared_ptr<EntitySnapshot> ReadFull(BitReader &reader);
+
+	/**
+	 * Reads the fields written with {@link EntitySnapshot#WriteDelta}, applied onto a copy of the baseline.
+	 * @param reader The reader to read from.
+	 * @param baseline The snapshot the delta was made against.
+	 * @return The snapshot, or null if the reader ran out of data.
+	 */
+	static std::shared_ptr<EntitySnapshot> ReadDelta(BitReader &reader, const EntitySnapshot &baseline);
+
+	/**
+	 * Writes the whole node, with names and types.
+	 * @param writer The writer to write to.
+	 */
+	void WriteFull(BitWriter &writer) const;
+
+	/**
+	 * Writes the fields that differ from a baseline with the same layout.
+	 * @param writer The writer to write to.
+	 * @param baseline The snapshot the peer already has.
+	 */
+	void WriteDelta(BitWriter &writer, const EntitySnapshot &baseline) const;
+
+	/**
+	 * Gets if a delta can be made against a baseline, which needs the same layout.
+	 * @param baseline The snapshot to compare with.
+	 * @return If the layouts are the same.
+	 */
+	bool CanDelta(const EntitySnapshot &baseline) const { return layout == baseline.layout && fields.size() == baseline.fields.size(); }
+
+	/**
+	 * Gets if any field differs from a baseline with the same layout.
+	 * @param baseline The snapshot to compare with.
+	 * @return If a field has changed.
+	 */
+	bool HasChanged(const EntitySnapshot &baseline) const;
+
+	const Node &GetNode() const { return node; }
+	const std::vector<const Node *> &GetFields() const { return fields; }
+	uint64_t GetLayout() const { return layout; }
+
+private:
+	Node node;
+	/// Leaves of the node in depth first order.
+	std::vector<const Node *> fields;
+	/// Hash of the names, types and shape of the node.
+	uint64_t layout = 0;
+};
+}
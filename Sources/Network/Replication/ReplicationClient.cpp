@@ -0,0 +1,123 @@
+#include "ReplicationClient.hpp"
+
+#include "Network/BitStream.hpp"
+#include "Network/Packet.hpp"
+#include "Scenes/SceneStructure.hpp"
+
+namespace acid {
+bool ReplicationClient::ReadSnapshot(Packet &packet) {
+	uint32_t snapshotTick, baselineTick;
+	if (!(packet >> snapshotTick >> baselineTick) || snapshotTick <= tick)
+		return false;
+
+	View view;
+
+	if (baselineTick != 0) {
+		auto baseline = history.find(baselineTick);
+		if (baseline == history.end())
+			return false;
+
+		view = baseline->second;
+	}
+
+	// Each record is padded to a byte, so is read with its own reader.
+	while (!packet.EndOfStream()) {
+		BitReader reader(packet);
+		uint64_t id;
+		uint32_t record;
+		if (!reader.ReadVarint(id) || !reader.ReadBits(record, 2))
+			return false;
+
+		switch (static_cast<EntitySnapshot::Record>(record)) {
+		case EntitySnapshot::Record::Full: {
+			auto snapshot = EntitySnapshot::ReadFull(reader);
+			if (!snapshot)
+				return false;
+
+			view[static_cast<uint32_t>(id)] = std::move(snapshot);
+			break;
+		}
+		case EntitySnapshot::Record::Delta: {
+			auto base = view.find(static_cast<uint32_t>(id));
+			if (base == view.end())
+				return false;
+
+			auto snapshot = EntitySnapshot::ReadDelta(reader, *base->second);
+			if (!snapshot)
+				return false;
+
+			base->second = std::move(snapshot);
+			break;
+		}
+		case EntitySnapshot::Record::Removed:
+			view.erase(static_cast<uint32_t>(id));
+			break;
+		default:
+			return false;
+		}
+	}
+
+	tick = snapshotTick;
+	entities = view;
+	history[tick] = std::move(view);
+
+	// The server only moves its baseline forward, so older snapshots won't be used again.
+	history.erase(history.begin(), history.lower_bound(baselineTick));
+
+	while (history.size() > HistorySize)
+		history.erase(history.begin());
+
+	return true;
+}
+
+void ReplicationClient::WriteAck(Packet &packet) const {
+	packet << tick;
+}
+
+void ReplicationClient::Apply(SceneStructure &scene) {
+	for (auto it = replicas.begin(); it != replicas.end();) {
+		if (entities.find(it->first) == entities.end()) {
+			it->second.entity->SetRemoved(true);
+			it = replicas.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	for (const auto &[id, snapshot] : entities) {
+		auto &replica = replicas[id];
+		if (replica.snapshot == snapshot)
+			continue;
+
+		if (!replica.entity)
+			replica.entity = scene.CreateEntity();
+
+		// Components the server no longer has are removed when the layout changes.
+		if (replica.snapshot && replica.snapshot->GetLayout() != snapshot->GetLayout()) {
+			for (const auto &component : replica.entity->GetComponents()) {
+				if (!snapshot->GetNode().HasProperty(component->GetTypeName()))
+					component->SetRemoved(true);
+			}
+		}
+
+		for (const auto &property : snapshot->GetNode().GetProperties()) {
+			Component *component = nullptr;
+
+			for (const auto &existing : replica.entity->GetComponents()) {
+				if (existing->GetTypeName() == property.GetName() && !existing->IsRemoved()) {
+					component = existing.get();
+					break;
+				}
+			}
+
+			if (!component)
+				component = replica.entity->AddComponent(Component::Create(property.GetName()));
+			if (component)
+				property >> *component;
+		}
+
+		replica.snapshot = snapshot;
+	}
+}
+}
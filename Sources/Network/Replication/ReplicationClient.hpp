@@ -0,0 +1,66 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+
+#include "EntitySnapshot.hpp"
+
+namespace acid {
+class Packet;
+class SceneStructure;
+
+/**
+ * @brief Class that receives the snapshots written by a acid::ReplicationServer, and keeps the entities of a scene up to date.
+ * Each snapshot is applied on top of the snapshot it was made against, so snapshots that are lost or arrive late don't matter.
+ * The tick of the last snapshot read is acknowledged back to the server, which uses it as the baseline of later snapshots.
+ */
+class ACID_EXPORT ReplicationClient : NonCopyable {
+public:
+	using View = std::unordered_map<uint32_t, std::shared_ptr<const EntitySnapshot>>;
+
+	/// Number of snapshots kept to be used as baselines.
+	static constexpr uint32_t HistorySize = 64;
+
+	ReplicationClient() = default;
+
+	/**
+	 * Reads a snapshot written by {@link ReplicationServer#WriteSnapshot}.
+	 * @param packet The packet to read from.
+	 * @return If the snapshot is newer than the last one and was read.
+	 */
+	bool ReadSnapshot(Packet &packet);
+
+	/**
+	 * Writes an acknowledgement of the last snapshot read, to be read with {@link ReplicationServer#ReadAck}.
+	 * @param packet The packet to append to.
+	 */
+	void WriteAck(Packet &packet) const;
+
+	/**
+	 * Creates, updates and removes entities in a scene to match the last snapshot read.
+	 * @param scene The scene to apply to.
+	 */
+	void Apply(SceneStructure &scene);
+
+	uint32_t GetTick() const { return tick; }
+
+	/**
+	 * Gets the state of every entity in the last snapshot read.
+	 * @return The snapshots by entity id.
+	 */
+	const View &GetEntities() const { return entities; }
+
+private:
+	class Replica {
+	public:
+		Entity *entity = nullptr;
+		std::shared_ptr<const EntitySnapshot> snapshot;
+	};
+
+	uint32_t tick = 0;
+	/// Each snapshot read, by tick.
+	std::map<uint32_t, View> history;
+	View entities;
+	std::unordered_map<uint32_t, Replica> replicas;
+};
+}
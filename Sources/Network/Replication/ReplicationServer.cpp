@@ -0,0 +1,194 @@
+#include "ReplicationServer.hpp"
+
+#include <algorithm>
+
+#include "Maths/Transform.hpp"
+#include "Network/BitStream.hpp"
+#include "Network/Packet.hpp"
+#include "Scenes/SceneStructure.hpp"
+
+namespace acid {
+ReplicationServer::ReplicationServer(std::size_t budget) :
+	budget(budget) {
+}
+
+uint32_t ReplicationServer::AddClient() {
+	auto client = nextClientId++;
+	clients.emplace(client, Client());
+	return client;
+}
+
+void ReplicationServer::RemoveClient(uint32_t client) {
+	clients.erase(client);
+}
+
+void ReplicationServer::SetViewer(uint32_t client, const Vector3f &position, float radius) {
+	auto it = clients.find(client);
+	if (it == clients.end())
+		return;
+
+	it->second.viewer = position;
+	it->second.radius = radius;
+}
+
+void ReplicationServer::Capture(SceneStructure &scene) {
+	tick++;
+
+	std::unordered_map<const Entity *, uint32_t> capturedIds;
+	View captured;
+
+	for (auto entity : scene.QueryAll()) {
+		auto it = entityIds.find(entity);
+		auto id = it != entityIds.end() ? it->second : nextEntityId++;
+		capturedIds.emplace(entity, id);
+		captured.emplace(id, EntitySnapshot::Capture(*entity));
+	}
+
+	entityIds = std::move(capturedIds);
+	entities = std::move(captured);
+
+	for (auto &[clientId, client] : clients) {
+		auto relevant = std::isinf(client.radius) ? scene.QueryAll() : scene.QuerySphere(client.viewer, client.radius);
+		std::unordered_map<uint32_t, float> priorities;
+
+		for (auto entity : relevant) {
+			auto id = entityIds.find(entity);
+			if (id == entityIds.end())
+				continue;
+
+			// Closer entities gain priority faster, entities without a position always gain the most.
+			auto priority = 1.0f;
+			if (auto transform = entity->GetComponent<Transform>())
+				priority = 1.0f / (1.0f + transform->GetPosition().Distance(client.viewer) / PriorityDistance);
+
+			priorities.emplace(id->second, client.priorities[id->second] + priority);
+		}
+
+		client.priorities = std::move(priorities);
+	}
+}
+
+void ReplicationServer::WriteSnapshot(uint32_t clientId, Packet &packet) {
+	auto it = clients.find(clientId);
+	if (it == clients.end())
+		return;
+
+	auto &client = it->second;
+
+	// The client builds this snapshot on top of the baseline, so the view starts as a copy of what it has there.
+	View view;
+	uint32_t baselineTick = 0;
+
+	if (auto baseline = client.history.find(client.ackedTick); baseline != client.history.end()) {
+		view = baseline->second;
+		baselineTick = baseline->first;
+	}
+
+	auto start = packet.GetDataSize();
+	packet << tick << baselineTick;
+	auto headerEnd = packet.GetDataSize();
+
+	Packet record;
+
+	// Records are written on their own first, so one that would go over the budget is left for a later snapshot.
+	auto appendRecord = [&]() {
+		if (packet.GetDataSize() > headerEnd && packet.GetDataSize() - start + record.GetDataSize() > budget)
+			return false;
+
+		packet.Append(record.GetData(), record.GetDataSize());
+		return true;
+	};
+
+	// Entities that are gone or no longer relevant are removed first, each takes a few bytes.
+	for (auto entity = view.begin(); entity != view.end();) {
+		if (client.priorities.find(entity->first) != client.priorities.end()) {
+			++entity;
+			continue;
+		}
+
+		record.Clear();
+		{
+			BitWriter writer(record);
+			writer.WriteVarint(entity->first);
+			writer.WriteBits(static_cast<uint32_t>(EntitySnapshot::Record::Removed), 2);
+		}
+
+		if (!appendRecord())
+			break;
+
+		entity = view.erase(entity);
+	}
+
+	std::vector<std::pair<float, uint32_t>> candidates;
+
+	for (auto &[id, priority] : client.priorities) {
+		auto base = view.find(id);
+		auto &snapshot = entities[id];
+
+		// Entities the client already has up to date are not sent, and don't build up priority.
+		if (base != view.end() && snapshot->CanDelta(*base->second) && !snapshot->HasChanged(*base->second)) {
+			priority = 0.0f;
+			continue;
+		}
+
+		candidates.emplace_back(priority, id);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+	for (const auto &[priority, id] : candidates) {
+		auto base = view.find(id);
+		auto &snapshot = entities[id];
+
+		record.Clear();
+		{
+			BitWriter writer(record);
+			writer.WriteVarint(id);
+
+			if (base != view.end() && snapshot->CanDelta(*base->second)) {
+				writer.WriteBits(static_cast<uint32_t>(EntitySnapshot::Record::Delta), 2);
+				snapshot->WriteDelta(writer, *base->second);
+			} else {
+				writer.WriteBits(static_cast<uint32_t>(EntitySnapshot::Record::Full), 2);
+				snapshot->WriteFull(writer);
+			}
+		}
+
+		if (!appendRecord())
+			break;
+
+		view[id] = snapshot;
+		client.priorities[id] = 0.0f;
+	}
+
+	client.history[tick] = std::move(view);
+
+	// Snapshots older than the baseline will never be acknowledged as a newer baseline.
+	client.history.erase(client.history.begin(), client.history.lower_bound(client.ackedTick));
+
+	while (client.history.size() > HistorySize)
+		client.history.erase(client.history.begin());
+}
+
+bool ReplicationServer::ReadAck(uint32_t clientId, Packet &packet) {
+	auto it = clients.find(clientId);
+	if (it == clients.end())
+		return false;
+
+	uint32_t ackedTick;
+	if (!(packet >> ackedTick))
+		return false;
+
+	// Acknowledgements can arrive out of order, only newer snapshots that are still known become the baseline.
+	auto &client = it->second;
+	if (ackedTick > client.ackedTick && client.history.find(ackedTick) != client.history.end())
+		client.ackedTick = ackedTick;
+
+	return true;
+}
+
+uint32_t ReplicationServer::GetAckedTick(uint32_t client) const {
+	auto it = clients.find(client);
+	return it != clients.end() ? it->second.ackedTick : 0;
+}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+#include "Maths/Vector3.hpp"
+#include "EntitySnapshot.hpp"
+
+namespace acid {
+class Packet;
+class SceneStructure;
+
+/**
+ * @brief Class that replicates the entities of a scene to clients with delta compressed snapshots.
+ * Each tick the state of every entity is captured, then a snapshot is written for each client against the last snapshot
+ * that client acknowledged, its baseline. Entities new to the client are sent whole, others only with the fields that changed.
+ *
+ * Clients only receive entities in a radius around their viewer, found with {@link SceneStructure#QuerySphere}. Each tick
+ * relevant entities gain priority, more when they are closer, and snapshots are filled with the highest priority entities
+ * until the budget of bytes is used. Entities that are left out keep their priority and are sent in a later tick.
+ */
+class ACID_EXPORT ReplicationServer : NonCopyable {
+public:
+	/// Default bytes per snapshot, small enough for a snapshot to fit in one datagram.
+	static constexpr std::size_t DefaultBudget = 1024;
+	/// Number of snapshots kept for each client to be used as baselines.
+	static constexpr uint32_t HistorySize = 64;
+	/// Distance from the viewer at which entities gain half the priority of those next to it.
+	static constexpr float PriorityDistance = 100.0f;
+
+	/**
+	 * Creates a new replication server.
+	 * @param budget The bytes each snapshot may use.
+	 */
+	explicit ReplicationServer(std::size_t budget = DefaultBudget);
+
+	/**
+	 * Adds a client, which will be sent every relevant entity in full in its first snapshots.
+	 * @return The id of the client.
+	 */
+	uint32_t AddClient();
+	void RemoveClient(uint32_t client);
+
+	/**
+	 * Sets where a client views the scene from, entities further than the radius are not sent.
+	 * @param client The id of the client.
+	 * @param position The position of the viewer.
+	 * @param radius The radius entities are relevant in.
+	 */
+	void SetViewer(uint32_t client, const Vector3f &position, float radius = std::numeric_limits<float>::infinity());
+
+	/**
+	 * Captures the state of every entity in a scene as a new tick, and updates the priorities of the entities for each client.
+	 * @param scene The scene to capture.
+	 */
+	void Capture(SceneStructure &scene);
+
+	/**
+	 * Writes a snapshot of the last captured tick for a client.
+	 * @param client The id of the client.
+	 * @param packet The packet to append the snapshot to.
+	 */
+	void WriteSnapshot(uint32_t client, Packet &packet);
+
+	/**
+	 * Reads an acknowledgement written by {@link ReplicationClient#WriteAck}.
+	 * @param client The id of the client.
+	 * @param packet The packet to read from.
+	 * @return If the acknowledgement was read.
+	 */
+	bool ReadAck(uint32_t client, Packet &packet);
+
+	uint32_t GetTick() const { return tick; }
+
+	std::size_t GetBudget() const { return budget; }
+	void SetBudget(std::size_t budget) { this->budget = budget; }
+
+	/**
+	 * Gets the last tick acknowledged by a client, the baseline of its next snapshot.
+	 * @param client The id of the client.
+	 * @return The tick, zero if none.
+	 */
+	uint32_t GetAckedTick(uint32_t client) const;
+
+private:
+	using View = std::unordered_map<uint32_t, std::shared_ptr<const EntitySnapshot>>;
+
+	class Client {
+	public:
+		Vector3f viewer;
+		float radius = std::numeric_limits<float>::infinity();
+		uint32_t ackedTick = 0;
+		/// What the client has after each snapshot sent to it, by tick.
+		std::map<uint32_t, View> history;
+		/// Accumulated priority of each relevant entity.
+		std::unordered_map<uint32_t, float> priorities;
+	};
+
+	std::size_t budget;
+	uint32_t tick = 0;
+	uint32_t nextEntityId = 1;
+	uint32_t nextClientId = 0;
+	std::unordered_map<const Entity *, uint32_t> entityIds;
+	View entities;
+	std::map<uint32_t, Client> clients;
+};
+}
@@ -200,4 +200,24 @@ void Socket::Close() {
 		socket = InvalidSocketHandle();
 	}
 }
+
+void Socket::RecordSend(std::size_t bytes, std::size_t packets, Status status) {
+	auto partial = status == Status::Partial;
+	auto notReady = status == Status::NotReady;
+	auto error = status == Status::Disconnected || status == Status::Error;
+	metrics.RecordSend(bytes, packets, partial, notReady, error);
+	SocketMetrics::Global().RecordSend(bytes, packets, partial, notReady, error);
+}
+
+void Socket::RecordReceive(std::size_t bytes, std::size_t packets, Status status) {
+	auto notReady = status == Status::NotReady;
+	auto error = status == Status::Disconnected || status == Status::Error;
+	metrics.RecordReceive(bytes, packets, notReady, error);
+	SocketMetrics::Global().RecordReceive(bytes, packets, notReady, error);
+}
+
+void Socket::RecordPacketReceived() {
+	metrics.packetsReceived.fetch_add(1, std::memory_order_relaxed);
+	SocketMetrics::Global().packetsReceived.fetch_add(1, std::memory_order_relaxed);
+}
 }
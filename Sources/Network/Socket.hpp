@@ -3,6 +3,7 @@
 #include <cstdint>
 
 #include "Export.hpp"
+#include "SocketMetrics.hpp"
 
 struct sockaddr_in;
 
@@ -113,6 +114,12 @@ public:
 	 */
 	void SetBlocking(bool blocking);
 
+	/**
+	 * Gets the counters of what this socket has sent and received, these are also added to SocketMetrics::Global.
+	 * @return The socket metrics.
+	 */
+	const SocketMetrics &GetMetrics() const { return metrics; }
+
 protected:
 	/**
 	 * Types of protocols that the socket can use.
@@ -158,6 +165,27 @@ protected:
 	 */
 	void Close();
 
+	/**
+	 * Records a send call in the metrics of this socket and the global metrics.
+	 * @param bytes The bytes the call sent.
+	 * @param packets The packets or datagrams completed by the call.
+	 * @param status The status of the call.
+	 */
+	void RecordSend(std::size_t bytes, std::size_t packets, Status status);
+
+	/**
+	 * Records a receive call in the metrics of this socket and the global metrics.
+	 * @param bytes The bytes the call received.
+	 * @param packets The packets or datagrams completed by the call.
+	 * @param status The status of the call.
+	 */
+	void RecordReceive(std::size_t bytes, std::size_t packets, Status status);
+
+	/**
+	 * Records a packet completed from data already received.
+	 */
+	void RecordPacketReceived();
+
 private:
 	/// Type of the socket (TCP or UDP).
 	Type type;
@@ -165,5 +193,6 @@ private:
 	SocketHandle socket;
 	/// Current blocking mode of the socket.
 	bool blocking = true;
+	SocketMetrics metrics;
 };
 }
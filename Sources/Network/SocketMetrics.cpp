@@ -0,0 +1,77 @@
+#include "SocketMetrics.hpp"
+
+#include <sstream>
+
+namespace acid {
+SocketMetrics::SocketMetrics(const SocketMetrics &other) {
+	*this = other;
+}
+
+SocketMetrics &SocketMetrics::operator=(const SocketMetrics &other) {
+	bytesSent = other.bytesSent.load(std::memory_order_relaxed);
+	bytesReceived = other.bytesReceived.load(std::memory_order_relaxed);
+	packetsSent = other.packetsSent.load(std::memory_order_relaxed);
+	packetsReceived = other.packetsReceived.load(std::memory_order_relaxed);
+	sendCalls = other.sendCalls.load(std::memory_order_relaxed);
+	receiveCalls = other.receiveCalls.load(std::memory_order_relaxed);
+	partialSends = other.partialSends.load(std::memory_order_relaxed);
+	notReady = other.notReady.load(std::memory_order_relaxed);
+	errors = other.errors.load(std::memory_order_relaxed);
+	return *this;
+}
+
+SocketMetrics &SocketMetrics::Global() {
+	static SocketMetrics global;
+	return global;
+}
+
+void SocketMetrics::RecordSend(uint64_t bytes, uint64_t packets, bool partial, bool notReady, bool error) {
+	bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+	packetsSent.fetch_add(packets, std::memory_order_relaxed);
+	sendCalls.fetch_add(1, std::memory_order_relaxed);
+
+	if (partial)
+		partialSends.fetch_add(1, std::memory_order_relaxed);
+	if (notReady)
+		this->notReady.fetch_add(1, std::memory_order_relaxed);
+	if (error)
+		errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SocketMetrics::RecordReceive(uint64_t bytes, uint64_t packets, bool notReady, bool error) {
+	bytesReceived.fetch_add(bytes, std::memory_order_relaxed);
+	packetsReceived.fetch_add(packets, std::memory_order_relaxed);
+	receiveCalls.fetch_add(1, std::memory_order_relaxed);
+
+	if (notReady)
+		this->notReady.fetch_add(1, std::memory_order_relaxed);
+	if (error)
+		errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SocketMetrics::Reset() {
+	*this = {};
+}
+
+SocketMetrics SocketMetrics::operator-(const SocketMetrics &earlier) const {
+	SocketMetrics result(*this);
+	result.bytesSent -= earlier.bytesSent;
+	result.bytesReceived -= earlier.bytesReceived;
+	result.packetsSent -= earlier.packetsSent;
+	result.packetsReceived -= earlier.packetsReceived;
+	result.sendCalls -= earlier.sendCalls;
+	result.receiveCalls -= earlier.receiveCalls;
+	result.partialSends -= earlier.partialSends;
+	result.notReady -= earlier.notReady;
+	result.errors -= earlier.errors;
+	return result;
+}
+
+std::string SocketMetrics::ToString() const {
+	std::stringstream stream;
+	stream << "sent " << bytesSent << " bytes in " << packetsSent << " packets over " << sendCalls << " calls, "
+		<< "received " << bytesReceived << " bytes in " << packetsReceived << " packets over " << receiveCalls << " calls, "
+		<< partialSends << " partial sends, " << notReady << " not ready, " << errors << " errors";
+	return stream.str();
+}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief Counters of what a socket, or every socket, has sent and received.
+ * Counters are updated with relaxed atomics, so sockets can be used and read from any thread.
+ * Copies are snapshots of the counters, which can be subtracted to find what happened between them.
+ */
+class ACID_EXPORT SocketMetrics {
+public:
+	SocketMetrics() = default;
+	SocketMetrics(const SocketMetrics &other);
+
+	SocketMetrics &operator=(const SocketMetrics &other);
+
+	/**
+	 * Gets the counters over every socket.
+	 * @return The global counters.
+	 */
+	static SocketMetrics &Global();
+
+	/**
+	 * Records one send call made by a socket.
+	 * @param bytes The bytes the call sent.
+	 * @param packets The packets or datagrams completed by the call.
+	 * @param partial If only part of the data was sent.
+	 * @param notReady If the socket could not send without blocking.
+	 * @param error If the call failed.
+	 */
+	void RecordSend(uint64_t bytes, uint64_t packets, bool partial, bool notReady, bool error);
+
+	/**
+	 * Records one receive call made by a socket.
+	 * @param bytes The bytes the call received.
+	 * @param packets The packets or datagrams completed by the call.
+	 * @param notReady If the socket had nothing to receive without blocking.
+	 * @param error If the call failed or the peer disconnected.
+	 */
+	void RecordReceive(uint64_t bytes, uint64_t packets, bool notReady, bool error);
+
+	void Reset();
+
+	/**
+	 * Gets the counters that changed from an earlier snapshot.
+	 * @param earlier The earlier snapshot.
+	 * @return The difference of each counter.
+	 */
+	SocketMetrics operator-(const SocketMetrics &earlier) const;
+
+	std::string ToString() const;
+
+	std::atomic<uint64_t> bytesSent = 0;
+	std::atomic<uint64_t> bytesReceived = 0;
+	std::atomic<uint64_t> packetsSent = 0;
+	std::atomic<uint64_t> packetsReceived = 0;
+	/// Number of send and receive calls made into the system.
+	std::atomic<uint64_t> sendCalls = 0;
+	std::atomic<uint64_t> receiveCalls = 0;
+	std::atomic<uint64_t> partialSends = 0;
+	/// Number of calls that returned Socket::Status::NotReady.
+	std::atomic<uint64_t> notReady = 0;
+	std::atomic<uint64_t> errors = 0;
+};
+}
@@ -1,7 +1,12 @@
 #include "SocketSelector.hpp"
 
+#include <unordered_map>
 #if defined(ACID_BUILD_WINDOWS)
 #include <WinSock2.h>
+#elif defined(ACID_BUILD_LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
 #else
 #include <sys/types.h>
 #include <unistd.h>
@@ -15,7 +20,66 @@
 #endif
 
 namespace acid {
+#if defined(ACID_BUILD_LINUX)
+struct SocketSelector::SocketSelectorImpl {
+	/**
+	 * @brief A socket in the selector, epoll events point directly to these.
+	 */
+	struct Entry {
+		Socket *socket = nullptr;
+		/// The wait this socket was last reported ready by.
+		uint64_t readyWait = 0;
+	};
+
+	explicit SocketSelectorImpl(Trigger trigger) :
+		epoll(epoll_create1(EPOLL_CLOEXEC)),
+		trigger(trigger) {
+		if (epoll == -1)
+			Log::Error("Failed to create epoll instance: ", errno, '\n');
+	}
+
+	SocketSelectorImpl(const SocketSelectorImpl &copy) :
+		SocketSelectorImpl(copy.trigger) {
+		sockets = copy.sockets;
+		readySockets = copy.readySockets;
+		waitCount = copy.waitCount;
+
+		for (auto &[handle, entry] : sockets)
+			Register(handle, entry);
+	}
+
+	~SocketSelectorImpl() {
+		if (epoll != -1)
+			close(epoll);
+	}
+
+	bool Register(SocketHandle handle, Entry &entry) {
+		epoll_event event = {};
+		event.events = EPOLLIN | (trigger == Trigger::Edge ? static_cast<uint32_t>(EPOLLET) : 0u);
+		// Map nodes are never moved by a rehash, so the event can point to the entry.
+		event.data.ptr = &entry;
+
+		// A handle that was closed and reused since it was added is no longer registered, so only a duplicate fails here.
+		return epoll_ctl(epoll, EPOLL_CTL_ADD, handle, &event) == 0 || errno == EEXIST;
+	}
+
+	/// The epoll instance.
+	int epoll;
+	Trigger trigger;
+	/// All the sockets, by their handle.
+	std::unordered_map<SocketHandle, Entry> sockets;
+	/// Events returned from the last wait.
+	std::vector<epoll_event> events;
+	/// Sockets that are ready.
+	std::vector<Socket *> readySockets;
+	/// Number of waits, so ready flags from previous waits don't have to be cleared.
+	uint64_t waitCount = 1;
+};
+#else
 struct SocketSelector::SocketSelectorImpl {
+	explicit SocketSelectorImpl(Trigger) {
+	}
+
 	/// Set containing all the sockets handles.
 	fd_set allSockets;
 	/// Set containing handles of the sockets that are ready.
@@ -24,10 +88,15 @@ struct SocketSelector::SocketSelectorImpl {
 	int maxSocket;
 	/// Number of socket handles.
 	int socketCount;
+	/// All the sockets, by their handle.
+	std::unordered_map<SocketHandle, Socket *> sockets;
+	/// Sockets that are ready.
+	std::vector<Socket *> readySockets;
 };
+#endif
 
-SocketSelector::SocketSelector() :
-	impl(std::make_unique<SocketSelectorImpl>()) {
+SocketSelector::SocketSelector(Trigger trigger) :
+	impl(std::make_unique<SocketSelectorImpl>(trigger)) {
 	Clear();
 }
 
@@ -35,10 +104,22 @@ SocketSelector::SocketSelector(const SocketSelector &copy) :
 	impl(std::make_unique<SocketSelectorImpl>(*copy.impl)) {
 }
 
+SocketSelector::~SocketSelector() = default;
+
 void SocketSelector::Add(Socket &socket) {
 	auto handle = socket.GetHandle();
 
 	if (handle != Socket::InvalidSocketHandle()) {
+#if defined(ACID_BUILD_LINUX)
+		auto [it, inserted] = impl->sockets.try_emplace(handle);
+		it->second.socket = &socket;
+		it->second.readyWait = 0;
+
+		if (!impl->Register(handle, it->second)) {
+			Log::Error("The socket can't be added to the selector: ", errno, '\n');
+			impl->sockets.erase(it);
+		}
+#else
 #if defined(ACID_BUILD_WINDOWS)
 		if (impl->socketCount >= FD_SETSIZE) {
 			Log::Error("The socket can't be added to the selector because the selector is full. This is a limitation of your operating system's FD_SETSIZE setting.\n");
@@ -60,6 +141,8 @@ void SocketSelector::Add(Socket &socket) {
 #endif
 
 		FD_SET(handle, &impl->allSockets);
+		impl->sockets[handle] = &socket;
+#endif
 	}
 }
 
@@ -67,6 +150,13 @@ void SocketSelector::Remove(Socket &socket) {
 	auto handle = socket.GetHandle();
 
 	if (handle != Socket::InvalidSocketHandle()) {
+#if defined(ACID_BUILD_LINUX)
+		if (impl->sockets.erase(handle) == 0)
+			return;
+
+		// Fails harmlessly if the handle was already closed, which removes it from epoll.
+		epoll_ctl(impl->epoll, EPOLL_CTL_DEL, handle, nullptr);
+#else
 #if defined(ACID_BUILD_WINDOWS)
 		if (!FD_ISSET(handle, &impl->allSockets))
 			return;
@@ -80,18 +170,44 @@ void SocketSelector::Remove(Socket &socket) {
 
 		FD_CLR(handle, &impl->allSockets);
 		FD_CLR(handle, &impl->socketsReady);
+		impl->sockets.erase(handle);
+#endif
 	}
 }
 
 void SocketSelector::Clear() {
+#if defined(ACID_BUILD_LINUX)
+	// Recreating the epoll instance is cheaper than removing each socket.
+	if (!impl->sockets.empty())
+		impl = std::make_unique<SocketSelectorImpl>(impl->trigger);
+#else
 	FD_ZERO(&impl->allSockets);
 	FD_ZERO(&impl->socketsReady);
 
 	impl->maxSocket = 0;
 	impl->socketCount = 0;
+	impl->sockets.clear();
+#endif
+	impl->readySockets.clear();
 }
 
 bool SocketSelector::Wait(const Time timeout) {
+	impl->readySockets.clear();
+
+#if defined(ACID_BUILD_LINUX)
+	impl->waitCount++;
+	impl->events.resize(std::max<std::size_t>(impl->sockets.size(), 1));
+
+	// Timeouts are rounded up to the next millisecond, so short timeouts don't become a poll.
+	auto milliseconds = timeout != 0s ? static_cast<int>((timeout.AsMicroseconds() + 999) / 1000) : -1;
+	auto count = epoll_wait(impl->epoll, impl->events.data(), static_cast<int>(impl->events.size()), milliseconds);
+
+	for (int i = 0; i < count; i++) {
+		auto entry = static_cast<SocketSelectorImpl::Entry *>(impl->events[i].data.ptr);
+		entry->readyWait = impl->waitCount;
+		impl->readySockets.emplace_back(entry->socket);
+	}
+#else
 	// Setup the timeout
 	timeval time = {};
 	time.tv_sec = static_cast<long>(timeout.AsMicroseconds() / 1000000);
@@ -104,6 +220,14 @@ bool SocketSelector::Wait(const Time timeout) {
 	// The first parameter is ignored on Windows
 	auto count = select(impl->maxSocket + 1, &impl->socketsReady, nullptr, nullptr, timeout != 0s ? &time : nullptr);
 
+	if (count > 0) {
+		for (const auto &[handle, socket] : impl->sockets) {
+			if (FD_ISSET(handle, &impl->socketsReady))
+				impl->readySockets.emplace_back(socket);
+		}
+	}
+#endif
+
 	return count > 0;
 }
 
@@ -111,17 +235,30 @@ bool SocketSelector::IsReady(const Socket &socket) const {
 	auto handle = socket.GetHandle();
 
 	if (handle != Socket::InvalidSocketHandle()) {
+#if defined(ACID_BUILD_LINUX)
+		auto it = impl->sockets.find(handle);
+		return it != impl->sockets.end() && it->second.readyWait == impl->waitCount;
+#else
 #if !defined(ACID_BUILD_WINDOWS)
 		if (handle >= FD_SETSIZE)
 			return false;
 #endif
 
 		return FD_ISSET(handle, &impl->socketsReady) != 0;
+#endif
 	}
 
 	return false;
 }
 
+const std::vector<Socket *> &SocketSelector::GetReadySockets() const {
+	return impl->readySockets;
+}
+
+std::size_t SocketSelector::GetSocketCount() const {
+	return impl->sockets.size();
+}
+
 SocketSelector &SocketSelector::operator=(const SocketSelector &right) {
 	SocketSelector temp = right;
 	impl.swap(temp.impl);
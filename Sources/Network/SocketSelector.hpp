@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "Maths/Time.hpp"
 
@@ -27,14 +28,30 @@ class Socket;
  * Using a selector is simple:
  * \li populate the selector with all the sockets that you want to observe
  * \li make it wait until there is data available on any of the sockets
- * \li test each socket to find out which ones are ready
+ * \li test each socket to find out which ones are ready, or iterate the ready list
+ *
+ * On Linux the selector is backed by epoll, so it has no limit on the number or value of socket handles,
+ * adding and removing sockets is constant time, and waiting costs the number of ready sockets instead of the highest handle.
+ * Other platforms fall back to select, which is limited by FD_SETSIZE.
  */
 class ACID_EXPORT SocketSelector {
 public:
+	/**
+	 * @brief How readiness is reported by {@link SocketSelector#Wait}.
+	 */
+	enum class Trigger {
+		/// A socket is reported by every wait while it has data available.
+		Level,
+		/// A socket is only reported when new data arrives, so it must be set as non-blocking and read until it returns NotReady.
+		/// This avoids reporting the same sockets again on each wait, falls back to level triggering without epoll.
+		Edge
+	};
+
 	/**
 	 * Default constructor.
+	 * @param trigger How readiness is reported.
 	 */
-	SocketSelector();
+	explicit SocketSelector(Trigger trigger = Trigger::Level);
 
 	/**
 	 * Copy constructor.
@@ -42,6 +59,8 @@ public:
 	 */
 	SocketSelector(const SocketSelector &copy);
 
+	~SocketSelector();
+
 	/**
 	 * Add a new socket to the selector.
 	 *
@@ -87,6 +106,20 @@ public:
 	 */
 	bool IsReady(const Socket &socket) const;
 
+	/**
+	 * Gets the sockets that were ready after the last call to Wait.
+	 * This is cheaper than calling IsReady on every socket when only a few of many sockets are ready.
+	 * Sockets removed after the wait stay in the list until the next wait, so they can be removed while iterating.
+	 * @return The ready sockets, in no particular order.
+	 */
+	const std::vector<Socket *> &GetReadySockets() const;
+
+	/**
+	 * Gets the number of sockets in the selector.
+	 * @return The number of sockets.
+	 */
+	std::size_t GetSocketCount() const;
+
 	/**
 	 * Overload of assignment operator.
 	 * @param right Instance to assign.
@@ -5,8 +5,14 @@
 #include <WinSock2.h>
 #else
 #include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #endif
+#if defined(ACID_BUILD_LINUX)
+#include <csignal>
+#include <sys/sendfile.h>
+#endif
 
 #include "Engine/Log.hpp"
 #include "Network/IpAddress.hpp"
@@ -153,8 +159,9 @@ void TcpSocket::Disconnect() {
 	// Close the socket.
 	Close();
 
-	// Reset the pending packet data.
-	pendingPacket = {};
+	// Drop any data that was received but not read.
+	receiveBegin = 0;
+	receiveEnd = 0;
 }
 
 Socket::Status TcpSocket::Send(const void *data, std::size_t size) {
@@ -183,12 +190,15 @@ Socket::Status TcpSocket::Send(const void *data, std::size_t size, std::size_t &
 		// Check for errors.
 		if (result < 0) {
 			auto status = GetErrorStatus();
+			RecordSend(0, 0, status);
 
 			if (status == Status::NotReady && sent)
 				return Status::Partial;
 
 			return status;
 		}
+
+		RecordSend(static_cast<std::size_t>(result), 0, sent + result < size ? Status::Partial : Status::Done);
 	}
 
 	return Status::Done;
@@ -204,19 +214,98 @@ Socket::Status TcpSocket::Receive(void *data, std::size_t size, std::size_t &rec
 		return Status::Error;
 	}
 
+	// Data left over from receiving packets comes first.
+	if (receiveBegin < receiveEnd) {
+		received = std::min(size, receiveEnd - receiveBegin);
+		std::memcpy(data, &receiveBuffer[receiveBegin], received);
+		receiveBegin += received;
+		return Status::Done;
+	}
+
 	// Receive a chunk of bytes.
 	auto sizeReceived = recv(GetHandle(), static_cast<char *>(data), static_cast<int>(size), flags);
 
 	// Check the number of bytes received.
 	if (sizeReceived > 0) {
 		received = static_cast<std::size_t>(sizeReceived);
+		RecordReceive(received, 0, Status::Done);
 		return Status::Done;
 	}
 
-	if (sizeReceived == 0)
-		return Status::Disconnected;
+	auto status = sizeReceived == 0 ? Status::Disconnected : GetErrorStatus();
+	RecordReceive(0, 0, status);
+	return status;
+}
+
+Socket::Status TcpSocket::SendFile(std::FILE *file, uint64_t offset, std::size_t size, std::size_t &sent) {
+	sent = 0;
+
+	if (!file) {
+		Log::Error("Cannot send a file over the network (the file is invalid)\n");
+		return Status::Error;
+	}
+
+#if defined(ACID_BUILD_LINUX)
+	// Unlike send, sendfile can't be told not to raise SIGPIPE when the peer has closed, so it is blocked and discarded.
+	sigset_t pipeSet, oldSet;
+	sigemptyset(&pipeSet);
+	sigaddset(&pipeSet, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipeSet, &oldSet);
+
+	auto position = static_cast<off_t>(offset);
+	auto status = Status::Done;
+
+	while (sent < size) {
+		auto result = sendfile(GetHandle(), fileno(file), &position, size - sent);
+
+		if (result < 0) {
+			auto error = errno;
+			status = GetErrorStatus();
+			RecordSend(0, 0, status);
+
+			if (status == Status::NotReady && sent)
+				status = Status::Partial;
+
+			if (error == EPIPE) {
+				timespec zero = {};
+				sigtimedwait(&pipeSet, nullptr, &zero);
+			}
+
+			break;
+		}
+
+		// The end of the file was reached.
+		if (result == 0)
+			break;
+
+		sent += static_cast<std::size_t>(result);
+		RecordSend(static_cast<std::size_t>(result), 0, sent < size ? Status::Partial : Status::Done);
+	}
+
+	pthread_sigmask(SIG_SETMASK, &oldSet, nullptr);
+	return status;
+#else
+	if (std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0)
+		return Status::Error;
+
+	std::vector<char> buffer(std::min<std::size_t>(size, 64 * 1024));
+
+	while (sent < size) {
+		auto count = std::fread(buffer.data(), 1, std::min(buffer.size(), size - sent), file);
+
+		if (count == 0)
+			break;
+
+		std::size_t blockSent;
+		auto status = Send(buffer.data(), count, blockSent);
+		sent += blockSent;
 
-	return GetErrorStatus();
+		if (status != Status::Done)
+			return status == Status::NotReady && sent ? Status::Partial : status;
+	}
+
+	return Status::Done;
+#endif
 }
 
 Socket::Status TcpSocket::Send(Packet &packet) {
@@ -224,90 +313,154 @@ Socket::Status TcpSocket::Send(Packet &packet) {
 	// This means that we have to send the packet size first, so that the
 	// receiver knows the actual end of the packet in the data stream.
 
-	// We allocate an extra memory block so that the size can be sent
-	// together with the data in a single call. This may seem inefficient,
-	// but it is actually required to avoid partial send, which could cause
-	// data corruption on the receiving end.
+	// The size and data are gathered into a single call, sending them separately
+	// could cause a partial send between them and data corruption on the receiving end.
 
 	// Get the data to send from the packet.
 	auto dataSize = packet.OnSend();
 
 	// First convert the packet size to network byte order
 	uint32_t packetSize = htonl(static_cast<uint32_t>(dataSize.second));
+	auto totalSize = sizeof(packetSize) + dataSize.second;
 
-	// Allocate memory for the data block to send
-	std::vector<char> blockToSend(sizeof(packetSize) + dataSize.second);
+	// Loop until the size and data have been sent, resuming from where a partial send stopped.
+	std::size_t sent = 0;
 
-	// Copy the packet size and data into the block to send
-	std::memcpy(&blockToSend[0], &packetSize, sizeof(packetSize));
+	while (packet.sendPos < totalSize) {
+		auto dataOffset = packet.sendPos > sizeof(packetSize) ? packet.sendPos - sizeof(packetSize) : 0;
+#if defined(ACID_BUILD_WINDOWS)
+		WSABUF buffers[2];
+		DWORD bufferCount = 0;
 
-	if (dataSize.second > 0)
-		std::memcpy(&blockToSend[0] + sizeof(packetSize), dataSize.first, dataSize.second);
+		if (packet.sendPos < sizeof(packetSize))
+			buffers[bufferCount++] = {static_cast<ULONG>(sizeof(packetSize) - packet.sendPos), reinterpret_cast<char *>(&packetSize) + packet.sendPos};
+		if (dataSize.second > 0)
+			buffers[bufferCount++] = {static_cast<ULONG>(dataSize.second - dataOffset), const_cast<char *>(static_cast<const char *>(dataSize.first)) + dataOffset};
 
-	// Send the data block.
-	std::size_t sent;
-	auto status = Send(&blockToSend[0] + packet.sendPos, blockToSend.size() - packet.sendPos, sent);
+		DWORD bufferSent = 0;
+		int32_t result = WSASend(GetHandle(), buffers, bufferCount, &bufferSent, 0, nullptr, nullptr) == 0 ? static_cast<int32_t>(bufferSent) : -1;
+#else
+		iovec buffers[2];
+		std::size_t bufferCount = 0;
+
+		if (packet.sendPos < sizeof(packetSize))
+			buffers[bufferCount++] = {reinterpret_cast<char *>(&packetSize) + packet.sendPos, sizeof(packetSize) - packet.sendPos};
+		if (dataSize.second > 0)
+			buffers[bufferCount++] = {const_cast<char *>(static_cast<const char *>(dataSize.first)) + dataOffset, dataSize.second - dataOffset};
+
+		msghdr message = {};
+		message.msg_iov = buffers;
+		message.msg_iovlen = bufferCount;
+		auto result = sendmsg(GetHandle(), &message, flags);
+#endif
 
-	// In the case of a partial send, record the location to resume from
-	if (status == Status::Partial)
-		packet.sendPos += sent;
-	else if (status == Status::Done)
-		packet.sendPos = 0;
+		// Check for errors.
+		if (result < 0) {
+			auto status = GetErrorStatus();
+			RecordSend(0, 0, status);
 
-	return status;
+			// In the case of a partial send, the location to resume from is kept.
+			if (status == Status::NotReady && sent)
+				return Status::Partial;
+
+			return status;
+		}
+
+		sent += static_cast<std::size_t>(result);
+		packet.sendPos += static_cast<std::size_t>(result);
+		auto complete = packet.sendPos == totalSize;
+		RecordSend(static_cast<std::size_t>(result), complete ? 1 : 0, complete ? Status::Done : Status::Partial);
+	}
+
+	packet.sendPos = 0;
+	return Status::Done;
 }
 
 Socket::Status TcpSocket::Receive(Packet &packet) {
 	// First clear the variables to fill.
 	packet.Clear();
 
-	// We start by getting the size of the incoming packet.
-	uint32_t packetSize = 0;
-	std::size_t received = 0;
+	if (receiveBuffer.empty())
+		receiveBuffer.resize(ReceiveBufferSize);
+
+	while (true) {
+		// Parse a packet if its size and all its data has been received.
+		auto available = receiveEnd - receiveBegin;
+		auto required = sizeof(uint32_t);
+
+		if (available >= sizeof(uint32_t)) {
+			uint32_t packetSize;
+			std::memcpy(&packetSize, &receiveBuffer[receiveBegin], sizeof(packetSize));
+			packetSize = ntohl(packetSize);
+
+			if (packetSize > MaxPacketSize) {
+				Log::Error("Cannot receive a packet of ", packetSize, " bytes (the maximum is ", MaxPacketSize, " bytes)\n");
+				receiveBegin = 0;
+				receiveEnd = 0;
+				RecordReceive(0, 0, Status::Error);
+				return Status::Error;
+			}
+
+			required += packetSize;
+
+			if (available >= required) {
+				if (required > sizeof(packetSize))
+					packet.OnReceive(&receiveBuffer[receiveBegin + sizeof(packetSize)], required - sizeof(packetSize));
+
+				receiveBegin += required;
+
+				if (receiveBegin == receiveEnd) {
+					receiveBegin = 0;
+					receiveEnd = 0;
+				}
 
-	if (pendingPacket.sizeReceived < sizeof(pendingPacket.size)) {
-		// Loop until we've received the entire size of the packet (even a 4 byte variable may be received in more than one call).
-		while (pendingPacket.sizeReceived < sizeof(pendingPacket.size)) {
-			auto data = reinterpret_cast<char *>(&pendingPacket.size) + pendingPacket.sizeReceived;
-			Status status = Receive(data, sizeof(pendingPacket.size) - pendingPacket.sizeReceived, received);
-			pendingPacket.sizeReceived += received;
+				// Shrink a buffer grown by a large packet once what remains fits in the default size again.
+				if (receiveBuffer.size() > ReceiveBufferSize && receiveEnd - receiveBegin <= ReceiveBufferSize) {
+					std::memmove(&receiveBuffer[0], &receiveBuffer[receiveBegin], receiveEnd - receiveBegin);
+					receiveEnd -= receiveBegin;
+					receiveBegin = 0;
+					receiveBuffer.resize(ReceiveBufferSize);
+					receiveBuffer.shrink_to_fit();
+				}
 
-			if (status != Status::Done)
-				return status;
+				RecordPacketReceived();
+				return Status::Done;
+			}
 		}
 
-		// The packet size has been fully received.
-		packetSize = ntohl(pendingPacket.size);
-	} else {
-		// The packet size has already been received in a previous call.
-		packetSize = ntohl(pendingPacket.size);
-	}
+		// Move the partial packet to the front when the rest of it won't fit after it, or the free space is getting small.
+		if (receiveBegin + required > receiveBuffer.size() || receiveBuffer.size() - receiveEnd < receiveBuffer.size() / 4) {
+			std::memmove(&receiveBuffer[0], &receiveBuffer[receiveBegin], available);
+			receiveBegin = 0;
+			receiveEnd = available;
+		}
 
-	// Loop until we receive all the packet data.
-	char buffer[1024];
+		// Packets larger than the buffer grow it.
+		if (required > receiveBuffer.size())
+			receiveBuffer.resize(required);
 
-	while (pendingPacket.data.size() < packetSize) {
-		// Receive a chunk of data.
-		auto sizeToGet = std::min(static_cast<std::size_t>(packetSize - pendingPacket.data.size()), sizeof(buffer));
-		auto status = Receive(buffer, sizeToGet, received);
+		// Read as much as fits, this may contain the rest of this packet and any following packets.
+		auto sizeReceived = recv(GetHandle(), &receiveBuffer[receiveEnd], static_cast<int>(receiveBuffer.size() - receiveEnd), flags);
 
-		if (status != Status::Done)
+		if (sizeReceived <= 0) {
+			auto status = sizeReceived == 0 ? Status::Disconnected : GetErrorStatus();
+			RecordReceive(0, 0, status);
 			return status;
-
-		// Append it into the packet.
-		if (received > 0) {
-			pendingPacket.data.resize(pendingPacket.data.size() + received);
-			auto begin = &pendingPacket.data[0] + pendingPacket.data.size() - received;
-			std::memcpy(begin, buffer, received);
 		}
+
+		receiveEnd += static_cast<std::size_t>(sizeReceived);
+		RecordReceive(static_cast<std::size_t>(sizeReceived), 0, Status::Done);
 	}
+}
 
-	// We have received all the packet data: we can copy it to the user packet.
-	if (!pendingPacket.data.empty())
-		packet.OnReceive(&pendingPacket.data[0], pendingPacket.data.size());
+bool TcpSocket::HasBufferedPacket() const {
+	auto available = receiveEnd - receiveBegin;
 
-	// Clear the pending packet data.
-	pendingPacket = {};
-	return Status::Done;
+	if (available < sizeof(uint32_t))
+		return false;
+
+	uint32_t packetSize;
+	std::memcpy(&packetSize, &receiveBuffer[receiveBegin], sizeof(packetSize));
+	return available >= sizeof(packetSize) + ntohl(packetSize);
 }
 }
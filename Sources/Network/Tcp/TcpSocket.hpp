@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <vector>
 
 #include "Maths/Time.hpp"
@@ -10,7 +11,9 @@ class IpAddress;
 class Packet;
 
 /**
- * @brief TCP is a connected protocol, which means that a TCP socket can only communicate with
+ * @brief Specialized socket using the TCP protocol.
+ *
+ * TCP is a connected protocol, which means that a TCP socket can only communicate with
  * the host it is connected to. It can't send or receive anything if it is not connected.
  *
  * The TCP protocol is reliable but adds a slight overhead. It ensures that your data
@@ -32,24 +35,14 @@ class Packet;
  * The socket is automatically disconnected when it is destroyed, but if you want to
  * explicitly close the connection while the socket instance is still alive, you can call disconnect.
  */
-class ACID_EXPORT PendingPacket {
-public:
-	PendingPacket() = default;
-
-	/// Data of packet size.
-	uint32_t size = 0;
-	/// Number of size bytes received so far.
-	std::size_t sizeReceived = 0;
-	/// Data of the packet.
-	std::vector<char> data;
-};
-
-/**
- * @brief Specialized socket using the TCP protocol
- */
 class ACID_EXPORT TcpSocket : public Socket {
 	friend class TcpListener;
 public:
+	/// Initial size of the receive buffer, packets larger than this grow it.
+	static constexpr std::size_t ReceiveBufferSize = 65536;
+	/// Largest packet that will be received, larger sizes are treated as a corrupt or hostile stream.
+	static constexpr std::size_t MaxPacketSize = 64 * 1024 * 1024;
+
 	/**
 	 * Default constructor.
 	 */
@@ -116,6 +109,7 @@ public:
 	/**
 	 * Receive raw data from the remote peer.
 	 * In blocking mode, this function will wait until some bytes are actually received.
+	 * Bytes already buffered by receiving packets are returned first.
 	 * This function will fail if the socket is not connected.
 	 * @param data Pointer to the array to fill with the received bytes.
 	 * @param size Maximum number of bytes that can be received.
@@ -124,8 +118,21 @@ public:
 	 */
 	Status Receive(void *data, std::size_t size, std::size_t &received);
 
+	/**
+	 * Send part of a file to the remote peer.
+	 * On Linux the system copies the file to the socket without it passing through the process, elsewhere it is read in blocks.
+	 * This function will fail if the socket is not connected.
+	 * @param file The file to send from, its position may be changed.
+	 * @param offset Offset in the file to start from.
+	 * @param size Number of bytes to send.
+	 * @param sent The number of bytes sent will be written here, less than the size if the end of the file was reached.
+	 * @return Status code.
+	 */
+	Status SendFile(std::FILE *file, uint64_t offset, std::size_t size, std::size_t &sent);
+
 	/**
 	 * Send a formatted packet of data to the remote peer.
+	 * The size and data are gathered into one send, without copying the packet.
 	 * In non-blocking mode, if this function returns SOCKET_STATUS_PARTIAL, you \em must retry sending the same unmodified
 	 * packet before sending anything else in order to guarantee the packet arrives at the remote peer uncorrupted.
 	 * This function will fail if the socket is not connected.
@@ -137,14 +144,28 @@ public:
 	/**
 	 * Receive a formatted packet of data from the remote peer.
 	 * In blocking mode, this function will wait until the whole packet has been received.
+	 * Data is received in large reads, so one read may hold several packets, these are returned by following calls without reading again.
+	 * When using non-blocking sockets with edge triggered selectors, call this until it no longer returns Done.
+	 * A packet with a size larger than MaxPacketSize returns Error and discards the buffered data.
 	 * This function will fail if the socket is not connected.
 	 * @param packet Packet to fill with the received data.
 	 * @return Status code.
 	 */
 	Status Receive(Packet &packet);
 
+	/**
+	 * Gets if a whole packet has already been read from the socket, so the next Receive(Packet) returns it without reading.
+	 * Selectors will not report these packets as the socket has nothing left to read.
+	 * @return If a whole packet is buffered.
+	 */
+	bool HasBufferedPacket() const;
+
 private:
-	/// Temporary data of the packet currently being received.
-	PendingPacket pendingPacket;
+	/// Received data that has not been returned yet, packets are parsed from here.
+	std::vector<char> receiveBuffer;
+	/// Start of the unread data in the receive buffer.
+	std::size_t receiveBegin = 0;
+	/// End of the unread data in the receive buffer.
+	std::size_t receiveEnd = 0;
 };
 }
@@ -0,0 +1,397 @@
+#include "UdpConnection.hpp"
+
+#include <cstring>
+
+#include "Engine/Log.hpp"
+#include "Network/Packet.hpp"
+#include "UdpSocket.hpp"
+
+namespace acid {
+/// Size of the sequence, flags, ack and ack bits at the start of each datagram.
+static constexpr std::size_t DatagramHeaderSize = 9;
+/// Size of the channel, message id, fragment index, fragment count and size before each fragment.
+static constexpr std::size_t FragmentHeaderSize = 9;
+/// Set in the datagram flags when the ack fields are valid.
+static constexpr uint8_t HasAckFlag = 1;
+
+/**
+ * Compares sequence numbers that may have wrapped around.
+ * @param a The first sequence.
+ * @param b The second sequence.
+ * @return If a is more recent than b.
+ */
+static bool SequenceGreater(uint16_t a, uint16_t b) {
+	return (a > b && a - b <= 32768) || (a < b && b - a > 32768);
+}
+
+static void Write8(std::vector<char> &data, uint8_t value) {
+	data.emplace_back(static_cast<char>(value));
+}
+
+static void Write16(std::vector<char> &data, uint16_t value) {
+	data.emplace_back(static_cast<char>(value >> 8));
+	data.emplace_back(static_cast<char>(value));
+}
+
+static void Write32(std::vector<char> &data, uint32_t value) {
+	Write16(data, static_cast<uint16_t>(value >> 16));
+	Write16(data, static_cast<uint16_t>(value));
+}
+
+static uint16_t Read16(const uint8_t *data) {
+	return static_cast<uint16_t>(data[0] << 8 | data[1]);
+}
+
+static uint32_t Read32(const uint8_t *data) {
+	return static_cast<uint32_t>(Read16(data)) << 16 | Read16(data + 2);
+}
+
+UdpConnection::UdpConnection(UdpSocket &socket, const IpAddress &address, uint16_t port, const std::vector<Delivery> &channels) :
+	socket(&socket),
+	address(address),
+	port(port),
+	random(std::random_device()()) {
+	for (auto delivery : channels) {
+		auto &channel = this->channels.emplace_back();
+		channel.delivery = delivery;
+	}
+
+	datagram.reserve(MaxDatagramSize);
+}
+
+bool UdpConnection::Send(uint8_t channel, const void *data, std::size_t size) {
+	if (channel >= channels.size()) {
+		Log::Error("Cannot send message on channel ", static_cast<uint32_t>(channel), ", the connection has ", channels.size(), " channels\n");
+		return false;
+	}
+
+	if (size > FragmentSize * MaxFragmentCount) {
+		Log::Error("Cannot send message of ", size, " bytes, the maximum is ", FragmentSize * MaxFragmentCount, '\n');
+		return false;
+	}
+
+	auto &message = channels[channel].outgoing.emplace_back();
+	message.data.assign(static_cast<const char *>(data), static_cast<const char *>(data) + size);
+	message.fragments.resize(std::max<std::size_t>((size + FragmentSize - 1) / FragmentSize, 1));
+	message.remaining = message.fragments.size();
+	return true;
+}
+
+bool UdpConnection::Send(uint8_t channel, Packet &packet) {
+	auto dataSize = packet.OnSend();
+	return Send(channel, dataSize.first, dataSize.second);
+}
+
+bool UdpConnection::Receive(uint8_t &channel, Packet &packet) {
+	if (received.empty())
+		return false;
+
+	auto &[messageChannel, data] = received.front();
+	channel = messageChannel;
+	packet.Clear();
+
+	if (!data.empty())
+		packet.OnReceive(data.data(), data.size());
+
+	received.pop_front();
+	return true;
+}
+
+void UdpConnection::OnReceive(const void *data, std::size_t size) {
+	auto bytes = static_cast<const uint8_t *>(data);
+
+	if (size < DatagramHeaderSize)
+		return;
+
+	receivedDatagramCount++;
+	auto remote = Read16(bytes);
+	auto flags = bytes[2];
+	auto ack = Read16(bytes + 3);
+	auto ackBits = Read32(bytes + 5);
+
+	// Remember this sequence, so it is acknowledged by the next datagram sent.
+	if (!receivedAny) {
+		remoteSequence = remote;
+		remoteAckBits = 0;
+		receivedAny = true;
+	} else if (SequenceGreater(remote, remoteSequence)) {
+		uint16_t difference = remote - remoteSequence;
+		remoteAckBits = difference < 32 ? remoteAckBits << difference : 0;
+		if (difference <= 32)
+			remoteAckBits |= 1u << (difference - 1);
+		remoteSequence = remote;
+	} else {
+		uint16_t difference = remoteSequence - remote;
+		if (difference > 0 && difference <= 32)
+			remoteAckBits |= 1u << (difference - 1);
+	}
+
+	ackPending = true;
+
+	if (flags & HasAckFlag) {
+		auto now = Time::Now();
+		AckDatagram(ack, now);
+
+		for (uint16_t i = 0; i < 32; i++) {
+			if (ackBits & (1u << i))
+				AckDatagram(static_cast<uint16_t>(ack - 1 - i), now);
+		}
+
+		DetectLoss(ack);
+
+		// Reliable messages are removed once every fragment has been acknowledged.
+		for (auto &channel : channels) {
+			while (!channel.outgoing.empty() && channel.outgoing.front().remaining == 0) {
+				channel.outgoing.pop_front();
+				channel.oldestMessageId++;
+			}
+		}
+	}
+
+	for (std::size_t offset = DatagramHeaderSize; offset + FragmentHeaderSize <= size;) {
+		auto channel = bytes[offset];
+		auto messageId = Read16(bytes + offset + 1);
+		auto fragment = Read16(bytes + offset + 3);
+		auto fragmentCount = Read16(bytes + offset + 5);
+		auto fragmentSize = Read16(bytes + offset + 7);
+		offset += FragmentHeaderSize;
+
+		// Anything malformed drops the rest of the datagram.
+		if (channel >= channels.size() || fragmentCount == 0 || fragmentCount > MaxFragmentCount || fragment >= fragmentCount ||
+			fragmentSize > FragmentSize || offset + fragmentSize > size)
+			break;
+
+		ReceiveFragment(channel, messageId, fragment, fragmentCount, reinterpret_cast<const char *>(bytes + offset), fragmentSize);
+		offset += fragmentSize;
+	}
+}
+
+void UdpConnection::Update() {
+	auto now = Time::Now();
+
+	// Send simulated datagrams that have been delayed long enough.
+	for (auto it = delayed.begin(); it != delayed.end();) {
+		if (it->time <= now) {
+			socket->Send(it->data.data(), it->data.size(), address, port);
+			it = delayed.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// Fragments are resent if they have not been acknowledged after a couple of round trips.
+	auto resendTime = roundTripSampled ? std::max(roundTripTime * 2.0f, Time::Milliseconds(20)) : Time::Milliseconds(250);
+
+	BeginDatagram();
+
+	for (std::size_t channelIndex = 0; channelIndex < channels.size(); channelIndex++) {
+		auto &channel = channels[channelIndex];
+
+		if (channel.delivery == Delivery::Unreliable) {
+			for (auto &message : channel.outgoing) {
+				for (std::size_t fragment = 0; fragment < message.fragments.size(); fragment++)
+					WriteFragment(static_cast<uint8_t>(channelIndex), channel.oldestMessageId, static_cast<uint16_t>(fragment), message, false, now);
+				channel.oldestMessageId++;
+			}
+
+			channel.outgoing.clear();
+			continue;
+		}
+
+		// Only messages the peer has room for are sent.
+		auto messageCount = std::min<std::size_t>(channel.outgoing.size(), MessageWindow);
+
+		for (std::size_t i = 0; i < messageCount; i++) {
+			auto &message = channel.outgoing[i];
+			auto messageId = static_cast<uint16_t>(channel.oldestMessageId + i);
+
+			for (std::size_t fragment = 0; fragment < message.fragments.size(); fragment++) {
+				auto &outgoingFragment = message.fragments[fragment];
+
+				if (outgoingFragment.acked || (outgoingFragment.sent && now - outgoingFragment.time < resendTime))
+					continue;
+
+				if (outgoingFragment.sent)
+					resentFragmentCount++;
+
+				outgoingFragment.sent = true;
+				outgoingFragment.time = now;
+				WriteFragment(static_cast<uint8_t>(channelIndex), messageId, static_cast<uint16_t>(fragment), message, true, now);
+			}
+		}
+	}
+
+	// Datagrams are sent without fragments when there is nothing else to acknowledge received datagrams with.
+	if (datagram.size() > DatagramHeaderSize || ackPending)
+		FlushDatagram(now);
+}
+
+void UdpConnection::ReceiveFragment(uint8_t channelIndex, uint16_t messageId, uint16_t fragment, uint16_t fragmentCount, const char *data, std::size_t size) {
+	auto &channel = channels[channelIndex];
+
+	if (channel.delivery == Delivery::Unreliable) {
+		// Unreliable channels keep a window behind the newest message, older incomplete messages are dropped.
+		if (static_cast<uint16_t>(messageId - channel.nextMessageId) >= MessageWindow && SequenceGreater(messageId, channel.nextMessageId)) {
+			channel.nextMessageId = static_cast<uint16_t>(messageId - MessageWindow + 1);
+
+			for (auto it = channel.incoming.begin(); it != channel.incoming.end();)
+				it = SequenceGreater(channel.nextMessageId, it->first) ? channel.incoming.erase(it) : std::next(it);
+			for (auto it = channel.delivered.begin(); it != channel.delivered.end();)
+				it = SequenceGreater(channel.nextMessageId, *it) ? channel.delivered.erase(it) : std::next(it);
+		}
+	}
+
+	// Drop messages that have already been delivered, or are outside of the window.
+	if (static_cast<uint16_t>(messageId - channel.nextMessageId) >= MessageWindow || channel.delivered.count(messageId))
+		return;
+
+	auto &message = channel.incoming[messageId];
+
+	if (message.fragmentReceived.empty()) {
+		message.fragmentReceived.resize(fragmentCount);
+		message.remaining = fragmentCount;
+	}
+
+	if (message.fragmentReceived.size() != fragmentCount || message.fragmentReceived[fragment])
+		return;
+
+	// Every fragment is full size except the last, so fragments are copied straight to their place in the message.
+	message.fragmentReceived[fragment] = true;
+	message.remaining--;
+	auto offset = fragment * FragmentSize;
+
+	if (message.data.size() < offset + size)
+		message.data.resize(offset + size);
+	if (size > 0)
+		std::memcpy(&message.data[offset], data, size);
+	if (fragment + 1 == fragmentCount)
+		message.size = offset + size;
+
+	if (message.remaining > 0)
+		return;
+
+	message.data.resize(message.size);
+
+	if (channel.delivery == Delivery::ReliableOrdered) {
+		// Deliver this message and any that were waiting for it.
+		for (auto it = channel.incoming.find(channel.nextMessageId); it != channel.incoming.end() && it->second.remaining == 0;
+			it = channel.incoming.find(channel.nextMessageId)) {
+			received.emplace_back(channelIndex, std::move(it->second.data));
+			channel.incoming.erase(it);
+			channel.nextMessageId++;
+		}
+	} else {
+		received.emplace_back(channelIndex, std::move(message.data));
+		channel.incoming.erase(messageId);
+		channel.delivered.emplace(messageId);
+
+		if (channel.delivery == Delivery::ReliableUnordered) {
+			while (channel.delivered.erase(channel.nextMessageId))
+				channel.nextMessageId++;
+		}
+	}
+}
+
+void UdpConnection::AckDatagram(uint16_t sequence, const Time &now) {
+	auto &sentDatagram = sentDatagrams[sequence % sentDatagrams.size()];
+
+	if (!sentDatagram.valid || sentDatagram.sequence != sequence || sentDatagram.acked)
+		return;
+
+	sentDatagram.acked = true;
+
+	auto sample = now - sentDatagram.time;
+	roundTripTime = roundTripSampled ? roundTripTime * 0.9f + sample * 0.1f : sample;
+	roundTripSampled = true;
+	packetLoss *= 0.95f;
+
+	for (const auto &fragmentId : sentDatagram.fragments) {
+		auto &channel = channels[fragmentId.channel];
+		auto index = static_cast<uint16_t>(fragmentId.messageId - channel.oldestMessageId);
+
+		if (index >= channel.outgoing.size())
+			continue;
+
+		auto &message = channel.outgoing[index];
+		auto &fragment = message.fragments[fragmentId.fragment];
+
+		if (!fragment.acked) {
+			fragment.acked = true;
+			message.remaining--;
+		}
+	}
+}
+
+void UdpConnection::DetectLoss(uint16_t ack) {
+	// Datagrams that fall out of the ack bits without being acknowledged were lost.
+	auto oldest = static_cast<uint16_t>(ack - 32);
+
+	while (SequenceGreater(oldest, lossSequence)) {
+		auto &sentDatagram = sentDatagrams[lossSequence % sentDatagrams.size()];
+
+		if (sentDatagram.valid && sentDatagram.sequence == lossSequence && !sentDatagram.acked)
+			packetLoss = packetLoss * 0.95f + 0.05f;
+
+		lossSequence++;
+	}
+}
+
+void UdpConnection::WriteFragment(uint8_t channelIndex, uint16_t messageId, uint16_t fragment, const OutgoingMessage &message, bool reliable, const Time &now) {
+	auto offset = fragment * FragmentSize;
+	auto size = std::min(FragmentSize, message.data.size() - offset);
+
+	if (datagram.size() + FragmentHeaderSize + size > MaxDatagramSize) {
+		FlushDatagram(now);
+		BeginDatagram();
+	}
+
+	Write8(datagram, channelIndex);
+	Write16(datagram, messageId);
+	Write16(datagram, fragment);
+	Write16(datagram, static_cast<uint16_t>(message.fragments.size()));
+	Write16(datagram, static_cast<uint16_t>(size));
+	datagram.insert(datagram.end(), message.data.begin() + offset, message.data.begin() + offset + size);
+
+	// Only reliable fragments need to know which datagram they were sent in.
+	if (reliable)
+		datagramFragments.emplace_back(FragmentId{channelIndex, messageId, fragment});
+}
+
+void UdpConnection::BeginDatagram() {
+	datagram.clear();
+	datagramFragments.clear();
+
+	Write16(datagram, sequence);
+	Write8(datagram, receivedAny ? HasAckFlag : 0);
+	Write16(datagram, remoteSequence);
+	Write32(datagram, remoteAckBits);
+}
+
+void UdpConnection::FlushDatagram(const Time &now) {
+	auto &sentDatagram = sentDatagrams[sequence % sentDatagrams.size()];
+	sentDatagram.sequence = sequence;
+	sentDatagram.valid = true;
+	sentDatagram.acked = false;
+	sentDatagram.time = now;
+	sentDatagram.fragments.assign(datagramFragments.begin(), datagramFragments.end());
+
+	sequence++;
+	sentDatagramCount++;
+	ackPending = false;
+
+	// The simulation drops and delays datagrams before they reach the socket.
+	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+	if (simulation.packetLoss > 0.0f && distribution(random) < simulation.packetLoss)
+		return;
+
+	auto delay = simulation.latency + simulation.jitter * distribution(random);
+
+	if (delay > Time()) {
+		delayed.emplace_back(DelayedDatagram{now + delay, datagram});
+		return;
+	}
+
+	socket->Send(datagram.data(), datagram.size(), address, port);
+}
+}
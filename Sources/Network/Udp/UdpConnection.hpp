@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Maths/Time.hpp"
+#include "Network/IpAddress.hpp"
+
+namespace acid {
+class Packet;
+class UdpSocket;
+
+/**
+ * @brief A connection to one peer on top of a UdpSocket, with reliable and unreliable channels.
+ *
+ * Every datagram carries a sequence number, the latest sequence received from the peer and a bitfield
+ * acknowledging the 32 sequences before it. Fragments of reliable messages are remembered with the datagram
+ * they were sent in, and only the fragments of datagrams that are never acknowledged are sent again.
+ *
+ * Messages are sent on channels, each channel delivers messages in one of these ways:
+ * \li Unreliable, messages may be lost, duplicated messages are dropped.
+ * \li ReliableUnordered, every message arrives once, in any order.
+ * \li ReliableOrdered, every message arrives once, in the order it was sent.
+ *
+ * Messages larger than FragmentSize are split into fragments and reassembled by the peer.
+ *
+ * The socket is not owned and may be shared by many connections, received datagrams from the peer
+ * are passed to the connection with {@link UdpConnection#OnReceive}, and {@link UdpConnection#Update}
+ * sends queued messages, retransmits and acknowledgements.
+ */
+class ACID_EXPORT UdpConnection {
+public:
+	/**
+	 * @brief How messages on a channel are delivered.
+	 */
+	enum class Delivery {
+		Unreliable, ReliableUnordered, ReliableOrdered
+	};
+
+	/**
+	 * @brief Settings that simulate a bad network on datagrams sent from this connection.
+	 */
+	class Simulation {
+	public:
+		/// Chance that a datagram is dropped, from 0 to 1.
+		float packetLoss = 0.0f;
+		/// Time added before each datagram is sent.
+		Time latency;
+		/// Random time up to this is added to the latency, which reorders datagrams.
+		Time jitter;
+	};
+
+	/// Maximum size of datagrams sent, small enough to avoid IP fragmentation.
+	static constexpr std::size_t MaxDatagramSize = 1200;
+	/// Size of each fragment of a message.
+	static constexpr std::size_t FragmentSize = 1024;
+	/// Maximum number of fragments in a message.
+	static constexpr std::size_t MaxFragmentCount = 256;
+	/// Number of messages on a reliable channel that may be in flight at once.
+	static constexpr uint16_t MessageWindow = 1024;
+
+	/**
+	 * Creates a new connection.
+	 * @param socket The socket to send with.
+	 * @param address Address of the peer.
+	 * @param port Port of the peer.
+	 * @param channels The delivery of each channel, channels are indexed in this order.
+	 */
+	UdpConnection(UdpSocket &socket, const IpAddress &address, uint16_t port,
+		const std::vector<Delivery> &channels = {Delivery::Unreliable, Delivery::ReliableUnordered, Delivery::ReliableOrdered});
+
+	/**
+	 * Queues a message to be sent on the next update.
+	 * @param channel The channel to send on.
+	 * @param data Pointer to the sequence of bytes to send.
+	 * @param size Number of bytes to send, at most FragmentSize * MaxFragmentCount.
+	 * @return If the message was queued.
+	 */
+	bool Send(uint8_t channel, const void *data, std::size_t size);
+
+	/**
+	 * Queues a packet to be sent on the next update.
+	 * @param channel The channel to send on.
+	 * @param packet Packet to send.
+	 * @return If the packet was queued.
+	 */
+	bool Send(uint8_t channel, Packet &packet);
+
+	/**
+	 * Takes the next message that has been delivered.
+	 * @param channel The channel the message was sent on will be written here.
+	 * @param packet Packet to fill with the message.
+	 * @return If there was a message.
+	 */
+	bool Receive(uint8_t &channel, Packet &packet);
+
+	/**
+	 * Handles a datagram received from the peer.
+	 * @param data Pointer to the datagram.
+	 * @param size Size of the datagram.
+	 */
+	void OnReceive(const void *data, std::size_t size);
+
+	/**
+	 * Sends queued messages, fragments that have not been acknowledged in time, and acknowledgements.
+	 */
+	void Update();
+
+	const IpAddress &GetAddress() const { return address; }
+	uint16_t GetPort() const { return port; }
+
+	const Simulation &GetSimulation() const { return simulation; }
+	void SetSimulation(const Simulation &simulation) { this->simulation = simulation; }
+
+	/**
+	 * Gets the smoothed round trip time of acknowledged datagrams.
+	 * @return The round trip time.
+	 */
+	const Time &GetRoundTripTime() const { return roundTripTime; }
+
+	/**
+	 * Gets the smoothed fraction of sent datagrams that were not acknowledged.
+	 * @return The packet loss, from 0 to 1.
+	 */
+	float GetPacketLoss() const { return packetLoss; }
+
+	uint64_t GetSentDatagrams() const { return sentDatagramCount; }
+	uint64_t GetReceivedDatagrams() const { return receivedDatagramCount; }
+	uint64_t GetResentFragments() const { return resentFragmentCount; }
+
+private:
+	class FragmentId {
+	public:
+		uint8_t channel;
+		uint16_t messageId;
+		uint16_t fragment;
+	};
+
+	class SentDatagram {
+	public:
+		uint16_t sequence = 0;
+		bool valid = false;
+		bool acked = false;
+		Time time;
+		std::vector<FragmentId> fragments;
+	};
+
+	class OutgoingFragment {
+	public:
+		/// When the fragment was last sent.
+		Time time;
+		bool sent = false;
+		bool acked = false;
+	};
+
+	class OutgoingMessage {
+	public:
+		std::vector<char> data;
+		std::vector<OutgoingFragment> fragments;
+		/// Number of fragments that have not been acknowledged.
+		std::size_t remaining = 0;
+	};
+
+	class IncomingMessage {
+	public:
+		std::vector<char> data;
+		std::vector<bool> fragmentReceived;
+		std::size_t remaining = 0;
+		std::size_t size = 0;
+	};
+
+	class Channel {
+	public:
+		Delivery delivery;
+		/// Messages not yet acknowledged, the front has the id oldestMessageId.
+		std::deque<OutgoingMessage> outgoing;
+		uint16_t oldestMessageId = 0;
+		/// Messages still being reassembled, or waiting for earlier messages on ordered channels.
+		std::map<uint16_t, IncomingMessage> incoming;
+		/// Oldest message id that has not been delivered, or the start of the window behind the newest message on unreliable channels.
+		uint16_t nextMessageId = 0;
+		/// Message ids after nextMessageId that have already been delivered, on channels that are not ordered.
+		std::set<uint16_t> delivered;
+	};
+
+	class DelayedDatagram {
+	public:
+		Time time;
+		std::vector<char> data;
+	};
+
+	void ReceiveFragment(uint8_t channelIndex, uint16_t messageId, uint16_t fragment, uint16_t fragmentCount, const char *data, std::size_t size);
+	void AckDatagram(uint16_t sequence, const Time &now);
+	void DetectLoss(uint16_t ack);
+	void WriteFragment(uint8_t channelIndex, uint16_t messageId, uint16_t fragment, const OutgoingMessage &message, bool reliable, const Time &now);
+	void BeginDatagram();
+	void FlushDatagram(const Time &now);
+
+	UdpSocket *socket;
+	IpAddress address;
+	uint16_t port;
+	std::vector<Channel> channels;
+
+	/// Messages that have been received and are waiting to be taken with Receive.
+	std::deque<std::pair<uint8_t, std::vector<char>>> received;
+
+	uint16_t sequence = 0;
+	std::array<SentDatagram, 1024> sentDatagrams;
+	/// The next sent sequence to check for loss.
+	uint16_t lossSequence = 0;
+	uint16_t remoteSequence = 0;
+	uint32_t remoteAckBits = 0;
+	bool receivedAny = false;
+	bool ackPending = false;
+
+	/// The datagram being written, and the fragments in it.
+	std::vector<char> datagram;
+	std::vector<FragmentId> datagramFragments;
+
+	Simulation simulation;
+	std::vector<DelayedDatagram> delayed;
+	std::mt19937 random;
+
+	Time roundTripTime;
+	bool roundTripSampled = false;
+	float packetLoss = 0.0f;
+	uint64_t sentDatagramCount = 0;
+	uint64_t receivedDatagramCount = 0;
+	uint64_t resentFragmentCount = 0;
+};
+}
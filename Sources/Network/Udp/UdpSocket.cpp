@@ -3,6 +3,7 @@
 #if defined(ACID_BUILD_WINDOWS)
 #include <WinSock2.h>
 #else
+#include <sys/socket.h>
 #include <netinet/in.h>
 #endif
 
@@ -76,9 +77,13 @@ Socket::Status UdpSocket::Send(const void *data, std::size_t size, const IpAddre
 	auto sent = sendto(GetHandle(), static_cast<const char *>(data), static_cast<int>(size), 0, reinterpret_cast<sockaddr *>(&address), sizeof(address));
 
 	// Check for errors.
-	if (sent < 0)
-		return GetErrorStatus();
+	if (sent < 0) {
+		auto status = GetErrorStatus();
+		RecordSend(0, 0, status);
+		return status;
+	}
 
+	RecordSend(static_cast<std::size_t>(sent), 1, Status::Done);
 	return Status::Done;
 }
 
@@ -102,11 +107,15 @@ Socket::Status UdpSocket::Receive(void *data, std::size_t size, std::size_t &rec
 	auto sizeReceived = recvfrom(GetHandle(), static_cast<char *>(data), static_cast<int>(size), 0, reinterpret_cast<sockaddr *>(&address), &addressSize);
 
 	// Check for errors.
-	if (sizeReceived < 0)
-		return GetErrorStatus();
+	if (sizeReceived < 0) {
+		auto status = GetErrorStatus();
+		RecordReceive(0, 0, status);
+		return status;
+	}
 
 	// Fill the sender informations.
 	received = static_cast<std::size_t>(sizeReceived);
+	RecordReceive(received, 1, Status::Done);
 	remoteAddress = IpAddress(ntohl(address.sin_addr.s_addr));
 	remotePort = ntohs(address.sin_port);
 
@@ -144,4 +153,144 @@ Socket::Status UdpSocket::Receive(Packet &packet, IpAddress &remoteAddress, uint
 
 	return status;
 }
+
+Socket::Status UdpSocket::Send(const Datagram *datagrams, std::size_t count, std::size_t &sent) {
+	sent = 0;
+
+	// Create the internal socket if it doesn't exist.
+	Create();
+
+#if defined(ACID_BUILD_LINUX)
+	mmsghdr messages[BatchSize];
+	iovec buffers[BatchSize];
+	sockaddr_in addresses[BatchSize];
+
+	while (sent < count) {
+		auto batchCount = std::min(count - sent, BatchSize);
+
+		for (std::size_t i = 0; i < batchCount; i++) {
+			auto &datagram = datagrams[sent + i];
+			auto dataSize = datagram.packet->OnSend();
+
+			// Make sure that all the data will fit in one datagram.
+			if (dataSize.second > MAX_DATAGRAM_SIZE) {
+				Log::Error("Cannot send data over the network (the number of bytes to send is greater than UdpSocket::MaxDatagramSize)\n");
+				return Status::Error;
+			}
+
+			addresses[i] = CreateAddress(datagram.address.ToInteger(), datagram.port);
+			buffers[i] = {const_cast<char *>(static_cast<const char *>(dataSize.first)), dataSize.second};
+			messages[i] = {};
+			messages[i].msg_hdr.msg_name = &addresses[i];
+			messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+			messages[i].msg_hdr.msg_iov = &buffers[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// Send every datagram in the batch with one call, this may send less than the whole batch.
+		auto result = sendmmsg(GetHandle(), messages, static_cast<unsigned int>(batchCount), 0);
+
+		// Check for errors.
+		if (result < 0) {
+			auto status = GetErrorStatus();
+			RecordSend(0, 0, status);
+			return status == Status::NotReady && sent ? Status::Partial : status;
+		}
+
+		std::size_t bytes = 0;
+		for (int i = 0; i < result; i++)
+			bytes += messages[i].msg_len;
+
+		RecordSend(bytes, static_cast<std::size_t>(result), static_cast<std::size_t>(result) < batchCount ? Status::Partial : Status::Done);
+		sent += static_cast<std::size_t>(result);
+	}
+#else
+	// Without sendmmsg each datagram is sent with its own call.
+	for (; sent < count; sent++) {
+		auto &datagram = datagrams[sent];
+		auto status = Send(*datagram.packet, datagram.address, datagram.port);
+
+		if (status != Status::Done)
+			return status == Status::NotReady && sent ? Status::Partial : status;
+	}
+#endif
+
+	return Status::Done;
+}
+
+Socket::Status UdpSocket::Receive(Datagram *datagrams, std::size_t count, std::size_t &received) {
+	received = 0;
+
+#if defined(ACID_BUILD_LINUX)
+	if (batchBuffer.empty())
+		batchBuffer.resize(BatchSize * BatchDatagramSize);
+
+	mmsghdr messages[BatchSize];
+	iovec buffers[BatchSize];
+	sockaddr_in addresses[BatchSize];
+
+	while (received < count) {
+		auto batchCount = std::min(count - received, BatchSize);
+
+		for (std::size_t i = 0; i < batchCount; i++) {
+			buffers[i] = {&batchBuffer[i * BatchDatagramSize], BatchDatagramSize};
+			messages[i] = {};
+			messages[i].msg_hdr.msg_name = &addresses[i];
+			messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+			messages[i].msg_hdr.msg_iov = &buffers[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// Only the first datagram may block, the rest of the batch is whatever is already waiting.
+		auto result = recvmmsg(GetHandle(), messages, static_cast<unsigned int>(batchCount), received == 0 ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+
+		// Check for errors, running out of datagrams after receiving some is not an error.
+		if (result < 0) {
+			auto status = GetErrorStatus();
+			RecordReceive(0, 0, status);
+			return status == Status::NotReady && received ? Status::Done : status;
+		}
+
+		std::size_t bytes = 0;
+		for (int i = 0; i < result; i++)
+			bytes += messages[i].msg_len;
+
+		RecordReceive(bytes, static_cast<std::size_t>(result), Status::Done);
+
+		for (int i = 0; i < result; i++) {
+			if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+				Log::Warning("Dropped a datagram larger than UdpSocket::BatchDatagramSize\n");
+				continue;
+			}
+
+			// Fill the sender informations, and copy the data to the user packet.
+			auto &datagram = datagrams[received++];
+			datagram.packet->Clear();
+			datagram.address = IpAddress(ntohl(addresses[i].sin_addr.s_addr));
+			datagram.port = ntohs(addresses[i].sin_port);
+
+			if (messages[i].msg_len > 0)
+				datagram.packet->OnReceive(buffers[i].iov_base, messages[i].msg_len);
+		}
+
+		// A short batch means there are no more datagrams waiting.
+		if (static_cast<std::size_t>(result) < batchCount && received)
+			break;
+	}
+#else
+	// Without recvmmsg each datagram is received with its own call, blocking sockets only wait for the first.
+	for (; received < count; received++) {
+		if (received && IsBlocking())
+			break;
+
+		auto &datagram = datagrams[received];
+		auto status = Receive(*datagram.packet, datagram.address, datagram.port);
+
+		if (status != Status::Done)
+			return status == Status::NotReady && received ? Status::Done : status;
+	}
+#endif
+
+	return Status::Done;
+}
 }
@@ -8,6 +8,19 @@
 namespace acid {
 class Packet;
 
+/**
+ * @brief A packet in a batch of datagrams, with the peer it is sent to or was received from.
+ */
+class ACID_EXPORT Datagram {
+public:
+	/// The packet to send, or to fill when receiving. This is not owned by the datagram, see acid::PacketPool.
+	Packet *packet = nullptr;
+	/// Address of the receiver, or the sender once received.
+	IpAddress address;
+	/// Port of the receiver, or the sender once received.
+	uint16_t port = 0;
+};
+
 /**
  * @brief A UDP socket is a connectionless socket. Instead of connecting once to a remote host,
  * like TCP sockets, it can send to and receive from any host at any time.
@@ -34,12 +47,20 @@ class Packet;
  * Indeed, even packets are unable to split and recompose data, due to the unreliability of the protocol
  * (dropped, mixed or duplicated datagrams may lead to a big mess when trying to recompose a packet).
  *
+ * Many datagrams can be sent or received with one call using the batched Send and Receive functions,
+ * these use sendmmsg and recvmmsg where available to send a whole tick of datagrams with a few system calls.
+ *
  * If the socket is bound to a port, it is automatically unbound from it when the socket is destroyed.
  * However, you can unbind the socket explicitly with the Unbind function if necessary,
  * to stop receiving messages or make the port available for other sockets.
  */
 class ACID_EXPORT UdpSocket : public Socket {
 public:
+	/// Maximum number of datagrams passed to the operating system in one call.
+	static constexpr std::size_t BatchSize = 64;
+	/// Maximum size of datagrams received in batches, larger datagrams are dropped.
+	static constexpr std::size_t BatchDatagramSize = 1472;
+
 	/**
 	 * Default constructor.
 	 */
@@ -117,8 +138,31 @@ public:
 	 */
 	Status Receive(Packet &packet, IpAddress &remoteAddress, uint16_t &remotePort);
 
+	/**
+	 * Send a batch of packets, each to its own peer.
+	 * In non-blocking mode, if this function returns Partial, the datagrams after \a sent must be sent again.
+	 * @param datagrams Packets to send, with the address and port of their receivers.
+	 * @param count Number of datagrams to send.
+	 * @param sent The number of datagrams sent will be written here.
+	 * @return Status code.
+	 */
+	Status Send(const Datagram *datagrams, std::size_t count, std::size_t &sent);
+
+	/**
+	 * Receive a batch of packets.
+	 * In blocking mode, this function waits for the first datagram, then receives any others that are waiting without blocking.
+	 * Datagrams larger than BatchDatagramSize are dropped.
+	 * @param datagrams Datagrams to fill, each must have a packet.
+	 * @param count Maximum number of datagrams to receive.
+	 * @param received The number of datagrams received will be written here.
+	 * @return Status code.
+	 */
+	Status Receive(Datagram *datagrams, std::size_t count, std::size_t &received);
+
 private:
 	/// Temporary buffer holding the received data in Receive(Packet).
 	std::vector<char> buffer;
+	/// Temporary buffer holding the received data of each datagram in a batch.
+	std::vector<char> batchBuffer;
 };
 }
@@ -52,8 +52,7 @@ void ParticleType::Update(const std::vector<Particle> &particles) {
 	if (particles.empty())
 		return;
 
-	Instance *instances;
-	instanceBuffer.MapMemory(reinterpret_cast<void **>(&instances));
+	auto instances = static_cast<Instance *>(instanceBuffer.GetMapped());
 
 	for (const auto &particle : particles) {
 		if (this->instances >= maxInstances)
@@ -80,10 +79,8 @@ void ParticleType::Update(const std::vector<Particle> &particles) {
 		instance->colourOffset = particle.GetParticleType()->colourOffset;
 		instance->offsets = {particle.imageOffset1, particle.imageOffset2};
 		instance->blend = {particle.imageBlendFactor, particle.transparency, static_cast<float>(particle.particleType->numberOfRows)};
-		instances++;
+		this->instances++;
 	}
-
-	instanceBuffer.UnmapMemory();
 }
 
 bool ParticleType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene) {
@@ -1,9 +1,16 @@
 #include "ConvexHullCollider.hpp"
 
+#include <cstring>
+
 #include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
 #include "Meshes/Mesh.hpp"
+#include "Physics/CollisionCache.hpp"
 
 namespace acid {
+/// Version of cooked hulls, changed whenever hulls are cooked differently.
+static constexpr uint32_t HullVersion = 1;
+
 ConvexHullCollider::ConvexHullCollider(const std::vector<float> &pointCloud, const Transform &localTransform) /*:
 	Collider(localTransform)*/ {
 	this->localTransform = localTransform;
@@ -11,6 +18,11 @@ ConvexHullCollider::ConvexHullCollider(const std::vector<float> &pointCloud, con
 		SetPointCount(pointCloud);
 }
 
+ConvexHullCollider::ConvexHullCollider(const std::shared_ptr<Model> &model, const Transform &localTransform) {
+	this->localTransform = localTransform;
+	SetModel(model);
+}
+
 ConvexHullCollider::~ConvexHullCollider() {
 }
 
@@ -48,19 +60,78 @@ btCollisionShape *ConvexHullCollider::GetCollisionShape() const {
 void ConvexHullCollider::SetPointCount(const std::vector<float> &pointCloud) {
 	if (pointCloud.empty()) return;
 
-	shape = std::make_unique<btConvexHullShape>(pointCloud.data(), static_cast<int32_t>(pointCloud.size() / 3), static_cast<int32_t>(sizeof(float)));
+	// Points are packed as three floats.
+	shape = std::make_unique<btConvexHullShape>(pointCloud.data(), static_cast<int32_t>(pointCloud.size() / 3), static_cast<int32_t>(3 * sizeof(float)));
 	shape->optimizeConvexHull();
 	shape->initializePolyhedralFeatures();
 	pointCount = static_cast<uint32_t>(pointCloud.size() / 3);
 }
 
+void ConvexHullCollider::SetModel(const std::shared_ptr<Model> &model) {
+	this->model = model;
+
+	if (!model)
+		return;
+
+	// Models without geometry in memory are read back from the GPU, and are not worth hashing to find in the cache.
+	if (!model->HasCachedGeometry()) {
+		SetPointCount(CookHull(model->GetPointCloud()));
+		return;
+	}
+
+	auto hash = CollisionCache::Hash(model->GetCachedPositions(), model->GetCachedIndices());
+
+	if (auto cooked = CollisionCache::Load("hull", HullVersion, hash)) {
+		std::vector<float> pointCloud(cooked->size() / sizeof(float));
+		std::memcpy(pointCloud.data(), cooked->data(), pointCloud.size() * sizeof(float));
+		SetPointCount(pointCloud);
+		return;
+	}
+
+	auto pointCloud = CookHull(model->GetPointCloud());
+	std::vector<uint8_t> cooked(pointCloud.size() * sizeof(float));
+	std::memcpy(cooked.data(), pointCloud.data(), cooked.size());
+	CollisionCache::Store("hull", HullVersion, hash, cooked);
+	SetPointCount(pointCloud);
+}
+
+std::vector<float> ConvexHullCollider::CookHull(const std::vector<float> &pointCloud) {
+	if (pointCloud.empty())
+		return {};
+
+	btConvexHullShape hullShape(pointCloud.data(), static_cast<int32_t>(pointCloud.size() / 3), static_cast<int32_t>(3 * sizeof(float)));
+	btShapeHull shapeHull(&hullShape);
+	shapeHull.buildHull(hullShape.getMargin());
+
+	std::vector<float> hull;
+	hull.reserve(shapeHull.numVertices() * 3);
+
+	for (int32_t i = 0; i < shapeHull.numVertices(); i++) {
+		const auto &vertex = shapeHull.getVertexPointer()[i];
+		hull.emplace_back(vertex.x());
+		hull.emplace_back(vertex.y());
+		hull.emplace_back(vertex.z());
+	}
+
+	return hull;
+}
+
 const Node &operator>>(const Node &node, ConvexHullCollider &collider) {
 	node["localTransform"].Get(collider.localTransform);
+
+	std::shared_ptr<Model> model;
+	if (node["model"].Get(model))
+		collider.SetModel(model);
+
 	return node;
 }
 
 Node &operator<<(Node &node, const ConvexHullCollider &collider) {
 	node["localTransform"].Set(collider.localTransform);
+
+	if (collider.model)
+		node["model"].Set(collider.model);
+
 	return node;
 }
 }
@@ -6,10 +6,21 @@
 class btConvexHullShape;
 
 namespace acid {
+/**
+ * @brief Collider that is the convex hull of a cloud of points.
+ * Hulls made from a model are simplified to a few dozen points, and kept in the acid::CollisionCache by the geometry of the
+ * model so they are only simplified once.
+ */
 class ACID_EXPORT ConvexHullCollider : public Collider::Registrar<ConvexHullCollider> {
 	inline static const bool Registered = Register("convexHull");
 public:
 	explicit ConvexHullCollider(const std::vector<float> &pointCloud = {}, const Transform &localTransform = {});
+	/**
+	 * Creates a new convex hull collider around a model.
+	 * @param model The model to take the hull of.
+	 * @param localTransform The parent offset of the body.
+	 */
+	explicit ConvexHullCollider(const std::shared_ptr<Model> &model, const Transform &localTransform = {});
 	~ConvexHullCollider();
 
 	btCollisionShape *GetCollisionShape() const override;
@@ -17,6 +28,20 @@ public:
 	uint32_t GetPointCount() const { return pointCount; }
 	void SetPointCount(const std::vector<float> &pointCloud);
 
+	const std::shared_ptr<Model> &GetModel() const { return model; }
+	/**
+	 * Sets the hull to the simplified hull of a model, from the cache when the model kept its geometry in memory.
+	 * @param model The model to take the hull of.
+	 */
+	void SetModel(const std::shared_ptr<Model> &model);
+
+	/**
+	 * Simplifies the convex hull of a cloud of points.
+	 * @param pointCloud The points, three floats for each.
+	 * @return The points of the simplified hull.
+	 */
+	static std::vector<float> CookHull(const std::vector<float> &pointCloud);
+
 	friend const Node &operator>>(const Node &node, ConvexHullCollider &collider);
 	friend Node &operator<<(Node &node, const ConvexHullCollider &collider);
 
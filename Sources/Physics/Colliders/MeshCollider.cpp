@@ -0,0 +1,139 @@
+#include "MeshCollider.hpp"
+
+#include <cstring>
+#include <numeric>
+
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+#include "Physics/CollisionCache.hpp"
+
+namespace acid {
+/// Version of cooked hierarchies, changed whenever they are built differently or Bullet changes their layout.
+static constexpr uint32_t HierarchyVersion = 1;
+/// Bullet reads and writes hierarchies in place in memory with this alignment.
+static constexpr int HierarchyAlignment = 16;
+
+static void FreeHierarchy(void *memory) {
+	btAlignedFree(memory);
+}
+
+MeshCollider::MeshCollider(const std::shared_ptr<Model> &model, const Transform &localTransform) :
+	//Collider(localTransform),
+	hierarchy(nullptr, FreeHierarchy) {
+	this->localTransform = localTransform;
+	SetModel(model);
+}
+
+MeshCollider::~MeshCollider() {
+}
+
+btCollisionShape *MeshCollider::GetCollisionShape() const {
+	return shape.get();
+}
+
+void MeshCollider::SetModel(const std::shared_ptr<Model> &model) {
+	this->model = model;
+	shape = nullptr;
+	triangles = nullptr;
+	hierarchy = nullptr;
+	positions.clear();
+	indices.clear();
+
+	if (!model)
+		return;
+
+	if (model->HasCachedGeometry()) {
+		positions = model->GetCachedPositions();
+		indices = model->GetCachedIndices();
+	} else if (model->GetVertexBuffer()) {
+		// This assumes a Vector3f attribute is the first vertex attribute.
+		positions = model->GetVertices<Vector3f>();
+		if (model->GetIndexBuffer())
+			indices = model->GetIndices();
+	}
+
+	// Models without indices are a list of triangles.
+	if (indices.empty()) {
+		indices.resize(positions.size() - positions.size() % 3);
+		std::iota(indices.begin(), indices.end(), 0);
+	}
+
+	if (indices.empty())
+		return;
+
+	btIndexedMesh mesh;
+	mesh.m_numTriangles = static_cast<int>(indices.size() / 3);
+	mesh.m_triangleIndexBase = reinterpret_cast<const unsigned char *>(indices.data());
+	mesh.m_triangleIndexStride = static_cast<int>(3 * sizeof(uint32_t));
+	mesh.m_numVertices = static_cast<int>(positions.size());
+	mesh.m_vertexBase = reinterpret_cast<const unsigned char *>(positions.data());
+	mesh.m_vertexStride = static_cast<int>(sizeof(Vector3f));
+	mesh.m_indexType = PHY_INTEGER;
+	mesh.m_vertexType = PHY_FLOAT;
+
+	triangles = std::make_unique<btTriangleIndexVertexArray>();
+	triangles->addIndexedMesh(mesh, PHY_INTEGER);
+
+	auto hash = CollisionCache::Hash(positions, indices);
+
+	if (auto bvh = LoadHierarchy(hash)) {
+		shape = std::make_unique<btBvhTriangleMeshShape>(triangles.get(), true, false);
+		shape->setOptimizedBvh(bvh);
+		return;
+	}
+
+	shape = std::make_unique<btBvhTriangleMeshShape>(triangles.get(), true, true);
+	StoreHierarchy(hash);
+}
+
+btOptimizedBvh *MeshCollider::LoadHierarchy(uint64_t hash) {
+	auto cooked = CollisionCache::Load("bvh", HierarchyVersion, hash);
+	if (!cooked)
+		return nullptr;
+
+	hierarchy.reset(btAlignedAlloc(cooked->size(), HierarchyAlignment));
+	std::memcpy(hierarchy.get(), cooked->data(), cooked->size());
+
+	// A hierarchy is read as the quantized base class, the optimized class adds nothing to its layout.
+	auto bvh = btOptimizedBvh::deSerializeInPlace(hierarchy.get(), static_cast<unsigned>(cooked->size()), false);
+
+	if (!bvh) {
+		hierarchy = nullptr;
+		return nullptr;
+	}
+
+	return static_cast<btOptimizedBvh *>(bvh);
+}
+
+void MeshCollider::StoreHierarchy(uint64_t hash) const {
+	if (CollisionCache::GetDirectory().empty())
+		return;
+
+	auto bvh = shape->getOptimizedBvh();
+	auto size = bvh->calculateSerializeBufferSize();
+	std::unique_ptr<void, void (*)(void *)> buffer(btAlignedAlloc(size, HierarchyAlignment), FreeHierarchy);
+
+	if (!bvh->serializeInPlace(buffer.get(), size, false))
+		return;
+
+	auto data = static_cast<const uint8_t *>(buffer.get());
+	CollisionCache::Store("bvh", HierarchyVersion, hash, std::vector<uint8_t>(data, data + size));
+}
+
+const Node &operator>>(const Node &node, MeshCollider &collider) {
+	node["localTransform"].Get(collider.localTransform);
+
+	std::shared_ptr<Model> model;
+	if (node["model"].Get(model))
+		collider.SetModel(model);
+
+	return node;
+}
+
+Node &operator<<(Node &node, const MeshCollider &collider) {
+	node["localTransform"].Set(collider.localTransform);
+	node["model"].Set(collider.model);
+	return node;
+}
+}
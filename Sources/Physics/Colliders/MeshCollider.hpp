@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Models/Model.hpp"
+#include "Collider.hpp"
+
+class btBvhTriangleMeshShape;
+class btOptimizedBvh;
+class btTriangleIndexVertexArray;
+
+namespace acid {
+/**
+ * @brief Collider that is the triangles of a model, for level geometry and other bodies that do not move.
+ * Triangles are found through a bounding volume hierarchy, the hierarchy is built once and kept in the acid::CollisionCache
+ * by the geometry of the model, later colliders load it instead of building it. Scaling the body builds the hierarchy again.
+ * Only bodies with no mass or kinematic bodies can use this collider.
+ */
+class ACID_EXPORT MeshCollider : public Collider::Registrar<MeshCollider> {
+	inline static const bool Registered = Register("mesh");
+public:
+	/**
+	 * Creates a new mesh collider.
+	 * @param model The model to take the triangles of.
+	 * @param localTransform The parent offset of the body.
+	 */
+	explicit MeshCollider(const std::shared_ptr<Model> &model = nullptr, const Transform &localTransform = {});
+	~MeshCollider();
+
+	btCollisionShape *GetCollisionShape() const override;
+
+	const std::shared_ptr<Model> &GetModel() const { return model; }
+	void SetModel(const std::shared_ptr<Model> &model);
+
+	uint32_t GetTriangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+
+	friend const Node &operator>>(const Node &node, MeshCollider &collider);
+	friend Node &operator<<(Node &node, const MeshCollider &collider);
+
+private:
+	/**
+	 * Loads the hierarchy from the cache into aligned memory the shape uses in place.
+	 * @param hash The hash of the geometry.
+	 * @return The hierarchy, null if it was not in the cache.
+	 */
+	btOptimizedBvh *LoadHierarchy(uint64_t hash);
+
+	/**
+	 * Stores the hierarchy built by the shape in the cache.
+	 * @param hash The hash of the geometry.
+	 */
+	void StoreHierarchy(uint64_t hash) const;
+
+	std::shared_ptr<Model> model;
+	/// The geometry the shape points into.
+	std::vector<Vector3f> positions;
+	std::vector<uint32_t> indices;
+	/// The hierarchy loaded from the cache, the shape uses it but does not own it.
+	std::unique_ptr<void, void (*)(void *)> hierarchy;
+	std::unique_ptr<btTriangleIndexVertexArray> triangles;
+	std::unique_ptr<btBvhTriangleMeshShape> shape;
+};
+}
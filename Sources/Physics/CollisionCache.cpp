@@ -0,0 +1,114 @@
+#include "CollisionCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include "Engine/Log.hpp"
+
+namespace acid {
+static constexpr char Identifier[4] = {'A', 'C', 'O', 'L'};
+/// The identifier, version, pointer size, payload size and payload hash.
+static constexpr std::size_t HeaderLength = sizeof(Identifier) + 4 + 4 + 8 + 8;
+
+static uint64_t Fnv1a(const void *data, std::size_t size, uint64_t hash = 0xCBF29CE484222325ull) {
+	auto bytes = static_cast<const uint8_t *>(data);
+
+	for (std::size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+static void WriteUint(std::vector<uint8_t> &data, uint64_t value, std::size_t length) {
+	for (std::size_t i = 0; i < length; i++)
+		data.emplace_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+static uint64_t ReadUint(const std::vector<uint8_t> &data, std::size_t offset, std::size_t length) {
+	uint64_t value = 0;
+	for (std::size_t i = 0; i < length; i++)
+		value |= static_cast<uint64_t>(data[offset + i]) << (i * 8);
+	return value;
+}
+
+uint64_t CollisionCache::Hash(const std::vector<Vector3f> &positions, const std::vector<uint32_t> &indices) {
+	uint64_t counts[2] = {positions.size(), indices.size()};
+	auto hash = Fnv1a(counts, sizeof(counts));
+	hash = Fnv1a(positions.data(), positions.size() * sizeof(Vector3f), hash);
+	return Fnv1a(indices.data(), indices.size() * sizeof(uint32_t), hash);
+}
+
+std::optional<std::vector<uint8_t>> CollisionCache::Load(const std::string &kind, uint32_t version, uint64_t hash) {
+	if (Directory.empty())
+		return std::nullopt;
+
+	std::ifstream is(GetFilename(kind, hash), std::ios::binary | std::ios::in);
+	if (!is)
+		return std::nullopt;
+
+	std::vector<uint8_t> file((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+	if (file.size() < HeaderLength || std::memcmp(file.data(), Identifier, sizeof(Identifier)) != 0 ||
+		ReadUint(file, 4, 4) != version || ReadUint(file, 8, 4) != sizeof(void *)) {
+		return std::nullopt;
+	}
+
+	auto size = ReadUint(file, 12, 8);
+	if (file.size() != HeaderLength + size || Fnv1a(file.data() + HeaderLength, size) != ReadUint(file, 20, 8)) {
+		Log::Warning("Cooked collision data is damaged: ", GetFilename(kind, hash), '\n');
+		return std::nullopt;
+	}
+
+	return std::vector<uint8_t>(file.begin() + HeaderLength, file.end());
+}
+
+bool CollisionCache::Store(const std::string &kind, uint32_t version, uint64_t hash, const std::vector<uint8_t> &data) {
+	if (Directory.empty())
+		return false;
+
+	std::error_code error;
+	std::filesystem::create_directories(Directory, error);
+
+	std::vector<uint8_t> file(std::begin(Identifier), std::end(Identifier));
+	file.reserve(HeaderLength + data.size());
+	WriteUint(file, version, 4);
+	WriteUint(file, sizeof(void *), 4);
+	WriteUint(file, data.size(), 8);
+	WriteUint(file, Fnv1a(data.data(), data.size()), 8);
+	file.insert(file.end(), data.begin(), data.end());
+
+	auto filename = GetFilename(kind, hash);
+	auto partFilename = filename;
+	partFilename += ".part";
+
+	{
+		std::ofstream os(partFilename, std::ios::binary | std::ios::out);
+		os.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+
+		if (!os) {
+			Log::Warning("Could not write cooked collision data: ", filename, '\n');
+			return false;
+		}
+	}
+
+	std::filesystem::rename(partFilename, filename, error);
+
+	if (error) {
+		std::filesystem::remove(partFilename, error);
+		return false;
+	}
+
+	return true;
+}
+
+std::filesystem::path CollisionCache::GetFilename(const std::string &kind, uint64_t hash) {
+	std::stringstream stream;
+	stream << std::hex << std::setw(16) << std::setfill('0') << hash << '.' << kind;
+	return Directory / stream.str();
+}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "Maths/Vector3.hpp"
+
+namespace acid {
+/**
+ * @brief Class that keeps collision data cooked from model geometry on disk, so each shape is only cooked once.
+ * Cooked data is found by a hash of the geometry it was cooked from and the kind of data, each file holds the version of
+ * the data and the pointer size of the build that cooked it, and files that don't match are cooked again.
+ */
+class ACID_EXPORT CollisionCache {
+public:
+	CollisionCache() = delete;
+
+	/**
+	 * Gets the folder cooked data is kept in.
+	 * @return The folder, empty if cooked data is not kept.
+	 */
+	static const std::filesystem::path &GetDirectory() { return Directory; }
+
+	/**
+	 * Sets the folder cooked data is kept in, should be set before colliders are created.
+	 * @param directory The folder, empty to not keep cooked data.
+	 */
+	static void SetDirectory(const std::filesystem::path &directory) { Directory = directory; }
+
+	/**
+	 * Hashes the geometry collision data is cooked from.
+	 * @param positions The vertex positions.
+	 * @param indices The triangle indices.
+	 * @return The hash.
+	 */
+	static uint64_t Hash(const std::vector<Vector3f> &positions, const std::vector<uint32_t> &indices);
+
+	/**
+	 * Loads cooked data from the cache.
+	 * @param kind The kind of data, used as the file extension.
+	 * @param version The version of the data, files with another version are ignored.
+	 * @param hash The hash of the geometry the data was cooked from.
+	 * @return The data, nothing if it was not found or does not match.
+	 */
+	static std::optional<std::vector<uint8_t>> Load(const std::string &kind, uint32_t version, uint64_t hash);
+
+	/**
+	 * Stores cooked data in the cache, the file is written next to where it goes and then moved so it is never read half written.
+	 * @param kind The kind of data, used as the file extension.
+	 * @param version The version of the data.
+	 * @param hash The hash of the geometry the data was cooked from.
+	 * @param data The data.
+	 * @return If the data was stored.
+	 */
+	static bool Store(const std::string &kind, uint32_t version, uint64_t hash, const std::vector<uint8_t> &data);
+
+private:
+	static std::filesystem::path GetFilename(const std::string &kind, uint64_t hash);
+
+	inline static std::filesystem::path Directory = "Cache/Collision";
+};
+}
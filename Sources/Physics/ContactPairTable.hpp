@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace acid {
+/**
+ * @brief A flat hash set of the pairs of objects in contact this update, and the pairs from the update before.
+ * Pairs are kept in open addressed tables with linear probing. A slot holds a pair only if its stamp is the stamp
+ * of its table, so a table is emptied by giving it a new stamp instead of clearing it, and tables are swapped between
+ * updates instead of copied. Once the tables have grown no memory is allocated.
+ * @tparam T The type of object in contact, pairs are ordered by address.
+ */
+template<typename T>
+class ContactPairTable {
+public:
+	using Pair = std::pair<const T *, const T *>;
+
+	/**
+	 * Creates a new pair table.
+	 * @param capacity The pairs each table holds before growing.
+	 */
+	explicit ContactPairTable(std::size_t capacity = 64) {
+		std::size_t slotCount = MinSlotCount;
+		while (slotCount < capacity * 2)
+			slotCount *= 2;
+
+		current.slots.resize(slotCount);
+		last.slots.resize(slotCount);
+		current.stamp = NextStamp();
+		last.stamp = NextStamp();
+	}
+
+	/**
+	 * Starts a new update, the pairs inserted become the pairs of the last update.
+	 */
+	void Update() {
+		std::swap(current, last);
+		current.stamp = NextStamp();
+		current.size = 0;
+	}
+
+	/**
+	 * Inserts a pair in contact this update, the order of the objects does not matter.
+	 * @param a The first object.
+	 * @param b The second object.
+	 * @return If the pair is new, false if it was in contact last update or was already inserted this update.
+	 */
+	bool Insert(const T *a, const T *b) {
+		if (b < a)
+			std::swap(a, b);
+
+		if ((current.size + 1) * 2 > current.slots.size())
+			Grow(current);
+
+		auto &slot = current.slots[Probe(current, a, b)];
+		if (slot.stamp == current.stamp)
+			return false;
+
+		slot.a = a;
+		slot.b = b;
+		slot.stamp = current.stamp;
+		current.size++;
+
+		if (last.size == 0)
+			return true;
+
+		// Pairs found in the last update are marked, whatever is left unmarked has ended.
+		auto &lastSlot = last.slots[Probe(last, a, b)];
+		if (lastSlot.stamp != last.stamp)
+			return true;
+
+		lastSlot.matched = current.stamp;
+		return false;
+	}
+
+	/**
+	 * Gets if a pair was inserted this update.
+	 * @param a The first object.
+	 * @param b The second object.
+	 * @return If the pair is in contact.
+	 */
+	bool Contains(const T *a, const T *b) const {
+		if (b < a)
+			std::swap(a, b);
+
+		return current.slots[Probe(current, a, b)].stamp == current.stamp;
+	}
+
+	/**
+	 * Gets the pairs in contact last update that were not inserted this update.
+	 * @param ended The list to add the pairs to.
+	 */
+	void GetEnded(std::vector<Pair> &ended) const {
+		if (last.size == 0)
+			return;
+
+		for (const auto &slot : last.slots) {
+			if (slot.stamp == last.stamp && slot.matched != current.stamp)
+				ended.emplace_back(slot.a, slot.b);
+		}
+	}
+
+	/**
+	 * Removes every pair, so every pair inserted next is new.
+	 */
+	void Clear() {
+		current.size = 0;
+		last.size = 0;
+		current.stamp = NextStamp();
+		last.stamp = NextStamp();
+	}
+
+	std::size_t GetSize() const { return current.size; }
+	std::size_t GetCapacity() const { return current.slots.size() / 2; }
+
+private:
+	static constexpr std::size_t MinSlotCount = 16;
+
+	class Slot {
+	public:
+		const T *a = nullptr;
+		const T *b = nullptr;
+		/// The stamp of the table when the pair was inserted.
+		uint32_t stamp = 0;
+		/// The stamp of the next update when the pair was inserted again.
+		uint32_t matched = 0;
+	};
+
+	class Table {
+	public:
+		std::vector<Slot> slots;
+		uint32_t stamp = 0;
+		std::size_t size = 0;
+	};
+
+	static std::size_t Hash(const T *a, const T *b) {
+		auto hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(a)) * 0x9E3779B97F4A7C15ull;
+		hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(b)) + 0x7F4A7C159E3779B9ull + (hash << 6) + (hash >> 2);
+		hash ^= hash >> 31;
+		hash *= 0xBF58476D1CE4E5B9ull;
+		return static_cast<std::size_t>(hash ^ (hash >> 29));
+	}
+
+	/**
+	 * Finds the slot holding a pair, or the empty slot it would go in.
+	 */
+	static std::size_t Probe(const Table &table, const T *a, const T *b) {
+		auto mask = table.slots.size() - 1;
+
+		for (auto index = Hash(a, b) & mask;; index = (index + 1) & mask) {
+			const auto &slot = table.slots[index];
+			if (slot.stamp != table.stamp || (slot.a == a && slot.b == b))
+				return index;
+		}
+	}
+
+	void Grow(Table &table) {
+		Table grown;
+		grown.slots.resize(table.slots.size() * 2);
+		grown.stamp = table.stamp;
+		grown.size = table.size;
+
+		for (const auto &slot : table.slots) {
+			if (slot.stamp == table.stamp)
+				grown.slots[Probe(grown, slot.a, slot.b)] = slot;
+		}
+
+		table = std::move(grown);
+	}
+
+	uint32_t NextStamp() {
+		// Stamps never repeat and are never 0, when they wrap around every slot is emptied.
+		if (++stamp == 0) {
+			for (auto table : {&current, &last}) {
+				for (auto &slot : table->slots)
+					slot = {};
+				table->size = 0;
+				table->stamp = ++stamp;
+			}
+
+			++stamp;
+		}
+
+		return stamp;
+	}
+
+	Table current;
+	Table last;
+	uint32_t stamp = 0;
+};
+}
@@ -0,0 +1,223 @@
+#include "HeightTileFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Engine/Log.hpp"
+
+namespace acid {
+static constexpr char Identifier[4] = {'A', 'H', 'T', 'F'};
+static constexpr std::size_t HeaderLength = 64;
+/// The offset, min height and max height of each tile.
+static constexpr std::size_t TileLength = 16;
+static constexpr int32_t MaxQuantized = 32767;
+
+static void WriteUint(std::vector<uint8_t> &data, uint64_t value, std::size_t length) {
+	for (std::size_t i = 0; i < length; i++)
+		data.emplace_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+static void WriteFloat(std::vector<uint8_t> &data, float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	WriteUint(data, bits, 4);
+}
+
+static uint64_t ReadUint(const uint8_t *data, std::size_t length) {
+	uint64_t value = 0;
+	for (std::size_t i = 0; i < length; i++)
+		value |= static_cast<uint64_t>(data[i]) << (i * 8);
+	return value;
+}
+
+static float ReadFloat(const uint8_t *data) {
+	auto bits = static_cast<uint32_t>(ReadUint(data, 4));
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/**
+ * Gets the offset of a level from the start of its tile.
+ */
+static uint64_t GetLevelOffset(uint32_t tileSize, uint32_t lod) {
+	uint64_t offset = 0;
+
+	for (uint32_t level = 0; level < lod; level++) {
+		uint64_t samples = (tileSize >> level) + 1;
+		offset += samples * samples * sizeof(int16_t);
+	}
+
+	return offset;
+}
+
+/**
+ * Gets if a tile size is a power of two with at least one quad at every level of detail.
+ */
+static bool IsValidLevels(uint32_t tileSize, uint32_t lodCount) {
+	return tileSize != 0 && (tileSize & (tileSize - 1)) == 0 && lodCount != 0 && lodCount <= 32 && (tileSize >> (lodCount - 1)) != 0;
+}
+
+bool HeightTileFile::Open(const std::filesystem::path &filename) {
+	stream.close();
+	stream.open(filename, std::ios::binary | std::ios::in);
+
+	uint8_t data[HeaderLength];
+	if (!stream.read(reinterpret_cast<char *>(data), HeaderLength) || std::memcmp(data, Identifier, sizeof(Identifier)) != 0 ||
+		ReadUint(data + 4, 4) != Version) {
+		Log::Error("Not a height tile file: ", filename, '\n');
+		stream.close();
+		return false;
+	}
+
+	header.tileSize = static_cast<uint32_t>(ReadUint(data + 8, 4));
+	header.tilesX = static_cast<uint32_t>(ReadUint(data + 12, 4));
+	header.tilesZ = static_cast<uint32_t>(ReadUint(data + 16, 4));
+	header.lodCount = static_cast<uint32_t>(ReadUint(data + 20, 4));
+	header.spacing = ReadFloat(data + 24);
+	header.heightScale = ReadFloat(data + 28);
+
+	std::error_code error;
+	auto fileLength = std::filesystem::file_size(filename, error);
+
+	// The header is checked the same as when writing, and the table must fit in the file before it is allocated.
+	if (error || !IsValidLevels(header.tileSize, header.lodCount) || header.tilesX == 0 || header.tilesZ == 0 || !(header.spacing > 0.0f) ||
+		static_cast<uint64_t>(header.tilesX) * header.tilesZ > (fileLength - HeaderLength) / TileLength) {
+		Log::Error("Height tile file has an invalid header: ", filename, '\n');
+		stream.close();
+		return false;
+	}
+
+	std::vector<uint8_t> table(static_cast<std::size_t>(header.tilesX) * header.tilesZ * TileLength);
+	if (!stream.read(reinterpret_cast<char *>(table.data()), static_cast<std::streamsize>(table.size()))) {
+		Log::Error("Height tile file is cut short: ", filename, '\n');
+		stream.close();
+		return false;
+	}
+
+	tiles.resize(static_cast<std::size_t>(header.tilesX) * header.tilesZ);
+
+	for (std::size_t i = 0; i < tiles.size(); i++) {
+		auto entry = table.data() + i * TileLength;
+		tiles[i].offset = ReadUint(entry, 8);
+		tiles[i].minHeight = ReadFloat(entry + 8);
+		tiles[i].maxHeight = ReadFloat(entry + 12);
+	}
+
+	// Every level of every tile must be inside the file.
+	auto tileLength = GetLevelOffset(header.tileSize, header.lodCount);
+
+	for (const auto &tile : tiles) {
+		if (tile.offset > fileLength || tileLength > fileLength - tile.offset) {
+			Log::Error("Height tile file has a tile outside of the file: ", filename, '\n');
+			stream.close();
+			tiles.clear();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool HeightTileFile::ReadTile(uint32_t x, uint32_t z, uint32_t lod, std::vector<int16_t> &heights) {
+	if (!IsOpen() || x >= header.tilesX || z >= header.tilesZ || lod >= header.lodCount)
+		return false;
+
+	auto samples = GetSampleCount(lod);
+	heights.resize(static_cast<std::size_t>(samples) * samples);
+
+	stream.clear();
+	stream.seekg(static_cast<std::streamoff>(GetTile(x, z).offset + GetLevelOffset(header.tileSize, lod)));
+	// Heights are little endian, as they are on every platform supported.
+	return static_cast<bool>(stream.read(reinterpret_cast<char *>(heights.data()), static_cast<std::streamsize>(heights.size() * sizeof(int16_t))));
+}
+
+bool HeightTileFile::Write(const std::filesystem::path &filename, const std::vector<float> &heights, uint32_t width, uint32_t length, float spacing,
+	uint32_t tileSize, uint32_t lodCount) {
+	if (!IsValidLevels(tileSize, lodCount)) {
+		Log::Error("Tile size must be a power of two with a quad at every level of detail\n");
+		return false;
+	}
+
+	if (width < 2 || length < 2 || (width - 1) % tileSize != 0 || (length - 1) % tileSize != 0 ||
+		heights.size() != static_cast<std::size_t>(width) * length) {
+		Log::Error("Heightfield of ", width, "x", length, " can't be split into tiles of ", tileSize, '\n');
+		return false;
+	}
+
+	Header header;
+	header.tileSize = tileSize;
+	header.tilesX = (width - 1) / tileSize;
+	header.tilesZ = (length - 1) / tileSize;
+	header.lodCount = lodCount;
+	header.spacing = spacing;
+
+	auto maxAbsolute = 0.0f;
+	for (auto height : heights)
+		maxAbsolute = std::max(maxAbsolute, std::abs(height));
+	header.heightScale = maxAbsolute > 0.0f ? maxAbsolute / MaxQuantized : 1.0f;
+
+	auto quantize = [&](uint32_t sampleX, uint32_t sampleZ) {
+		auto height = heights[static_cast<std::size_t>(sampleZ) * width + sampleX];
+		return static_cast<int16_t>(std::clamp<long>(std::lround(height / header.heightScale), -MaxQuantized, MaxQuantized));
+	};
+
+	auto tileLength = GetLevelOffset(tileSize, lodCount);
+	auto pageLength = (tileLength + PageSize - 1) / PageSize * PageSize;
+	auto tableLength = HeaderLength + static_cast<uint64_t>(header.tilesX) * header.tilesZ * TileLength;
+	auto firstOffset = (tableLength + PageSize - 1) / PageSize * PageSize;
+
+	std::vector<uint8_t> table(std::begin(Identifier), std::end(Identifier));
+	table.reserve(firstOffset);
+	WriteUint(table, Version, 4);
+	WriteUint(table, header.tileSize, 4);
+	WriteUint(table, header.tilesX, 4);
+	WriteUint(table, header.tilesZ, 4);
+	WriteUint(table, header.lodCount, 4);
+	WriteFloat(table, header.spacing);
+	WriteFloat(table, header.heightScale);
+	table.resize(HeaderLength);
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	// Tiles are quantized and written one at a time after room for the table, the table is written once their bounds are known.
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.seekp(static_cast<std::streamoff>(firstOffset));
+	std::vector<uint8_t> tileData;
+	tileData.reserve(pageLength);
+
+	for (uint32_t z = 0; z < header.tilesZ; z++) {
+		for (uint32_t x = 0; x < header.tilesX; x++) {
+			tileData.clear();
+			int16_t minQuantized = MaxQuantized, maxQuantized = -MaxQuantized;
+
+			for (uint32_t lod = 0; lod < lodCount; lod++) {
+				auto samples = (tileSize >> lod) + 1;
+
+				for (uint32_t j = 0; j < samples; j++) {
+					for (uint32_t i = 0; i < samples; i++) {
+						auto quantized = quantize(x * tileSize + (i << lod), z * tileSize + (j << lod));
+						minQuantized = std::min(minQuantized, quantized);
+						maxQuantized = std::max(maxQuantized, quantized);
+						WriteUint(tileData, static_cast<uint16_t>(quantized), 2);
+					}
+				}
+			}
+
+			WriteUint(table, firstOffset + (static_cast<uint64_t>(z) * header.tilesX + x) * pageLength, 8);
+			WriteFloat(table, minQuantized * header.heightScale);
+			WriteFloat(table, maxQuantized * header.heightScale);
+
+			tileData.resize(pageLength);
+			os.write(reinterpret_cast<const char *>(tileData.data()), static_cast<std::streamsize>(tileData.size()));
+		}
+	}
+
+	table.resize(firstOffset);
+	os.seekp(0);
+	os.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(table.size()));
+	return static_cast<bool>(os);
+}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief Class that reads and writes heightfields split into square tiles, with every level of detail of each tile.
+ * Heights are quantized to signed 16 bit steps of one scale for the whole file, which Bullet reads as they are. Each tile
+ * starts on a page boundary and holds its levels from most to least detailed, so a tile can be read, or mapped, in one go.
+ * Neighbouring tiles share their edge samples. Values are stored little endian.
+ */
+class ACID_EXPORT HeightTileFile {
+public:
+	class Header {
+	public:
+		/// Quads on each side of a tile at full detail, a power of two.
+		uint32_t tileSize = 0;
+		uint32_t tilesX = 0;
+		uint32_t tilesZ = 0;
+		/// Levels of detail of each tile, each level has half the quads on a side of the level before.
+		uint32_t lodCount = 0;
+		/// Distance between samples at full detail.
+		float spacing = 1.0f;
+		/// Height of each step of the quantized heights.
+		float heightScale = 1.0f;
+	};
+
+	class Tile {
+	public:
+		/// Offset of the first level of the tile in the file.
+		uint64_t offset = 0;
+		float minHeight = 0.0f;
+		float maxHeight = 0.0f;
+	};
+
+	static constexpr uint32_t Version = 1;
+	/// Tiles start at a multiple of this offset.
+	static constexpr uint64_t PageSize = 4096;
+
+	HeightTileFile() = default;
+
+	/**
+	 * Opens a file and reads its header and tile table.
+	 * @param filename The file to open.
+	 * @return If the file is a height tile file of this version.
+	 */
+	bool Open(const std::filesystem::path &filename);
+
+	bool IsOpen() const { return stream.is_open(); }
+	const Header &GetHeader() const { return header; }
+	const Tile &GetTile(uint32_t x, uint32_t z) const { return tiles[z * header.tilesX + x]; }
+
+	/**
+	 * Gets the samples on each side of a tile at a level of detail.
+	 * @param lod The level of detail.
+	 * @return The samples on a side.
+	 */
+	uint32_t GetSampleCount(uint32_t lod) const { return (header.tileSize >> lod) + 1; }
+
+	/**
+	 * Reads the heights of a tile at a level of detail, only one thread may read from a file at once.
+	 * @param x The column of the tile.
+	 * @param z The row of the tile.
+	 * @param lod The level of detail.
+	 * @param heights The quantized heights, row by row.
+	 * @return If the heights were read.
+	 */
+	bool ReadTile(uint32_t x, uint32_t z, uint32_t lod, std::vector<int16_t> &heights);
+
+	/**
+	 * Splits a heightfield into tiles and writes it.
+	 * @param filename The file to write.
+	 * @param heights The heights, row by row, with tileSize * tiles + 1 samples on each side.
+	 * @param width The samples in each row.
+	 * @param length The rows.
+	 * @param spacing Distance between samples.
+	 * @param tileSize Quads on each side of a tile, a power of two.
+	 * @param lodCount Levels of detail to write for each tile.
+	 * @return If the file was written.
+	 */
+	static bool Write(const std::filesystem::path &filename, const std::vector<float> &heights, uint32_t width, uint32_t length, float spacing,
+		uint32_t tileSize, uint32_t lodCount);
+
+private:
+	Header header;
+	std::vector<Tile> tiles;
+	std::ifstream stream;
+};
+}
@@ -4,13 +4,72 @@
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 #include <BulletDynamics/Dynamics/btRigidBody.h>
-#include <LinearMath/btDefaultMotionState.h>
+#include <LinearMath/btMotionState.h>
 #include "Maths/Transform.hpp"
 #include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Colliders/Collider.hpp"
 
 namespace acid {
+/**
+ * Keeps the transforms of the last two steps a body was moved by, and the step that last moved it.
+ * Bullet only synchronizes the motion states of bodies that are awake, so sleeping bodies are never written to.
+ */
+class InterpolatedMotionState : public btMotionState {
+public:
+	InterpolatedMotionState(const ScenePhysics *physics, const btTransform &worldTransform) :
+		physics(physics),
+		previous(worldTransform),
+		current(worldTransform) {
+	}
+
+	void getWorldTransform(btTransform &worldTransform) const override {
+		worldTransform = current;
+	}
+
+	void setWorldTransform(const btTransform &worldTransform) override {
+		previous = current;
+		current = worldTransform;
+		step = physics->GetStepCount();
+	}
+
+	/**
+	 * Sets where a kinematic body is, Bullet reads it from the motion state at the start of the next step.
+	 * @param worldTransform The world transform.
+	 */
+	void Push(const btTransform &worldTransform) {
+		previous = worldTransform;
+		current = worldTransform;
+	}
+
+	/**
+	 * Gets if the last step moved the body, so it is drawn between the last two steps.
+	 * @return If the body is moving.
+	 */
+	bool IsMoving() const { return step == physics->GetStepCount(); }
+
+	/**
+	 * Gets the transform between the last two steps.
+	 * @return The transform, the latest if the last step did not move the body.
+	 */
+	btTransform Interpolate() const {
+		if (!IsMoving())
+			return current;
+
+		auto progression = physics->GetInterpolation();
+		return btTransform(previous.getRotation().slerp(current.getRotation(), progression), previous.getOrigin().lerp(current.getOrigin(), progression));
+	}
+
+	const btTransform &GetCurrent() const { return current; }
+	uint64_t GetStep() const { return step; }
+
+private:
+	const ScenePhysics *physics;
+	btTransform previous;
+	btTransform current;
+	uint64_t step = 0;
+};
+
 Rigidbody::Rigidbody(std::unique_ptr<Collider> &&collider, float mass, float friction, const Vector3f &linearFactor, const Vector3f &angularFactor) :
 	CollisionObject({}, mass, friction, linearFactor, angularFactor) {
 	AddCollider(std::move(collider));
@@ -27,6 +86,7 @@ Rigidbody::~Rigidbody() {
 void Rigidbody::Start() {
 	if (rigidBody) {
 		Scenes::Get()->GetPhysics()->GetDynamicsWorld()->removeRigidBody(rigidBody.get());
+		delete rigidBody->getMotionState();
 	}
 
 	CreateShape();
@@ -41,7 +101,7 @@ void Rigidbody::Start() {
 	auto worldTransform = Collider::Convert(*GetEntity()->GetComponent<Transform>());
 
 	// Using motionstate is recommended, it provides interpolation capabilities, and only synchronizes 'active' objects.
-	auto motionState = new btDefaultMotionState(worldTransform);
+	auto motionState = new InterpolatedMotionState(Scenes::Get()->GetPhysics(), worldTransform);
 	btRigidBody::btRigidBodyConstructionInfo cInfo(mass, motionState, shape.get(), localInertia);
 
 	rigidBody = std::make_unique<btRigidBody>(cInfo);
@@ -55,37 +115,61 @@ void Rigidbody::Start() {
 	rigidBody->setLinearFactor(Collider::Convert(linearFactor));
 	rigidBody->setAngularFactor(Collider::Convert(angularFactor));
 	rigidBody->setUserPointer(dynamic_cast<CollisionObject *>(this));
+
+	// Kinematic bodies are moved by their transform, and must stay awake for Bullet to read where they are.
+	if (kinematic) {
+		rigidBody->setCollisionFlags(rigidBody->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+		rigidBody->setActivationState(DISABLE_DEACTIVATION);
+	}
+
 	body = rigidBody.get();
 	Scenes::Get()->GetPhysics()->GetDynamicsWorld()->addRigidBody(rigidBody.get());
 	rigidBody->activate(true);
 	RecalculateMass();
+	writtenStep = NotWritten;
+	forcesObserver = nullptr;
 }
 
 void Rigidbody::Update() {
 	if (shape.get() != body->getCollisionShape())
 		body->setCollisionShape(shape.get());
 
-	auto delta = Engine::Get()->GetDelta();
+	// Bullet clears forces after every step, so they are applied again before each one while there are any.
+	if (!forces.empty() && !forcesObserver) {
+		forcesObserver = std::make_unique<Observer>();
+		Scenes::Get()->GetPhysics()->OnFixedUpdate().Add([this](Time delta) {
+			ApplyForces(delta);
+		}, forcesObserver.get());
+	}
 
-	for (auto it = forces.begin(); it != forces.end();) {
-		(*it)->Update(delta);
-		rigidBody->applyForce(Collider::Convert((*it)->GetForce()), Collider::Convert((*it)->GetPosition()));
+	auto motionState = static_cast<InterpolatedMotionState *>(rigidBody->getMotionState());
 
-		if ((*it)->IsExpired()) {
-			it = forces.erase(it);
-			continue;
+	if (kinematic) {
+		auto &transform = *GetEntity()->GetComponent<Transform>();
+		auto worldTransform = Collider::Convert(transform);
+
+		if (!(worldTransform == motionState->GetCurrent())) {
+			motionState->Push(worldTransform);
+			shape->setLocalScaling(Collider::Convert(transform.GetScale()));
 		}
 
-		++it;
+		return;
+	}
+
+	// Moving bodies are drawn between steps, bodies that stopped are written once where they stopped and then left alone.
+	if (!motionState->IsMoving()) {
+		if (writtenStep == motionState->GetStep())
+			return;
+
+		writtenStep = motionState->GetStep();
+	} else {
+		writtenStep = NotWritten;
 	}
 
 	auto &transform = *GetEntity()->GetComponent<Transform>();
-	btTransform motionTransform;
-	rigidBody->getMotionState()->getWorldTransform(motionTransform);
-	transform = Collider::Convert(motionTransform, transform.GetScale());
+	transform = Collider::Convert(motionState->Interpolate(), transform.GetScale());
 
 	shape->setLocalScaling(Collider::Convert(transform.GetScale()));
-	//rigidBody->getMotionState()->setWorldTransform(Collider::Convert(transform));
 	linearVelocity = Collider::Convert(rigidBody->getLinearVelocity());
 	angularVelocity = Collider::Convert(rigidBody->getAngularVelocity());
 }
@@ -153,6 +237,7 @@ const Node &operator>>(const Node &node, Rigidbody &rigidbody) {
 	node["frictionSpinning"].Get(rigidbody.frictionSpinning);
 	node["linearFactor"].Get(rigidbody.linearFactor);
 	node["angularFactor"].Get(rigidbody.angularFactor);
+	node["kinematic"].Get(rigidbody.kinematic);
 	return node;
 }
 
@@ -164,19 +249,60 @@ Node &operator<<(Node &node, const Rigidbody &rigidbody) {
 	node["frictionSpinning"].Set(rigidbody.frictionSpinning);
 	node["linearFactor"].Set(rigidbody.linearFactor);
 	node["angularFactor"].Set(rigidbody.angularFactor);
+	node["kinematic"].Set(rigidbody.kinematic);
 	return node;
 }
 
+void Rigidbody::SetKinematic(bool kinematic) {
+	this->kinematic = kinematic;
+
+	if (!rigidBody)
+		return;
+
+	if (kinematic) {
+		rigidBody->setCollisionFlags(rigidBody->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+		rigidBody->setActivationState(DISABLE_DEACTIVATION);
+	} else {
+		rigidBody->setCollisionFlags(rigidBody->getCollisionFlags() & ~btCollisionObject::CF_KINEMATIC_OBJECT);
+		rigidBody->forceActivationState(ACTIVE_TAG);
+	}
+
+	RecalculateMass();
+}
+
+void Rigidbody::ApplyForces(const Time &delta) {
+	// Once the forces are gone the observer is dropped, and the delegate forgets this body.
+	if (forces.empty()) {
+		forcesObserver = nullptr;
+		return;
+	}
+
+	rigidBody->activate();
+
+	for (auto it = forces.begin(); it != forces.end();) {
+		(*it)->Update(delta);
+		rigidBody->applyForce(Collider::Convert((*it)->GetForce()), Collider::Convert((*it)->GetPosition()));
+
+		if ((*it)->IsExpired()) {
+			it = forces.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+}
+
 void Rigidbody::RecalculateMass() {
 	if (!rigidBody) return;
 
-	auto isDynamic = mass != 0.0f;
+	// Kinematic bodies have infinite mass, they push dynamic bodies aside.
+	auto isDynamic = mass != 0.0f && !kinematic;
 
 	btVector3 localInertia;
 
 	if (!colliders.empty() && isDynamic)
 		colliders[0]->GetCollisionShape()->calculateLocalInertia(mass, localInertia);
 
-	rigidBody->setMassProps(mass, localInertia);
+	rigidBody->setMassProps(isDynamic ? mass : 0.0f, localInertia);
 }
 }
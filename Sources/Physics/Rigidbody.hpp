@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <limits>
+
 #include "Maths/Vector3.hpp"
 #include "Scenes/Component.hpp"
 #include "CollisionObject.hpp"
@@ -10,6 +12,9 @@ class btRigidBody;
 namespace acid {
 /**
  * @brief Represents a object in a scene effected by physics.
+ * Forces are applied before every step of the physics while there are any, and the transform is drawn between the last
+ * two steps. Only bodies that are moving write to their transform, a body that stopped or fell asleep is written once.
+ * Kinematic bodies are moved by their transform instead, changes to it are read by Bullet at the start of the next step.
  */
 class ACID_EXPORT Rigidbody : public Component::Registrar<Rigidbody>, public CollisionObject {
 	inline static const bool Registered = Register("rigidbody");
@@ -38,6 +43,9 @@ public:
 	void SetLinearVelocity(const Vector3f &linearVelocity) override;
 	void SetAngularVelocity(const Vector3f &angularVelocity) override;
 
+	bool IsKinematic() const { return kinematic; }
+	void SetKinematic(bool kinematic);
+
 	friend const Node &operator>>(const Node &node, Rigidbody &rigidbody);
 	friend Node &operator<<(Node &node, const Rigidbody &rigidbody);
 
@@ -45,6 +53,15 @@ protected:
 	void RecalculateMass() override;
 
 private:
+	static constexpr uint64_t NotWritten = std::numeric_limits<uint64_t>::max();
+
+	void ApplyForces(const Time &delta);
+
 	std::unique_ptr<btRigidBody> rigidBody;
+	bool kinematic = false;
+	/// The step the transform was last written from, once the body stopped moving.
+	uint64_t writtenStep = NotWritten;
+	/// Subscribes the body to each step while it has forces.
+	std::unique_ptr<Observer> forcesObserver;
 };
 }
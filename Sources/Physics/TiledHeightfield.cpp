@@ -0,0 +1,253 @@
+#include "TiledHeightfield.hpp"
+
+#include <BulletCollision/BroadphaseCollision/btBroadphaseProxy.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include "Maths/Transform.hpp"
+#include "Scenes/Entity.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Colliders/Collider.hpp"
+
+namespace acid {
+TiledHeightfield::Tile::Tile() {
+}
+
+TiledHeightfield::Tile::~Tile() {
+}
+
+TiledHeightfield::TiledHeightfield(std::filesystem::path filename, float loadRadius, float lodDistance, float friction) :
+	filename(std::move(filename)),
+	loadRadius(loadRadius),
+	lodDistance(lodDistance),
+	friction(friction),
+	loader(1) {
+}
+
+TiledHeightfield::~TiledHeightfield() {
+	for (auto &[key, tile] : tiles)
+		RemoveTile(*tile);
+}
+
+void TiledHeightfield::Start() {
+	// Reads still running use the file, they finish before it is opened again.
+	for (auto &[key, request] : pending)
+		request.second.wait();
+
+	pending.clear();
+
+	for (auto &[key, tile] : tiles)
+		RemoveTile(*tile);
+
+	tiles.clear();
+
+	if (auto transform = GetEntity()->GetComponent<Transform>())
+		origin = transform->GetPosition();
+
+	std::unique_lock<std::mutex> lock(fileMutex);
+	if (!filename.empty())
+		file.Open(filename);
+}
+
+void TiledHeightfield::Update() {
+	if (!file.IsOpen())
+		return;
+
+	AddLoadedTiles();
+	FindWantedTiles();
+
+	// Tiles no longer near any focus point are removed.
+	for (auto it = tiles.begin(); it != tiles.end();) {
+		if (wanted.find(it->first) == wanted.end()) {
+			RemoveTile(*it->second);
+			it = tiles.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	RequestTiles();
+	focusPoints.clear();
+}
+
+int32_t TiledHeightfield::GetTileLod(uint32_t x, uint32_t z) const {
+	auto it = tiles.find(GetKey(x, z));
+	return it != tiles.end() ? static_cast<int32_t>(it->second->lod) : -1;
+}
+
+void TiledHeightfield::FindWantedTiles() {
+	wanted.clear();
+
+	const auto &header = file.GetHeader();
+	auto tileLength = header.tileSize * header.spacing;
+	// Tiles are kept half a tile further than they are loaded, so bodies on the edge of the radius don't load and remove them every update.
+	auto keepRadius = loadRadius + 0.5f * tileLength;
+
+	auto addFocus = [&](const Vector3f &point) {
+		auto localX = point.x - origin.x;
+		auto localZ = point.z - origin.z;
+
+		if (localX + keepRadius < 0.0f || localZ + keepRadius < 0.0f || localX - keepRadius > header.tilesX * tileLength ||
+			localZ - keepRadius > header.tilesZ * tileLength) {
+			return;
+		}
+
+		auto minX = static_cast<uint32_t>(std::max(0.0f, std::floor((localX - keepRadius) / tileLength)));
+		auto minZ = static_cast<uint32_t>(std::max(0.0f, std::floor((localZ - keepRadius) / tileLength)));
+		auto maxX = std::min(header.tilesX - 1, static_cast<uint32_t>(std::max(0.0f, (localX + keepRadius) / tileLength)));
+		auto maxZ = std::min(header.tilesZ - 1, static_cast<uint32_t>(std::max(0.0f, (localZ + keepRadius) / tileLength)));
+
+		for (auto z = minZ; z <= maxZ; z++) {
+			for (auto x = minX; x <= maxX; x++) {
+				// Distance from the point to the nearest edge of the tile, 0 when the point is over it.
+				auto dx = std::max({x * tileLength - localX, localX - (x + 1) * tileLength, 0.0f});
+				auto dz = std::max({z * tileLength - localZ, localZ - (z + 1) * tileLength, 0.0f});
+				auto distance = std::sqrt(dx * dx + dz * dz);
+
+				if (distance > keepRadius)
+					continue;
+
+				auto lod = lodDistance > 0.0f ? std::min(static_cast<uint32_t>(distance / lodDistance), header.lodCount - 1) : 0;
+				auto [it, inserted] = wanted.try_emplace(GetKey(x, z), lod, distance);
+
+				if (!inserted) {
+					it->second.first = std::min(it->second.first, lod);
+					it->second.second = std::min(it->second.second, distance);
+				}
+			}
+		}
+	};
+
+	// Sleeping bodies are included, so the terrain is under them when they wake.
+	auto dynamicsWorld = Scenes::Get()->GetPhysics()->GetDynamicsWorld();
+
+	for (int32_t i = 0; i < dynamicsWorld->getNumCollisionObjects(); i++) {
+		auto object = dynamicsWorld->getCollisionObjectArray()[i];
+
+		if (!object->isStaticObject())
+			addFocus(Collider::Convert(object->getWorldTransform().getOrigin()));
+	}
+
+	for (const auto &point : focusPoints)
+		addFocus(point);
+}
+
+void TiledHeightfield::RequestTiles() {
+	std::vector<std::pair<float, uint64_t>> missing;
+
+	for (const auto &[key, want] : wanted) {
+		auto [lod, distance] = want;
+		auto tile = tiles.find(key);
+
+		if ((tile != tiles.end() && tile->second->lod == lod) || pending.find(key) != pending.end())
+			continue;
+
+		if (tile == tiles.end() && distance == 0.0f) {
+			AddTile(LoadTile(static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key), lod));
+			continue;
+		}
+
+		if (distance <= loadRadius || tile != tiles.end())
+			missing.emplace_back(distance, key);
+	}
+
+	std::sort(missing.begin(), missing.end());
+
+	for (const auto &[distance, key] : missing) {
+		if (pending.size() >= MaxPendingLoads)
+			break;
+
+		auto x = static_cast<uint32_t>(key >> 32);
+		auto z = static_cast<uint32_t>(key);
+		auto lod = wanted[key].first;
+		pending.emplace(key, std::make_pair(lod, loader.Enqueue([this, x, z, lod]() {
+			return LoadTile(x, z, lod);
+		})));
+	}
+}
+
+void TiledHeightfield::AddLoadedTiles() {
+	for (auto it = pending.begin(); it != pending.end();) {
+		auto &future = it->second.second;
+
+		if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		// Tiles that stopped being wanted while they were read are dropped.
+		if (auto tile = future.get(); tile && wanted.find(it->first) != wanted.end())
+			AddTile(std::move(tile));
+
+		it = pending.erase(it);
+	}
+}
+
+std::unique_ptr<TiledHeightfield::Tile> TiledHeightfield::LoadTile(uint32_t x, uint32_t z, uint32_t lod) {
+	auto tile = std::make_unique<Tile>();
+	tile->x = x;
+	tile->z = z;
+	tile->lod = lod;
+
+	std::unique_lock<std::mutex> lock(fileMutex);
+	if (!file.ReadTile(x, z, lod, tile->heights))
+		return nullptr;
+
+	const auto &header = file.GetHeader();
+	const auto &info = file.GetTile(x, z);
+	auto samples = static_cast<int32_t>(file.GetSampleCount(lod));
+	lock.unlock();
+
+	// Bullet reads the quantized heights as they are, scaled by the height scale.
+	tile->shape = std::make_unique<btHeightfieldTerrainShape>(samples, samples, tile->heights.data(), header.heightScale, info.minHeight, info.maxHeight,
+		1, PHY_SHORT, false);
+	auto step = header.spacing * static_cast<float>(1u << lod);
+	tile->shape->setLocalScaling(btVector3(step, 1.0f, step));
+
+	// The shape is centred on its bounds.
+	auto tileLength = header.tileSize * header.spacing;
+	btVector3 centre(origin.x + (x + 0.5f) * tileLength, origin.y + 0.5f * (info.minHeight + info.maxHeight), origin.z + (z + 0.5f) * tileLength);
+
+	tile->object = std::make_unique<btCollisionObject>();
+	tile->object->setCollisionShape(tile->shape.get());
+	tile->object->setWorldTransform(btTransform(btQuaternion::getIdentity(), centre));
+	tile->object->setCollisionFlags(tile->object->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT);
+	tile->object->setFriction(friction);
+	return tile;
+}
+
+void TiledHeightfield::AddTile(std::unique_ptr<Tile> &&tile) {
+	if (!tile)
+		return;
+
+	auto &instance = tiles[GetKey(tile->x, tile->z)];
+	if (instance)
+		RemoveTile(*instance);
+
+	instance = std::move(tile);
+	Scenes::Get()->GetPhysics()->GetDynamicsWorld()->addCollisionObject(instance->object.get(), btBroadphaseProxy::StaticFilter,
+		btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+}
+
+void TiledHeightfield::RemoveTile(Tile &tile) {
+	if (auto physics = Scenes::Get()->GetPhysics())
+		physics->GetDynamicsWorld()->removeCollisionObject(tile.object.get());
+}
+
+const Node &operator>>(const Node &node, TiledHeightfield &heightfield) {
+	node["filename"].Get(heightfield.filename);
+	node["loadRadius"].Get(heightfield.loadRadius);
+	node["lodDistance"].Get(heightfield.lodDistance);
+	node["friction"].Get(heightfield.friction);
+	return node;
+}
+
+Node &operator<<(Node &node, const TiledHeightfield &heightfield) {
+	node["filename"].Set(heightfield.filename);
+	node["loadRadius"].Set(heightfield.loadRadius);
+	node["lodDistance"].Set(heightfield.lodDistance);
+	node["friction"].Set(heightfield.friction);
+	return node;
+}
+}
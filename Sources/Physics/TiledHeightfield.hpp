@@ -0,0 +1,122 @@
+#pragma once
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+#include "Maths/Vector3.hpp"
+#include "Scenes/Component.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "HeightTileFile.hpp"
+
+class btCollisionObject;
+class btHeightfieldTerrainShape;
+
+namespace acid {
+/**
+ * @brief Component that collides with terrain read from a acid::HeightTileFile, with only the tiles around bodies that can move loaded.
+ * Each tile is its own static object in the world. Tiles are read on a loader thread and added to the world in
+ * {@link TiledHeightfield#Update}, a tile that changes level of detail is kept until its new level is read.
+ * Tiles under and next to a body are at full detail, each level after is used one LOD distance further away, so
+ * distant tiles cost less to collide with and to query. Neighbouring tiles at different levels of detail can leave small
+ * gaps along their shared edge, away from the bodies. A tile right under a body that is not loaded yet is read at once,
+ * so bodies never fall through. The terrain starts at the position of the entity.
+ */
+class ACID_EXPORT TiledHeightfield : public Component::Registrar<TiledHeightfield> {
+	inline static const bool Registered = Register("tiledHeightfield");
+public:
+	/// Most tile reads waiting on the loader at once, nearest tiles are asked for first.
+	static constexpr std::size_t MaxPendingLoads = 8;
+
+	/**
+	 * Creates a new tiled heightfield.
+	 * @param filename The height tile file to read.
+	 * @param loadRadius The distance from active bodies that tiles are loaded within.
+	 * @param lodDistance The distance from active bodies between each level of detail.
+	 * @param friction The amount of surface friction.
+	 */
+	explicit TiledHeightfield(std::filesystem::path filename = "", float loadRadius = 256.0f, float lodDistance = 128.0f, float friction = 0.7f);
+	~TiledHeightfield();
+
+	void Start() override;
+	void Update() override;
+
+	/**
+	 * Adds a point to load tiles around this update, as well as active bodies, such as the camera to raycast from.
+	 * @param point The point in world space.
+	 */
+	void AddFocusPoint(const Vector3f &point) { focusPoints.emplace_back(point); }
+
+	const std::filesystem::path &GetFilename() const { return filename; }
+
+	float GetLoadRadius() const { return loadRadius; }
+	void SetLoadRadius(float loadRadius) { this->loadRadius = loadRadius; }
+
+	float GetLodDistance() const { return lodDistance; }
+	void SetLodDistance(float lodDistance) { this->lodDistance = lodDistance; }
+
+	float GetFriction() const { return friction; }
+
+	std::size_t GetLoadedTileCount() const { return tiles.size(); }
+	std::size_t GetPendingTileCount() const { return pending.size(); }
+
+	/**
+	 * Gets the level of detail a tile is loaded at.
+	 * @param x The column of the tile.
+	 * @param z The row of the tile.
+	 * @return The level of detail, -1 if the tile is not loaded.
+	 */
+	int32_t GetTileLod(uint32_t x, uint32_t z) const;
+
+	friend const Node &operator>>(const Node &node, TiledHeightfield &heightfield);
+	friend Node &operator<<(Node &node, const TiledHeightfield &heightfield);
+
+private:
+	class Tile {
+	public:
+		Tile();
+		~Tile();
+
+		uint32_t x = 0, z = 0, lod = 0;
+		/// The quantized heights the shape reads from.
+		std::vector<int16_t> heights;
+		std::unique_ptr<btHeightfieldTerrainShape> shape;
+		std::unique_ptr<btCollisionObject> object;
+	};
+
+	static uint64_t GetKey(uint32_t x, uint32_t z) { return static_cast<uint64_t>(x) << 32 | z; }
+
+	/**
+	 * Finds the level of detail wanted for each tile near a focus point, from the bodies that can move and the points added.
+	 */
+	void FindWantedTiles();
+	void RequestTiles();
+	void AddLoadedTiles();
+
+	/**
+	 * Reads a tile and creates its shape, called from the loader or the calling thread.
+	 * @return The tile, null if it could not be read.
+	 */
+	std::unique_ptr<Tile> LoadTile(uint32_t x, uint32_t z, uint32_t lod);
+	void AddTile(std::unique_ptr<Tile> &&tile);
+	void RemoveTile(Tile &tile);
+
+	std::filesystem::path filename;
+	float loadRadius;
+	float lodDistance;
+	float friction;
+	Vector3f origin;
+
+	/// Guards the file, which is read by the loader and by the calling thread for tiles under bodies.
+	std::mutex fileMutex;
+	HeightTileFile file;
+	std::vector<Vector3f> focusPoints;
+	/// Tiles in the world, and the level of detail and distance wanted for tiles near a focus point.
+	std::unordered_map<uint64_t, std::unique_ptr<Tile>> tiles;
+	std::unordered_map<uint64_t, std::pair<uint32_t, float>> wanted;
+	/// Tiles being read, with the level of detail asked for.
+	std::unordered_map<uint64_t, std::pair<uint32_t, std::future<std::unique_ptr<Tile>>>> pending;
+	/// Reads tiles one at a time, declared last so reads finish before the file is closed.
+	ThreadPool loader;
+};
+}
@@ -1,5 +1,6 @@
 #include "DeferredSubrender.hpp"
 
+#include "Devices/Window.hpp"
 #include "Files/File.hpp"
 #include "Files/Json/Json.hpp"
 #include "Lights/Light.hpp"
@@ -13,14 +14,26 @@
 #include "Meshes/Mesh.hpp"
 
 namespace acid {
-static const uint32_t MAX_LIGHTS = 32; // TODO: Make configurable.
+static const uint32_t MIN_LIGHTS = 32;
+static const uint32_t MIN_CLUSTER_VALUES = 4096;
+
+/**
+ * Gets the size a buffer grows to in doubling steps.
+ */
+static std::size_t GetCapacity(std::size_t capacity, std::size_t minCapacity, std::size_t size) {
+	capacity = std::max(capacity, minCapacity);
+	while (capacity < size)
+		capacity *= 2;
+	return capacity;
+}
 
 DeferredSubrender::DeferredSubrender(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
 	pipeline(pipelineStage, {"Shaders/Deferred/Deferred.vert", "Shaders/Deferred/Deferred.frag"}, {}, {},
 		PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::None),
 	brdf(Resources::Get()->GetThreadPool().Enqueue(ComputeBRDF, 512)),
-	fog(Colour::White, 0.001f, 2.0f, -0.1f, 0.3f) {
+	fog(Colour::White, 0.001f, 2.0f, -0.1f, 0.3f),
+	threadPool(3) {
 #if defined(ACID_DEBUG)
 	Node node;
 	node << *pipeline.GetShader();
@@ -47,35 +60,33 @@ void DeferredSubrender::Render(const CommandBuffer &commandBuffer) {
 		prefiltered = Resources::Get()->GetThreadPool().Enqueue(ComputePrefiltered, skybox, 512);
 	}
 
-	// Updates uniforms.
-	std::vector<DeferredLight> deferredLights(MAX_LIGHTS);
-	uint32_t lightCount = 0;
-
+	// Updates lights.
 	auto sceneLights = Scenes::Get()->GetStructure()->QueryComponents<Light>();
+	auto lightCount = static_cast<uint32_t>(sceneLights.size());
+	deferredLights.assign(GetCapacity(deferredLights.size(), MIN_LIGHTS, lightCount), {});
+	lightBounds.clear();
 
-	for (const auto &light : sceneLights) {
-		//auto position = *light->GetPosition();
-		//float radius = light->GetRadius();
-
-		//if (radius >= 0.0f && !camera.GetViewFrustum()->SphereInFrustum(position, radius))
-		//{
-		//	continue;
-		//}
-
-		DeferredLight deferredLight = {};
+	for (uint32_t i = 0; i < lightCount; i++) {
+		const auto &light = sceneLights[i];
+		auto &deferredLight = deferredLights[i];
 		deferredLight.colour = light->GetColour();
 
 		if (auto transform = light->GetEntity()->GetComponent<Transform>())
 			deferredLight.position = transform->GetPosition();
 
 		deferredLight.radius = light->GetRadius();
-		deferredLights[lightCount] = deferredLight;
-		lightCount++;
-
-		if (lightCount >= MAX_LIGHTS)
-			break;
+		lightBounds.emplace_back(deferredLight.position, deferredLight.radius);
 	}
 
+	// Lights outside of the view are in no cluster, so they are culled here too.
+	lightClusters.Update(camera->GetViewMatrix(), camera->GetFieldOfView(), Window::Get()->GetAspectRatio(), camera->GetNearPlane(), camera->GetFarPlane(),
+		lightBounds, &threadPool);
+
+	const auto &clusters = lightClusters.GetBuffer();
+	auto clusterCapacity = GetCapacity(clusterBuffer.size(), MIN_CLUSTER_VALUES, clusters.size());
+	clusterBuffer.assign(clusters.begin(), clusters.end());
+	clusterBuffer.resize(clusterCapacity);
+
 	// Updates uniforms.
 	uniformScene.Push("view", camera->GetViewMatrix());
 	uniformScene.Push("shadowSpace", Shadows::Get()->GetShadowBox().GetToShadowMapSpaceMatrix());
@@ -84,13 +95,18 @@ void DeferredSubrender::Render(const CommandBuffer &commandBuffer) {
 	uniformScene.Push("fogColour", fog.GetColour());
 	uniformScene.Push("fogDensity", fog.GetDensity());
 	uniformScene.Push("fogGradient", fog.GetGradient());
+	uniformScene.Push("clusterGrid", lightClusters.GetGridSize());
+	uniformScene.Push("clusterScale", lightClusters.GetDepthScale());
+	uniformScene.Push("clusterBias", lightClusters.GetDepthBias());
 
 	// Updates storage buffers.
-	storageLights.Push(deferredLights.data(), sizeof(DeferredLight) * MAX_LIGHTS);
+	storageLights.Push(deferredLights.data(), sizeof(DeferredLight) * deferredLights.size());
+	storageClusters.Push(clusterBuffer.data(), sizeof(uint32_t) * clusterBuffer.size());
 
 	// Updates descriptors.
 	descriptorSet.Push("UniformScene", uniformScene);
 	descriptorSet.Push("BufferLights", storageLights);
+	descriptorSet.Push("BufferClusters", storageClusters);
 	descriptorSet.Push("samplerShadows", Graphics::Get()->GetAttachment("shadows"));
 	descriptorSet.Push("samplerPosition", Graphics::Get()->GetAttachment("position"));
 	descriptorSet.Push("samplerDiffuse", Graphics::Get()->GetAttachment("diffuse"));
@@ -2,6 +2,7 @@
 
 #include "Utils/Future.hpp"
 #include "Lights/Fog.hpp"
+#include "Lights/LightClusters.hpp"
 #include "Maths/Vector3.hpp"
 #include "Graphics/Subrender.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
@@ -23,6 +24,12 @@ public:
 	const Fog &GetFog() const { return fog; }
 	void SetFog(const Fog &fog) { this->fog = fog; }
 
+	/**
+	 * Gets the clusters lights were found for last frame, each pixel only shades with the lights of its cluster.
+	 * @return The light clusters.
+	 */
+	const LightClusters &GetLightClusters() const { return lightClusters; }
+
 private:
 	class DeferredLight {
 	public:
@@ -34,6 +41,7 @@ private:
 	DescriptorsHandler descriptorSet;
 	UniformHandler uniformScene;
 	StorageHandler storageLights;
+	StorageHandler storageClusters;
 
 	PipelineGraphics pipeline;
 
@@ -45,5 +53,13 @@ private:
 	Future<std::unique_ptr<ImageCube>> prefiltered;
 
 	Fog fog;
+
+	/// Light and cluster buffers grow in doubling steps, so they are not created again each time the light count changes.
+	std::vector<DeferredLight> deferredLights;
+	std::vector<Vector4f> lightBounds;
+	std::vector<uint32_t> clusterBuffer;
+	LightClusters lightClusters;
+	/// Finds lights for clusters, separate from the pools subrenders are recorded on.
+	ThreadPool threadPool;
 };
 }
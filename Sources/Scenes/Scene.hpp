@@ -14,11 +14,12 @@ public:
 	/**
 	 * Creates a new scene.
 	 * @param camera The scenes camera.
+	 * @param physicsThreads The number of threads that step the scenes physics, 0 to step on the game thread only.
 	 */
-	explicit Scene(std::unique_ptr<Camera> &&camera) :
+	explicit Scene(std::unique_ptr<Camera> &&camera, uint32_t physicsThreads = 0) :
 		camera(std::move(camera)),
 		structure(std::make_unique<SceneStructure>()),
-		physics(std::make_unique<ScenePhysics>()) {
+		physics(std::make_unique<ScenePhysics>(physicsThreads)) {
 	}
 
 	virtual ~Scene() = default;
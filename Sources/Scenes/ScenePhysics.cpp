@@ -1,41 +1,315 @@
 #include "ScenePhysics.hpp"
 
-#include <iterator>
+#include <algorithm>
+#include <atomic>
 
 #include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
 #include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h>
 #include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
+#include <LinearMath/btThreads.h>
 #include "Engine/Engine.hpp"
 #include "Physics/Colliders/Collider.hpp"
 #include "Physics/CollisionObject.hpp"
+#include "Utils/ThreadPool.hpp"
 
 namespace acid {
-ScenePhysics::ScenePhysics() :
-	collisionConfiguration(std::make_unique<btSoftBodyRigidBodyCollisionConfiguration>()),
-	broadphase(std::make_unique<btDbvtBroadphase>()),
-	dispatcher(std::make_unique<btCollisionDispatcher>(collisionConfiguration.get())),
-	solver(std::make_unique<btSequentialImpulseConstraintSolver>()),
-	dynamicsWorld(std::make_unique<btSoftRigidDynamicsWorld>(dispatcher.get(), broadphase.get(), solver.get(), collisionConfiguration.get())),
+/// Pairs each worker of the collision dispatcher takes at a time.
+static constexpr int DispatcherGrainSize = 40;
+/// Persistent manifolds and collision algorithms pooled up front, workers only take the slower allocator once these run out.
+static constexpr int MaxPoolSize = 16384;
+
+/**
+ * Runs the parallel loops of Bullet on a pool of engine worker threads, the calling thread takes part in every loop.
+ * Bullet keeps per thread data by the index it gives each thread, so one scheduler with a fixed pool is shared by every world.
+ */
+class PhysicsTaskScheduler : public btITaskScheduler {
+public:
+	explicit PhysicsTaskScheduler(uint32_t maxThreadCount) :
+		btITaskScheduler("Acid"),
+		maxThreadCount(static_cast<int>(maxThreadCount)),
+		threadCount(static_cast<int>(maxThreadCount)),
+		threadPool(maxThreadCount - 1) {
+	}
+
+	static PhysicsTaskScheduler *Get() {
+		static PhysicsTaskScheduler instance(ScenePhysics::GetMaxThreadCount());
+		return &instance;
+	}
+
+	int getMaxNumThreads() const override { return maxThreadCount; }
+	int getNumThreads() const override { return threadCount; }
+	void setNumThreads(int numThreads) override { threadCount = std::clamp(numThreads, 1, maxThreadCount); }
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body) override {
+		Run(iBegin, iEnd, grainSize, threadCount, [&body](int begin, int end) {
+			body.forLoop(begin, end);
+			return btScalar(0);
+		});
+	}
+
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody &body) override {
+		return Run(iBegin, iEnd, grainSize, threadCount, [&body](int begin, int end) {
+			return body.sumLoop(begin, end);
+		});
+	}
+
+	/**
+	 * Runs a loop split into chunks between the calling thread and the workers.
+	 * @param iBegin The first index.
+	 * @param iEnd The index after the last.
+	 * @param grainSize The indices each thread takes at a time.
+	 * @param threads The most threads to run on, including the calling thread.
+	 * @param loop The function run for each chunk, with its first index and the index after its last.
+	 * @return The sum of what the loop returned for each chunk.
+	 */
+	template<typename F>
+	btScalar Run(int iBegin, int iEnd, int grainSize, int threads, const F &loop) {
+		grainSize = std::max(grainSize, 1);
+		auto chunkCount = (iEnd - iBegin + grainSize - 1) / grainSize;
+		auto workerCount = std::min({threads, maxThreadCount, chunkCount});
+
+		// Loops started from inside a loop run where they are, the workers are already busy.
+		if (workerCount <= 1 || running) {
+			return loop(iBegin, iEnd);
+		}
+
+		std::atomic<int> nextChunk = 0;
+		auto work = [&]() {
+			running = true;
+			btScalar sum = 0;
+
+			for (int chunk; (chunk = nextChunk++) < chunkCount;) {
+				auto begin = iBegin + chunk * grainSize;
+				sum += loop(begin, std::min(begin + grainSize, iEnd));
+			}
+
+			running = false;
+			return sum;
+		};
+
+		std::vector<std::future<btScalar>> futures;
+		futures.reserve(workerCount - 1);
+
+		for (int i = 1; i < workerCount; i++)
+			futures.emplace_back(threadPool.Enqueue(work));
+
+		auto sum = work();
+
+		for (auto &future : futures)
+			sum += future.get();
+
+		return sum;
+	}
+
+private:
+	int maxThreadCount;
+	int threadCount;
+	ThreadPool threadPool;
+	/// If this thread is running a loop.
+	inline static thread_local bool running = false;
+};
+
+/// Queries each worker takes at a time.
+static constexpr int QueryGrainSize = 64;
+
+/**
+ * Runs a function for each query of a batch, split between every thread of the pool.
+ * Queries only read the world, Bullet keeps the stacks of broadphase ray tests per thread so they can run in parallel.
+ * @param count The number of queries.
+ * @param query The function run with the index of each query.
+ */
+template<typename F>
+static void RunQueries(std::size_t count, const F &query) {
+	PhysicsTaskScheduler::Get()->Run(0, static_cast<int>(count), QueryGrainSize, static_cast<int>(ScenePhysics::GetMaxThreadCount()),
+		[&query](int begin, int end) {
+		for (int i = begin; i < end; i++)
+			query(static_cast<std::size_t>(i));
+		return btScalar(0);
+	});
+}
+
+static CollisionObject *GetCollisionObject(const btCollisionObject *object) {
+	return object ? static_cast<CollisionObject *>(object->getUserPointer()) : nullptr;
+}
+
+/**
+ * Keeps the closest hits of a query in the slots given to it.
+ */
+class HitList {
+public:
+	HitList(Raycast *hits, uint32_t maxHits) :
+		hits(hits),
+		maxHits(maxHits) {
+	}
+
+	void Add(const Raycast &hit) {
+		if (count < maxHits) {
+			hits[count++] = hit;
+			return;
+		}
+
+		// Once full the farthest hit kept is replaced by closer hits.
+		auto farthest = std::max_element(hits, hits + count, [](const Raycast &a, const Raycast &b) {
+			return a.GetFraction() < b.GetFraction();
+		});
+
+		if (farthest != hits + count && hit.GetFraction() < farthest->GetFraction())
+			*farthest = hit;
+	}
+
+	/**
+	 * Sorts the hits from closest to farthest.
+	 * @return The number of hits.
+	 */
+	uint32_t Sort() {
+		std::sort(hits, hits + count, [](const Raycast &a, const Raycast &b) {
+			return a.GetFraction() < b.GetFraction();
+		});
+		return count;
+	}
+
+private:
+	Raycast *hits;
+	uint32_t maxHits;
+	uint32_t count = 0;
+};
+
+/**
+ * Keeps every hit along a ray, Bullet is asked for all hits by never moving the closest hit fraction.
+ */
+class AllHitsRayCallback : public btCollisionWorld::RayResultCallback {
+public:
+	AllHitsRayCallback(const btVector3 &from, const btVector3 &to, Raycast *hits, uint32_t maxHits) :
+		from(from),
+		to(to),
+		hits(hits, maxHits) {
+	}
+
+	btScalar addSingleResult(btCollisionWorld::LocalRayResult &rayResult, bool normalInWorldSpace) override {
+		m_collisionObject = rayResult.m_collisionObject;
+		auto normal = normalInWorldSpace ? rayResult.m_hitNormalLocal : m_collisionObject->getWorldTransform().getBasis() * rayResult.m_hitNormalLocal;
+		hits.Add(Raycast(true, Collider::Convert(from.lerp(to, rayResult.m_hitFraction)), GetCollisionObject(m_collisionObject),
+			Collider::Convert(normal), rayResult.m_hitFraction));
+		return m_closestHitFraction;
+	}
+
+	btVector3 from;
+	btVector3 to;
+	HitList hits;
+};
+
+/**
+ * Keeps every hit of a swept shape.
+ */
+class AllHitsConvexCallback : public btCollisionWorld::ConvexResultCallback {
+public:
+	AllHitsConvexCallback(Raycast *hits, uint32_t maxHits) :
+		hits(hits, maxHits) {
+	}
+
+	btScalar addSingleResult(btCollisionWorld::LocalConvexResult &convexResult, bool normalInWorldSpace) override {
+		auto object = convexResult.m_hitCollisionObject;
+		auto normal = normalInWorldSpace ? convexResult.m_hitNormalLocal : object->getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+		// The local hit point of a convex result is in world space.
+		hits.Add(Raycast(true, Collider::Convert(convexResult.m_hitPointLocal), GetCollisionObject(object), Collider::Convert(normal),
+			convexResult.m_hitFraction));
+		return m_closestHitFraction;
+	}
+
+	HitList hits;
+};
+
+/**
+ * Gathers the objects in the leaves of the broadphase overlapping a box, and optionally a sphere inside it.
+ * Objects that are not owned by a collision object are skipped.
+ */
+class OverlapCallback : public btBroadphaseAabbCallback {
+public:
+	OverlapCallback(CollisionObject **results, uint32_t maxResults, const btVector3 &centre = btVector3(0.0f, 0.0f, 0.0f), btScalar radius = -1.0f) :
+		results(results),
+		maxResults(maxResults),
+		centre(centre),
+		radius(radius) {
+	}
+
+	bool process(const btBroadphaseProxy *proxy) override {
+		if (count == maxResults)
+			return false;
+
+		if (radius >= 0.0f) {
+			auto closest = centre;
+			closest.setMax(proxy->m_aabbMin);
+			closest.setMin(proxy->m_aabbMax);
+
+			if (closest.distance2(centre) > radius * radius)
+				return true;
+		}
+
+		if (auto object = GetCollisionObject(static_cast<const btCollisionObject *>(proxy->m_clientObject)))
+			results[count++] = object;
+
+		return count < maxResults;
+	}
+
+	CollisionObject **results;
+	uint32_t maxResults;
+	uint32_t count = 0;
+	btVector3 centre;
+	btScalar radius;
+};
+
+ScenePhysics::ScenePhysics(uint32_t threadCount) :
+	threadCount(std::min(threadCount, GetMaxThreadCount())),
 	gravity(0.0f, -9.81f, 0.0f),
 	airDensity(1.2f) {
+	broadphase = std::make_unique<btDbvtBroadphase>();
+
+	if (this->threadCount == 0) {
+		collisionConfiguration = std::make_unique<btSoftBodyRigidBodyCollisionConfiguration>();
+		dispatcher = std::make_unique<btCollisionDispatcher>(collisionConfiguration.get());
+		solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+		dynamicsWorld = std::make_unique<btSoftRigidDynamicsWorld>(dispatcher.get(), broadphase.get(), solver.get(), collisionConfiguration.get());
+	} else {
+		// The dispatcher sizes its per thread data by the threads of the scheduler, so it is made with every thread.
+		auto taskScheduler = PhysicsTaskScheduler::Get();
+		btSetTaskScheduler(taskScheduler);
+		taskScheduler->setNumThreads(taskScheduler->getMaxNumThreads());
+
+		btDefaultCollisionConstructionInfo constructionInfo;
+		constructionInfo.m_defaultMaxPersistentManifoldPoolSize = MaxPoolSize;
+		constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = MaxPoolSize;
+		collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>(constructionInfo);
+		dispatcher = std::make_unique<btCollisionDispatcherMt>(collisionConfiguration.get(), DispatcherGrainSize);
+		auto solverPool = std::make_unique<btConstraintSolverPoolMt>(static_cast<int>(this->threadCount));
+		dynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(dispatcher.get(), broadphase.get(), solverPool.get(), nullptr,
+			collisionConfiguration.get());
+		solver = std::move(solverPool);
+	}
+
 	dynamicsWorld->setGravity(Collider::Convert(gravity));
-	dynamicsWorld->getDispatchInfo().m_enableSPU = true;
 	dynamicsWorld->getSolverInfo().m_minimumSolverBatchSize = 128;
 	dynamicsWorld->getSolverInfo().m_globalCfm = 0.00001f;
 
-	auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(dynamicsWorld.get());
-	softDynamicsWorld->getWorldInfo().water_density = 0.0f;
-	softDynamicsWorld->getWorldInfo().water_offset = 0.0f;
-	softDynamicsWorld->getWorldInfo().water_normal = btVector3(0.0f, 0.0f, 0.0f);
-	softDynamicsWorld->getWorldInfo().m_gravity.setValue(0.0f, -9.81f, 0.0f);
-	softDynamicsWorld->getWorldInfo().air_density = airDensity;
-	softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
+	if (this->threadCount == 0) {
+		auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(dynamicsWorld.get());
+		softDynamicsWorld->getWorldInfo().water_density = 0.0f;
+		softDynamicsWorld->getWorldInfo().water_offset = 0.0f;
+		softDynamicsWorld->getWorldInfo().water_normal = btVector3(0.0f, 0.0f, 0.0f);
+		softDynamicsWorld->getWorldInfo().m_gravity.setValue(0.0f, -9.81f, 0.0f);
+		softDynamicsWorld->getWorldInfo().air_density = airDensity;
+		softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
+	}
 }
 
 ScenePhysics::~ScenePhysics() {
@@ -53,7 +327,34 @@ ScenePhysics::~ScenePhysics() {
 }
 
 void ScenePhysics::Update() {
-	dynamicsWorld->stepSimulation(Engine::Get()->GetDelta().AsSeconds());
+	accumulator += Engine::Get()->GetDelta();
+	subSteps = 0;
+
+	while (accumulator >= fixedDelta) {
+		if (subSteps == maxSubSteps) {
+			// Whole steps that are left over are dropped, the fraction of a step is kept for interpolation.
+			auto dropped = static_cast<int64_t>(accumulator / fixedDelta);
+			droppedTime += fixedDelta * dropped;
+			accumulator -= fixedDelta * dropped;
+			break;
+		}
+
+		onFixedUpdate(fixedDelta);
+		Step(fixedDelta);
+		accumulator -= fixedDelta;
+		subSteps++;
+	}
+}
+
+void ScenePhysics::Step(const Time &delta) {
+	// The scheduler is shared, each world steps with its own number of threads.
+	if (threadCount != 0)
+		btGetTaskScheduler()->setNumThreads(static_cast<int>(threadCount));
+
+	// Counted first, so motion states synchronized by this step see its number.
+	stepCount++;
+	// Steps by exactly the delta, with no sub steps of Bullets own.
+	dynamicsWorld->stepSimulation(delta.AsSeconds(), 0);
 	CheckForCollisionEvents();
 }
 
@@ -63,8 +364,108 @@ Raycast ScenePhysics::Raytest(const Vector3f &start, const Vector3f &end) const
 	btCollisionWorld::ClosestRayResultCallback result(startBt, endBt);
 	dynamicsWorld->getCollisionWorld()->rayTest(startBt, endBt, result);
 
-	return Raycast(result.hasHit(), Collider::Convert(result.m_hitPointWorld),
-		result.m_collisionObject ? static_cast<CollisionObject *>(result.m_collisionObject->getUserPointer()) : nullptr);
+	return Raycast(result.hasHit(), Collider::Convert(result.m_hitPointWorld), GetCollisionObject(result.m_collisionObject),
+		Collider::Convert(result.m_hitNormalWorld), result.m_closestHitFraction);
+}
+
+void ScenePhysics::Raytest(const RayQuery *queries, Raycast *results, std::size_t count) const {
+	auto collisionWorld = dynamicsWorld->getCollisionWorld();
+
+	RunQueries(count, [&](std::size_t i) {
+		auto startBt = Collider::Convert(queries[i].start);
+		auto endBt = Collider::Convert(queries[i].end);
+		btCollisionWorld::ClosestRayResultCallback result(startBt, endBt);
+		collisionWorld->rayTest(startBt, endBt, result);
+
+		results[i] = result.hasHit() ? Raycast(true, Collider::Convert(result.m_hitPointWorld), GetCollisionObject(result.m_collisionObject),
+			Collider::Convert(result.m_hitNormalWorld), result.m_closestHitFraction) : Raycast();
+	});
+}
+
+void ScenePhysics::RaytestAll(const RayQuery *queries, Raycast *results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const {
+	auto collisionWorld = dynamicsWorld->getCollisionWorld();
+
+	RunQueries(count, [&](std::size_t i) {
+		auto startBt = Collider::Convert(queries[i].start);
+		auto endBt = Collider::Convert(queries[i].end);
+		AllHitsRayCallback result(startBt, endBt, results + i * maxResults, maxResults);
+		collisionWorld->rayTest(startBt, endBt, result);
+		resultCounts[i] = result.hits.Sort();
+	});
+}
+
+void ScenePhysics::Sweeptest(const SweepQuery *queries, Raycast *results, std::size_t count) const {
+	auto collisionWorld = dynamicsWorld->getCollisionWorld();
+
+	RunQueries(count, [&](std::size_t i) {
+		btSphereShape shape(queries[i].radius);
+		auto startBt = Collider::Convert(queries[i].start);
+		auto endBt = Collider::Convert(queries[i].end);
+		btCollisionWorld::ClosestConvexResultCallback result(startBt, endBt);
+		collisionWorld->convexSweepTest(&shape, btTransform(btQuaternion::getIdentity(), startBt), btTransform(btQuaternion::getIdentity(), endBt), result);
+
+		results[i] = result.hasHit() ? Raycast(true, Collider::Convert(result.m_hitPointWorld), GetCollisionObject(result.m_hitCollisionObject),
+			Collider::Convert(result.m_hitNormalWorld), result.m_closestHitFraction) : Raycast();
+	});
+}
+
+void ScenePhysics::Sweeptest(const Collider &collider, const SweepQuery *queries, Raycast *results, std::size_t count) const {
+	auto shape = collider.GetCollisionShape();
+
+	if (!shape || !shape->isConvex()) {
+		Log::Error("Only convex colliders can be swept\n");
+		std::fill(results, results + count, Raycast());
+		return;
+	}
+
+	auto convexShape = static_cast<const btConvexShape *>(shape);
+	auto basis = Collider::Convert(collider.GetLocalTransform()).getBasis();
+	auto collisionWorld = dynamicsWorld->getCollisionWorld();
+
+	RunQueries(count, [&](std::size_t i) {
+		auto startBt = Collider::Convert(queries[i].start);
+		auto endBt = Collider::Convert(queries[i].end);
+		btCollisionWorld::ClosestConvexResultCallback result(startBt, endBt);
+		collisionWorld->convexSweepTest(convexShape, btTransform(basis, startBt), btTransform(basis, endBt), result);
+
+		results[i] = result.hasHit() ? Raycast(true, Collider::Convert(result.m_hitPointWorld), GetCollisionObject(result.m_hitCollisionObject),
+			Collider::Convert(result.m_hitNormalWorld), result.m_closestHitFraction) : Raycast();
+	});
+}
+
+void ScenePhysics::SweeptestAll(const SweepQuery *queries, Raycast *results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const {
+	auto collisionWorld = dynamicsWorld->getCollisionWorld();
+
+	RunQueries(count, [&](std::size_t i) {
+		btSphereShape shape(queries[i].radius);
+		AllHitsConvexCallback result(results + i * maxResults, maxResults);
+		collisionWorld->convexSweepTest(&shape, btTransform(btQuaternion::getIdentity(), Collider::Convert(queries[i].start)),
+			btTransform(btQuaternion::getIdentity(), Collider::Convert(queries[i].end)), result);
+		resultCounts[i] = result.hits.Sort();
+	});
+}
+
+void ScenePhysics::OverlapBox(const BoxQuery *queries, CollisionObject **results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const {
+	RunQueries(count, [&](std::size_t i) {
+		OverlapCallback result(results + i * maxResults, maxResults);
+		broadphase->aabbTest(Collider::Convert(queries[i].min), Collider::Convert(queries[i].max), result);
+		resultCounts[i] = result.count;
+	});
+}
+
+void ScenePhysics::OverlapSphere(const SphereQuery *queries, CollisionObject **results, uint32_t *resultCounts, uint32_t maxResults,
+	std::size_t count) const {
+	RunQueries(count, [&](std::size_t i) {
+		auto centre = Collider::Convert(queries[i].centre);
+		auto extent = btVector3(queries[i].radius, queries[i].radius, queries[i].radius);
+		OverlapCallback result(results + i * maxResults, maxResults, centre, queries[i].radius);
+		broadphase->aabbTest(centre - extent, centre + extent, result);
+		resultCounts[i] = result.count;
+	});
+}
+
+uint32_t ScenePhysics::GetMaxThreadCount() {
+	return std::clamp<uint32_t>(std::thread::hardware_concurrency(), 1, BT_MAX_THREAD_COUNT);
 }
 
 void ScenePhysics::SetGravity(const Vector3f &gravity) {
@@ -74,14 +475,19 @@ void ScenePhysics::SetGravity(const Vector3f &gravity) {
 
 void ScenePhysics::SetAirDensity(float airDensity) {
 	this->airDensity = airDensity;
+
+	if (threadCount != 0)
+		return;
+
 	auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(dynamicsWorld.get());
 	softDynamicsWorld->getWorldInfo().air_density = airDensity;
 	softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
 }
 
 void ScenePhysics::CheckForCollisionEvents() {
-	// Keep a list of the collision pairs found during the current update.
-	CollisionPairs pairsThisUpdate;
+	contactPairs.Update();
+	startedPairs.clear();
+	endedPairs.clear();
 
 	// Iterate through all of the manifolds in the dispatcher.
 	for (int32_t i = 0; i < dispatcher->getNumManifolds(); ++i) {
@@ -92,48 +498,33 @@ void ScenePhysics::CheckForCollisionEvents() {
 		if (manifold->getNumContacts() == 0)
 			continue;
 
-		// Get the two rigid bodies involved in the collision.
+		// The pair is ordered by address, if it wasn't in contact last step it is a new pair and we must send a collision event.
 		auto body0 = manifold->getBody0();
 		auto body1 = manifold->getBody1();
 
-		// Always create the pair in a predictable order (use the pointer value..).
-		const auto swapped = body0 > body1;
-		const auto sortedBodyA = swapped ? body1 : body0;
-		const auto sortedBodyB = swapped ? body0 : body1;
-
-		// Create the pair.
-		auto thisPair = std::make_pair(sortedBodyA, sortedBodyB);
+		if (contactPairs.Insert(body0, body1))
+			startedPairs.emplace_back(std::min(body0, body1), std::max(body0, body1));
+	}
 
-		// Insert the pair into the current list.
-		pairsThisUpdate.insert(thisPair);
+	// Pairs in contact last step that weren't found this step have separated.
+	contactPairs.GetEnded(endedPairs);
 
-		// If this pair doesn't exist in the list from the previous update, it is a new pair and we must send a collision event.
-		if (pairsLastUpdate.find(thisPair) == pairsLastUpdate.end()) {
-			// Gets the user pointer (entity).
-			auto collisionObjectA = static_cast<CollisionObject *>(sortedBodyA->getUserPointer());
-			auto collisionObjectB = static_cast<CollisionObject *>(sortedBodyB->getUserPointer());
+	// Events are sent once every pair is found, so delegates can change the world safely.
+	for (const auto &[object0, object1] : startedPairs) {
+		// Gets the user pointer (entity).
+		auto collisionObjectA = static_cast<CollisionObject *>(object0->getUserPointer());
+		auto collisionObjectB = static_cast<CollisionObject *>(object1->getUserPointer());
 
+		if (collisionObjectA)
 			collisionObjectA->OnCollision()(collisionObjectB);
-		}
 	}
 
-	// Creates another list for pairs that were removed this update.
-	CollisionPairs removedPairs;
-
-	// This handy function gets the difference between two sets. It takes the difference between collision pairs from the last update,
-	// and this update and pushes them into the removed pairs list.
-	std::set_difference(pairsLastUpdate.begin(), pairsLastUpdate.end(), pairsThisUpdate.begin(), pairsThisUpdate.end(), std::inserter(removedPairs, removedPairs.begin()));
+	for (const auto &[object0, object1] : endedPairs) {
+		auto collisionObjectA = static_cast<CollisionObject *>(object0->getUserPointer());
+		auto collisionObjectB = static_cast<CollisionObject *>(object1->getUserPointer());
 
-	// Iterate through all of the removed pairs sending separation events for them.
-	for (const auto &[removedObject0, removedObject1] : removedPairs) {
-		// Gets the user pointer (entity).
-		auto collisionObjectA = static_cast<CollisionObject *>(removedObject0->getUserPointer());
-		auto collisionObjectB = static_cast<CollisionObject *>(removedObject1->getUserPointer());
-
-		collisionObjectA->OnSeparation()(collisionObjectB);
+		if (collisionObjectA)
+			collisionObjectA->OnSeparation()(collisionObjectB);
 	}
-
-	// In the next iteration we'll want to compare against the pairs we found in this iteration.
-	pairsLastUpdate = pairsThisUpdate;
 }
 }
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <set>
 #include <memory>
 
+#include "Maths/Time.hpp"
 #include "Maths/Vector3.hpp"
+#include "Physics/ContactPairTable.hpp"
+#include "Utils/Delegate.hpp"
 
 class btCollisionObject;
 class btCollisionConfiguration;
@@ -14,48 +16,243 @@ class btDiscreteDynamicsWorld;
 
 namespace acid {
 class Entity;
+class Collider;
 class CollisionObject;
 
-using CollisionPair = std::pair<const btCollisionObject *, const btCollisionObject *>;
-using CollisionPairs = std::set<CollisionPair>;
+using CollisionPair = ContactPairTable<btCollisionObject>::Pair;
 
 class ACID_EXPORT Raycast {
 public:
-	Raycast(bool hasHit, const Vector3f &pointWorld, CollisionObject *collisionObject) :
+	Raycast() = default;
+	Raycast(bool hasHit, const Vector3f &pointWorld, CollisionObject *collisionObject, const Vector3f &normalWorld = {}, float fraction = 1.0f) :
 		hasHit(hasHit),
 		pointWorld(pointWorld),
+		normalWorld(normalWorld),
+		fraction(fraction),
 		collisionObject(collisionObject) {
 	}
 
 	bool HasHit() const { return hasHit; }
 	const Vector3f &GetPointWorld() const { return pointWorld; }
+	const Vector3f &GetNormalWorld() const { return normalWorld; }
+	/**
+	 * Gets how far along the query the hit is.
+	 * @return The fraction from the start to the end, 1 if nothing was hit.
+	 */
+	float GetFraction() const { return fraction; }
 	CollisionObject *GetCollisionObject() const { return collisionObject; }
 
 private:
-	bool hasHit;
+	bool hasHit = false;
 	Vector3f pointWorld;
-	CollisionObject *collisionObject;
+	Vector3f normalWorld;
+	float fraction = 1.0f;
+	CollisionObject *collisionObject = nullptr;
 };
 
+/**
+ * @brief A segment tested against the world by a ray test.
+ */
+class ACID_EXPORT RayQuery {
+public:
+	Vector3f start;
+	Vector3f end;
+};
+
+/**
+ * @brief A shape swept along a segment, a sphere unless a collider is given to the sweep.
+ */
+class ACID_EXPORT SweepQuery {
+public:
+	Vector3f start;
+	Vector3f end;
+	/// The radius of the sphere swept.
+	float radius = 0.5f;
+};
+
+/**
+ * @brief A world space box tested for overlapping objects.
+ */
+class ACID_EXPORT BoxQuery {
+public:
+	Vector3f min;
+	Vector3f max;
+};
+
+/**
+ * @brief A world space sphere tested for overlapping objects.
+ */
+class ACID_EXPORT SphereQuery {
+public:
+	Vector3f centre;
+	float radius = 0.5f;
+};
+
+/**
+ * @brief Class that owns the dynamics world of a scene.
+ * The world is stepped at a fixed rate whatever the frame rate, frame time is gathered until there is a whole step to take.
+ * Under load at most the max sub steps are taken each frame and the rest of the time is dropped, so slow steps can't
+ * make the next frame slower still. Bodies are drawn between their last two steps by {@link ScenePhysics#GetInterpolation}.
+ *
+ * By default the world is stepped on the calling thread and supports soft bodies. When created with a thread count
+ * the world is a btDiscreteDynamicsWorldMt, that finds contacts, solves islands and integrates bodies in parallel on
+ * a pool of engine worker threads shared by every multithreaded scene. The multithreaded world does not support soft bodies.
+ *
+ * Scene queries are also taken in batches, queries only read the world so a batch is split between every worker of the pool
+ * whatever the world was created with. Results are written to arrays given by the caller, queries that keep every hit are
+ * given a fixed number of slots each so nothing is allocated. Batches must not be queried while the world is stepped.
+ */
 class ACID_EXPORT ScenePhysics {
 public:
-	ScenePhysics();
+	/// Default time each step simulates.
+	static constexpr Time DefaultFixedDelta = Time::Microseconds(1000000 / 120);
+	/// Default most steps taken in a frame.
+	static constexpr uint32_t DefaultMaxSubSteps = 4;
+
+	/**
+	 * Creates a new dynamics world.
+	 * @param threadCount The number of threads that step the world, 0 to step on the calling thread only.
+	 */
+	explicit ScenePhysics(uint32_t threadCount = 0);
 	~ScenePhysics();
 
+	/**
+	 * Takes the fixed steps the time since the last frame adds up to.
+	 */
 	void Update();
 
+	/**
+	 * Steps the world once, and sends collision events for the contacts that started or ended.
+	 * @param delta The time to step by.
+	 */
+	void Step(const Time &delta);
+
 	Raycast Raytest(const Vector3f &start, const Vector3f &end) const;
 
+	/**
+	 * Finds the closest hit along each ray of a batch.
+	 * @param queries The rays to test.
+	 * @param results The closest hit of each ray, as many as there are queries.
+	 * @param count The number of queries.
+	 */
+	void Raytest(const RayQuery *queries, Raycast *results, std::size_t count) const;
+
+	/**
+	 * Finds the hits along each ray of a batch, the hits of query i are written from results[i * maxResults].
+	 * @param queries The rays to test.
+	 * @param results The hits of each ray from closest to farthest, maxResults for each query.
+	 * @param resultCounts The number of hits written for each query.
+	 * @param maxResults The most hits kept for a query, the closest are kept.
+	 * @param count The number of queries.
+	 */
+	void RaytestAll(const RayQuery *queries, Raycast *results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const;
+
+	/**
+	 * Finds the first hit of a sphere swept along each segment of a batch.
+	 * @param queries The spheres to sweep.
+	 * @param results The closest hit of each sweep, as many as there are queries.
+	 * @param count The number of queries.
+	 */
+	void Sweeptest(const SweepQuery *queries, Raycast *results, std::size_t count) const;
+
+	/**
+	 * Finds the first hit of a convex collider swept along each segment of a batch, the radius of the queries is unused.
+	 * @param collider The collider to sweep, in its local rotation.
+	 * @param queries The segments to sweep along.
+	 * @param results The closest hit of each sweep, as many as there are queries.
+	 * @param count The number of queries.
+	 */
+	void Sweeptest(const Collider &collider, const SweepQuery *queries, Raycast *results, std::size_t count) const;
+
+	/**
+	 * Finds the hits of a sphere swept along each segment of a batch, the hits of query i are written from results[i * maxResults].
+	 * @param queries The spheres to sweep.
+	 * @param results The hits of each sweep from closest to farthest, maxResults for each query.
+	 * @param resultCounts The number of hits written for each query.
+	 * @param maxResults The most hits kept for a query, the closest are kept.
+	 * @param count The number of queries.
+	 */
+	void SweeptestAll(const SweepQuery *queries, Raycast *results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const;
+
+	/**
+	 * Finds the objects with bounds overlapping each box of a batch, the objects of query i are written from results[i * maxResults].
+	 * @param queries The boxes to test.
+	 * @param results The objects found for each box, maxResults for each query.
+	 * @param resultCounts The number of objects written for each query.
+	 * @param maxResults The most objects kept for a query, the first found are kept.
+	 * @param count The number of queries.
+	 */
+	void OverlapBox(const BoxQuery *queries, CollisionObject **results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const;
+
+	/**
+	 * Finds the objects with bounds overlapping each sphere of a batch, the objects of query i are written from results[i * maxResults].
+	 * Objects are tested by their bounding boxes, not their shapes.
+	 * @param queries The spheres to test.
+	 * @param results The objects found for each sphere, maxResults for each query.
+	 * @param resultCounts The number of objects written for each query.
+	 * @param maxResults The most objects kept for a query, the first found are kept.
+	 * @param count The number of queries.
+	 */
+	void OverlapSphere(const SphereQuery *queries, CollisionObject **results, uint32_t *resultCounts, uint32_t maxResults, std::size_t count) const;
+
 	const Vector3f &GetGravity() const { return gravity; }
 	void SetGravity(const Vector3f &gravity);
 
 	float GetAirDensity() const { return airDensity; }
 	void SetAirDensity(float airDensity);
 
+	const Time &GetFixedDelta() const { return fixedDelta; }
+	void SetFixedDelta(const Time &fixedDelta) { this->fixedDelta = fixedDelta; }
+
+	uint32_t GetMaxSubSteps() const { return maxSubSteps; }
+	void SetMaxSubSteps(uint32_t maxSubSteps) { this->maxSubSteps = maxSubSteps; }
+
+	/**
+	 * Gets how far the frame is between the last step and the next, for drawing bodies between their last two steps.
+	 * @return The progression, from 0 to 1.
+	 */
+	float GetInterpolation() const { return static_cast<float>(accumulator / fixedDelta); }
+
+	/**
+	 * Gets the number of steps taken, bodies that were not moved by the last step are drawn where they are.
+	 * @return The number of steps.
+	 */
+	uint64_t GetStepCount() const { return stepCount; }
+
+	/**
+	 * Gets the number of steps taken in the last update.
+	 * @return The number of steps.
+	 */
+	uint32_t GetSubSteps() const { return subSteps; }
+
+	/**
+	 * Gets the time that was dropped since the world was created, because more than the max sub steps were due.
+	 * @return The time dropped.
+	 */
+	const Time &GetDroppedTime() const { return droppedTime; }
+
 	btBroadphaseInterface *GetBroadphase() { return broadphase.get(); }
 
 	btDiscreteDynamicsWorld *GetDynamicsWorld() { return dynamicsWorld.get(); }
 
+	/**
+	 * Gets the number of threads that step the world.
+	 * @return The number of threads, 0 if the world is stepped on the calling thread only.
+	 */
+	uint32_t GetThreadCount() const { return threadCount; }
+
+	/**
+	 * Gets the most threads a multithreaded world can be stepped with.
+	 * @return The most threads, including the calling thread.
+	 */
+	static uint32_t GetMaxThreadCount();
+
+	/**
+	 * Called before each step, with the time the step simulates.
+	 * @return The delegate.
+	 */
+	Delegate<void(Time)> &OnFixedUpdate() { return onFixedUpdate; }
+
 private:
 	void CheckForCollisionEvents();
 
@@ -64,9 +261,23 @@ private:
 	std::unique_ptr<btCollisionDispatcher> dispatcher;
 	std::unique_ptr<btConstraintSolver> solver;
 	std::unique_ptr<btDiscreteDynamicsWorld> dynamicsWorld;
-	CollisionPairs pairsLastUpdate;
+	/// Pairs in contact this step and last step, and the pairs that started and ended contact this step.
+	ContactPairTable<btCollisionObject> contactPairs;
+	std::vector<CollisionPair> startedPairs;
+	std::vector<CollisionPair> endedPairs;
 
+	uint32_t threadCount;
 	Vector3f gravity;
 	float airDensity;
+
+	Time fixedDelta = DefaultFixedDelta;
+	uint32_t maxSubSteps = DefaultMaxSubSteps;
+	/// Time gathered towards the next step.
+	Time accumulator;
+	uint64_t stepCount = 0;
+	uint32_t subSteps = 0;
+	Time droppedTime;
+
+	Delegate<void(Time)> onFixedUpdate;
 };
 }
@@ -1,5 +1,6 @@
 #include "SceneStructure.hpp"
 
+#include "Maths/Transform.hpp"
 #include "Physics/Rigidbody.hpp"
 
 namespace acid {
@@ -93,9 +94,22 @@ std::vector<Entity *> SceneStructure::QueryFrustum(const Frustum &range) {
 	return entities;
 }
 
-/*std::vector<Entity *> SceneStructure::QuerySphere(const Vector3 &centre, const Vector3 &radius) {
-	return {};
-}*/
+std::vector<Entity *> SceneStructure::QuerySphere(const Vector3f &centre, float radius) {
+	std::vector<Entity *> entities;
+
+	for (const auto &object : objects) {
+		if (object->IsRemoved())
+			continue;
+
+		auto transform = object->GetComponent<Transform>();
+
+		if (!transform || transform->GetPosition().Distance(centre) <= radius) {
+			entities.emplace_back(object.get());
+		}
+	}
+
+	return entities;
+}
 
 /*std::vector<Entity *> SceneStructure::QueryCube(const Vector3 &min, const Vector3 &max) {
 	return {};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Maths/Vector3.hpp"
 #include "Physics/Rigidbody.hpp"
 #include "Entity.hpp"
 
@@ -80,7 +81,14 @@ public:
 	 */
 	std::vector<Entity *> QueryFrustum(const Frustum &range);
 
-	//std::vector<Entity *> QuerySphere(const Vector3 &centre, const Vector3 &radius);
+	/**
+	 * Gets a set of all objects in a spatial objects contained in a sphere.
+	 * Objects without a transform have no position, and are always contained.
+	 * @param centre The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 * @return The list of all object in range.
+	 */
+	std::vector<Entity *> QuerySphere(const Vector3f &centre, float radius);
 
 	//std::vector<Entity *> QueryCube(const Vector3 &min, const Vector3 &max);
 
@@ -1,135 +1,101 @@
 #include "ShadowBox.hpp"
 
-#include "Devices/Window.hpp"
-#include "Graphics/Graphics.hpp"
-#include "Maths/Maths.hpp"
+#include <array>
 
 namespace acid {
-ShadowBox::ShadowBox() {
-	// Creates the offset for part of the conversion to shadow map space.
-	offset = offset.Translate(Vector3f(0.5f));
-	offset = offset.Scale(Vector3f(0.5f));
-}
-
-void ShadowBox::Update(const Camera &camera, const Vector3f &lightDirection, float shadowOffset, float shadowDistance) {
-	this->lightDirection = lightDirection;
-	this->shadowOffset = shadowOffset;
-	this->shadowDistance = shadowDistance;
-
-	UpdateShadowBox(camera);
-	UpdateOrthoProjectionMatrix();
-	UpdateCenter();
-	UpdateLightViewMatrix();
-	UpdateViewShadowMatrix();
-}
-
-bool ShadowBox::IsInBox(const Vector3f &position, float radius) const {
-	auto entityPos = lightViewMatrix.Transform(Vector4f(position));
-
-	Vector3f closestPoint;
-	closestPoint.x = std::clamp(entityPos.x, minExtents.x, maxExtents.x);
-	closestPoint.y = std::clamp(entityPos.y, minExtents.y, maxExtents.y);
-	closestPoint.z = std::clamp(entityPos.z, minExtents.z, maxExtents.z);
-
-	Vector3f centre(entityPos);
-	auto distance = centre - closestPoint;
-	auto distanceSquared = distance.LengthSquared();
-
-	return distanceSquared < radius * radius;
-}
-
-void ShadowBox::UpdateShadowBox(const Camera &camera) {
-	UpdateSizes(camera);
+/// Bounding sphere radii are rounded up to this step, so float error doesn't change the box size between frames.
+static const float RADIUS_STEP = 1.0f / 16.0f;
+
+void ShadowBox::Update(const Matrix4 &viewMatrix, float fieldOfView, float aspectRatio, float nearSplit, float farSplit, const Vector3f &lightDirection,
+	float shadowOffset, uint32_t resolution) {
+	this->nearSplit = nearSplit;
+	this->farSplit = farSplit;
+
+	// Finds the corners of the slice of the view frustum in world space.
+	auto inverseView = viewMatrix.Inverse();
+	auto tanY = std::tan(0.5f * fieldOfView);
+	auto tanX = tanY * aspectRatio;
+
+	std::array<Vector3f, 8> corners;
+	Vector3f centre;
+
+	for (uint32_t i = 0; i < 8; i++) {
+		auto distance = i < 4 ? nearSplit : farSplit;
+		auto x = (i & 1 ? 1.0f : -1.0f) * distance * tanX;
+		auto y = (i & 2 ? 1.0f : -1.0f) * distance * tanY;
+		corners[i] = Vector3f(inverseView.Transform(Vector4f(x, y, -distance, 1.0f)));
+		centre += corners[i] / 8.0f;
+	}
 
-	Matrix4 rotation;
-	rotation = rotation.Rotate(-camera.GetRotation().y, Vector3f::Up);
-	rotation = rotation.Rotate(-camera.GetRotation().x, Vector3f::Right);
+	// A sphere around the slice keeps the same size however the camera is turned.
+	auto radius = 0.0f;
 
-	Vector3f forwardVector(rotation.Transform(Vector4f(0.0f, 0.0f, -1.0f, 0.0f)));
+	for (const auto &corner : corners)
+		radius = std::max(radius, corner.Distance(centre));
 
-	auto toFar = forwardVector * shadowDistance;
-	auto toNear = forwardVector * camera.GetNearPlane();
-	auto centreNear = toNear + camera.GetPosition();
-	auto centreFar = toFar + camera.GetPosition();
+	radius = std::ceil(radius / RADIUS_STEP) * RADIUS_STEP;
 
-	auto points = CalculateFrustumVertices(rotation, forwardVector, centreNear, centreFar);
+	// The light view has no translation, so whole texels in light space stay on the same world positions.
+	auto up = std::abs(lightDirection.Normalize().y) > 0.99f ? Vector3f::Front : Vector3f::Up;
+	lightViewMatrix = Matrix4::LookAt(Vector3f(), lightDirection, up);
 
-	minExtents = Vector3f::Infinity;
-	maxExtents = -Vector3f::Infinity;
+	Vector3f lightCentre(lightViewMatrix.Transform(Vector4f(centre)));
+	texelSize = 0.0f;
 
-	for (const auto &point : points) {
-		Vector3f extent(point);
-		minExtents = minExtents.Min(extent);
-		maxExtents = minExtents.Max(extent);
+	if (resolution != 0) {
+		texelSize = 2.0f * radius / static_cast<float>(resolution);
+		lightCentre.x = std::floor(lightCentre.x / texelSize) * texelSize;
+		lightCentre.y = std::floor(lightCentre.y / texelSize) * texelSize;
 	}
 
+	// The light looks down -z, so the box is extended towards +z for casters between the light and the slice.
+	minExtents = lightCentre - Vector3f(radius);
+	maxExtents = lightCentre + Vector3f(radius);
 	maxExtents.z += shadowOffset;
-}
-
-void ShadowBox::UpdateSizes(const Camera &camera) {
-	farWidth = shadowDistance * std::tan(camera.GetFieldOfView());
-	nearWidth = camera.GetNearPlane() * std::tan(camera.GetFieldOfView());
-	farHeight = farWidth / Window::Get()->GetAspectRatio();
-	nearHeight = nearWidth / Window::Get()->GetAspectRatio();
-}
 
-std::array<Vector4f, 8> ShadowBox::CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar) const {
-	Vector3f upVector(rotation.Transform(Vector4f(0.0f, 1.0f, 0.0f, 0.0f)));
-	auto rightVector = forwardVector.Cross(upVector);
-	auto downVector = -upVector;
-	auto leftVector = -rightVector;
-
-	auto farTop = centreFar + (upVector * farHeight);
-	auto farBottom = centreFar + (downVector * farHeight);
-	auto nearTop = centreNear + (upVector * nearHeight);
-	auto nearBottom = centreNear + (downVector * nearHeight);
-
-	std::array<Vector4f, 8> points;
-	points[0] = CalculateLightSpaceFrustumCorner(farTop, rightVector, farWidth);
-	points[1] = CalculateLightSpaceFrustumCorner(farTop, leftVector, farWidth);
-	points[2] = CalculateLightSpaceFrustumCorner(farBottom, rightVector, farWidth);
-	points[3] = CalculateLightSpaceFrustumCorner(farBottom, leftVector, farWidth);
-	points[4] = CalculateLightSpaceFrustumCorner(nearTop, rightVector, nearWidth);
-	points[5] = CalculateLightSpaceFrustumCorner(nearTop, leftVector, nearWidth);
-	points[6] = CalculateLightSpaceFrustumCorner(nearBottom, rightVector, nearWidth);
-	points[7] = CalculateLightSpaceFrustumCorner(nearBottom, leftVector, nearWidth);
-	return points;
-}
-
-Vector4f ShadowBox::CalculateLightSpaceFrustumCorner(const Vector3f &startPoint, const Vector3f &direction, float width) const {
-	Vector4f point(startPoint + (direction * width));
-	point = lightViewMatrix.Transform(point);
-	return point;
-}
-
-void ShadowBox::UpdateOrthoProjectionMatrix() {
+	// Orthographic projection from the box to clip space, with depth from 0 at the light side to 1.
 	projectionMatrix = {};
 	projectionMatrix[0][0] = 2.0f / GetWidth();
 	projectionMatrix[1][1] = 2.0f / GetHeight();
-	projectionMatrix[2][2] = -2.0f / GetDepth();
-	projectionMatrix[3][3] = 1.0f;
+	projectionMatrix[2][2] = -1.0f / GetDepth();
+	projectionMatrix[3][0] = -(maxExtents.x + minExtents.x) / GetWidth();
+	projectionMatrix[3][1] = -(maxExtents.y + minExtents.y) / GetHeight();
+	projectionMatrix[3][2] = maxExtents.z / GetDepth();
+
+	UpdateViewShadowMatrix();
 }
 
-void ShadowBox::UpdateCenter() {
-	Vector4f centre((minExtents + maxExtents) / 2.0f);
-	auto invertedLight = lightViewMatrix.Inverse();
-	centre = {invertedLight.Transform(centre)};
+void ShadowBox::SetTile(const Vector2f &offset, float scale) {
+	tileOffset = offset;
+	tileScale = scale;
+	UpdateViewShadowMatrix();
 }
 
-void ShadowBox::UpdateLightViewMatrix() {
-	lightViewMatrix = {};
-	auto pitch = std::acos(Vector2f(lightDirection.x, lightDirection.z).Length());
-	lightViewMatrix = lightViewMatrix.Rotate(pitch, Vector3f::Right);
-	auto yaw = std::atan(lightDirection.x / lightDirection.z);
-	if (lightDirection.z > 0.0f)
-		yaw -= Maths::PI<float>;
+bool ShadowBox::IsInBox(const Vector3f &position, float radius) const {
+	auto entityPos = lightViewMatrix.Transform(Vector4f(position));
+
+	Vector3f closestPoint;
+	closestPoint.x = std::clamp(entityPos.x, minExtents.x, maxExtents.x);
+	closestPoint.y = std::clamp(entityPos.y, minExtents.y, maxExtents.y);
+	closestPoint.z = std::clamp(entityPos.z, minExtents.z, maxExtents.z);
+
+	Vector3f centre(entityPos);
+	auto distance = centre - closestPoint;
+	auto distanceSquared = distance.LengthSquared();
 
-	lightViewMatrix = lightViewMatrix.Rotate(-yaw, Vector3f::Up);
-	lightViewMatrix = lightViewMatrix.Translate(centre);
+	return distanceSquared <= radius * radius;
 }
 
 void ShadowBox::UpdateViewShadowMatrix() {
 	projectionViewMatrix = projectionMatrix * lightViewMatrix;
-	shadowMapSpaceMatrix = offset * projectionViewMatrix;
+	frustum.Update(lightViewMatrix, projectionMatrix);
+
+	// Converts clip space x and y into coordinates of the tile in the shadow map.
+	Matrix4 toTile;
+	toTile[0][0] = 0.5f * tileScale;
+	toTile[1][1] = 0.5f * tileScale;
+	toTile[3][0] = tileOffset.x + 0.5f * tileScale;
+	toTile[3][1] = tileOffset.y + 0.5f * tileScale;
+	shadowMapSpaceMatrix = toTile * projectionViewMatrix;
 }
 }
@@ -1,32 +1,41 @@
 ﻿#pragma once
 
 #include "Maths/Matrix4.hpp"
+#include "Maths/Vector2.hpp"
 #include "Maths/Vector4.hpp"
-#include "Scenes/Camera.hpp"
+#include "Physics/Frustum.hpp"
 
 namespace acid {
 /**
  * @brief Represents the 3D area of the world in which engine.shadows will be cast (basically represents the orthographic projection area for the shadow render pass).
- * It can be updated each frame to optimize the area, making it as small as possible (to allow for optimal shadow map resolution) while not being too small to avoid objects not having shadows when they should.
+ * The box is fitted around a bounding sphere of a slice of the camera's view frustum, so its size doesn't change as the camera turns,
+ * and its position is snapped to whole shadow map texels so shadow edges don't shimmer as the camera moves.
  * This class also provides functionality to test whether an object is inside this shadow box. Everything inside the box will be rendered to the shadow map in the shadow render pass.
  */
 class ACID_EXPORT ShadowBox {
 public:
+	ShadowBox() = default;
+
 	/**
-	 * Creates a new shadow box and calculates some initial values relating to the camera's view frustum.
+	 * Updates the bounds of the shadow box around a slice of a camera's view frustum.
+	 * @param viewMatrix The camera's view matrix.
+	 * @param fieldOfView The camera's vertical field of view.
+	 * @param aspectRatio The camera's aspect ratio.
+	 * @param nearSplit The distance from the camera the slice starts at.
+	 * @param farSplit The distance from the camera the slice ends at.
+	 * @param lightDirection The lights direction.
+	 * @param shadowOffset How far the box is extended towards the light, so casters outside of the slice still shadow it.
+	 * @param resolution The texels on each side of the shadow map the box is drawn to, 0 to not snap the box to texels.
 	 */
-	ShadowBox();
+	void Update(const Matrix4 &viewMatrix, float fieldOfView, float aspectRatio, float nearSplit, float farSplit, const Vector3f &lightDirection,
+		float shadowOffset, uint32_t resolution);
 
 	/**
-	 * Updates the bounds of the shadow box based on the light direction and the camera's view frustum.
-	 * Will make sure that the box covers the smallest area possible while still ensuring that everything.
-	 * Objects inside the camera's view (and in range) will be shadowed.
-	 * @param camera The camera object to be used when calculating the shadow boxes size.
-	 * @param lightDirection The lights direction.
-	 * @param shadowOffset The shadows offset.
-	 * @param shadowDistance The shadows distance.
+	 * Sets the part of the shadow map the box is drawn to, for boxes that share one shadow map.
+	 * @param offset The top left of the tile, in shadow map coordinates.
+	 * @param scale The size of the tile, in shadow map coordinates.
 	 */
-	void Update(const Camera &camera, const Vector3f &lightDirection, float shadowOffset, float shadowDistance);
+	void SetTile(const Vector2f &offset, float scale);
 
 	/**
 	 * Tests if a bounding sphere intersects the shadow box. Can be used to decide which engine.entities should be rendered in the shadow render pass.
@@ -38,6 +47,12 @@ public:
 
 	const Matrix4 &GetProjectionViewMatrix() const { return projectionViewMatrix; }
 
+	/**
+	 * Gets the volume the shadow map is rendered from, casters outside of it are clipped when drawn.
+	 * @return The light frustum.
+	 */
+	const Frustum &GetFrustum() const { return frustum; }
+
 	/**
 	 * This biased projection-view matrix is used to convert fragments into "shadow map space" when rendering the main render pass.
 	 * @return The to-shadow-map-space matrix.
@@ -54,58 +69,32 @@ public:
 	float GetWidth() const { return maxExtents.x - minExtents.x; }
 	float GetHeight() const { return maxExtents.y - minExtents.y; }
 	float GetDepth() const { return maxExtents.z - minExtents.z; }
-
-private:
-	void UpdateShadowBox(const Camera &camera);
-
-	/**
-	 * Updates the widths and heights of the box panes.
-	 * @param camera The camera object.
-	 */
-	void UpdateSizes(const Camera &camera);
-
-	/**
-	 * Calculates the vertex of each corner of the view frustum in light space.
-	 * @param rotation The cameras rotation.
-	 * @param forwardVector The direction that the camera is aiming, and thus the direction of the frustum.
-	 * @param centreNear The centre point of the frustum's near plane.
-	 * @param centreFar The centre point of the frustum's far plane.
-	 * @return The vertices of the frustum in light space.
-	 */
-	std::array<Vector4f, 8> CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar) const;
+	float GetNearSplit() const { return nearSplit; }
+	float GetFarSplit() const { return farSplit; }
 
 	/**
-	 * Calculates one of the corner vertices of the view frustum in world space and converts it to light space.
-	 * @param startPoint The starting centre point on the view frustum.
-	 * @param direction The direction of the corner from the start point.
-	 * @param width The distance of the corner from the start point.
-	 * @return The relevant corner vertex of the view frustum in light space.
+	 * Gets the world space size of a shadow map texel.
+	 * @return The texel size, 0 if the box is not snapped to texels.
 	 */
-	Vector4f CalculateLightSpaceFrustumCorner(const Vector3f &startPoint, const Vector3f &direction, float width) const;
+	float GetTexelSize() const { return texelSize; }
 
-	void UpdateOrthoProjectionMatrix();
-
-	/**
-	 * Updates the centre of the shadow box (orthographic projection area).
-	 */
-	void UpdateCenter();
-	void UpdateLightViewMatrix();
+private:
 	void UpdateViewShadowMatrix();
 
-	Vector3f lightDirection;
-	float shadowOffset = 0.0f;
-	float shadowDistance = 0.0f;
+	float nearSplit = 0.0f;
+	float farSplit = 0.0f;
+	float texelSize = 0.0f;
 
 	Matrix4 projectionMatrix;
 	Matrix4 lightViewMatrix;
 	Matrix4 projectionViewMatrix;
 	Matrix4 shadowMapSpaceMatrix;
-	Matrix4 offset;
-	Vector3f centre;
+	Frustum frustum;
 
-	float farHeight = 0.0f, farWidth = 0.0f;
-	float nearHeight = 0.0f, nearWidth = 0.0f;
+	Vector2f tileOffset;
+	float tileScale = 1.0f;
 
+	/// The bounds of the box in light space.
 	Vector3f minExtents, maxExtents;
 };
 }
@@ -0,0 +1,95 @@
+#include "ShadowCascades.hpp"
+
+#include <cmath>
+
+namespace acid {
+ShadowCascades::ShadowCascades(uint32_t count, SplitScheme splitScheme, float splitLambda) :
+	count(std::max(count, 1u)),
+	splitScheme(splitScheme),
+	splitLambda(splitLambda),
+	boxes(this->count) {
+}
+
+std::vector<float> ShadowCascades::CalculateSplits(uint32_t count, float nearPlane, float farPlane, SplitScheme splitScheme, float splitLambda) {
+	std::vector<float> splits(count + 1);
+
+	for (uint32_t i = 0; i <= count; i++) {
+		auto fraction = static_cast<float>(i) / static_cast<float>(count);
+		auto uniform = nearPlane + (farPlane - nearPlane) * fraction;
+		auto logarithmic = nearPlane * std::pow(farPlane / nearPlane, fraction);
+
+		switch (splitScheme) {
+		case SplitScheme::Uniform:
+			splits[i] = uniform;
+			break;
+		case SplitScheme::Logarithmic:
+			splits[i] = logarithmic;
+			break;
+		case SplitScheme::Practical:
+			splits[i] = splitLambda * logarithmic + (1.0f - splitLambda) * uniform;
+			break;
+		}
+	}
+
+	// The ends are exact, whatever the scheme rounds to.
+	splits.front() = nearPlane;
+	splits.back() = farPlane;
+	return splits;
+}
+
+uint32_t ShadowCascades::GetGridSize(uint32_t count) {
+	uint32_t gridSize = 1;
+	while (gridSize * gridSize < count)
+		gridSize++;
+	return gridSize;
+}
+
+void ShadowCascades::Update(const Matrix4 &viewMatrix, float fieldOfView, float aspectRatio, float nearPlane, float shadowDistance,
+	const Vector3f &lightDirection, float shadowOffset, uint32_t shadowSize) {
+	auto splits = CalculateSplits(count, nearPlane, shadowDistance, splitScheme, splitLambda);
+	auto gridSize = GetGridSize(count);
+	auto tileScale = 1.0f / static_cast<float>(gridSize);
+
+	for (uint32_t i = 0; i < count; i++) {
+		boxes[i].Update(viewMatrix, fieldOfView, aspectRatio, splits[i], splits[i + 1], lightDirection, shadowOffset, shadowSize / gridSize);
+		boxes[i].SetTile(Vector2f(static_cast<float>(i % gridSize), static_cast<float>(i / gridSize)) * tileScale, tileScale);
+	}
+}
+
+void ShadowCascades::Cull(const std::vector<Vector4f> &spheres, std::vector<std::vector<uint32_t>> &visible, ThreadPool *threadPool) const {
+	visible.resize(boxes.size());
+
+	auto cullCascade = [&](std::size_t cascade) {
+		auto &indices = visible[cascade];
+		indices.clear();
+
+		for (std::size_t i = 0; i < spheres.size(); i++) {
+			if (boxes[cascade].IsInBox(Vector3f(spheres[i]), spheres[i].w))
+				indices.emplace_back(static_cast<uint32_t>(i));
+		}
+	};
+
+	if (!threadPool || boxes.size() == 1) {
+		for (std::size_t cascade = 0; cascade < boxes.size(); cascade++)
+			cullCascade(cascade);
+		return;
+	}
+
+	// The last cascade is culled on this thread while the others are on the pool.
+	std::vector<std::future<void>> cullings;
+	cullings.reserve(boxes.size() - 1);
+
+	for (std::size_t cascade = 0; cascade + 1 < boxes.size(); cascade++)
+		cullings.emplace_back(threadPool->Enqueue(cullCascade, cascade));
+
+	cullCascade(boxes.size() - 1);
+
+	for (auto &culling : cullings)
+		culling.get();
+}
+
+void ShadowCascades::SetCount(uint32_t count) {
+	this->count = std::max(count, 1u);
+	boxes.resize(this->count);
+}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+#include "Utils/ThreadPool.hpp"
+#include "ShadowBox.hpp"
+
+namespace acid {
+/**
+ * @brief Class that splits the shadow distance between cascades, each with its own acid::ShadowBox drawn to a tile of one shadow map.
+ * Near cascades cover less of the view, so they get more shadow map texels for each unit of the world than far cascades.
+ * Tiles are laid out in a square grid, cascade 0 is the top left tile.
+ */
+class ACID_EXPORT ShadowCascades {
+public:
+	enum class SplitScheme {
+		/// Cascades cover the same distance.
+		Uniform,
+		/// Each cascade covers the same ratio of distances, so texels cover about the same part of the screen.
+		Logarithmic,
+		/// A blend of logarithmic and uniform splits, by the split lambda.
+		Practical
+	};
+
+	/**
+	 * Creates a new set of cascades.
+	 * @param count The number of cascades.
+	 * @param splitScheme How the shadow distance is split between cascades.
+	 * @param splitLambda The weight of logarithmic over uniform splits in practical splits.
+	 */
+	explicit ShadowCascades(uint32_t count = 1, SplitScheme splitScheme = SplitScheme::Practical, float splitLambda = 0.5f);
+
+	/**
+	 * Calculates the distances cascades start and end at.
+	 * @param count The number of cascades.
+	 * @param nearPlane The distance the first cascade starts at.
+	 * @param farPlane The distance the last cascade ends at.
+	 * @param splitScheme How the distance is split.
+	 * @param splitLambda The weight of logarithmic over uniform splits in practical splits.
+	 * @return The count + 1 distances, each cascade is between a distance and the next.
+	 */
+	static std::vector<float> CalculateSplits(uint32_t count, float nearPlane, float farPlane, SplitScheme splitScheme, float splitLambda = 0.5f);
+
+	/**
+	 * Gets the tiles on each side of the shadow map for a number of cascades.
+	 * @param count The number of cascades.
+	 * @return The tiles on each side.
+	 */
+	static uint32_t GetGridSize(uint32_t count);
+
+	/**
+	 * Fits every cascade around its slice of a camera's view frustum.
+	 * @param viewMatrix The camera's view matrix.
+	 * @param fieldOfView The camera's vertical field of view.
+	 * @param aspectRatio The camera's aspect ratio.
+	 * @param nearPlane The camera's near plane.
+	 * @param shadowDistance The distance shadows are drawn to.
+	 * @param lightDirection The lights direction.
+	 * @param shadowOffset How far each box is extended towards the light.
+	 * @param shadowSize The texels on each side of the shadow map.
+	 */
+	void Update(const Matrix4 &viewMatrix, float fieldOfView, float aspectRatio, float nearPlane, float shadowDistance, const Vector3f &lightDirection,
+		float shadowOffset, uint32_t shadowSize);
+
+	/**
+	 * Finds the bounding spheres inside each cascade, cascades are culled on the thread pool when one is given.
+	 * @param spheres The bounding spheres in world space, with the radius in w.
+	 * @param visible Filled with the index of each sphere inside each cascade, in increasing order.
+	 * @param threadPool The thread pool to cull on.
+	 */
+	void Cull(const std::vector<Vector4f> &spheres, std::vector<std::vector<uint32_t>> &visible, ThreadPool *threadPool = nullptr) const;
+
+	uint32_t GetCount() const { return count; }
+	void SetCount(uint32_t count);
+
+	SplitScheme GetSplitScheme() const { return splitScheme; }
+	void SetSplitScheme(SplitScheme splitScheme) { this->splitScheme = splitScheme; }
+
+	float GetSplitLambda() const { return splitLambda; }
+	void SetSplitLambda(float splitLambda) { this->splitLambda = splitLambda; }
+
+	const std::vector<ShadowBox> &GetBoxes() const { return boxes; }
+
+private:
+	uint32_t count;
+	SplitScheme splitScheme;
+	float splitLambda;
+
+	std::vector<ShadowBox> boxes;
+};
+}
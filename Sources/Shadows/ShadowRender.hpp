@@ -1,29 +1,31 @@
 #pragma once
 
 #include "Scenes/Component.hpp"
-#include "Graphics/Descriptors/DescriptorsHandler.hpp"
-#include "Graphics/Buffers/PushHandler.hpp"
-#include "Graphics/Pipelines/PipelineGraphics.hpp"
 
 namespace acid {
 /**
  * @brief Component that is used to render a entity as a shadow.
+ * Static casters are drawn into the static shadow layer by acid::ShadowsSubrender, which is only redrawn when one of them moves.
  */
 class ACID_EXPORT ShadowRender : public Component::Registrar<ShadowRender> {
 	inline static const bool Registered = Register("shadowRender");
 public:
-	ShadowRender();
+	/**
+	 * Creates a new shadow render component.
+	 * @param isStatic If the entity is not expected to move.
+	 */
+	explicit ShadowRender(bool isStatic = false);
 
 	void Start() override;
 	void Update() override;
 
-	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline);
+	bool IsStatic() const { return isStatic; }
+	void SetStatic(bool isStatic) { this->isStatic = isStatic; }
 
 	friend const Node &operator>>(const Node &node, ShadowRender &shadowRender);
 	friend Node &operator<<(Node &node, const ShadowRender &shadowRender);
 
 private:
-	DescriptorsHandler descriptorSet;
-	PushHandler pushObject;
+	bool isStatic;
 };
 }
@@ -1,5 +1,6 @@
 #include "Shadows.hpp"
 
+#include "Devices/Window.hpp"
 #include "Scenes/Scenes.hpp"
 
 namespace acid {
@@ -11,11 +12,14 @@ Shadows::Shadows() :
 	shadowDarkness(0.6f),
 	shadowTransition(11.0f),
 	shadowBoxOffset(9.0f),
-	shadowBoxDistance(70.0f) {
+	shadowBoxDistance(70.0f),
+	cascades(4),
+	threadPool(3) {
 }
 
 void Shadows::Update() {
 	if (auto camera = Scenes::Get()->GetCamera())
-		shadowBox.Update(*camera, lightDirection, shadowBoxOffset, shadowBoxDistance);
+		cascades.Update(camera->GetViewMatrix(), camera->GetFieldOfView(), Window::Get()->GetAspectRatio(), camera->GetNearPlane(), shadowBoxDistance,
+			lightDirection, shadowBoxOffset, shadowSize);
 }
 }
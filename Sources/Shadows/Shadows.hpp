@@ -2,11 +2,11 @@
 
 #include "Engine/Engine.hpp"
 #include "Maths/Vector3.hpp"
-#include "ShadowBox.hpp"
+#include "ShadowCascades.hpp"
 
 namespace acid {
 /**
- * @brief Module used for managing a shadow map.
+ * @brief Module used for managing a shadow map, split into cascades that each cover a slice of the camera view.
  */
 class ACID_EXPORT Shadows : public Module::Registrar<Shadows> {
 	inline static const bool Registered = Register(Stage::Normal);
@@ -39,11 +39,28 @@ public:
 	float GetShadowBoxDistance() const { return shadowBoxDistance; }
 	void SetShadowBoxDistance(float shadowBoxDistance) { this->shadowBoxDistance = shadowBoxDistance; }
 
+	uint32_t GetCascadeCount() const { return cascades.GetCount(); }
+	void SetCascadeCount(uint32_t cascadeCount) { cascades.SetCount(cascadeCount); }
+
+	ShadowCascades::SplitScheme GetSplitScheme() const { return cascades.GetSplitScheme(); }
+	void SetSplitScheme(ShadowCascades::SplitScheme splitScheme) { cascades.SetSplitScheme(splitScheme); }
+
+	float GetSplitLambda() const { return cascades.GetSplitLambda(); }
+	void SetSplitLambda(float splitLambda) { cascades.SetSplitLambda(splitLambda); }
+
+	const ShadowCascades &GetCascades() const { return cascades; }
+
 	/**
-	 * Get the shadow box, so that it can be used by other class to test if engine.entities are inside the box.
+	 * Get the shadow box of the nearest cascade, so that it can be used by other class to test if engine.entities are inside the box.
 	 * @return The shadow box.
 	 */
-	const ShadowBox &GetShadowBox() const { return shadowBox; }
+	const ShadowBox &GetShadowBox() const { return cascades.GetBoxes().front(); }
+
+	/**
+	 * Gets the thread pool casters are culled against each cascade on.
+	 * @return The culling thread pool.
+	 */
+	ThreadPool &GetThreadPool() { return threadPool; }
 
 private:
 	Vector3f lightDirection;
@@ -57,6 +74,7 @@ private:
 	float shadowBoxOffset;
 	float shadowBoxDistance;
 
-	ShadowBox shadowBox;
+	ShadowCascades cascades;
+	ThreadPool threadPool;
 };
 }
@@ -1,25 +1,255 @@
 #include "ShadowsSubrender.hpp"
 
+#include "Graphics/Graphics.hpp"
+#include "Maths/Transform.hpp"
+#include "Meshes/Mesh.hpp"
 #include "Models/Vertex3d.hpp"
+#include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
 #include "ShadowRender.hpp"
 #include "Shadows.hpp"
 
 namespace acid {
-ShadowsSubrender::ShadowsSubrender(const Pipeline::Stage &pipelineStage) :
+static const uint32_t MIN_INSTANCES = 64;
+
+ShadowsSubrender::ShadowsSubrender(const Pipeline::Stage &pipelineStage, Layer layer, std::string staticAttachment) :
 	Subrender(pipelineStage),
-	pipeline(pipelineStage, {"Shaders/Shadows/Shadow.vert", "Shaders/Shadows/Shadow.frag"}, {Vertex3d::GetVertexInput()}, {},
+	layer(layer),
+	staticAttachment(std::move(staticAttachment)),
+	pipeline(pipelineStage, {"Shaders/Shadows/Shadow.vert", "Shaders/Shadows/Shadow.frag"}, {Vertex3d::GetVertexInput(0), Instance::GetVertexInput(1)}, {},
 		PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT) {
+	if (layer == Layer::Dynamic) {
+		layerPipeline = std::make_unique<PipelineGraphics>(pipelineStage, std::vector<std::filesystem::path>{"Shaders/Post/Default.vert", "Shaders/Shadows/Layer.frag"},
+			std::vector<Shader::VertexInput>{}, std::vector<Shader::Define>{}, PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::None);
+	}
 }
 
 void ShadowsSubrender::Render(const CommandBuffer &commandBuffer) {
-	auto camera = Scenes::Get()->GetCamera();
+	auto shadows = Shadows::Get();
+	FindCasters();
+	shadows->GetCascades().Cull(casterBounds, cascadeCasters, &shadows->GetThreadPool());
 
-	pipeline.BindPipeline(commandBuffer);
+	culledCount = 0;
+	drawnCount = 0;
+	cachedCount = 0;
+	drawCallCount = 0;
+
+	for (const auto &visible : cascadeCasters)
+		culledCount += static_cast<uint32_t>(casters.size() - visible.size());
+
+	switch (layer) {
+	case Layer::All:
+		CmdRenderCasters(commandBuffer);
+		break;
+	case Layer::Static: {
+		// The layer is kept while the same casters would be drawn to the same image from the same cascades.
+		auto attachment = Graphics::Get()->GetAttachment(staticAttachment);
+		std::vector<Matrix4> projectionViews;
+		projectionViews.reserve(shadows->GetCascades().GetBoxes().size());
+
+		for (const auto &shadowBox : shadows->GetCascades().GetBoxes())
+			projectionViews.emplace_back(shadowBox.GetProjectionViewMatrix());
+
+		if (attachment == drawnAttachment && projectionViews == drawnProjectionViews && casters == drawnCasters) {
+			cachedCount = static_cast<uint32_t>(casters.size());
+			break;
+		}
+
+		ClearStaticLayer(commandBuffer);
+
+		if (CmdRenderCasters(commandBuffer)) {
+			drawnCasters = casters;
+			drawnProjectionViews = std::move(projectionViews);
+			drawnAttachment = attachment;
+		}
+
+		break;
+	}
+	case Layer::Dynamic:
+		CmdRenderStaticLayer(commandBuffer);
+		CmdRenderCasters(commandBuffer);
+		break;
+	}
+}
+
+void ShadowsSubrender::FindCasters() {
+	casters.clear();
+	casterBounds.clear();
 
 	auto sceneShadowRenders = Scenes::Get()->GetStructure()->QueryComponents<ShadowRender>();
 
-	for (const auto &shadowRender : sceneShadowRenders)
-		shadowRender->CmdRender(commandBuffer, pipeline);
+	for (const auto &shadowRender : sceneShadowRenders) {
+		if ((layer == Layer::Static && !shadowRender->IsStatic()) || (layer == Layer::Dynamic && shadowRender->IsStatic()))
+			continue;
+
+		auto entity = shadowRender->GetEntity();
+		auto transform = entity->GetComponent<Transform>();
+		auto mesh = entity->GetComponent<Mesh>();
+
+		if (!transform || !mesh || !mesh->GetModel())
+			continue;
+
+		casters.emplace_back(Caster{mesh->GetModel(), transform->GetWorldMatrix()});
+	}
+
+	std::stable_sort(casters.begin(), casters.end(), [](const Caster &a, const Caster &b) {
+		return a.model < b.model;
+	});
+
+	// Casters outside a cascade would be clipped when drawn to it, so they are tested with a sphere around their model bounds.
+	casterBounds.reserve(casters.size());
+
+	for (const auto &caster : casters) {
+		const auto &modelMatrix = caster.modelMatrix;
+		Vector3f centre(modelMatrix.Transform(Vector4f((caster.model->GetMinExtents() + caster.model->GetMaxExtents()) / 2.0f)));
+		auto scale = std::max({Vector3f(modelMatrix[0]).Length(), Vector3f(modelMatrix[1]).Length(), Vector3f(modelMatrix[2]).Length()});
+		auto radius = 0.5f * (caster.model->GetMaxExtents() - caster.model->GetMinExtents()).Length() * scale;
+		casterBounds.emplace_back(centre, radius);
+	}
+}
+
+void ShadowsSubrender::ClearStaticLayer(const CommandBuffer &commandBuffer) const {
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto attachment = renderStage->GetAttachment(staticAttachment);
+
+	if (!attachment) {
+		Log::Error("Static shadow layer attachment not found: ", staticAttachment, '\n');
+		return;
+	}
+
+	auto colourAttachment = renderStage->GetColourAttachmentIndex(GetStage().second, attachment->GetBinding());
+
+	if (!colourAttachment) {
+		Log::Error("Static shadow layer attachment is not written by its subpass: ", staticAttachment, '\n');
+		return;
+	}
+
+	const auto &clearColour = attachment->GetClearColour();
+	const auto &renderArea = renderStage->GetRenderArea();
+
+	// The attachment keeps the last frame, and is only cleared when static casters are drawn again.
+	VkClearAttachment clearAttachment = {};
+	clearAttachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	clearAttachment.colorAttachment = *colourAttachment;
+	clearAttachment.clearValue.color = {{clearColour.r, clearColour.g, clearColour.b, clearColour.a}};
+
+	VkClearRect clearRect = {};
+	clearRect.rect.offset = {renderArea.GetOffset().x, renderArea.GetOffset().y};
+	clearRect.rect.extent = {renderArea.GetExtent().x, renderArea.GetExtent().y};
+	clearRect.baseArrayLayer = 0;
+	clearRect.layerCount = 1;
+	vkCmdClearAttachments(commandBuffer, 1, &clearAttachment, 1, &clearRect);
+}
+
+void ShadowsSubrender::CmdRenderStaticLayer(const CommandBuffer &commandBuffer) {
+	// Updates descriptors.
+	layerDescriptorSet.Push("samplerStatic", Graphics::Get()->GetAttachment(staticAttachment));
+
+	if (!layerDescriptorSet.Update(*layerPipeline))
+		return;
+
+	// Draws the layer over the whole shadow map.
+	layerPipeline->BindPipeline(commandBuffer);
+	layerDescriptorSet.BindDescriptor(commandBuffer, *layerPipeline);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+bool ShadowsSubrender::CmdRenderCasters(const CommandBuffer &commandBuffer) {
+	std::size_t instanceCount = 0;
+	for (const auto &visible : cascadeCasters)
+		instanceCount += visible.size();
+
+	// With every caster culled nothing is drawn, which is still a complete draw.
+	if (instanceCount == 0)
+		return true;
+
+	if (instanceCount > maxInstances) {
+		// The buffer is grown in doubling steps, the last frame may still be reading the old one.
+		if (instanceBuffer)
+			Graphics::CheckVk(vkDeviceWaitIdle(*Graphics::Get()->GetLogicalDevice()));
+
+		maxInstances = std::max(MIN_INSTANCES, maxInstances);
+		while (maxInstances < instanceCount)
+			maxInstances *= 2;
+
+		instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Instance) * maxInstances);
+	}
+
+	// Every cascade writes its casters after the cascade before it.
+	auto instances = static_cast<Instance *>(instanceBuffer->GetMapped());
+	std::size_t instance = 0;
+
+	for (const auto &visible : cascadeCasters) {
+		for (auto index : visible)
+			instances[instance++].modelMatrix = casters[index].modelMatrix;
+	}
+
+	// Updates descriptors.
+	descriptorSet.Push("PushScene", pushScene);
+
+	if (!descriptorSet.Update(pipeline))
+		return false;
+
+	pipeline.BindPipeline(commandBuffer);
+	descriptorSet.BindDescriptor(commandBuffer, pipeline);
+
+	const auto &renderArea = Graphics::Get()->GetRenderStage(GetStage().first)->GetRenderArea();
+	const auto &shadowBoxes = Shadows::Get()->GetCascades().GetBoxes();
+	auto gridSize = ShadowCascades::GetGridSize(static_cast<uint32_t>(shadowBoxes.size()));
+	Vector2ui tileExtent(renderArea.GetExtent().x / gridSize, renderArea.GetExtent().y / gridSize);
+	VkBuffer instanceBuffers[1] = {instanceBuffer->GetBuffer()};
+	std::size_t firstInstance = 0;
+
+	for (std::size_t cascade = 0; cascade < cascadeCasters.size(); cascade++) {
+		const auto &visible = cascadeCasters[cascade];
+
+		// Each cascade draws to its own tile of the shadow map.
+		Vector2i tileOffset(renderArea.GetOffset().x + static_cast<int32_t>(cascade % gridSize * tileExtent.x),
+			renderArea.GetOffset().y + static_cast<int32_t>(cascade / gridSize * tileExtent.y));
+		CmdSetViewport(commandBuffer, tileOffset, tileExtent);
+
+		pushScene.Push("projectionView", shadowBoxes[cascade].GetProjectionViewMatrix());
+		pushScene.BindPush(commandBuffer, pipeline);
+
+		// Draws each run of casters with the same model as instances.
+		for (std::size_t first = 0; first < visible.size();) {
+			auto model = casters[visible[first]].model;
+			auto last = first + 1;
+			while (last < visible.size() && casters[visible[last]].model == model)
+				last++;
+
+			VkDeviceSize offsets[1] = {(firstInstance + first) * sizeof(Instance)};
+			vkCmdBindVertexBuffers(commandBuffer, 1, 1, instanceBuffers, offsets);
+
+			if (model->CmdRender(commandBuffer, static_cast<uint32_t>(last - first))) {
+				drawnCount += static_cast<uint32_t>(last - first);
+				drawCallCount++;
+			}
+
+			first = last;
+		}
+
+		firstInstance += visible.size();
+	}
+
+	// Later subrenders draw over the whole shadow map.
+	CmdSetViewport(commandBuffer, renderArea.GetOffset(), renderArea.GetExtent());
+	return true;
+}
+
+void ShadowsSubrender::CmdSetViewport(const CommandBuffer &commandBuffer, const Vector2i &offset, const Vector2ui &extent) {
+	VkViewport viewport = {};
+	viewport.x = static_cast<float>(offset.x);
+	viewport.y = static_cast<float>(offset.y);
+	viewport.width = static_cast<float>(extent.x);
+	viewport.height = static_cast<float>(extent.y);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.offset = {offset.x, offset.y};
+	scissor.extent = {extent.x, extent.y};
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
 }
@@ -1,16 +1,142 @@
 #pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/InstanceBuffer.hpp"
+#include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Maths/Matrix4.hpp"
+#include "Maths/Vector2.hpp"
+#include "Maths/Vector4.hpp"
 
 namespace acid {
+class Model;
+
+/**
+ * @brief Subrender that draws shadow casters into the tile of each shadow cascade they are inside, with one instanced draw for each model in each cascade.
+ * Casters are culled against every cascade on the shadows thread pool, and the instances of all cascades are written to one buffer.
+ * Static casters can be kept in a persistent attachment that is only redrawn when one of them moves or the shadow box changes,
+ * a subrender of {@link Layer#Static} draws into it and a subrender of {@link Layer#Dynamic} in a later subpass copies it and draws the rest.
+ * The static attachment must be created as persistent, or the renderpass clears it every frame.
+ */
 class ACID_EXPORT ShadowsSubrender : public Subrender {
 public:
-	explicit ShadowsSubrender(const Pipeline::Stage &pipelineStage);
+	enum class Layer {
+		/// Every caster, each frame.
+		All,
+		/// Static casters, into a persistent attachment when they or a cascade changed.
+		Static,
+		/// The static layer, then casters that are not static.
+		Dynamic
+	};
+
+	class Instance {
+	public:
+		static Shader::VertexInput GetVertexInput(uint32_t baseBinding = 0) {
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
+				{baseBinding, sizeof(Instance), VK_VERTEX_INPUT_RATE_INSTANCE}
+			};
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				{0, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, modelMatrix) + offsetof(Matrix4, rows[0])},
+				{1, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, modelMatrix) + offsetof(Matrix4, rows[1])},
+				{2, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, modelMatrix) + offsetof(Matrix4, rows[2])},
+				{3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, modelMatrix) + offsetof(Matrix4, rows[3])}
+			};
+			return {bindingDescriptions, attributeDescriptions};
+		}
+
+		Matrix4 modelMatrix;
+	};
+
+	/**
+	 * Creates a new shadows subrender.
+	 * @param pipelineStage The pipelines graphics stage.
+	 * @param layer The casters this subrender draws.
+	 * @param staticAttachment The persistent attachment static casters are kept in, used by the static and dynamic layers.
+	 */
+	explicit ShadowsSubrender(const Pipeline::Stage &pipelineStage, Layer layer = Layer::All, std::string staticAttachment = "shadowsStatic");
 
 	void Render(const CommandBuffer &commandBuffer) override;
 
+	Layer GetLayer() const { return layer; }
+
+	/**
+	 * Gets the casters outside of each cascade last frame, summed over cascades.
+	 * @return The culled caster count.
+	 */
+	uint32_t GetCulledCount() const { return culledCount; }
+
+	/**
+	 * Gets the casters drawn last frame, summed over cascades.
+	 * @return The drawn caster count.
+	 */
+	uint32_t GetDrawnCount() const { return drawnCount; }
+
+	/**
+	 * Gets the static casters kept in the static layer from an earlier frame, instead of being drawn last frame.
+	 * @return The cached caster count.
+	 */
+	uint32_t GetCachedCount() const { return cachedCount; }
+
+	/**
+	 * Gets the instanced draws recorded last frame.
+	 * @return The draw call count.
+	 */
+	uint32_t GetDrawCallCount() const { return drawCallCount; }
+
 private:
+	class Caster {
+	public:
+		bool operator==(const Caster &rhs) const {
+			return model == rhs.model && modelMatrix == rhs.modelMatrix;
+		}
+
+		const Model *model;
+		Matrix4 modelMatrix;
+	};
+
+	/**
+	 * Finds the casters of this layer and their bounding spheres, sorted so casters of the same model are next to each other.
+	 */
+	void FindCasters();
+	void ClearStaticLayer(const CommandBuffer &commandBuffer) const;
+	void CmdRenderStaticLayer(const CommandBuffer &commandBuffer);
+
+	/**
+	 * Draws the casters inside each cascade this frame into the tile of that cascade.
+	 * @param commandBuffer The command buffer to record into.
+	 * @return If the casters were drawn, which is true when every caster is culled.
+	 */
+	bool CmdRenderCasters(const CommandBuffer &commandBuffer);
+	static void CmdSetViewport(const CommandBuffer &commandBuffer, const Vector2i &offset, const Vector2ui &extent);
+
+	Layer layer;
+	std::string staticAttachment;
+
 	PipelineGraphics pipeline;
+	DescriptorsHandler descriptorSet;
+	PushHandler pushScene;
+	std::unique_ptr<InstanceBuffer> instanceBuffer;
+	uint32_t maxInstances = 0;
+
+	/// Copies the static layer in the dynamic layer.
+	std::unique_ptr<PipelineGraphics> layerPipeline;
+	DescriptorsHandler layerDescriptorSet;
+
+	std::vector<Caster> casters;
+	/// The bounding sphere of each caster, with the radius in w.
+	std::vector<Vector4f> casterBounds;
+	/// The index of each caster inside each cascade.
+	std::vector<std::vector<uint32_t>> cascadeCasters;
+
+	/// What the static layer was last drawn with, it is kept while these stay the same.
+	std::vector<Caster> drawnCasters;
+	std::vector<Matrix4> drawnProjectionViews;
+	const Descriptor *drawnAttachment = nullptr;
+
+	uint32_t culledCount = 0;
+	uint32_t drawnCount = 0;
+	uint32_t cachedCount = 0;
+	uint32_t drawCallCount = 0;
 };
 }
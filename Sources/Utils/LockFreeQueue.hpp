@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "NonCopyable.hpp"
+
+namespace acid {
+/**
+ * @brief A constant-sized queue for one producer thread and one consumer thread, that never locks.
+ * The producer only writes the head and the consumer only writes the tail, each is on its own cache line
+ * so the two threads don't contend over the same memory.
+ * @tparam T The type to hold, must be default constructible and move assignable.
+ */
+template<typename T>
+class LockFreeQueue : NonCopyable {
+public:
+	explicit LockFreeQueue(std::size_t capacity) :
+		data(capacity + 1) {
+		if (capacity == 0)
+			throw std::runtime_error("Capacity must be non-zero");
+	}
+
+	/**
+	 * Gets the number of elements in the queue, only exact when called from the producer or consumer while the other is idle.
+	 * @return The number of elements.
+	 */
+	std::size_t size() const {
+		auto h = head.load(std::memory_order_acquire);
+		auto t = tail.load(std::memory_order_acquire);
+		return h >= t ? h - t : h + data.size() - t;
+	}
+	std::size_t capacity() const { return data.size() - 1; }
+	bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+	bool full() const { return Next(head.load(std::memory_order_acquire)) == tail.load(std::memory_order_acquire); }
+
+	/**
+	 * Adds an element to the queue, only called from the producer thread.
+	 * @param value The element to move into the queue.
+	 * @return If the element was added, false if the queue is full.
+	 */
+	bool push(T &&value) {
+		auto h = head.load(std::memory_order_relaxed);
+		auto next = Next(h);
+
+		if (next == tail.load(std::memory_order_acquire))
+			return false;
+
+		data[h] = std::move(value);
+		head.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Removes the oldest element from the queue, only called from the consumer thread.
+	 * @param value The element to move out of the queue.
+	 * @return If an element was removed, false if the queue is empty.
+	 */
+	bool pop(T &value) {
+		auto t = tail.load(std::memory_order_relaxed);
+
+		if (t == head.load(std::memory_order_acquire))
+			return false;
+
+		value = std::move(data[t]);
+		tail.store(Next(t), std::memory_order_release);
+		return true;
+	}
+
+private:
+	std::size_t Next(std::size_t index) const { return index + 1 == data.size() ? 0 : index + 1; }
+
+	/// One slot is always left empty, so a full queue can be told apart from an empty one.
+	std::vector<T> data;
+	alignas(64) std::atomic<std::size_t> head = 0;
+	alignas(64) std::atomic<std::size_t> tail = 0;
+};
+}
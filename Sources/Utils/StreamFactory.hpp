@@ -48,11 +48,11 @@ public:
 	class Registrar : public Base {
 	public:
 		TypeId GetTypeId() const override { return TypeInfo<Base>::template GetTypeId<T>(); }
-		std::string GetTypeName() const override { return name; }
+		std::string GetTypeName() const override { return Name(); }
 
 	protected:
 		static bool Register(const std::string &name) {
-			Registrar::name = name;
+			Name() = name;
 			StreamFactory::Registry()[name] = [](Args... args) -> TCreateReturn {
 				return std::make_unique<T>(std::forward<Args>(args)...);
 			};
@@ -64,11 +64,19 @@ public:
 		}
 		
 		Node &Write(Node &node) const override {
-			node["type"].Set(name);
+			node["type"].Set(Name());
 			return node << *dynamic_cast<const T *>(this);
 		}
 
-		inline static std::string name;
+		/**
+		 * Gets the registered name, held in a function static so it is constructed before the registration that sets it,
+		 * registrations run during static initialization in an order that isn't specified.
+		 * @return The registered name.
+		 */
+		static std::string &Name() {
+			static std::string name;
+			return name;
+		}
 	};
 
 	friend const Node &operator>>(const Node &node, std::unique_ptr<Base> &object) {
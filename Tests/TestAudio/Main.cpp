@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <Audio/SoundDecoder.hpp>
+#include <Audio/SoundStream.hpp>
+#include <Engine/Log.hpp>
+#include <Maths/Time.hpp>
+
+using namespace acid;
+
+/**
+ * Creates a stereo 16 bit wave file in memory containing a sine sweep.
+ */
+static std::string CreateWave(uint32_t sampleRate, float duration) {
+	auto frames = static_cast<uint32_t>(sampleRate * duration);
+	uint32_t channels = 2;
+	uint32_t dataLength = frames * channels * sizeof(int16_t);
+
+	std::string wave;
+	auto write = [&wave](uint32_t value, uint32_t length) {
+		for (uint32_t i = 0; i < length; i++)
+			wave.push_back(static_cast<char>(value >> (8 * i)));
+	};
+
+	wave += "RIFF";
+	write(36 + dataLength, 4);
+	wave += "WAVEfmt ";
+	write(16, 4);
+	write(1, 2);
+	write(channels, 2);
+	write(sampleRate, 4);
+	write(sampleRate * channels * sizeof(int16_t), 4);
+	write(channels * sizeof(int16_t), 2);
+	write(16, 2);
+	wave += "data";
+	write(dataLength, 4);
+
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		auto t = static_cast<float>(frame) / sampleRate;
+		auto sample = static_cast<int16_t>(8000.0f * std::sin(2.0f * 3.14159265f * (220.0f + 220.0f * t / duration) * t));
+		write(static_cast<uint16_t>(sample), 2);
+		write(static_cast<uint16_t>(sample), 2);
+	}
+
+	return wave;
+}
+
+/**
+ * Decodes a sound the way buffers are loaded, all at once into one block of PCM, then the way streams decode it, a chunk at a time.
+ */
+static bool Benchmark(const std::string &name, const std::string &data, const std::string &extension) {
+	auto decoder = SoundDecoder::Create(data, extension);
+	if (!decoder) {
+		Log::Error("Could not decode ", name, '\n');
+		return false;
+	}
+
+	auto channels = decoder->GetChannels();
+	auto chunkFrames = static_cast<std::size_t>(decoder->GetSampleRate() * SoundStream::BufferDuration);
+
+	// Whole sound, growing the PCM block as the sound is decoded.
+	std::vector<int16_t> pcm;
+	std::size_t frames = 0;
+	auto debugStart = Time::Now();
+	while (true) {
+		pcm.resize((frames + chunkFrames * 64) * channels);
+		auto read = decoder->Read(pcm.data() + frames * channels, chunkFrames * 64);
+		frames += read;
+		if (read < chunkFrames * 64)
+			break;
+	}
+	pcm.resize(frames * channels);
+	auto wholeTime = Time::Now() - debugStart;
+
+	// Chunks the size of a stream buffer, reusing the same memory.
+	decoder->Rewind();
+	std::vector<int16_t> chunk(chunkFrames * channels);
+	std::size_t streamedFrames = 0;
+	debugStart = Time::Now();
+	while (auto read = decoder->Read(chunk.data(), chunkFrames))
+		streamedFrames += read;
+	auto streamTime = Time::Now() - debugStart;
+
+	auto seconds = static_cast<float>(frames) / decoder->GetSampleRate();
+	Log::Out(name, ": ", seconds, "s of audio, ", channels, " channels at ", decoder->GetSampleRate(), "Hz\n");
+	Log::Out("  Whole decode: ", wholeTime.AsMilliseconds<float>(), "ms, ", seconds / wholeTime.AsSeconds<float>(), "x realtime, ",
+		pcm.size() * sizeof(int16_t) / 1024, "KB of PCM\n");
+	Log::Out("  Streamed decode: ", streamTime.AsMilliseconds<float>(), "ms, ", seconds / streamTime.AsSeconds<float>(), "x realtime, ",
+		chunk.size() * sizeof(int16_t) * SoundStream::ChunkCount / 1024, "KB of PCM\n");
+
+	if (streamedFrames != frames) {
+		Log::Error("  Streamed ", streamedFrames, " frames, expected ", frames, '\n');
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv) {
+	auto result = Benchmark("Generated wave", CreateWave(44100, 120.0f), ".wav");
+
+	// Any other sounds given on the command line are benchmarked too, such as Ogg or MP3 music.
+	for (int32_t i = 1; i < argc; i++) {
+		std::filesystem::path filename(argv[i]);
+		std::ifstream inStream(filename, std::ios::binary);
+		std::string data((std::istreambuf_iterator<char>(inStream)), std::istreambuf_iterator<char>());
+		result &= Benchmark(filename.string(), data, filename.extension().string());
+	}
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+#include <cstring>
+
+#include <stb/stb_image.h>
+#include <stb/stb_image_write.h>
+
+#include <Bitmaps/Png/PngBitmap.hpp>
+#include <Engine/Log.hpp>
+#include <Maths/Time.hpp>
+
+using namespace acid;
+
+static constexpr uint32_t Iterations = 4;
+
+/**
+ * Fills a bitmap with gradients and noise, so it compresses about as well as a typical texture.
+ */
+static void FillBitmap(Bitmap &bitmap) {
+	auto size = bitmap.GetSize();
+	auto bytesPerPixel = bitmap.GetBytesPerPixel();
+	auto data = bitmap.GetData().get();
+	uint32_t seed = 1;
+
+	for (uint32_t y = 0; y < size.y; y++) {
+		for (uint32_t x = 0; x < size.x; x++) {
+			for (uint32_t c = 0; c < bytesPerPixel; c++) {
+				seed = seed * 1664525 + 1013904223;
+				data[(y * size.x + x) * bytesPerPixel + c] = static_cast<uint8_t>((x * (c + 1) + y) / 8 + (seed >> 29));
+			}
+		}
+	}
+}
+
+static float Throughput(std::size_t bytes, const Time &time) {
+	return static_cast<float>(bytes * Iterations) / (1024.0f * 1024.0f) / time.AsSeconds<float>();
+}
+
+int main(int argc, char **argv) {
+	auto result = EXIT_SUCCESS;
+	std::filesystem::path filename = std::filesystem::temp_directory_path() / "AcidTestBitmap.png";
+
+	for (auto bytesPerPixel : {3u, 4u}) {
+		Bitmap bitmap({2048, 2048}, bytesPerPixel);
+		FillBitmap(bitmap);
+		Log::Out("Bitmap ", bitmap.GetSize(), " with ", bytesPerPixel, " bytes per pixel, ", bitmap.GetLength() / (1024 * 1024), "MB\n");
+
+		std::vector<uint8_t> png;
+		auto debugStart = Time::Now();
+		for (uint32_t i = 0; i < Iterations; i++)
+			png = PngBitmap::Encode(bitmap);
+		Log::Out("  PngBitmap encode: ", Throughput(bitmap.GetLength(), Time::Now() - debugStart), "MB/s, ", png.size(), " bytes\n");
+
+		int32_t stbLength = 0;
+		debugStart = Time::Now();
+		for (uint32_t i = 0; i < Iterations; i++) {
+			std::unique_ptr<uint8_t[]> stbPng(stbi_write_png_to_mem(bitmap.GetData().get(), bitmap.GetSize().x * bytesPerPixel, bitmap.GetSize().x,
+				bitmap.GetSize().y, bytesPerPixel, &stbLength));
+		}
+		Log::Out("  stb encode: ", Throughput(bitmap.GetLength(), Time::Now() - debugStart), "MB/s, ", stbLength, " bytes\n");
+
+		std::ofstream(filename, std::ios::binary).write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+
+		Bitmap decoded;
+		debugStart = Time::Now();
+		for (uint32_t i = 0; i < Iterations; i++)
+			PngBitmap::Load(&decoded, filename);
+		Log::Out("  PngBitmap decode: ", Throughput(decoded.GetLength(), Time::Now() - debugStart), "MB/s\n");
+
+		std::unique_ptr<uint8_t[]> stbDecoded;
+		int32_t width, height, components;
+		debugStart = Time::Now();
+		for (uint32_t i = 0; i < Iterations; i++) {
+			stbDecoded.reset(stbi_load_from_memory(png.data(), static_cast<int32_t>(png.size()), &width, &height, &components, STBI_rgb_alpha));
+		}
+		Log::Out("  stb decode: ", Throughput(decoded.GetLength(), Time::Now() - debugStart), "MB/s\n");
+
+		// Both decoders expand to RGBA, so the results must match exactly.
+		if (!decoded.GetData() || !stbDecoded || decoded.GetSize() != Vector2ui(width, height) ||
+			std::memcmp(decoded.GetData().get(), stbDecoded.get(), decoded.GetLength()) != 0) {
+			Log::Error("  PngBitmap round trip does not match stb\n");
+			result = EXIT_FAILURE;
+		}
+	}
+
+	std::filesystem::remove(filename);
+	return result;
+}
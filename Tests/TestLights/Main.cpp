@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include <Engine/Log.hpp>
+#include <Lights/LightClusters.hpp>
+#include <Maths/Maths.hpp>
+#include <Maths/Time.hpp>
+
+using namespace acid;
+
+static constexpr float FieldOfView = Maths::Radians(60.0f);
+static constexpr float AspectRatio = 16.0f / 9.0f;
+static constexpr float NearPlane = 0.1f;
+static constexpr float FarPlane = 1000.0f;
+
+/**
+ * Places street lights along a grid of roads around the camera, as in a city at night.
+ */
+static std::vector<Vector4f> CreateLights(uint32_t count) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int32_t> road(-10, 10);
+	std::uniform_real_distribution<float> along(-400.0f, 400.0f);
+	std::uniform_real_distribution<float> radius(4.0f, 16.0f);
+	std::vector<Vector4f> lights;
+	lights.reserve(count);
+
+	for (uint32_t i = 0; i < count; i++) {
+		auto across = static_cast<float>(road(random)) * 40.0f;
+		if (i % 2 == 0)
+			lights.emplace_back(across, 6.0f, along(random), radius(random));
+		else
+			lights.emplace_back(along(random), 6.0f, across, radius(random));
+	}
+
+	return lights;
+}
+
+/**
+ * Checks two cluster grids have the same lights in each cluster, the order of the lists in their buffers depends on the threads used.
+ */
+static bool Equal(const LightClusters &a, const LightClusters &b) {
+	for (uint32_t cluster = 0; cluster < a.GetClusterCount(); cluster++) {
+		if (a.GetLightCount(cluster) != b.GetLightCount(cluster) ||
+			!std::equal(a.GetLights(cluster), a.GetLights(cluster) + a.GetLightCount(cluster), b.GetLights(cluster)))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Finds the lights of each cluster for a number of lights, on this thread and on a thread pool, with the camera turning each frame.
+ */
+static bool BenchmarkAssignment(uint32_t lightCount, ThreadPool &threadPool, uint32_t frames) {
+	auto lights = CreateLights(lightCount);
+	LightClusters serial, threaded;
+	Time serialTime, threadedTime;
+
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		auto angle = 0.01f * static_cast<float>(frame);
+		auto viewMatrix = Matrix4::LookAt(Vector3f(0.0f, 2.0f, 0.0f), Vector3f(std::sin(angle), 2.0f, std::cos(angle)), Vector3f::Up);
+
+		auto debugStart = Time::Now();
+		serial.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, lights);
+		serialTime += Time::Now() - debugStart;
+
+		debugStart = Time::Now();
+		threaded.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, lights, &threadPool);
+		threadedTime += Time::Now() - debugStart;
+
+		if (!Equal(serial, threaded)) {
+			Log::Error("  Threaded clusters differ from serial clusters for ", lightCount, " lights\n");
+			return false;
+		}
+	}
+
+	// Each pixel used to shade with every light, now it shades with the lights of its cluster.
+	auto averageLights = static_cast<float>(serial.GetIndexCount()) / static_cast<float>(serial.GetClusterCount());
+	Log::Out(lightCount, " lights: serial ", serialTime.AsMicroseconds<float>() / frames, "us, ", threadPool.GetWorkers().size() + 1, " threads ",
+		threadedTime.AsMicroseconds<float>() / frames, "us, ", serial.GetIndexCount(), " indices, ", averageLights, " lights per cluster\n");
+	return true;
+}
+
+int main(int argc, char **argv) {
+	ThreadPool threadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	Log::Out("Light cluster assignment for ", LightClusters().GetClusterCount(), " clusters:\n");
+
+	auto result = true;
+	for (auto lightCount : {32, 128, 512, 800, 2048, 8192})
+		result &= BenchmarkAssignment(lightCount, threadPool, 200);
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
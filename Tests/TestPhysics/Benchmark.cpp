@@ -0,0 +1,294 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include <btBulletDynamicsCommon.h>
+#include <Engine/Log.hpp>
+#include <Physics/ContactPairTable.hpp>
+#include <Scenes/ScenePhysics.hpp>
+#include <Utils/String.hpp>
+
+using namespace acid;
+
+namespace test {
+/// Boxes on each side of the base of a pyramid, and pyramids on each side of the grid.
+static constexpr int PyramidSize = 10;
+static constexpr int PyramidGrid = 5;
+/// Pieces of rubble dropped onto the pyramids.
+static constexpr int RubbleCount = 1000;
+static constexpr Time StepDelta = Time::Seconds(1.0f / 60.0f);
+static constexpr uint32_t WarmupSteps = 30;
+static constexpr uint32_t MeasuredSteps = 120;
+/// Pairs in contact each update, and how many of them change between updates.
+static constexpr uint32_t ContactPairs = 20000;
+static constexpr uint32_t ChangedPairs = 1000;
+static constexpr uint32_t ContactUpdates = 200;
+/// Pillars on each side of the grid rays are cast through, and rays cast each tick.
+static constexpr int PillarGrid = 40;
+static constexpr uint32_t RayCount = 30000;
+static constexpr uint32_t RayTicks = 10;
+
+class BenchmarkResult {
+public:
+	Time mean;
+	Time max;
+	uint32_t bodies = 0;
+	uint32_t active = 0;
+};
+
+/**
+ * Fills a world with stacks of boxes and falling rubble, then steps it.
+ * @param threadCount The threads the world is stepped with, 0 for the single threaded world.
+ * @return The step times.
+ */
+static BenchmarkResult Run(uint32_t threadCount) {
+	btBoxShape boxShape(btVector3(0.5f, 0.5f, 0.5f));
+	btSphereShape sphereShape(0.3f);
+	btBoxShape groundShape(btVector3(200.0f, 1.0f, 200.0f));
+	// Bodies are removed from the world as it is destroyed, so they are declared first.
+	std::vector<std::unique_ptr<btRigidBody>> bodies;
+	ScenePhysics physics(threadCount);
+
+	auto addBody = [&](btCollisionShape *shape, float mass, const btVector3 &position) {
+		btVector3 inertia(0.0f, 0.0f, 0.0f);
+		if (mass != 0.0f)
+			shape->calculateLocalInertia(mass, inertia);
+
+		// The motion state is deleted by the world.
+		auto motionState = new btDefaultMotionState(btTransform(btQuaternion::getIdentity(), position));
+		auto &body = bodies.emplace_back(std::make_unique<btRigidBody>(btRigidBody::btRigidBodyConstructionInfo(mass, motionState, shape, inertia)));
+		physics.GetDynamicsWorld()->addRigidBody(body.get());
+	};
+
+	addBody(&groundShape, 0.0f, btVector3(0.0f, -1.0f, 0.0f));
+
+	for (int gx = 0; gx < PyramidGrid; gx++) {
+		for (int gz = 0; gz < PyramidGrid; gz++) {
+			auto origin = btVector3((gx - PyramidGrid / 2) * 15.0f, 0.0f, (gz - PyramidGrid / 2) * 15.0f);
+
+			for (int y = 0; y < PyramidSize; y++) {
+				auto size = PyramidSize - y;
+
+				for (int x = 0; x < size; x++) {
+					for (int z = 0; z < size; z++) {
+						addBody(&boxShape, 1.0f, origin + btVector3(x - size * 0.5f + 0.5f, y + 0.5f, z - size * 0.5f + 0.5f));
+					}
+				}
+			}
+		}
+	}
+
+	// The same rubble falls for every thread count.
+	std::mt19937 random(2019);
+	std::uniform_real_distribution<float> spread(-35.0f, 35.0f);
+	std::uniform_real_distribution<float> height(15.0f, 45.0f);
+
+	for (int i = 0; i < RubbleCount; i++)
+		addBody(i % 2 == 0 ? static_cast<btCollisionShape *>(&sphereShape) : &boxShape, 0.5f, btVector3(spread(random), height(random), spread(random)));
+
+	BenchmarkResult result;
+	result.bodies = static_cast<uint32_t>(bodies.size());
+
+	for (uint32_t i = 0; i < WarmupSteps; i++)
+		physics.Step(StepDelta);
+
+	Time total;
+
+	for (uint32_t i = 0; i < MeasuredSteps; i++) {
+		auto start = Time::Now();
+		physics.Step(StepDelta);
+		auto elapsed = Time::Now() - start;
+		total += elapsed;
+		result.max = std::max(result.max, elapsed);
+	}
+
+	result.mean = total / static_cast<int64_t>(MeasuredSteps);
+
+	for (const auto &body : bodies) {
+		if (body->isActive())
+			result.active++;
+	}
+
+	return result;
+}
+
+/**
+ * Finds the pairs that started and ended contact, the way ScenePhysics did before it used a pair table.
+ * @param pairs The pairs in contact for each update.
+ * @param events The number of pairs that started or ended contact.
+ * @return The time taken.
+ */
+static Time RunOrderedSet(const std::vector<std::vector<std::pair<const int *, const int *>>> &pairs, std::size_t &events) {
+	using CollisionPairs = std::set<std::pair<const int *, const int *>>;
+	CollisionPairs pairsLastUpdate;
+	auto start = Time::Now();
+
+	for (const auto &update : pairs) {
+		CollisionPairs pairsThisUpdate;
+
+		for (const auto &[body0, body1] : update) {
+			auto thisPair = std::make_pair(std::min(body0, body1), std::max(body0, body1));
+			if (pairsThisUpdate.insert(thisPair).second && pairsLastUpdate.find(thisPair) == pairsLastUpdate.end())
+				events++;
+		}
+
+		CollisionPairs removedPairs;
+		std::set_difference(pairsLastUpdate.begin(), pairsLastUpdate.end(), pairsThisUpdate.begin(), pairsThisUpdate.end(),
+			std::inserter(removedPairs, removedPairs.begin()));
+		events += removedPairs.size();
+		pairsLastUpdate = pairsThisUpdate;
+	}
+
+	return Time::Now() - start;
+}
+
+static Time RunPairTable(const std::vector<std::vector<std::pair<const int *, const int *>>> &pairs, std::size_t &events) {
+	ContactPairTable<int> contactPairs;
+	std::vector<ContactPairTable<int>::Pair> startedPairs, endedPairs;
+	auto start = Time::Now();
+
+	for (const auto &update : pairs) {
+		contactPairs.Update();
+		startedPairs.clear();
+		endedPairs.clear();
+
+		for (const auto &[body0, body1] : update) {
+			if (contactPairs.Insert(body0, body1))
+				startedPairs.emplace_back(body0, body1);
+		}
+
+		contactPairs.GetEnded(endedPairs);
+		events += startedPairs.size() + endedPairs.size();
+	}
+
+	return Time::Now() - start;
+}
+
+/**
+ * Compares finding contact events with an ordered set and with the pair table, over pairs that change a little each update.
+ * @return If both found the same events.
+ */
+static bool BenchmarkContactPairs() {
+	std::vector<int> objects(ContactPairs * 2);
+	std::mt19937 random(2019);
+	std::uniform_int_distribution<std::size_t> pick(0, objects.size() - 1);
+	auto randomPair = [&]() {
+		return std::make_pair<const int *, const int *>(&objects[pick(random)], &objects[pick(random)]);
+	};
+
+	std::vector<std::pair<const int *, const int *>> pairs(ContactPairs);
+	std::generate(pairs.begin(), pairs.end(), randomPair);
+	std::vector<std::vector<std::pair<const int *, const int *>>> updates;
+
+	for (uint32_t i = 0; i < ContactUpdates; i++) {
+		for (uint32_t j = 0; j < ChangedPairs; j++)
+			pairs[pick(random) % pairs.size()] = randomPair();
+
+		// Manifolds are listed in no particular order.
+		std::shuffle(pairs.begin(), pairs.end(), random);
+		updates.emplace_back(pairs);
+	}
+
+	std::size_t setEvents = 0, tableEvents = 0;
+	auto setTime = RunOrderedSet(updates, setEvents);
+	auto tableTime = RunPairTable(updates, tableEvents);
+
+	Log::Out("Finding contact events for ", ContactPairs, " pairs, ", ChangedPairs, " changing each update:\n");
+	Log::Out("  Ordered set: ", (setTime / static_cast<int64_t>(ContactUpdates)).AsMicroseconds(), "us per update\n");
+	Log::Out("  Pair table: ", (tableTime / static_cast<int64_t>(ContactUpdates)).AsMicroseconds(), "us per update, ", setTime / tableTime, "x\n");
+
+	if (setEvents != tableEvents) {
+		Log::Error("The ordered set found ", setEvents, " events, the pair table found ", tableEvents, "\n");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Compares casting line of sight rays through a grid of pillars one call at a time and as a batch.
+ * @return If both found the same hits.
+ */
+static bool BenchmarkRaytests() {
+	btBoxShape pillarShape(btVector3(0.5f, 4.0f, 0.5f));
+	std::vector<std::unique_ptr<btRigidBody>> pillars;
+	ScenePhysics physics;
+
+	for (int x = 0; x < PillarGrid; x++) {
+		for (int z = 0; z < PillarGrid; z++) {
+			auto motionState = new btDefaultMotionState(btTransform(btQuaternion::getIdentity(), btVector3(x * 4.0f, 4.0f, z * 4.0f)));
+			auto &pillar = pillars.emplace_back(std::make_unique<btRigidBody>(btRigidBody::btRigidBodyConstructionInfo(0.0f, motionState, &pillarShape,
+				btVector3(0.0f, 0.0f, 0.0f))));
+			physics.GetDynamicsWorld()->addRigidBody(pillar.get());
+		}
+	}
+
+	std::mt19937 random(2019);
+	std::uniform_real_distribution<float> spread(0.0f, PillarGrid * 4.0f);
+	std::vector<RayQuery> queries(RayCount);
+
+	for (auto &query : queries) {
+		query.start = Vector3f(spread(random), 1.5f, spread(random));
+		query.end = Vector3f(spread(random), 1.5f, spread(random));
+	}
+
+	std::vector<Raycast> results(RayCount);
+	auto start = Time::Now();
+
+	for (uint32_t tick = 0; tick < RayTicks; tick++) {
+		for (uint32_t i = 0; i < RayCount; i++)
+			results[i] = physics.Raytest(queries[i].start, queries[i].end);
+	}
+
+	auto callTime = Time::Now() - start;
+	auto callHits = std::count_if(results.begin(), results.end(), [](const Raycast &result) { return result.HasHit(); });
+	start = Time::Now();
+
+	for (uint32_t tick = 0; tick < RayTicks; tick++)
+		physics.Raytest(queries.data(), results.data(), results.size());
+
+	auto batchTime = Time::Now() - start;
+	auto batchHits = std::count_if(results.begin(), results.end(), [](const Raycast &result) { return result.HasHit(); });
+
+	Log::Out("Casting ", RayCount, " rays through ", pillars.size(), " pillars:\n");
+	Log::Out("  Per call: ", (callTime / static_cast<int64_t>(RayTicks)).AsMilliseconds<float>(), "ms per tick\n");
+	Log::Out("  Batch on ", ScenePhysics::GetMaxThreadCount(), " threads: ", (batchTime / static_cast<int64_t>(RayTicks)).AsMilliseconds<float>(),
+		"ms per tick, ", callTime / batchTime, "x\n");
+
+	if (callHits != batchHits) {
+		Log::Error("Per call rays hit ", callHits, " times, batched rays hit ", batchHits, " times\n");
+		return false;
+	}
+
+	return true;
+}
+
+int RunBenchmark() {
+	std::vector<uint32_t> threadCounts = {0};
+	for (uint32_t threads = 1; threads < ScenePhysics::GetMaxThreadCount(); threads *= 2)
+		threadCounts.emplace_back(threads);
+	threadCounts.emplace_back(ScenePhysics::GetMaxThreadCount());
+
+	Log::Out("Stepping ", MeasuredSteps, " steps of ", StepDelta.AsMilliseconds<float>(), "ms, after ", WarmupSteps, " to settle\n");
+	Time baseline;
+
+	for (auto threadCount : threadCounts) {
+		auto result = Run(threadCount);
+
+		if (threadCount == 0)
+			baseline = result.mean;
+
+		Log::Out("  ", threadCount == 0 ? "Single threaded world" : "Threads " + String::To(threadCount), ": ", result.mean.AsMilliseconds<float>(),
+			"ms per step, ", result.max.AsMilliseconds<float>(), "ms at most, ", baseline / result.mean, "x, ",
+			result.active, " of ", result.bodies, " bodies awake\n");
+	}
+
+	auto contactPairsMatch = BenchmarkContactPairs();
+	auto raytestsMatch = BenchmarkRaytests();
+	return contactPairsMatch && raytestsMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}
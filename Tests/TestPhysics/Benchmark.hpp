@@ -0,0 +1,10 @@
+#pragma once
+
+namespace test {
+/**
+ * Steps a stacking and rubble scene without a window and reports the step time for each number of threads, then
+ * compares ways of finding contact events and of casting rays.
+ * @return The exit code.
+ */
+int RunBenchmark();
+}
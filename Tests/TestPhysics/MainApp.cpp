@@ -6,6 +6,7 @@
 #include <Graphics/Graphics.hpp>
 #include <Scenes/Scenes.hpp>
 #include <Timers/Timers.hpp>
+#include "Benchmark.hpp"
 #include "MainRenderer.hpp"
 #include "Scenes/Scene1.hpp"
 #include "World/World.hpp"
@@ -14,6 +15,10 @@
 int main(int argc, char **argv) {
 	using namespace test;
 
+	// Steps a physics scene without a window, and exits.
+	if (argc > 1 && std::string(argv[1]) == "benchmark")
+		return RunBenchmark();
+
 	// Creates the engine.
 	auto engine = std::make_unique<Engine>(argv[0]);
 	engine->SetApp(std::make_unique<MainApp>());
@@ -167,13 +167,13 @@ void Scene1::Start() {
 	plane->AddComponent<Mesh>(CubeModel::Create({1.0f, 1.0f, 1.0f}),
 		std::make_unique<DefaultMaterial>(Colour::White, Image2d::Create("Undefined2.png", VK_FILTER_NEAREST)));
 	plane->AddComponent<Rigidbody>(std::make_unique<CubeCollider>(Vector3f(1.0f, 1.0f, 1.0f)), 0.0f, 0.5f);
-	plane->AddComponent<ShadowRender>();
+	plane->AddComponent<ShadowRender>(true);
 
 	auto terrain = GetStructure()->CreateEntity();
 	terrain->AddComponent<Transform>(Vector3f(0.0f, -10.0f, 0.0f));
 	terrain->AddComponent<Mesh>(CubeModel::Create({50.0f, 1.0f, 50.0f}), 
 		std::make_unique<TerrainMaterial>(Image2d::Create("Objects/Terrain/Grass.png"), Image2d::Create("Objects/Terrain/Rocks.png")));
-	terrain->AddComponent<ShadowRender>();
+	terrain->AddComponent<ShadowRender>(true);
 
 	//auto terrain = GetStructure()->CreateEntity();
 	//terrain->AddComponent<Transform>();
@@ -0,0 +1,234 @@
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+#include <Engine/Log.hpp>
+#include <Maths/Transform.hpp>
+#include <Network/Replication/ReplicationClient.hpp>
+#include <Network/Replication/ReplicationServer.hpp>
+#include <Network/Udp/UdpConnection.hpp>
+#include <Network/Udp/UdpSocket.hpp>
+#include <Network/Packet.hpp>
+#include <Scenes/SceneStructure.hpp>
+
+using namespace acid;
+
+static constexpr uint32_t EntityCount = 1000;
+static constexpr uint32_t MovingTicks = 300;
+/// Snapshots and their acknowledgements are sent unreliably, control messages are reliable and ordered.
+static constexpr uint8_t SnapshotChannel = 0;
+static constexpr uint8_t ControlChannel = 2;
+
+/**
+ * Entities move around circles on a grid, so both processes know where they should be at any tick.
+ */
+static Vector3f GetPosition(uint32_t index, uint32_t tick) {
+	auto angle = 0.05f * static_cast<float>(tick) + static_cast<float>(index);
+	auto centre = Vector3f(static_cast<float>(index % 32) * 20.0f, 0.0f, static_cast<float>(index / 32) * 20.0f);
+	return centre + Vector3f(std::cos(angle), 0.0f, std::sin(angle)) * 5.0f;
+}
+
+static void Poll(UdpSocket &socket, UdpConnection &connection) {
+	char data[UdpConnection::MaxDatagramSize];
+	std::size_t received;
+	IpAddress address;
+	uint16_t port;
+
+	while (socket.Receive(data, sizeof(data), received, address, port) == Socket::Status::Done)
+		connection.OnReceive(data, received);
+}
+
+/**
+ * Receives snapshots until the server is done, then checks every entity ended up where the server left it.
+ */
+static int RunClient(uint16_t serverPort) {
+	UdpSocket socket;
+	socket.Bind(0, IpAddress::LocalHost);
+	socket.SetBlocking(false);
+	UdpConnection connection(socket, IpAddress::LocalHost, serverPort);
+
+	Packet hello;
+	hello << std::string("hello");
+	connection.Send(ControlChannel, hello);
+
+	ReplicationClient client;
+	SceneStructure scene;
+	Packet packet;
+	auto start = Time::Now();
+
+	while (Time::Now() - start < 60s) {
+		connection.Update();
+		Poll(socket, connection);
+		uint8_t channel;
+
+		while (connection.Receive(channel, packet)) {
+			if (channel == SnapshotChannel) {
+				if (client.ReadSnapshot(packet)) {
+					Packet ack;
+					client.WriteAck(ack);
+					connection.Send(SnapshotChannel, ack);
+				}
+
+				continue;
+			}
+
+			uint32_t finalTick;
+			packet >> finalTick;
+			client.Apply(scene);
+			scene.Update();
+
+			// Each replicated entity must be at one of the final positions, the grid keeps them apart.
+			std::vector<Vector3f> expected;
+			for (uint32_t i = 0; i < EntityCount; i++)
+				expected.emplace_back(GetPosition(i, finalTick));
+
+			uint32_t matched = 0;
+
+			for (auto transform : scene.QueryComponents<Transform>()) {
+				for (const auto &position : expected) {
+					if (transform->GetPosition().Distance(position) < 0.01f) {
+						matched++;
+						break;
+					}
+				}
+			}
+
+			Log::Out("Client replicated ", scene.GetSize(), " entities, ", matched, " at their final position\n");
+
+			Packet result;
+			result << static_cast<uint8_t>(matched == EntityCount && scene.GetSize() == EntityCount);
+			connection.Send(ControlChannel, result);
+
+			// Keep updating so the result is delivered.
+			for (uint32_t i = 0; i < 200; i++) {
+				connection.Update();
+				Poll(socket, connection);
+				std::this_thread::sleep_for(5ms);
+			}
+
+			return matched == EntityCount ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+
+		std::this_thread::sleep_for(1ms);
+	}
+
+	Log::Error("Client timed out\n");
+	return EXIT_FAILURE;
+}
+
+/**
+ * Moves entities and replicates them to a client in another process, measuring the bytes sent each tick.
+ */
+static int RunServer(const std::string &program) {
+	UdpSocket socket;
+	socket.Bind(0, IpAddress::LocalHost);
+	socket.SetBlocking(false);
+
+	auto clientResult = EXIT_FAILURE;
+	std::thread clientProcess([&]() {
+		auto command = "\"" + program + "\" client " + String::To(socket.GetLocalPort());
+		clientResult = std::system(command.c_str());
+	});
+
+	// The first datagram from the client tells where it is.
+	char data[UdpConnection::MaxDatagramSize];
+	std::size_t received = 0;
+	IpAddress address;
+	uint16_t port = 0;
+	auto start = Time::Now();
+
+	while (socket.Receive(data, sizeof(data), received, address, port) != Socket::Status::Done && Time::Now() - start < 20s)
+		std::this_thread::sleep_for(1ms);
+
+	if (port == 0) {
+		Log::Error("Client never connected\n");
+		clientProcess.join();
+		return EXIT_FAILURE;
+	}
+
+	UdpConnection connection(socket, address, port);
+	connection.OnReceive(data, received);
+
+	SceneStructure scene;
+	for (uint32_t i = 0; i < EntityCount; i++)
+		scene.CreateEntity()->AddComponent<Transform>(GetPosition(i, 0));
+
+	ReplicationServer server;
+	auto client = server.AddClient();
+
+	// A second server sends every change each tick to a client that acknowledges straight away, to compare against.
+	ReplicationServer unbudgeted(std::numeric_limits<std::size_t>::max());
+	auto localClient = unbudgeted.AddClient();
+
+	std::size_t fullBytes = 0, deltaBytes = 0, sentBytes = 0;
+	uint8_t result = 0;
+	bool done = false, finished = false;
+	Packet packet;
+
+	while (Time::Now() - start < 60s) {
+		auto moving = server.GetTick() < MovingTicks;
+
+		if (moving) {
+			auto transforms = scene.QueryComponents<Transform>();
+			for (uint32_t i = 0; i < transforms.size(); i++)
+				transforms[i]->SetLocalPosition(GetPosition(i, server.GetTick() + 1));
+		}
+
+		server.Capture(scene);
+		packet.Clear();
+		server.WriteSnapshot(client, packet);
+		connection.Send(SnapshotChannel, packet);
+
+		if (moving) {
+			sentBytes += packet.GetDataSize();
+			unbudgeted.Capture(scene);
+			Packet unbudgetedPacket, ack;
+			unbudgeted.WriteSnapshot(localClient, unbudgetedPacket);
+			ack << unbudgeted.GetTick();
+			unbudgeted.ReadAck(localClient, ack);
+
+			if (server.GetTick() == 1)
+				fullBytes = unbudgetedPacket.GetDataSize();
+			else
+				deltaBytes += unbudgetedPacket.GetDataSize();
+		} else if (!done && server.GetAckedTick(client) != 0 && packet.GetDataSize() == 2 * sizeof(uint32_t)) {
+			// A snapshot with only the tick and baseline means what the client acknowledged is where every entity stopped.
+			Packet finalTick;
+			finalTick << MovingTicks;
+			connection.Send(ControlChannel, finalTick);
+			done = true;
+		}
+
+		connection.Update();
+		Poll(socket, connection);
+		uint8_t channel;
+
+		while (connection.Receive(channel, packet)) {
+			if (channel == SnapshotChannel)
+				server.ReadAck(client, packet);
+			else if (channel == ControlChannel && done)
+				finished = static_cast<bool>(packet >> result);
+		}
+
+		if (finished)
+			break;
+
+		std::this_thread::sleep_for(2ms);
+	}
+
+	clientProcess.join();
+
+	Log::Out("Replicated ", EntityCount, " moving entities over ", MovingTicks, " ticks:\n");
+	Log::Out("  Full state: ", fullBytes, " bytes\n");
+	Log::Out("  Every change, each tick: ", deltaBytes / (MovingTicks - 1), " bytes per tick\n");
+	Log::Out("  Sent with a budget of ", server.GetBudget(), " bytes: ", sentBytes / MovingTicks, " bytes per tick\n");
+	Log::Out("  Client ", result && clientResult == 0 ? "matched" : "did not match", " the server\n");
+	return result && clientResult == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 2 && std::string(argv[1]) == "client")
+		return RunClient(String::From<uint16_t>(argv[2]));
+
+	return RunServer(argv[0]);
+}
@@ -0,0 +1,398 @@
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+
+#if defined(ACID_BUILD_LINUX)
+#include <sys/resource.h>
+#endif
+
+#include <Engine/Log.hpp>
+#include <Network/BitStream.hpp>
+#include <Network/Tcp/TcpListener.hpp>
+#include <Network/Tcp/TcpSocket.hpp>
+#include <Network/Udp/UdpSocket.hpp>
+#include <Network/IpAddress.hpp>
+#include <Network/Packet.hpp>
+#include <Network/PacketPool.hpp>
+#include <Network/SocketSelector.hpp>
+
+using namespace acid;
+
+/**
+ * A server and client ends of loopback connections, connected through a listener.
+ */
+struct Connections {
+	std::vector<std::unique_ptr<TcpSocket>> clients;
+	std::vector<std::unique_ptr<TcpSocket>> servers;
+};
+
+static bool Connect(Connections &connections, std::size_t count) {
+	TcpListener listener;
+	if (listener.Listen(0, IpAddress::LocalHost) != Socket::Status::Done)
+		return false;
+
+	for (std::size_t i = 0; i < count; i++) {
+		auto client = std::make_unique<TcpSocket>();
+		auto server = std::make_unique<TcpSocket>();
+
+		if (client->Connect(IpAddress::LocalHost, listener.GetLocalPort()) != Socket::Status::Done ||
+			listener.Accept(*server) != Socket::Status::Done) {
+			Log::Error("Failed to connect socket ", i, '\n');
+			return false;
+		}
+
+		server->SetBlocking(false);
+		connections.clients.emplace_back(std::move(client));
+		connections.servers.emplace_back(std::move(server));
+	}
+
+	return true;
+}
+
+/**
+ * Waits on every server socket while only the first busyCount clients send, the rest stay idle.
+ */
+static bool BenchmarkSelector(Connections &connections, std::size_t busyCount, SocketSelector::Trigger trigger, uint32_t rounds) {
+	SocketSelector selector(trigger);
+
+	auto debugStart = Time::Now();
+	for (auto &server : connections.servers)
+		selector.Add(*server);
+	auto addTime = Time::Now() - debugStart;
+
+	std::size_t received = 0;
+	std::size_t waits = 0;
+	std::size_t readyCount = 0;
+	Time waitTime;
+
+	for (uint32_t round = 0; round < rounds; round++) {
+		char byte = static_cast<char>(round);
+		for (std::size_t i = 0; i < busyCount; i++)
+			connections.clients[i]->Send(&byte, 1);
+
+		// Every busy socket has sent one byte, wait until they have all been read.
+		std::size_t roundReceived = 0;
+		while (roundReceived < busyCount) {
+			debugStart = Time::Now();
+			if (!selector.Wait(1s)) {
+				Log::Error("Timed out waiting for sockets, received ", roundReceived, " of ", busyCount, '\n');
+				return false;
+			}
+			waitTime += Time::Now() - debugStart;
+			waits++;
+			readyCount += selector.GetReadySockets().size();
+
+			for (auto socket : selector.GetReadySockets()) {
+				auto tcpSocket = static_cast<TcpSocket *>(socket);
+				char buffer[64];
+				std::size_t size;
+
+				// Edge triggered sockets are only reported again for new data, so they are read until empty.
+				while (tcpSocket->Receive(buffer, sizeof(buffer), size) == Socket::Status::Done)
+					roundReceived += size;
+			}
+		}
+
+		received += roundReceived;
+	}
+
+	debugStart = Time::Now();
+	for (auto &server : connections.servers)
+		selector.Remove(*server);
+	auto removeTime = Time::Now() - debugStart;
+
+	Log::Out(trigger == SocketSelector::Trigger::Edge ? "Edge" : "Level", " triggered, ", connections.servers.size(), " sockets with ", busyCount, " busy:\n");
+	Log::Out("  Add: ", addTime.AsMicroseconds<float>() / connections.servers.size(), "us per socket, Remove: ",
+		removeTime.AsMicroseconds<float>() / connections.servers.size(), "us per socket\n");
+	Log::Out("  Wait: ", waitTime.AsMicroseconds<float>() / waits, "us per wait, ", static_cast<float>(readyCount) / waits, " ready per wait, ",
+		waitTime.AsMilliseconds<float>() / rounds, "ms per round\n");
+
+	if (received != busyCount * rounds) {
+		Log::Error("  Received ", received, " bytes, expected ", busyCount * rounds, '\n');
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Sends packets of one size from a thread through a loopback connection, and receives them on this thread.
+ */
+static bool BenchmarkPackets(std::size_t packetSize, std::size_t totalSize) {
+	Connections connections;
+	if (!Connect(connections, 1))
+		return false;
+
+	auto &server = *connections.servers[0];
+	server.SetBlocking(true);
+
+	auto packetCount = std::max<std::size_t>(totalSize / packetSize, 1);
+	std::vector<char> payload(packetSize);
+	for (std::size_t i = 0; i < packetSize; i++)
+		payload[i] = static_cast<char>(i * 31);
+
+	auto debugStart = Time::Now();
+	std::thread sender([&]() {
+		Packet packet;
+		packet.Append(payload.data(), payload.size());
+
+		for (std::size_t i = 0; i < packetCount; i++)
+			connections.clients[0]->Send(packet);
+	});
+
+	std::size_t received = 0;
+	bool valid = true;
+	Packet packet;
+
+	for (std::size_t i = 0; i < packetCount; i++) {
+		if (server.Receive(packet) != Socket::Status::Done) {
+			valid = false;
+			break;
+		}
+
+		valid &= packet.GetDataSize() == packetSize && std::memcmp(packet.GetData(), payload.data(), packetSize) == 0;
+		received += packet.GetDataSize();
+	}
+
+	sender.join();
+	auto elapsedTime = Time::Now() - debugStart;
+
+	Log::Out("Packets of ", packetSize, " bytes: ", packetCount / elapsedTime.AsSeconds<float>(), " packets/s, ",
+		received / elapsedTime.AsSeconds<float>() / (1024.0f * 1024.0f), "MB/s\n");
+
+	if (!valid)
+		Log::Error("  Packets were not received intact\n");
+	return valid;
+}
+
+/**
+ * Sends and receives rounds of datagrams through loopback, one system call per datagram or in batches.
+ */
+static bool BenchmarkDatagrams(bool batched, std::size_t datagramSize, uint32_t rounds) {
+	UdpSocket sender;
+	UdpSocket receiver;
+	if (receiver.Bind(0, IpAddress::LocalHost) != Socket::Status::Done)
+		return false;
+
+	// Every packet comes from the pool, so no round allocates.
+	PacketPool pool(PacketPool::DefaultCapacity, 2 * UdpSocket::BatchSize);
+	std::vector<Datagram> outgoing(UdpSocket::BatchSize);
+	std::vector<Datagram> incoming(UdpSocket::BatchSize);
+	std::vector<char> payload(datagramSize, 'a');
+
+	for (auto &datagram : outgoing) {
+		datagram.packet = pool.Acquire().release();
+		datagram.packet->Append(payload.data(), payload.size());
+		datagram.address = IpAddress::LocalHost;
+		datagram.port = receiver.GetLocalPort();
+	}
+
+	for (auto &datagram : incoming)
+		datagram.packet = pool.Acquire().release();
+
+	std::size_t received = 0;
+	auto debugStart = Time::Now();
+
+	for (uint32_t round = 0; round < rounds; round++) {
+		std::size_t roundReceived = 0;
+
+		if (batched) {
+			std::size_t sent;
+			if (sender.Send(outgoing.data(), outgoing.size(), sent) != Socket::Status::Done)
+				return false;
+
+			while (roundReceived < incoming.size()) {
+				std::size_t count;
+				if (receiver.Receive(incoming.data() + roundReceived, incoming.size() - roundReceived, count) != Socket::Status::Done)
+					return false;
+				roundReceived += count;
+			}
+		} else {
+			for (auto &datagram : outgoing) {
+				if (sender.Send(*datagram.packet, datagram.address, datagram.port) != Socket::Status::Done)
+					return false;
+			}
+
+			for (auto &datagram : incoming) {
+				if (receiver.Receive(*datagram.packet, datagram.address, datagram.port) != Socket::Status::Done)
+					return false;
+				roundReceived++;
+			}
+		}
+
+		for (std::size_t i = 0; i < roundReceived; i++)
+			received += incoming[i].packet->GetDataSize();
+	}
+
+	auto elapsedTime = Time::Now() - debugStart;
+	auto datagramCount = rounds * outgoing.size();
+	Log::Out(batched ? "Batched" : "Single", " datagrams of ", datagramSize, " bytes: ", datagramCount / elapsedTime.AsSeconds<float>(), " datagrams/s\n");
+
+	for (auto &datagram : outgoing)
+		pool.Release(std::unique_ptr<Packet>(datagram.packet));
+	for (auto &datagram : incoming)
+		pool.Release(std::unique_ptr<Packet>(datagram.packet));
+
+	if (received != datagramCount * datagramSize) {
+		Log::Error("  Received ", received, " bytes, expected ", datagramCount * datagramSize, '\n');
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * The state of an entity sent each tick, with the ranges and precision the game needs.
+ */
+class EntityState {
+public:
+	template<typename Stream>
+	bool Serialize(Stream &stream) {
+		return stream.SerializeVarint(id) && stream.SerializeVector(position, -2000.0f, 2000.0f, 0.005f) &&
+			stream.SerializeQuaternion(rotation) && stream.SerializeVector(velocity, -64.0f, 64.0f, 0.02f) &&
+			stream.template SerializeRanged<0, 100>(health) && stream.template SerializeRanged<0, 31>(animation) &&
+			stream.Serialize(grounded) && stream.Serialize(crouching) && stream.Serialize(firing) && stream.Serialize(visible);
+	}
+
+	uint32_t id = 0;
+	Vector3f position;
+	Quaternion rotation;
+	Vector3f velocity;
+	int32_t health = 0;
+	int32_t animation = 0;
+	bool grounded = false;
+	bool crouching = false;
+	bool firing = false;
+	bool visible = false;
+};
+
+/// Number of fields in the entity state, vectors and rotations count as one.
+static constexpr uint32_t EntityFieldCount = 10;
+
+static Packet &operator<<(Packet &packet, const EntityState &state) {
+	return packet << state.id << state.position.x << state.position.y << state.position.z << state.rotation.x << state.rotation.y <<
+		state.rotation.z << state.rotation.w << state.velocity.x << state.velocity.y << state.velocity.z << state.health << state.animation <<
+		state.grounded << state.crouching << state.firing << state.visible;
+}
+
+static Packet &operator>>(Packet &packet, EntityState &state) {
+	return packet >> state.id >> state.position.x >> state.position.y >> state.position.z >> state.rotation.x >> state.rotation.y >>
+		state.rotation.z >> state.rotation.w >> state.velocity.x >> state.velocity.y >> state.velocity.z >> state.health >> state.animation >>
+		state.grounded >> state.crouching >> state.firing >> state.visible;
+}
+
+/**
+ * Encodes and decodes a state update of many entities, with full width packet operators and with bit packing.
+ */
+static bool BenchmarkSerialization(uint32_t entityCount, uint32_t iterations) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	std::vector<EntityState> states(entityCount);
+
+	for (uint32_t i = 0; i < entityCount; i++) {
+		auto &state = states[i];
+		state.id = i;
+		state.position = Vector3f(distribution(random), distribution(random), distribution(random)) * 2000.0f;
+		state.rotation = Quaternion(Vector3f(distribution(random), distribution(random), distribution(random)) * 3.0f);
+		state.velocity = Vector3f(distribution(random), distribution(random), distribution(random)) * 64.0f;
+		state.health = static_cast<int32_t>(i % 101);
+		state.animation = static_cast<int32_t>(i % 32);
+		state.grounded = i % 2 == 0;
+		state.visible = i % 3 == 0;
+	}
+
+	std::vector<EntityState> read(entityCount);
+	Packet packet;
+	Packet bitPacket;
+	Time encodeTime, decodeTime, bitEncodeTime, bitDecodeTime;
+
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		packet.Clear();
+		auto debugStart = Time::Now();
+		for (auto &state : states)
+			packet << state;
+		encodeTime += Time::Now() - debugStart;
+
+		debugStart = Time::Now();
+		for (auto &state : read)
+			packet >> state;
+		decodeTime += Time::Now() - debugStart;
+
+		bitPacket.Clear();
+		debugStart = Time::Now();
+		{
+			BitWriter writer(bitPacket);
+			for (auto &state : states)
+				state.Serialize(writer);
+		}
+		bitEncodeTime += Time::Now() - debugStart;
+
+		debugStart = Time::Now();
+		BitReader reader(bitPacket);
+		for (auto &state : read)
+			state.Serialize(reader);
+		bitDecodeTime += Time::Now() - debugStart;
+
+		if (!reader.IsValid())
+			return false;
+	}
+
+	auto fieldCount = static_cast<float>(entityCount) * EntityFieldCount * iterations;
+	Log::Out("State update of ", entityCount, " entities:\n");
+	Log::Out("  Full width: ", packet.GetDataSize(), " bytes, encode ", encodeTime.AsMicroseconds<float>() * 1000.0f / fieldCount, "ns per field, decode ",
+		decodeTime.AsMicroseconds<float>() * 1000.0f / fieldCount, "ns per field\n");
+	Log::Out("  Bit packed: ", bitPacket.GetDataSize(), " bytes, encode ", bitEncodeTime.AsMicroseconds<float>() * 1000.0f / fieldCount,
+		"ns per field, decode ", bitDecodeTime.AsMicroseconds<float>() * 1000.0f / fieldCount, "ns per field, ",
+		static_cast<float>(packet.GetDataSize()) / bitPacket.GetDataSize(), "x smaller\n");
+
+	// Quantized fields come back within their precision.
+	for (uint32_t i = 0; i < entityCount; i++) {
+		if (read[i].id != states[i].id || read[i].health != states[i].health || read[i].position.Distance(states[i].position) > 0.01f) {
+			Log::Error("  Entity ", i, " was not decoded correctly\n");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv) {
+#if defined(ACID_BUILD_LINUX)
+	std::size_t idleCount = 10000;
+	std::size_t busyCount = 1000;
+
+	// Each connection uses two handles, one for each end.
+	rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	limit.rlim_cur = limit.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limit);
+
+	auto maxConnections = static_cast<std::size_t>(limit.rlim_cur / 2) - 32;
+	if (idleCount + busyCount > maxConnections) {
+		Log::Warning("Open file limit is ", limit.rlim_cur, ", using ", maxConnections - busyCount, " idle sockets\n");
+		idleCount = maxConnections - busyCount;
+	}
+#else
+	// Select is limited by FD_SETSIZE.
+	std::size_t idleCount = 0;
+	std::size_t busyCount = 32;
+#endif
+
+	Connections connections;
+	if (!Connect(connections, idleCount + busyCount))
+		return EXIT_FAILURE;
+
+	auto result = BenchmarkSelector(connections, busyCount, SocketSelector::Trigger::Level, 100);
+	result &= BenchmarkSelector(connections, busyCount, SocketSelector::Trigger::Edge, 100);
+
+	for (auto packetSize : {64, 1024, 1024 * 1024})
+		result &= BenchmarkPackets(packetSize, 64 * 1024 * 1024);
+
+	for (auto batched : {false, true})
+		result &= BenchmarkDatagrams(batched, 256, 2000);
+
+	result &= BenchmarkSerialization(1000, 200);
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <Network/BitStream.hpp>
+#include <Network/Packet.hpp>
+
+using namespace acid;
+
+class EntityState {
+public:
+	uint32_t id = 0;
+	int32_t health = 0;
+	bool visible = false;
+	Vector3f position;
+	Quaternion rotation;
+	std::string name;
+};
+
+template<typename Stream>
+bool Serialize(Stream &stream, EntityState &state) {
+	return stream.SerializeVarint(state.id) && stream.template SerializeRanged<0, 100>(state.health) && stream.Serialize(state.visible) &&
+		stream.SerializeVector(state.position, -1000.0f, 1000.0f, 0.01f) && stream.SerializeQuaternion(state.rotation) &&
+		stream.SerializeString(state.name);
+}
+
+TEST(BitStream, bitsRequired) {
+	static_assert(BitStream::BitsRequired(0) == 0);
+	static_assert(BitStream::BitsRequired(1) == 1);
+	static_assert(BitStream::BitsRequired(100) == 7);
+	static_assert(BitStream::BitsRequired(255) == 8);
+	static_assert(BitStream::BitsRequired(256) == 9);
+}
+
+TEST(BitStream, roundTrip) {
+	Packet packet;
+	{
+		BitWriter writer(packet);
+		writer.WriteBool(true);
+		writer.WriteBits(5, 3);
+		writer.WriteBits(0xDEADBEEF, 32);
+		writer.WriteVarint(300);
+		writer.WriteVarint(UINT64_MAX);
+		writer.WriteSignedVarint(-2);
+		writer.WriteRanged(-7, -10, 10);
+		writer.WriteFloat(3.14159f, -10.0f, 10.0f, 0.001f);
+		writer.WriteString("Hello bits");
+		EXPECT_EQ(writer.GetBitCount(), 247u);
+	}
+
+	// The last bits are appended when the writer is destroyed, padded to a byte.
+	EXPECT_EQ(packet.GetDataSize(), 31u);
+
+	// Packet operators carry on reading from where the bits end.
+	packet << static_cast<uint8_t>(42);
+
+	BitReader reader(packet);
+	bool flag;
+	uint32_t bits, word;
+	uint64_t varint, large;
+	int64_t signedVarint;
+	int32_t ranged;
+	float value;
+	std::string string;
+
+	EXPECT_TRUE(reader.ReadBool(flag));
+	EXPECT_TRUE(flag);
+	EXPECT_TRUE(reader.ReadBits(bits, 3));
+	EXPECT_EQ(bits, 5u);
+	EXPECT_TRUE(reader.ReadBits(word, 32));
+	EXPECT_EQ(word, 0xDEADBEEF);
+	EXPECT_TRUE(reader.ReadVarint(varint));
+	EXPECT_EQ(varint, 300u);
+	EXPECT_TRUE(reader.ReadVarint(large));
+	EXPECT_EQ(large, UINT64_MAX);
+	EXPECT_TRUE(reader.ReadSignedVarint(signedVarint));
+	EXPECT_EQ(signedVarint, -2);
+	EXPECT_TRUE(reader.ReadRanged(ranged, -10, 10));
+	EXPECT_EQ(ranged, -7);
+	EXPECT_TRUE(reader.ReadFloat(value, -10.0f, 10.0f, 0.001f));
+	EXPECT_NEAR(value, 3.14159f, 0.001f);
+	EXPECT_TRUE(reader.ReadString(string));
+	EXPECT_EQ(string, "Hello bits");
+
+	uint8_t trailing;
+	EXPECT_TRUE(packet >> trailing);
+	EXPECT_EQ(trailing, 42);
+
+	// Reading past the end invalidates the reader.
+	EXPECT_FALSE(reader.ReadBits(bits, 8));
+	EXPECT_FALSE(reader.IsValid());
+}
+
+TEST(BitStream, schema) {
+	EntityState state;
+	state.id = 1234;
+	state.health = 87;
+	state.visible = true;
+	state.position = {-512.25f, 3.5f, 999.99f};
+	state.rotation = Quaternion(Vector3f(0.3f, -1.2f, 2.0f));
+	state.name = "Crate";
+
+	Packet packet;
+	{
+		BitWriter writer(packet);
+		EXPECT_TRUE(Serialize(writer, state));
+	}
+
+	EntityState read;
+	BitReader reader(packet);
+	EXPECT_TRUE(Serialize(reader, read));
+
+	EXPECT_EQ(read.id, state.id);
+	EXPECT_EQ(read.health, state.health);
+	EXPECT_EQ(read.visible, state.visible);
+	EXPECT_LE(read.position.Distance(state.position), 0.02f);
+	EXPECT_EQ(read.name, state.name);
+
+	// The rotation may come back negated, which is the same rotation.
+	auto dot = std::abs(read.rotation.x * state.rotation.x + read.rotation.y * state.rotation.y + read.rotation.z * state.rotation.z +
+		read.rotation.w * state.rotation.w);
+	EXPECT_GT(dot, 0.999f);
+}
+
+TEST(BitStream, rangedClamp) {
+	Packet packet;
+	{
+		BitWriter writer(packet);
+		int32_t high = 150, low = -5;
+		EXPECT_TRUE((writer.SerializeRanged<0, 100>(high)));
+		EXPECT_TRUE((writer.SerializeRanged<0, 100>(low)));
+		writer.WriteBits(3, 2);
+	}
+
+	// Values outside the range are clamped, and do not spill into the bits that follow.
+	int32_t high, low;
+	uint32_t bits;
+	BitReader reader(packet);
+	EXPECT_TRUE((reader.SerializeRanged<0, 100>(high)));
+	EXPECT_TRUE((reader.SerializeRanged<0, 100>(low)));
+	EXPECT_TRUE(reader.ReadBits(bits, 2));
+	EXPECT_EQ(high, 100);
+	EXPECT_EQ(low, 0);
+	EXPECT_EQ(bits, 3u);
+}
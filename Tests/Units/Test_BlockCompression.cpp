@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <Bitmaps/BlockCompression.hpp>
+#include <Bitmaps/Ktx2/Ktx2Texture.hpp>
+#include <Bitmaps/Mipmaps.hpp>
+
+static acid::Bitmap CreateGradient(const acid::Vector2ui &size) {
+	acid::Bitmap bitmap(size, 4);
+	auto data = bitmap.GetData().get();
+
+	for (uint32_t y = 0; y < size.y; y++) {
+		for (uint32_t x = 0; x < size.x; x++) {
+			// Channels change together, as in most texture blocks, so the colours of a block lie close to a line.
+			auto value = (x + y) * 255 / (size.x + size.y - 2);
+			auto texel = data + (y * size.x + x) * 4;
+			texel[0] = static_cast<uint8_t>(value);
+			texel[1] = static_cast<uint8_t>(value / 2 + 64);
+			texel[2] = 128;
+			texel[3] = static_cast<uint8_t>(255 - value);
+		}
+	}
+
+	return bitmap;
+}
+
+static double MeanError(const acid::Bitmap &a, const acid::Bitmap &b) {
+	double error = 0.0;
+	for (uint32_t i = 0; i < a.GetLength(); i++)
+		error += std::abs(a.GetData()[i] - b.GetData()[i]);
+	return error / a.GetLength();
+}
+
+TEST(Mipmaps, levels) {
+	ASSERT_EQ(acid::Mipmaps::GetLevelCount({256, 64}), 9);
+	ASSERT_EQ(acid::Mipmaps::GetLevelSize({256, 64}, 7), acid::Vector2ui(2, 1));
+
+	for (auto filter : {acid::Mipmaps::Filter::Box, acid::Mipmaps::Filter::Kaiser}) {
+		acid::Bitmap flat(acid::Vector2ui(37, 20), 4);
+		std::fill(flat.GetData().get(), flat.GetData().get() + flat.GetLength(), 200);
+
+		auto levels = acid::Mipmaps::Generate(flat, filter);
+		ASSERT_EQ(levels.size(), 5);
+		ASSERT_EQ(levels.back().GetSize(), acid::Vector2ui(1, 1));
+
+		// Filters are normalized, so a flat image stays flat.
+		for (const auto &level : levels) {
+			for (uint32_t i = 0; i < level.GetLength(); i++)
+				ASSERT_EQ(level.GetData()[i], 200);
+		}
+	}
+
+	auto box = acid::Mipmaps::Downsample(CreateGradient({4, 4}), {2, 2}, acid::Mipmaps::Filter::Box);
+	ASSERT_EQ(box.GetData()[0], 42);
+}
+
+TEST(BlockCompression, roundTrip) {
+	auto bitmap = CreateGradient({30, 18});
+
+	ASSERT_EQ(acid::BlockCompression::GetLength(acid::BlockCompression::Format::BC1, {30, 18}), 8 * 8 * 5);
+	ASSERT_EQ(acid::BlockCompression::GetLength(acid::BlockCompression::Format::BC7, {30, 18}), 16 * 8 * 5);
+
+	for (auto format : {acid::BlockCompression::Format::RGBA8, acid::BlockCompression::Format::BC3, acid::BlockCompression::Format::BC7}) {
+		auto encoded = acid::BlockCompression::Encode(bitmap, format);
+		ASSERT_EQ(encoded.size(), acid::BlockCompression::GetLength(format, bitmap.GetSize()));
+
+		auto decoded = acid::BlockCompression::Decode(encoded.data(), bitmap.GetSize(), format);
+		ASSERT_LT(MeanError(bitmap, decoded), format == acid::BlockCompression::Format::RGBA8 ? 0.001 : 3.0);
+	}
+
+	// Punch through alpha keeps opaque texels opaque and transparent texels transparent.
+	auto bc1 = acid::BlockCompression::Encode(bitmap, acid::BlockCompression::Format::BC1);
+	auto decoded = acid::BlockCompression::Decode(bc1.data(), bitmap.GetSize(), acid::BlockCompression::Format::BC1);
+	for (uint32_t i = 0; i < bitmap.GetLength(); i += 4)
+		ASSERT_EQ(decoded.GetData()[i + 3], bitmap.GetData()[i + 3] >= 128 ? 255 : 0);
+}
+
+TEST(Ktx2Texture, writeLoad) {
+	auto filename = std::filesystem::temp_directory_path() / "AcidTestTexture.ktx2";
+	acid::Ktx2Texture texture(CreateGradient({64, 32}), acid::BlockCompression::Format::BC7, true);
+	ASSERT_EQ(texture.GetLevels().size(), 7);
+	texture.Write(filename);
+
+	acid::Ktx2Texture loaded(filename);
+	std::filesystem::remove(filename);
+
+	ASSERT_TRUE(loaded);
+	ASSERT_EQ(loaded.GetFormat(), acid::BlockCompression::Format::BC7);
+	ASSERT_TRUE(loaded.IsSrgb());
+	ASSERT_EQ(loaded.GetVkFormat(), 146);
+	ASSERT_EQ(loaded.GetLevels().size(), texture.GetLevels().size());
+
+	for (std::size_t i = 0; i < loaded.GetLevels().size(); i++) {
+		ASSERT_EQ(loaded.GetLevels()[i].size, texture.GetLevels()[i].size);
+		ASSERT_EQ(loaded.GetLevels()[i].data, texture.GetLevels()[i].data);
+	}
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include <Physics/CollisionCache.hpp>
+
+using namespace acid;
+
+/**
+ * Points the cache at an empty folder for the length of a test.
+ */
+class CacheDirectory {
+public:
+	CacheDirectory() :
+		previous(CollisionCache::GetDirectory()),
+		directory(std::filesystem::temp_directory_path() / "Test_CollisionCache") {
+		std::filesystem::remove_all(directory);
+		CollisionCache::SetDirectory(directory);
+	}
+
+	~CacheDirectory() {
+		CollisionCache::SetDirectory(previous);
+		std::filesystem::remove_all(directory);
+	}
+
+	std::filesystem::path previous;
+	std::filesystem::path directory;
+};
+
+TEST(CollisionCache, hash) {
+	std::vector<Vector3f> positions = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+	std::vector<uint32_t> indices = {0, 1, 2};
+	auto hash = CollisionCache::Hash(positions, indices);
+
+	EXPECT_EQ(hash, CollisionCache::Hash(positions, indices));
+	EXPECT_NE(hash, CollisionCache::Hash(positions, {0, 2, 1}));
+
+	positions[2].y = 2.0f;
+	EXPECT_NE(hash, CollisionCache::Hash(positions, indices));
+}
+
+TEST(CollisionCache, storeAndLoad) {
+	CacheDirectory cacheDirectory;
+	std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+
+	EXPECT_FALSE(CollisionCache::Load("hull", 1, 42));
+	ASSERT_TRUE(CollisionCache::Store("hull", 1, 42, data));
+
+	auto loaded = CollisionCache::Load("hull", 1, 42);
+	ASSERT_TRUE(loaded);
+	EXPECT_EQ(*loaded, data);
+
+	// Another version, kind or hash is not found.
+	EXPECT_FALSE(CollisionCache::Load("hull", 2, 42));
+	EXPECT_FALSE(CollisionCache::Load("bvh", 1, 42));
+	EXPECT_FALSE(CollisionCache::Load("hull", 1, 43));
+}
+
+TEST(CollisionCache, damaged) {
+	CacheDirectory cacheDirectory;
+	ASSERT_TRUE(CollisionCache::Store("bvh", 1, 7, std::vector<uint8_t>(64, 0xAB)));
+
+	auto filename = *std::filesystem::directory_iterator(cacheDirectory.directory);
+
+	{
+		std::fstream file(filename.path(), std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(-1, std::ios::end);
+		file.put(0x00);
+	}
+
+	EXPECT_FALSE(CollisionCache::Load("bvh", 1, 7));
+
+	// Files cut short are ignored too.
+	std::filesystem::resize_file(filename.path(), 10);
+	EXPECT_FALSE(CollisionCache::Load("bvh", 1, 7));
+}
+
+TEST(CollisionCache, disabled) {
+	CacheDirectory cacheDirectory;
+	CollisionCache::SetDirectory({});
+
+	EXPECT_FALSE(CollisionCache::Store("hull", 1, 42, {1, 2, 3}));
+	EXPECT_FALSE(CollisionCache::Load("hull", 1, 42));
+}
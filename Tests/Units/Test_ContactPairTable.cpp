@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <Physics/ContactPairTable.hpp>
+
+using namespace acid;
+
+TEST(ContactPairTable, startedAndEnded) {
+	int objects[4];
+	ContactPairTable<int> table;
+	std::vector<ContactPairTable<int>::Pair> ended;
+
+	table.Update();
+	EXPECT_TRUE(table.Insert(&objects[0], &objects[1]));
+	EXPECT_TRUE(table.Insert(&objects[2], &objects[3]));
+	// Pairs are the same whichever way round, and only new once per update.
+	EXPECT_FALSE(table.Insert(&objects[1], &objects[0]));
+	EXPECT_EQ(table.GetSize(), 2u);
+	table.GetEnded(ended);
+	EXPECT_TRUE(ended.empty());
+
+	table.Update();
+	EXPECT_FALSE(table.Insert(&objects[1], &objects[0]));
+	EXPECT_TRUE(table.Insert(&objects[1], &objects[2]));
+	table.GetEnded(ended);
+	ASSERT_EQ(ended.size(), 1u);
+	EXPECT_EQ(ended[0].first, &objects[2]);
+	EXPECT_EQ(ended[0].second, &objects[3]);
+	EXPECT_TRUE(table.Contains(&objects[2], &objects[1]));
+	EXPECT_FALSE(table.Contains(&objects[2], &objects[3]));
+
+	// Nothing in contact, every pair ends.
+	table.Update();
+	ended.clear();
+	table.GetEnded(ended);
+	EXPECT_EQ(ended.size(), 2u);
+
+	table.Update();
+	ended.clear();
+	table.GetEnded(ended);
+	EXPECT_TRUE(ended.empty());
+	EXPECT_TRUE(table.Insert(&objects[0], &objects[1]));
+}
+
+TEST(ContactPairTable, growAndChurn) {
+	// Each update a window of pairs slides along, so some pairs start, some stay and some end.
+	std::vector<int> objects(2001);
+	ContactPairTable<int> table(4);
+	constexpr int Window = 1000, Slide = 100;
+
+	for (int update = 0; update < 10; update++) {
+		table.Update();
+		int started = 0;
+
+		for (int i = update * Slide; i < update * Slide + Window; i++) {
+			if (table.Insert(&objects[i], &objects[i + 1]))
+				started++;
+		}
+
+		std::vector<ContactPairTable<int>::Pair> ended;
+		table.GetEnded(ended);
+		EXPECT_EQ(table.GetSize(), static_cast<std::size_t>(Window));
+		EXPECT_EQ(started, update == 0 ? Window : Slide);
+		EXPECT_EQ(ended.size(), update == 0 ? 0u : static_cast<std::size_t>(Slide));
+
+		for (const auto &[a, b] : ended)
+			EXPECT_LT(a - objects.data(), update * Slide);
+	}
+
+	EXPECT_GE(table.GetCapacity(), static_cast<std::size_t>(Window));
+
+	table.Clear();
+	EXPECT_EQ(table.GetSize(), 0u);
+	EXPECT_TRUE(table.Insert(&objects[1000], &objects[1001]));
+}
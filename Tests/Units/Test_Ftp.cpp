@@ -0,0 +1,285 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <Network/Ftp/Ftp.hpp>
+#include <Network/Tcp/TcpListener.hpp>
+#include <Utils/String.hpp>
+
+using namespace acid;
+
+/**
+ * A small FTP server on loopback serving files from a local directory, each session is served on its own thread.
+ * Supports passive mode, retrieving, storing, and resuming with REST.
+ */
+class LoopbackFtpServer {
+public:
+	explicit LoopbackFtpServer(std::filesystem::path root) :
+		root(std::move(root)) {
+		listener.Listen(0, IpAddress::LocalHost);
+		listener.SetBlocking(false);
+
+		acceptThread = std::thread([this]() {
+			while (!stop) {
+				auto socket = std::make_unique<TcpSocket>();
+
+				if (listener.Accept(*socket) != Socket::Status::Done) {
+					std::this_thread::sleep_for(1ms);
+					continue;
+				}
+
+				socket->SetBlocking(true);
+				sessionThreads.emplace_back(&LoopbackFtpServer::Serve, this, std::move(socket));
+			}
+		});
+	}
+
+	~LoopbackFtpServer() {
+		stop = true;
+		acceptThread.join();
+
+		for (auto &thread : sessionThreads)
+			thread.join();
+	}
+
+	uint16_t GetPort() const { return listener.GetLocalPort(); }
+
+	std::atomic<uint32_t> peakSessions = 0;
+	std::atomic<uint32_t> restCount = 0;
+
+private:
+	static void Reply(TcpSocket &socket, const std::string &line) {
+		auto data = line + "\r\n";
+		socket.Send(data.c_str(), data.size());
+	}
+
+	void Serve(std::unique_ptr<TcpSocket> socket) {
+		auto active = ++activeSessions;
+		for (auto peak = peakSessions.load(); active > peak && !peakSessions.compare_exchange_weak(peak, active);) {
+		}
+
+		Reply(*socket, "220 Ready");
+
+		std::string buffer;
+		char data[1024];
+		std::size_t received;
+		TcpListener passive;
+		uint64_t rest = 0;
+
+		while (socket->Receive(data, sizeof(data), received) == Socket::Status::Done) {
+			buffer.append(data, received);
+			std::size_t end;
+
+			while ((end = buffer.find("\r\n")) != std::string::npos) {
+				auto line = buffer.substr(0, end);
+				buffer.erase(0, end + 2);
+				auto space = line.find(' ');
+				auto command = line.substr(0, space);
+				auto parameter = space != std::string::npos ? line.substr(space + 1) : "";
+				auto path = root / std::filesystem::path(parameter).relative_path();
+
+				if (command == "USER") {
+					Reply(*socket, "331 Need password");
+				} else if (command == "PASS") {
+					Reply(*socket, "230 Logged in");
+				} else if (command == "TYPE" || command == "NOOP" || command == "CWD") {
+					Reply(*socket, "200 Ok");
+				} else if (command == "PWD") {
+					Reply(*socket, "257 \"/\"");
+				} else if (command == "PASV") {
+					passive.Close();
+					passive.Listen(0, IpAddress::LocalHost);
+					auto port = passive.GetLocalPort();
+					Reply(*socket, "227 Entering Passive Mode (127,0,0,1," + String::To(port >> 8) + "," + String::To(port & 0xff) + ")");
+				} else if (command == "REST") {
+					rest = String::From<uint64_t>(parameter);
+					restCount++;
+					Reply(*socket, "350 Restarting at " + parameter);
+				} else if (command == "SIZE") {
+					if (std::filesystem::exists(path))
+						Reply(*socket, "213 " + String::To(std::filesystem::file_size(path)));
+					else
+						Reply(*socket, "550 No such file");
+				} else if (command == "RETR") {
+					std::ifstream file(path, std::ios::binary);
+					if (!file) {
+						Reply(*socket, "550 No such file");
+						continue;
+					}
+
+					Reply(*socket, "150 Opening data connection");
+					TcpSocket dataSocket;
+					passive.Accept(dataSocket);
+					file.seekg(static_cast<std::streamoff>(rest));
+					std::vector<char> block(16 * 1024);
+
+					while (file.read(block.data(), block.size()) || file.gcount() > 0)
+						dataSocket.Send(block.data(), static_cast<std::size_t>(file.gcount()));
+
+					dataSocket.Disconnect();
+					rest = 0;
+					Reply(*socket, "226 Transfer complete");
+				} else if (command == "STOR" || command == "APPE") {
+					Reply(*socket, "150 Opening data connection");
+					TcpSocket dataSocket;
+					passive.Accept(dataSocket);
+
+					auto mode = command == "APPE" ? std::ios::app : rest != 0 ? std::ios::in : std::ios::trunc;
+					std::fstream file(path, std::ios::out | std::ios::binary | mode);
+					file.seekp(static_cast<std::streamoff>(rest));
+
+					while (dataSocket.Receive(data, sizeof(data), received) == Socket::Status::Done)
+						file.write(data, static_cast<std::streamsize>(received));
+
+					rest = 0;
+					Reply(*socket, "226 Transfer complete");
+				} else if (command == "QUIT") {
+					Reply(*socket, "221 Bye");
+					activeSessions--;
+					return;
+				} else {
+					Reply(*socket, "502 Not implemented");
+				}
+			}
+		}
+
+		activeSessions--;
+	}
+
+	std::filesystem::path root;
+	TcpListener listener;
+	std::atomic<uint32_t> activeSessions = 0;
+	std::atomic<bool> stop = false;
+	std::thread acceptThread;
+	std::vector<std::thread> sessionThreads;
+};
+
+/**
+ * Directories for the server and client, removed afterwards.
+ */
+class FtpDirectories {
+public:
+	FtpDirectories() :
+		base(std::filesystem::temp_directory_path() / "Test_Ftp"),
+		remote(base / "remote"),
+		local(base / "local") {
+		std::filesystem::remove_all(base);
+		std::filesystem::create_directories(remote);
+		std::filesystem::create_directories(local);
+	}
+
+	~FtpDirectories() {
+		std::filesystem::remove_all(base);
+	}
+
+	std::filesystem::path base, remote, local;
+};
+
+static std::string MakeContents(std::size_t size, uint32_t seed) {
+	std::string contents(size, '\0');
+
+	for (auto &c : contents) {
+		seed = seed * 1664525 + 1013904223;
+		c = static_cast<char>(seed >> 24);
+	}
+
+	return contents;
+}
+
+static void WriteFile(const std::filesystem::path &path, const std::string &contents) {
+	std::ofstream(path, std::ios::binary).write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+static std::string ReadFile(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+TEST(Ftp, downloadUpload) {
+	FtpDirectories directories;
+	LoopbackFtpServer server(directories.remote);
+	auto contents = MakeContents(1024 * 1024 + 17, 1);
+	WriteFile(directories.remote / "asset.bin", contents);
+
+	Ftp ftp;
+	ASSERT_TRUE(ftp.Connect(IpAddress::LocalHost, server.GetPort()).IsOk());
+	ASSERT_TRUE(ftp.Login().IsOk());
+
+	EXPECT_TRUE(ftp.Download("asset.bin", directories.local.string()).IsOk());
+	EXPECT_EQ(ReadFile(directories.local / "asset.bin"), contents);
+
+	std::filesystem::rename(directories.local / "asset.bin", directories.local / "copy.bin");
+	EXPECT_TRUE(ftp.Upload((directories.local / "copy.bin").string(), "/").IsOk());
+	EXPECT_EQ(ReadFile(directories.remote / "copy.bin"), contents);
+	EXPECT_EQ(server.restCount, 0u);
+}
+
+TEST(Ftp, resume) {
+	FtpDirectories directories;
+	LoopbackFtpServer server(directories.remote);
+	auto contents = MakeContents(1024 * 1024, 2);
+	WriteFile(directories.remote / "download.bin", contents);
+	WriteFile(directories.local / "download.bin", contents.substr(0, 300000));
+	WriteFile(directories.local / "upload.bin", contents);
+	WriteFile(directories.remote / "upload.bin", contents.substr(0, 400000));
+
+	Ftp ftp;
+	ASSERT_TRUE(ftp.Connect(IpAddress::LocalHost, server.GetPort()).IsOk());
+	ASSERT_TRUE(ftp.Login().IsOk());
+
+	auto transfers = ftp.Transfer({
+		{FtpTransfer::Direction::Download, "download.bin", directories.local.string(), FtpDataChannel::Mode::Binary, true},
+		{FtpTransfer::Direction::Upload, (directories.local / "upload.bin").string(), "/", FtpDataChannel::Mode::Binary, true}
+	}, 1);
+
+	ASSERT_EQ(transfers.size(), 2u);
+	EXPECT_TRUE(transfers[0].GetResponse().IsOk());
+	EXPECT_EQ(transfers[0].GetOffset(), 300000u);
+	EXPECT_EQ(transfers[0].GetTransferred(), contents.size() - 300000u);
+	EXPECT_EQ(ReadFile(directories.local / "download.bin"), contents);
+
+	EXPECT_TRUE(transfers[1].GetResponse().IsOk());
+	EXPECT_EQ(transfers[1].GetOffset(), 400000u);
+	EXPECT_EQ(transfers[1].GetTransferred(), contents.size() - 400000u);
+	EXPECT_EQ(ReadFile(directories.remote / "upload.bin"), contents);
+	EXPECT_EQ(server.restCount, 2u);
+}
+
+TEST(Ftp, parallel) {
+	FtpDirectories directories;
+	LoopbackFtpServer server(directories.remote);
+	constexpr uint32_t FileCount = 32;
+	std::vector<FtpTransfer> uploads, downloads;
+
+	for (uint32_t i = 0; i < FileCount; i++) {
+		auto filename = "file" + String::To(i) + ".bin";
+		WriteFile(directories.local / filename, MakeContents(64 * 1024 * (i % 4 + 1), i));
+		uploads.emplace_back(FtpTransfer::Direction::Upload, (directories.local / filename).string(), "/");
+		downloads.emplace_back(FtpTransfer::Direction::Download, filename, (directories.base / "downloaded").string());
+	}
+
+	std::filesystem::create_directories(directories.base / "downloaded");
+
+	Ftp ftp;
+	ASSERT_TRUE(ftp.Connect(IpAddress::LocalHost, server.GetPort()).IsOk());
+	ASSERT_TRUE(ftp.Login().IsOk());
+
+	for (const auto &transfer : ftp.Transfer(uploads, 4)) {
+		EXPECT_TRUE(transfer.GetResponse().IsOk());
+		EXPECT_EQ(transfer.GetTransferred(), std::filesystem::file_size(transfer.GetFile()));
+		EXPECT_GT(transfer.GetThroughput(), 0.0);
+	}
+
+	EXPECT_EQ(server.peakSessions, 4u);
+
+	for (const auto &transfer : ftp.Transfer(downloads, 4))
+		EXPECT_TRUE(transfer.GetResponse().IsOk());
+
+	for (uint32_t i = 0; i < FileCount; i++) {
+		auto filename = "file" + String::To(i) + ".bin";
+		EXPECT_EQ(ReadFile(directories.base / "downloaded" / filename), MakeContents(64 * 1024 * (i % 4 + 1), i));
+	}
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <fstream>
+
+#include <Physics/HeightTileFile.hpp>
+
+using namespace acid;
+
+static float GetHeight(uint32_t x, uint32_t z) {
+	return 20.0f * std::sin(x * 0.05f) * std::cos(z * 0.03f) - 5.0f;
+}
+
+TEST(HeightTileFile, writeAndRead) {
+	constexpr uint32_t TileSize = 16, TilesX = 3, TilesZ = 2, LodCount = 3;
+	constexpr uint32_t Width = TileSize * TilesX + 1, Length = TileSize * TilesZ + 1;
+
+	std::vector<float> heights(Width * Length);
+	for (uint32_t z = 0; z < Length; z++) {
+		for (uint32_t x = 0; x < Width; x++)
+			heights[z * Width + x] = GetHeight(x, z);
+	}
+
+	auto filename = std::filesystem::temp_directory_path() / "Test_HeightTileFile.aht";
+	ASSERT_TRUE(HeightTileFile::Write(filename, heights, Width, Length, 2.0f, TileSize, LodCount));
+
+	HeightTileFile file;
+	ASSERT_TRUE(file.Open(filename));
+	EXPECT_EQ(file.GetHeader().tileSize, TileSize);
+	EXPECT_EQ(file.GetHeader().tilesX, TilesX);
+	EXPECT_EQ(file.GetHeader().tilesZ, TilesZ);
+	EXPECT_EQ(file.GetHeader().lodCount, LodCount);
+	EXPECT_FLOAT_EQ(file.GetHeader().spacing, 2.0f);
+
+	auto heightScale = file.GetHeader().heightScale;
+	std::vector<int16_t> tile;
+
+	for (uint32_t tz = 0; tz < TilesZ; tz++) {
+		for (uint32_t tx = 0; tx < TilesX; tx++) {
+			EXPECT_EQ(file.GetTile(tx, tz).offset % HeightTileFile::PageSize, 0u);
+
+			for (uint32_t lod = 0; lod < LodCount; lod++) {
+				ASSERT_TRUE(file.ReadTile(tx, tz, lod, tile));
+				auto samples = file.GetSampleCount(lod);
+				ASSERT_EQ(tile.size(), samples * samples);
+
+				for (uint32_t j = 0; j < samples; j++) {
+					for (uint32_t i = 0; i < samples; i++) {
+						auto height = tile[j * samples + i] * heightScale;
+						EXPECT_NEAR(height, GetHeight(tx * TileSize + (i << lod), tz * TileSize + (j << lod)), heightScale);
+						EXPECT_GE(height, file.GetTile(tx, tz).minHeight);
+						EXPECT_LE(height, file.GetTile(tx, tz).maxHeight);
+					}
+				}
+			}
+		}
+	}
+
+	EXPECT_FALSE(file.ReadTile(TilesX, 0, 0, tile));
+	EXPECT_FALSE(file.ReadTile(0, 0, LodCount, tile));
+	std::filesystem::remove(filename);
+}
+
+TEST(HeightTileFile, invalidSizes) {
+	auto filename = std::filesystem::temp_directory_path() / "Test_HeightTileFile_invalid.aht";
+	std::vector<float> heights(20 * 20);
+
+	// Not a power of two, not a whole number of tiles, and more levels than the tile has.
+	EXPECT_FALSE(HeightTileFile::Write(filename, heights, 20, 20, 1.0f, 19, 1));
+	EXPECT_FALSE(HeightTileFile::Write(filename, heights, 20, 20, 1.0f, 8, 1));
+	EXPECT_FALSE(HeightTileFile::Write(filename, std::vector<float>(17 * 17), 17, 17, 1.0f, 8, 5));
+	EXPECT_FALSE(std::filesystem::exists(filename));
+
+	HeightTileFile file;
+	EXPECT_FALSE(file.Open(filename));
+}
+
+TEST(HeightTileFile, openInvalid) {
+	auto filename = std::filesystem::temp_directory_path() / "Test_HeightTileFile_openInvalid.aht";
+	std::vector<float> heights(17 * 17);
+	ASSERT_TRUE(HeightTileFile::Write(filename, heights, 17, 17, 1.0f, 16, 3));
+
+	std::ifstream is(filename, std::ios::binary);
+	std::vector<char> valid((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	is.close();
+
+	// Writes the file with one little endian value changed, then tries to open it.
+	auto openPatched = [&](std::size_t offset, uint64_t value, std::size_t length) {
+		auto data = valid;
+		for (std::size_t i = 0; i < length; i++)
+			data[offset + i] = static_cast<char>(value >> (i * 8));
+
+		std::ofstream os(filename, std::ios::binary);
+		os.write(data.data(), static_cast<std::streamsize>(data.size()));
+		os.close();
+
+		HeightTileFile file;
+		return file.Open(filename);
+	};
+
+	EXPECT_TRUE(openPatched(8, 16, 4));
+	// A tile size of zero or not a power of two, no levels or more levels than the tile size has.
+	EXPECT_FALSE(openPatched(8, 0, 4));
+	EXPECT_FALSE(openPatched(8, 12, 4));
+	EXPECT_FALSE(openPatched(20, 0, 4));
+	EXPECT_FALSE(openPatched(20, 6, 4));
+	// A table larger than the file, and a tile past the end of the file.
+	EXPECT_FALSE(openPatched(12, 0xFFFFFFFF, 4));
+	EXPECT_FALSE(openPatched(64, valid.size(), 8));
+	EXPECT_FALSE(openPatched(64, ~0ull, 8));
+	std::filesystem::remove(filename);
+}
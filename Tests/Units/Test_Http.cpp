@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <Network/Http/Http.hpp>
+#include <Network/Tcp/TcpListener.hpp>
+#include <Utils/String.hpp>
+
+using namespace acid;
+
+/**
+ * A small HTTP/1.1 server on loopback, each connection is served on its own thread.
+ * The body of each response depends on the requested URI:
+ * \li /chunked is sent in chunks.
+ * \li /large is a megabyte long.
+ * \li /continue is preceded by interim responses.
+ * \li anything else is the URI itself.
+ */
+class LoopbackServer {
+public:
+	/**
+	 * Creates a new server.
+	 * @param closeSilently If connections are closed after each response without telling the client.
+	 */
+	explicit LoopbackServer(bool closeSilently = false) :
+		closeSilently(closeSilently) {
+		listener.Listen(0, IpAddress::LocalHost);
+		listener.SetBlocking(false);
+
+		acceptThread = std::thread([this]() {
+			while (!stop) {
+				auto socket = std::make_unique<TcpSocket>();
+
+				if (listener.Accept(*socket) != Socket::Status::Done) {
+					std::this_thread::sleep_for(1ms);
+					continue;
+				}
+
+				acceptedCount++;
+				socket->SetBlocking(true);
+				connectionThreads.emplace_back(&LoopbackServer::Serve, this, std::move(socket));
+			}
+		});
+	}
+
+	~LoopbackServer() {
+		stop = true;
+		acceptThread.join();
+
+		for (auto &thread : connectionThreads)
+			thread.join();
+	}
+
+	uint16_t GetPort() const { return listener.GetLocalPort(); }
+
+	std::atomic<uint32_t> acceptedCount = 0;
+	std::atomic<uint32_t> requestCount = 0;
+
+private:
+	void Serve(std::unique_ptr<TcpSocket> socket) {
+		std::string buffer;
+		char data[4096];
+		std::size_t received;
+
+		while (socket->Receive(data, sizeof(data), received) == Socket::Status::Done) {
+			buffer.append(data, received);
+
+			// Answers every complete request received, pipelined requests arrive together.
+			std::size_t end;
+
+			while ((end = buffer.find("\r\n\r\n")) != std::string::npos) {
+				auto uri = buffer.substr(buffer.find(' ') + 1);
+				uri = uri.substr(0, uri.find(' '));
+				buffer.erase(0, end + 4);
+				requestCount++;
+
+				auto response = Respond(uri);
+				socket->Send(response.c_str(), response.size());
+
+				if (closeSilently) {
+					socket->Disconnect();
+					return;
+				}
+			}
+		}
+	}
+
+	static std::string Respond(const std::string &uri) {
+		if (uri == "/chunked") {
+			return "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+				"5\r\nHello\r\n"
+				"7;name=value\r\n, world\r\n"
+				"0\r\nExpires: never\r\n\r\n";
+		}
+
+		// Interim responses are sent before the final one.
+		std::string interim = uri == "/continue" ? "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 102 Processing\r\nX-Interim: true\r\n\r\n" : "";
+		std::string body = uri == "/large" ? std::string(1024 * 1024, 'x') : uri;
+		return interim + "HTTP/1.1 200 OK\r\nContent-Length: " + String::To(body.size()) + "\r\n\r\n" + body;
+	}
+
+	TcpListener listener;
+	bool closeSilently;
+	std::atomic<bool> stop = false;
+	std::thread acceptThread;
+	std::vector<std::thread> connectionThreads;
+};
+
+TEST(Http, keepAlive) {
+	LoopbackServer server;
+	Http http("http://127.0.0.1", server.GetPort());
+
+	for (uint32_t i = 0; i < 50; i++) {
+		auto uri = "/asset/" + String::To(i);
+		auto response = http.SendRequest(HttpRequest(uri));
+		EXPECT_EQ(response.GetStatus(), HttpResponse::Status::Ok);
+		EXPECT_EQ(response.GetBody(), uri);
+	}
+
+	EXPECT_EQ(server.acceptedCount, 1u);
+	EXPECT_EQ(http.GetLatency().GetCount(), 50u);
+}
+
+TEST(Http, chunked) {
+	LoopbackServer server;
+	Http http("http://127.0.0.1", server.GetPort());
+
+	auto response = http.SendRequest(HttpRequest("/chunked"));
+	EXPECT_EQ(response.GetStatus(), HttpResponse::Status::Ok);
+	EXPECT_EQ(response.GetBody(), "Hello, world");
+	EXPECT_EQ(response.GetField("expires"), "never");
+
+	// The connection is still usable after the chunks.
+	EXPECT_EQ(http.SendRequest(HttpRequest("/after")).GetBody(), "/after");
+	EXPECT_EQ(server.acceptedCount, 1u);
+}
+
+TEST(Http, interim) {
+	LoopbackServer server;
+	Http http("http://127.0.0.1", server.GetPort());
+
+	auto response = http.SendRequest(HttpRequest("/continue"));
+	EXPECT_EQ(response.GetStatus(), HttpResponse::Status::Ok);
+	EXPECT_EQ(response.GetBody(), "/continue");
+	EXPECT_TRUE(response.GetField("x-interim").empty());
+
+	// The connection is still usable after the interim responses.
+	EXPECT_EQ(http.SendRequest(HttpRequest("/after")).GetBody(), "/after");
+	EXPECT_EQ(server.acceptedCount, 1u);
+}
+
+TEST(Http, streaming) {
+	LoopbackServer server;
+	Http http("http://127.0.0.1", server.GetPort());
+
+	std::size_t size = 0;
+	uint32_t parts = 0;
+	auto response = http.SendRequest(HttpRequest("/large"), [&](const HttpResponse &response, const char *data, std::size_t length) {
+		EXPECT_EQ(response.GetStatus(), HttpResponse::Status::Ok);
+		size += length;
+		parts++;
+	});
+
+	EXPECT_EQ(response.GetStatus(), HttpResponse::Status::Ok);
+	EXPECT_TRUE(response.GetBody().empty());
+	EXPECT_EQ(size, 1024u * 1024u);
+	EXPECT_GT(parts, 1u);
+
+	auto filename = std::filesystem::temp_directory_path() / "Test_Http_download.bin";
+	http.Download(HttpRequest("/large"), filename);
+	EXPECT_EQ(std::filesystem::file_size(filename), 1024u * 1024u);
+	std::filesystem::remove(filename);
+}
+
+TEST(Http, pipelining) {
+	LoopbackServer server;
+	Http http("http://127.0.0.1", server.GetPort());
+
+	std::vector<HttpRequest> requests;
+	for (uint32_t i = 0; i < 20; i++)
+		requests.emplace_back(i % 5 == 0 ? "/chunked" : "/item/" + String::To(i));
+
+	auto responses = http.SendRequests(requests);
+	ASSERT_EQ(responses.size(), requests.size());
+
+	for (uint32_t i = 0; i < responses.size(); i++)
+		EXPECT_EQ(responses[i].GetBody(), i % 5 == 0 ? "Hello, world" : "/item/" + String::To(i));
+
+	EXPECT_EQ(server.acceptedCount, 1u);
+}
+
+TEST(Http, async) {
+	LoopbackServer server;
+	Http http("http://127.0.0.1", server.GetPort());
+
+	std::atomic<uint32_t> completed = 0;
+	std::vector<std::future<HttpResponse>> futures;
+
+	for (uint32_t i = 0; i < 10; i++) {
+		futures.emplace_back(http.SendRequestAsync(HttpRequest("/async/" + String::To(i)), [&](const HttpResponse &response) {
+			completed++;
+		}));
+	}
+
+	for (uint32_t i = 0; i < futures.size(); i++)
+		EXPECT_EQ(futures[i].get().GetBody(), "/async/" + String::To(i));
+
+	EXPECT_EQ(completed, 10u);
+}
+
+TEST(Http, closedConnection) {
+	// Pooled connections are closed by the server without telling the client, requests must be sent again on a new connection.
+	LoopbackServer server(true);
+	Http http("http://127.0.0.1", server.GetPort());
+
+	for (uint32_t i = 0; i < 5; i++) {
+		auto response = http.SendRequest(HttpRequest("/retry"));
+		EXPECT_EQ(response.GetStatus(), HttpResponse::Status::Ok);
+		EXPECT_EQ(response.GetBody(), "/retry");
+	}
+
+	EXPECT_EQ(server.requestCount, 5u);
+}
+
+TEST(Http, closedConnectionPost) {
+	// Requests that are not idempotent are not sent again, the server may have acted on them.
+	LoopbackServer server(true);
+	Http http("http://127.0.0.1", server.GetPort());
+
+	EXPECT_EQ(http.SendRequest(HttpRequest("/first", HttpRequest::Method::Post)).GetBody(), "/first");
+	EXPECT_NE(http.SendRequest(HttpRequest("/second", HttpRequest::Method::Post)).GetStatus(), HttpResponse::Status::Ok);
+	EXPECT_EQ(server.requestCount, 1u);
+}
+
+TEST(Http, droppedAfterResponse) {
+	// The connection drops after the first pipelined response, the POST after it is not sent again.
+	LoopbackServer server(true);
+	Http http("http://127.0.0.1", server.GetPort());
+
+	auto responses = http.SendRequests({HttpRequest("/first"), HttpRequest("/second", HttpRequest::Method::Post)});
+	ASSERT_EQ(responses.size(), 2u);
+	EXPECT_EQ(responses[0].GetBody(), "/first");
+	EXPECT_NE(responses[1].GetStatus(), HttpResponse::Status::Ok);
+	EXPECT_EQ(server.requestCount, 1u);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <Lights/LightClusters.hpp>
+#include <Maths/Maths.hpp>
+
+using namespace acid;
+
+static constexpr float FieldOfView = Maths::Radians(60.0f);
+static constexpr float AspectRatio = 16.0f / 9.0f;
+static constexpr float NearPlane = 0.1f;
+static constexpr float FarPlane = 500.0f;
+
+static std::vector<Vector4f> CreateLights(uint32_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> radius(0.5f, 20.0f);
+	std::vector<Vector4f> lights;
+
+	for (uint32_t i = 0; i < count; i++)
+		lights.emplace_back(position(random), position(random) * 0.1f, position(random), radius(random));
+
+	return lights;
+}
+
+static bool HasLight(const LightClusters &clusters, uint32_t cluster, uint32_t light) {
+	auto lights = clusters.GetLights(cluster);
+	return std::binary_search(lights, lights + clusters.GetLightCount(cluster), light);
+}
+
+TEST(LightClusters, pointsFindTheirLights) {
+	auto viewMatrix = Matrix4::LookAt(Vector3f(5.0f, 2.0f, -3.0f), Vector3f(20.0f, 0.0f, 40.0f), Vector3f::Up);
+	auto lights = CreateLights(800, 1);
+
+	LightClusters clusters;
+	clusters.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, lights);
+	const auto &gridSize = clusters.GetGridSize();
+
+	// Lights in each cluster are in increasing order.
+	for (uint32_t cluster = 0; cluster < clusters.GetClusterCount(); cluster++) {
+		auto first = clusters.GetLights(cluster);
+		EXPECT_TRUE(std::is_sorted(first, first + clusters.GetLightCount(cluster)));
+	}
+
+	// Every point in the view finds each light that reaches it in its cluster, as the deferred shader looks it up.
+	std::mt19937 random(2);
+	std::uniform_real_distribution<float> screen(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> depths(std::log(NearPlane), std::log(FarPlane));
+	auto inverseView = viewMatrix.Inverse();
+	auto tanY = std::tan(0.5f * FieldOfView), tanX = tanY * AspectRatio;
+
+	for (uint32_t i = 0; i < 20000; i++) {
+		auto x = screen(random), y = screen(random), depth = std::exp(depths(random));
+		Vector3f position(inverseView.Transform(Vector4f(x * tanX * depth, y * tanY * depth, -depth, 1.0f)));
+
+		auto tileX = std::min(static_cast<uint32_t>((0.5f * x + 0.5f) * gridSize.x), gridSize.x - 1);
+		auto tileY = std::min(static_cast<uint32_t>((0.5f * y + 0.5f) * gridSize.y), gridSize.y - 1);
+		auto slice = static_cast<int32_t>(std::log(depth) * clusters.GetDepthScale() + clusters.GetDepthBias());
+		EXPECT_EQ(static_cast<uint32_t>(std::clamp(slice, 0, static_cast<int32_t>(gridSize.z) - 1)), clusters.GetSlice(depth));
+		auto cluster = clusters.GetClusterIndex(tileX, tileY, clusters.GetSlice(depth));
+
+		for (uint32_t light = 0; light < lights.size(); light++) {
+			// Points right on the edge of a light may be on either side of a slice boundary.
+			if (position.Distance(Vector3f(lights[light])) < lights[light].w * 0.999f) {
+				EXPECT_TRUE(HasLight(clusters, cluster, light)) << "Light " << light << " is missing from cluster " << cluster;
+			}
+		}
+	}
+}
+
+TEST(LightClusters, lightsOutsideAndEverywhere) {
+	auto viewMatrix = Matrix4::LookAt(Vector3f(), Vector3f(0.0f, 0.0f, -1.0f), Vector3f::Up);
+	std::vector<Vector4f> lights = {
+		{0.0f, 0.0f, 10.0f, 2.0f},
+		{0.0f, 0.0f, -2000.0f, 5.0f},
+		{500.0f, 0.0f, -20.0f, 5.0f},
+		{0.0f, 0.0f, 0.0f, -1.0f},
+		{0.0f, 0.0f, -20.0f, 0.5f}
+	};
+
+	LightClusters clusters(Vector3ui(8, 4, 16));
+	clusters.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, lights);
+
+	std::vector<uint32_t> clusterCounts(lights.size());
+	for (uint32_t cluster = 0; cluster < clusters.GetClusterCount(); cluster++) {
+		for (uint32_t i = 0; i < clusters.GetLightCount(cluster); i++)
+			clusterCounts[clusters.GetLights(cluster)[i]]++;
+	}
+
+	// Behind the camera, past the far plane and off the side of the screen.
+	EXPECT_EQ(clusterCounts[0], 0u);
+	EXPECT_EQ(clusterCounts[1], 0u);
+	EXPECT_EQ(clusterCounts[2], 0u);
+	EXPECT_EQ(clusterCounts[3], clusters.GetClusterCount());
+	// A small light in the middle of the screen reaches the centre tiles of one or two slices.
+	EXPECT_GE(clusterCounts[4], 4u);
+	EXPECT_LE(clusterCounts[4], 8u);
+	EXPECT_TRUE(HasLight(clusters, clusters.GetClusterIndex(4, 2, clusters.GetSlice(20.0f)), 4));
+	EXPECT_EQ(clusters.GetIndexCount(), clusterCounts[3] + clusterCounts[4]);
+}
+
+TEST(LightClusters, threadedMatchesSerial) {
+	auto viewMatrix = Matrix4::LookAt(Vector3f(0.0f, 3.0f, 0.0f), Vector3f(1.0f, 3.0f, 1.0f), Vector3f::Up);
+	auto lights = CreateLights(2000, 3);
+
+	LightClusters serial;
+	serial.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, lights);
+
+	ThreadPool threadPool(3);
+	LightClusters threaded;
+	// Updated twice so the second update reuses the lists of the first.
+	threaded.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, CreateLights(100, 4), &threadPool);
+	threaded.Update(viewMatrix, FieldOfView, AspectRatio, NearPlane, FarPlane, lights, &threadPool);
+
+	ASSERT_EQ(serial.GetIndexCount(), threaded.GetIndexCount());
+
+	for (uint32_t cluster = 0; cluster < serial.GetClusterCount(); cluster++) {
+		ASSERT_EQ(serial.GetLightCount(cluster), threaded.GetLightCount(cluster));
+		EXPECT_TRUE(std::equal(serial.GetLights(cluster), serial.GetLights(cluster) + serial.GetLightCount(cluster), threaded.GetLights(cluster)));
+	}
+}
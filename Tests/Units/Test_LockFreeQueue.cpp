@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <Utils/LockFreeQueue.hpp>
+
+using namespace acid;
+
+TEST(LockFreeQueue, capacity) {
+	LockFreeQueue<uint32_t> queue(3);
+	EXPECT_TRUE(queue.empty());
+	EXPECT_TRUE(queue.push(1));
+	EXPECT_TRUE(queue.push(2));
+	EXPECT_TRUE(queue.push(3));
+	EXPECT_TRUE(queue.full());
+	EXPECT_FALSE(queue.push(4));
+	EXPECT_EQ(queue.size(), 3u);
+
+	uint32_t value;
+	EXPECT_TRUE(queue.pop(value));
+	EXPECT_EQ(value, 1u);
+	EXPECT_TRUE(queue.push(4));
+
+	for (uint32_t expected : {2u, 3u, 4u}) {
+		EXPECT_TRUE(queue.pop(value));
+		EXPECT_EQ(value, expected);
+	}
+
+	EXPECT_FALSE(queue.pop(value));
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueue, threads) {
+	constexpr uint32_t Count = 1000000;
+	LockFreeQueue<std::unique_ptr<uint32_t>> queue(64);
+
+	std::thread producer([&]() {
+		for (uint32_t i = 0; i < Count; i++) {
+			auto value = std::make_unique<uint32_t>(i);
+			while (!queue.push(std::move(value)))
+				std::this_thread::yield();
+		}
+	});
+
+	// Every value arrives once, in order.
+	uint32_t next = 0;
+	std::unique_ptr<uint32_t> value;
+
+	while (next < Count) {
+		if (!queue.pop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		ASSERT_EQ(*value, next);
+		next++;
+	}
+
+	producer.join();
+	EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <Network/NetworkMetrics.hpp>
+#include <Network/Packet.hpp>
+#include <Network/Tcp/TcpListener.hpp>
+#include <Network/Tcp/TcpSocket.hpp>
+#include <Network/Udp/UdpSocket.hpp>
+
+using namespace acid;
+
+TEST(NetworkMetrics, latencyHistogram) {
+	LatencyHistogram histogram;
+	EXPECT_EQ(histogram.GetPercentile(0.5), Time());
+
+	for (int64_t i = 1; i <= 100; i++)
+		histogram.Record(Time::Milliseconds(i));
+
+	EXPECT_EQ(histogram.GetCount(), 100u);
+	EXPECT_EQ(histogram.GetMax(), 100ms);
+	EXPECT_EQ(histogram.GetMean().AsMicroseconds<int64_t>(), 50500);
+
+	// Percentiles are the limit of their bucket, which is at most twice the real value.
+	auto median = histogram.GetPercentile(0.5);
+	EXPECT_GE(median, 50ms);
+	EXPECT_LE(median, 100ms);
+	EXPECT_EQ(histogram.GetPercentile(1.0), 100ms);
+
+	histogram.Reset();
+	EXPECT_EQ(histogram.GetCount(), 0u);
+}
+
+TEST(NetworkMetrics, tcp) {
+	TcpListener listener;
+	ASSERT_EQ(listener.Listen(0, IpAddress::LocalHost), Socket::Status::Done);
+	TcpSocket client, server;
+	ASSERT_EQ(client.Connect(IpAddress::LocalHost, listener.GetLocalPort()), Socket::Status::Done);
+	ASSERT_EQ(listener.Accept(server), Socket::Status::Done);
+
+	SocketMetrics globalBefore(SocketMetrics::Global());
+
+	Packet packet;
+	packet.Append(std::string(1000, 'x').data(), 1000);
+	ASSERT_EQ(client.Send(packet), Socket::Status::Done);
+	ASSERT_EQ(client.Send(packet), Socket::Status::Done);
+
+	EXPECT_EQ(client.GetMetrics().packetsSent, 2u);
+	EXPECT_EQ(client.GetMetrics().bytesSent, 2 * (sizeof(uint32_t) + 1000));
+	EXPECT_EQ(client.GetMetrics().sendCalls, 2u);
+
+	Packet received;
+	ASSERT_EQ(server.Receive(received), Socket::Status::Done);
+	ASSERT_EQ(server.Receive(received), Socket::Status::Done);
+	EXPECT_EQ(server.GetMetrics().packetsReceived, 2u);
+	EXPECT_EQ(server.GetMetrics().bytesReceived, 2 * (sizeof(uint32_t) + 1000));
+
+	// Nothing is waiting, so a non-blocking receive is not ready.
+	server.SetBlocking(false);
+	EXPECT_EQ(server.Receive(received), Socket::Status::NotReady);
+	EXPECT_EQ(server.GetMetrics().notReady, 1u);
+
+	auto changed = SocketMetrics(SocketMetrics::Global()) - globalBefore;
+	EXPECT_GE(changed.bytesSent, 2 * (sizeof(uint32_t) + 1000));
+	EXPECT_GE(changed.packetsReceived, 2u);
+}
+
+TEST(NetworkMetrics, udp) {
+	UdpSocket sender, receiver;
+	ASSERT_EQ(receiver.Bind(0, IpAddress::LocalHost), Socket::Status::Done);
+
+	Packet packet;
+	packet << std::string("datagram");
+	ASSERT_EQ(sender.Send(packet, IpAddress::LocalHost, receiver.GetLocalPort()), Socket::Status::Done);
+	EXPECT_EQ(sender.GetMetrics().packetsSent, 1u);
+	EXPECT_EQ(sender.GetMetrics().bytesSent, packet.GetDataSize());
+
+	Packet received;
+	IpAddress address;
+	uint16_t port;
+	ASSERT_EQ(receiver.Receive(received, address, port), Socket::Status::Done);
+	EXPECT_EQ(receiver.GetMetrics().packetsReceived, 1u);
+	EXPECT_EQ(receiver.GetMetrics().bytesReceived, packet.GetDataSize());
+	EXPECT_EQ(receiver.GetMetrics().errors, 0u);
+}
+
+TEST(NetworkMetrics, packetAllocations) {
+	auto before = Packet::GetAllocationCount();
+
+	Packet packet;
+	packet.Reserve(128);
+	EXPECT_EQ(Packet::GetAllocationCount(), before + 1);
+
+	// Appending within the reserved memory does not allocate.
+	packet.Append(std::string(100, 'x').data(), 100);
+	packet.Clear();
+	packet.Append(std::string(128, 'x').data(), 128);
+	EXPECT_EQ(Packet::GetAllocationCount(), before + 1);
+
+	packet.Append("x", 1);
+	EXPECT_EQ(Packet::GetAllocationCount(), before + 2);
+}
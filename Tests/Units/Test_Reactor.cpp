@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <Network/Reactor.hpp>
+#include <Utils/String.hpp>
+
+using namespace acid;
+
+/**
+ * Updates the reactor on this thread, as the engine would, until a condition is met.
+ */
+template<typename Func>
+static bool UpdateUntil(Reactor &reactor, Func &&condition, const Time &timeout = 10s) {
+	auto start = Time::Now();
+
+	while (!condition()) {
+		if (Time::Now() - start > timeout)
+			return false;
+
+		reactor.Update();
+		std::this_thread::sleep_for(1ms);
+	}
+
+	return true;
+}
+
+TEST(Reactor, echo) {
+	Reactor reactor;
+	auto port = reactor.Listen(0, IpAddress::LocalHost);
+	ASSERT_NE(port, 0);
+
+	Reactor::ConnectionId accepted = 0;
+	std::vector<std::string> echoed;
+
+	reactor.OnAccepted().Add([&](Reactor::ConnectionId connection, uint16_t listenerPort) {
+		EXPECT_EQ(listenerPort, port);
+		accepted = connection;
+	});
+	reactor.OnReceived().Add([&](Reactor::ConnectionId connection, Packet &packet) {
+		std::string message;
+		packet >> message;
+
+		// The accepted side echoes, the connecting side records.
+		if (connection == accepted) {
+			Packet reply;
+			reply << message;
+			EXPECT_TRUE(reactor.Send(connection, reply));
+		} else {
+			echoed.emplace_back(message);
+		}
+	});
+
+	auto client = reactor.Connect(IpAddress::LocalHost, port);
+	ASSERT_NE(client, 0u);
+
+	// Sends are queued straight away, before the connection is even accepted.
+	for (uint32_t i = 0; i < 100; i++) {
+		Packet packet;
+		packet << "message " + String::To(i);
+		EXPECT_TRUE(reactor.Send(client, packet));
+	}
+
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return echoed.size() == 100; }));
+
+	for (uint32_t i = 0; i < echoed.size(); i++)
+		EXPECT_EQ(echoed[i], "message " + String::To(i));
+}
+
+TEST(Reactor, backpressure) {
+	Reactor reactor;
+	reactor.SetWriteLimit(64 * 1024);
+	auto port = reactor.Listen(0, IpAddress::LocalHost);
+
+	Reactor::ConnectionId accepted = 0;
+	bool writable = false;
+	reactor.OnAccepted().Add([&](Reactor::ConnectionId connection, uint16_t) {
+		accepted = connection;
+	});
+	reactor.OnWritable().Add([&](Reactor::ConnectionId connection) {
+		EXPECT_EQ(connection, accepted);
+		writable = true;
+	});
+
+	// The peer doesn't read, so the socket buffers fill and then the write queue.
+	TcpSocket peer;
+	ASSERT_EQ(peer.Connect(IpAddress::LocalHost, port), Socket::Status::Done);
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return accepted != 0; }));
+
+	Packet packet;
+	packet.Append(std::string(16 * 1024, 'x').data(), 16 * 1024);
+	std::size_t sent = 0;
+	auto start = Time::Now();
+
+	while (reactor.Send(accepted, packet) && Time::Now() - start < 10s) {
+		sent++;
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	EXPECT_LE(reactor.GetQueuedBytes(accepted), reactor.GetWriteLimit());
+	EXPECT_GT(reactor.GetQueuedBytes(accepted), 0u);
+	EXPECT_FALSE(writable);
+
+	// Reading everything drains the queue, every packet arrives whole.
+	for (std::size_t i = 0; i < sent; i++) {
+		Packet received;
+		ASSERT_EQ(peer.Receive(received), Socket::Status::Done);
+		EXPECT_EQ(received.GetDataSize(), packet.GetDataSize());
+	}
+
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return writable; }));
+	EXPECT_EQ(reactor.GetQueuedBytes(accepted), 0u);
+	EXPECT_TRUE(reactor.Send(accepted, packet));
+}
+
+TEST(Reactor, bufferedPackets) {
+	Reactor reactor;
+	auto port = reactor.Listen(0, IpAddress::LocalHost);
+
+	Reactor::ConnectionId accepted = 0;
+	std::vector<uint32_t> received;
+	reactor.OnAccepted().Add([&](Reactor::ConnectionId connection, uint16_t) {
+		accepted = connection;
+	});
+	reactor.OnReceived().Add([&](Reactor::ConnectionId connection, Packet &packet) {
+		uint32_t value;
+		packet >> value;
+		received.emplace_back(value);
+	});
+
+	TcpSocket peer;
+	ASSERT_EQ(peer.Connect(IpAddress::LocalHost, port), Socket::Status::Done);
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return accepted != 0; }));
+
+	// The event queue is nearly filled, then more packets than fit arrive in one read.
+	// The rest wait in the receive buffer with nothing left in the socket for the selector to report.
+	uint32_t count = 0;
+	auto sendFrames = [&](uint32_t frameCount) {
+		Packet frames;
+		for (uint32_t i = 0; i < frameCount; i++)
+			frames << static_cast<uint32_t>(sizeof(uint32_t)) << count++;
+
+		ASSERT_EQ(peer.Send(frames.GetData(), frames.GetDataSize()), Socket::Status::Done);
+		std::this_thread::sleep_for(100ms);
+	};
+
+	sendFrames(static_cast<uint32_t>(Reactor::EventCapacity - 10));
+	sendFrames(1000);
+
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return received.size() == count; }));
+
+	for (uint32_t i = 0; i < received.size(); i++)
+		EXPECT_EQ(received[i], i);
+}
+
+TEST(Reactor, timeout) {
+	Reactor reactor;
+	auto port = reactor.Listen(0, IpAddress::LocalHost);
+
+	Reactor::ConnectionId accepted = 0;
+	std::vector<Reactor::EventType> closed;
+	reactor.OnAccepted().Add([&](Reactor::ConnectionId connection, uint16_t) {
+		accepted = connection;
+		reactor.SetTimeout(connection, 50ms);
+	});
+	reactor.OnTimeout().Add([&](Reactor::ConnectionId connection) {
+		EXPECT_EQ(connection, accepted);
+		closed.emplace_back(Reactor::EventType::Timeout);
+	});
+	reactor.OnDisconnected().Add([&](Reactor::ConnectionId connection) {
+		EXPECT_EQ(connection, accepted);
+		closed.emplace_back(Reactor::EventType::Disconnected);
+	});
+
+	TcpSocket peer;
+	ASSERT_EQ(peer.Connect(IpAddress::LocalHost, port), Socket::Status::Done);
+	auto start = Time::Now();
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return closed.size() == 2; }));
+
+	EXPECT_GE(Time::Now() - start, 50ms);
+	EXPECT_EQ(closed[0], Reactor::EventType::Timeout);
+	EXPECT_EQ(closed[1], Reactor::EventType::Disconnected);
+	EXPECT_EQ(reactor.GetQueuedBytes(accepted), 0u);
+
+	// The peer sees the connection closed.
+	char data[16];
+	std::size_t received;
+	EXPECT_EQ(peer.Receive(data, sizeof(data), received), Socket::Status::Disconnected);
+}
+
+TEST(Reactor, disconnect) {
+	Reactor reactor;
+	auto port = reactor.Listen(0, IpAddress::LocalHost);
+
+	Reactor::ConnectionId accepted = 0;
+	bool remoteClosed = false;
+	reactor.OnAccepted().Add([&](Reactor::ConnectionId connection, uint16_t) {
+		accepted = connection;
+	});
+	reactor.OnDisconnected().Add([&](Reactor::ConnectionId connection) {
+		EXPECT_EQ(connection, accepted);
+		remoteClosed = true;
+	});
+
+	// Packets queued before disconnecting are still written.
+	TcpSocket peer;
+	ASSERT_EQ(peer.Connect(IpAddress::LocalHost, port), Socket::Status::Done);
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return accepted != 0; }));
+
+	Packet packet;
+	packet << std::string("goodbye");
+	EXPECT_TRUE(reactor.Send(accepted, packet));
+	reactor.Disconnect(accepted);
+	EXPECT_FALSE(reactor.Send(accepted, packet));
+
+	Packet received;
+	ASSERT_EQ(peer.Receive(received), Socket::Status::Done);
+	std::string message;
+	received >> message;
+	EXPECT_EQ(message, "goodbye");
+	EXPECT_EQ(peer.Receive(received), Socket::Status::Disconnected);
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return remoteClosed; }));
+
+	// A peer closing its side is reported too.
+	accepted = 0;
+	remoteClosed = false;
+	TcpSocket other;
+	ASSERT_EQ(other.Connect(IpAddress::LocalHost, port), Socket::Status::Done);
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return accepted != 0; }));
+	other.Disconnect();
+	ASSERT_TRUE(UpdateUntil(reactor, [&]() { return remoteClosed; }));
+}
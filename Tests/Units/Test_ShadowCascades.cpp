@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Maths/Maths.hpp>
+#include <Shadows/ShadowCascades.hpp>
+
+using namespace acid;
+
+static constexpr float FieldOfView = Maths::Radians(70.0f);
+static constexpr float AspectRatio = 16.0f / 9.0f;
+static const Vector3f LightDirection(0.5f, -1.0f, 0.3f);
+
+/**
+ * Gets the corners of a slice of the view frustum in world space.
+ */
+static std::vector<Vector3f> GetSliceCorners(const Matrix4 &viewMatrix, float nearSplit, float farSplit) {
+	auto inverseView = viewMatrix.Inverse();
+	auto tanY = std::tan(FieldOfView / 2.0f), tanX = tanY * AspectRatio;
+	std::vector<Vector3f> corners;
+
+	for (auto distance : {nearSplit, farSplit}) {
+		for (auto x : {-1.0f, 1.0f}) {
+			for (auto y : {-1.0f, 1.0f})
+				corners.emplace_back(inverseView.Transform(Vector4f(x * tanX * distance, y * tanY * distance, -distance, 1.0f)));
+		}
+	}
+
+	return corners;
+}
+
+TEST(ShadowCascades, splits) {
+	auto uniform = ShadowCascades::CalculateSplits(4, 1.0f, 81.0f, ShadowCascades::SplitScheme::Uniform);
+	ASSERT_EQ(uniform.size(), 5u);
+	EXPECT_FLOAT_EQ(uniform[1], 21.0f);
+	EXPECT_FLOAT_EQ(uniform[2], 41.0f);
+
+	auto logarithmic = ShadowCascades::CalculateSplits(4, 1.0f, 81.0f, ShadowCascades::SplitScheme::Logarithmic);
+	EXPECT_FLOAT_EQ(logarithmic[1], 3.0f);
+	EXPECT_FLOAT_EQ(logarithmic[2], 9.0f);
+	EXPECT_FLOAT_EQ(logarithmic[3], 27.0f);
+
+	auto practical = ShadowCascades::CalculateSplits(4, 1.0f, 81.0f, ShadowCascades::SplitScheme::Practical, 0.25f);
+	EXPECT_FLOAT_EQ(practical[1], 0.25f * 3.0f + 0.75f * 21.0f);
+
+	for (const auto &splits : {uniform, logarithmic, practical}) {
+		EXPECT_FLOAT_EQ(splits.front(), 1.0f);
+		EXPECT_FLOAT_EQ(splits.back(), 81.0f);
+
+		for (std::size_t i = 1; i < splits.size(); i++)
+			EXPECT_LT(splits[i - 1], splits[i]);
+	}
+
+	EXPECT_EQ(ShadowCascades::GetGridSize(1), 1u);
+	EXPECT_EQ(ShadowCascades::GetGridSize(3), 2u);
+	EXPECT_EQ(ShadowCascades::GetGridSize(4), 2u);
+	EXPECT_EQ(ShadowCascades::GetGridSize(5), 3u);
+}
+
+TEST(ShadowCascades, slicesInsideCascades) {
+	auto viewMatrix = Matrix4::LookAt(Vector3f(3.0f, 2.0f, -4.0f), Vector3f(10.0f, 0.0f, 6.0f), Vector3f::Up);
+
+	ShadowCascades cascades(4, ShadowCascades::SplitScheme::Practical);
+	cascades.Update(viewMatrix, FieldOfView, AspectRatio, 0.1f, 100.0f, LightDirection, 10.0f, 2048);
+	auto splits = ShadowCascades::CalculateSplits(4, 0.1f, 100.0f, ShadowCascades::SplitScheme::Practical);
+
+	for (std::size_t i = 0; i < cascades.GetBoxes().size(); i++) {
+		const auto &shadowBox = cascades.GetBoxes()[i];
+		EXPECT_FLOAT_EQ(shadowBox.GetNearSplit(), splits[i]);
+		EXPECT_FLOAT_EQ(shadowBox.GetFarSplit(), splits[i + 1]);
+
+		for (const auto &corner : GetSliceCorners(viewMatrix, splits[i], splits[i + 1])) {
+			auto clip = shadowBox.GetProjectionViewMatrix().Transform(Vector4f(corner, 1.0f));
+			EXPECT_GE(clip.x, -1.0f);
+			EXPECT_LE(clip.x, 1.0f);
+			EXPECT_GE(clip.y, -1.0f);
+			EXPECT_LE(clip.y, 1.0f);
+			EXPECT_GE(clip.z, 0.0f);
+			EXPECT_LE(clip.z, 1.0f);
+			EXPECT_TRUE(shadowBox.IsInBox(corner, 0.0f));
+
+			// Each cascade only samples from its own tile of the shadow map.
+			auto tile = shadowBox.GetToShadowMapSpaceMatrix().Transform(Vector4f(corner, 1.0f));
+			EXPECT_GE(tile.x, static_cast<float>(i % 2) * 0.5f - 1e-5f);
+			EXPECT_LE(tile.x, static_cast<float>(i % 2 + 1) * 0.5f + 1e-5f);
+			EXPECT_GE(tile.y, static_cast<float>(i / 2) * 0.5f - 1e-5f);
+			EXPECT_LE(tile.y, static_cast<float>(i / 2 + 1) * 0.5f + 1e-5f);
+		}
+	}
+}
+
+TEST(ShadowCascades, texelSnapping) {
+	ShadowCascades cascades(2, ShadowCascades::SplitScheme::Uniform);
+	std::vector<Matrix4> lastProjectionViews;
+
+	for (uint32_t step = 0; step < 8; step++) {
+		// The camera moves less than a texel each step without turning.
+		Vector3f position(0.013f * step, 1.0f, 0.021f * step);
+		auto viewMatrix = Matrix4::LookAt(position, position + Vector3f(0.0f, 0.0f, 1.0f), Vector3f::Up);
+		cascades.Update(viewMatrix, FieldOfView, AspectRatio, 0.1f, 60.0f, LightDirection, 5.0f, 1024);
+
+		for (std::size_t i = 0; i < cascades.GetBoxes().size(); i++) {
+			const auto &shadowBox = cascades.GetBoxes()[i];
+			ASSERT_GT(shadowBox.GetTexelSize(), 0.0f);
+			EXPECT_NEAR(shadowBox.GetWidth() / shadowBox.GetTexelSize(), 512.0f, 1e-2f);
+
+			// The world origin lands on a texel corner, so texels don't slide over the world as the camera moves.
+			auto clip = shadowBox.GetProjectionViewMatrix().Transform(Vector4f(0.0f, 0.0f, 0.0f, 1.0f));
+			auto texel = (clip.x + 1.0f) * 0.5f * 512.0f;
+			EXPECT_NEAR(texel, std::round(texel), 1e-2f);
+		}
+
+		if (!lastProjectionViews.empty()) {
+			for (std::size_t i = 0; i < cascades.GetBoxes().size(); i++) {
+				const auto &last = lastProjectionViews[i];
+				const auto &current = cascades.GetBoxes()[i].GetProjectionViewMatrix();
+				// Any shift is a whole number of texels.
+				auto shift = (current[3][0] - last[3][0]) * 0.5f * 512.0f;
+				EXPECT_NEAR(shift, std::round(shift), 1e-2f);
+			}
+		}
+
+		lastProjectionViews.clear();
+		for (const auto &shadowBox : cascades.GetBoxes())
+			lastProjectionViews.emplace_back(shadowBox.GetProjectionViewMatrix());
+	}
+}
+
+TEST(ShadowCascades, cull) {
+	auto viewMatrix = Matrix4::LookAt(Vector3f(), Vector3f(0.0f, 0.0f, 1.0f), Vector3f::Up);
+
+	ShadowCascades cascades(3, ShadowCascades::SplitScheme::Logarithmic);
+	cascades.Update(viewMatrix, FieldOfView, AspectRatio, 1.0f, 64.0f, Vector3f(0.0f, -1.0f, 0.0f), 10.0f, 1024);
+
+	std::vector<Vector4f> spheres = {
+		{0.0f, 0.0f, 2.0f, 0.5f},
+		{0.0f, 0.0f, 10.0f, 0.5f},
+		{0.0f, 0.0f, 40.0f, 0.5f},
+		{0.0f, 0.0f, -500.0f, 1.0f},
+		{0.0f, 0.0f, 4.0f, 200.0f}
+	};
+
+	std::vector<std::vector<uint32_t>> visible;
+	cascades.Cull(spheres, visible);
+
+	ASSERT_EQ(visible.size(), 3u);
+
+	for (std::size_t i = 0; i < visible.size(); i++) {
+		std::vector<uint32_t> expected;
+		for (uint32_t j = 0; j < spheres.size(); j++) {
+			if (cascades.GetBoxes()[i].IsInBox(Vector3f(spheres[j]), spheres[j].w))
+				expected.emplace_back(j);
+		}
+
+		EXPECT_EQ(visible[i], expected);
+		// Behind the camera is in no cascade, and the sphere over the whole view is in every cascade.
+		EXPECT_EQ(std::count(visible[i].begin(), visible[i].end(), 3u), 0);
+		EXPECT_EQ(std::count(visible[i].begin(), visible[i].end(), 4u), 1);
+	}
+
+	// Near casters are in the near cascade, far casters only in the far cascade.
+	EXPECT_EQ(visible[0].front(), 0u);
+	EXPECT_EQ(std::count(visible[0].begin(), visible[0].end(), 2u), 0);
+	EXPECT_EQ(std::count(visible[2].begin(), visible[2].end(), 2u), 1);
+
+	ThreadPool threadPool(2);
+	std::vector<std::vector<uint32_t>> pooled;
+	cascades.Cull(spheres, pooled, &threadPool);
+	EXPECT_EQ(pooled, visible);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <Network/Udp/UdpConnection.hpp>
+#include <Network/Udp/UdpSocket.hpp>
+#include <Network/Packet.hpp>
+
+using namespace acid;
+
+/**
+ * Two connections talking to each other through loopback sockets.
+ */
+class ConnectionPair {
+public:
+	explicit ConnectionPair(const UdpConnection::Simulation &simulation = {}) {
+		socketA.Bind(0, IpAddress::LocalHost);
+		socketB.Bind(0, IpAddress::LocalHost);
+		socketA.SetBlocking(false);
+		socketB.SetBlocking(false);
+
+		a = std::make_unique<UdpConnection>(socketA, IpAddress::LocalHost, socketB.GetLocalPort());
+		b = std::make_unique<UdpConnection>(socketB, IpAddress::LocalHost, socketA.GetLocalPort());
+		a->SetSimulation(simulation);
+		b->SetSimulation(simulation);
+	}
+
+	void Update() {
+		a->Update();
+		b->Update();
+		Poll(socketA, *a);
+		Poll(socketB, *b);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	UdpSocket socketA;
+	UdpSocket socketB;
+	std::unique_ptr<UdpConnection> a;
+	std::unique_ptr<UdpConnection> b;
+
+private:
+	static void Poll(UdpSocket &socket, UdpConnection &connection) {
+		char data[UdpConnection::MaxDatagramSize];
+		std::size_t received;
+		IpAddress address;
+		uint16_t port;
+
+		while (socket.Receive(data, sizeof(data), received, address, port) == Socket::Status::Done)
+			connection.OnReceive(data, received);
+	}
+};
+
+static std::vector<char> CreateMessage(uint32_t index, std::size_t size) {
+	std::vector<char> message(size);
+	for (std::size_t i = 0; i < size; i++)
+		message[i] = static_cast<char>(index * 7 + i);
+	return message;
+}
+
+static std::size_t MessageSize(uint32_t index) {
+	// Mostly small messages, with some that need several fragments.
+	return index % 10 == 0 ? 5000 + index : 16 + index % 200;
+}
+
+static void SendAndCheck(UdpConnection::Delivery delivery, uint8_t channel, const UdpConnection::Simulation &simulation) {
+	ConnectionPair pair(simulation);
+	const uint32_t messageCount = 200;
+
+	std::vector<bool> received(messageCount);
+	uint32_t sentCount = 0;
+	uint32_t receivedCount = 0;
+	uint32_t lastIndex = 0;
+	Packet packet;
+	auto start = Time::Now();
+
+	while (receivedCount < messageCount && Time::Now() - start < 20s) {
+		// Messages are sent over several updates, a burst of datagrams could overflow the receive buffer of the socket.
+		for (uint32_t i = 0; i < 10 && sentCount < messageCount; i++, sentCount++) {
+			auto message = CreateMessage(sentCount, MessageSize(sentCount));
+			EXPECT_TRUE(pair.a->Send(channel, message.data(), message.size()));
+		}
+
+		pair.Update();
+		uint8_t receivedChannel;
+
+		while (pair.b->Receive(receivedChannel, packet)) {
+			EXPECT_EQ(receivedChannel, channel);
+
+			// The index is recovered from the size, then the contents are checked against it.
+			uint32_t index = 0;
+			while (index < messageCount && MessageSize(index) != packet.GetDataSize())
+				index++;
+			ASSERT_LT(index, messageCount);
+
+			auto message = CreateMessage(index, MessageSize(index));
+			EXPECT_EQ(std::memcmp(packet.GetData(), message.data(), message.size()), 0);
+			EXPECT_FALSE(received[index]) << "Message " << index << " was delivered twice";
+
+			if (delivery == UdpConnection::Delivery::ReliableOrdered && receivedCount > 0) {
+				EXPECT_GT(index, lastIndex);
+			}
+
+			received[index] = true;
+			receivedCount++;
+			lastIndex = index;
+		}
+	}
+
+	EXPECT_EQ(receivedCount, messageCount);
+}
+
+TEST(UdpConnection, reliableOrdered) {
+	UdpConnection::Simulation simulation;
+	simulation.packetLoss = 0.2f;
+	simulation.latency = Time::Milliseconds(10);
+	simulation.jitter = Time::Milliseconds(10);
+	SendAndCheck(UdpConnection::Delivery::ReliableOrdered, 2, simulation);
+}
+
+TEST(UdpConnection, reliableUnordered) {
+	UdpConnection::Simulation simulation;
+	simulation.packetLoss = 0.2f;
+	simulation.latency = Time::Milliseconds(10);
+	simulation.jitter = Time::Milliseconds(10);
+	SendAndCheck(UdpConnection::Delivery::ReliableUnordered, 1, simulation);
+}
+
+TEST(UdpConnection, unreliableWithoutLoss) {
+	SendAndCheck(UdpConnection::Delivery::Unreliable, 0, {});
+}
+
+TEST(UdpConnection, largeMessage) {
+	UdpConnection::Simulation simulation;
+	simulation.packetLoss = 0.1f;
+	simulation.latency = Time::Milliseconds(5);
+	ConnectionPair pair(simulation);
+
+	auto message = CreateMessage(1, 200 * 1024);
+	EXPECT_TRUE(pair.a->Send(2, message.data(), message.size()));
+	EXPECT_FALSE(pair.a->Send(2, message.data(), UdpConnection::FragmentSize * UdpConnection::MaxFragmentCount + 1));
+
+	Packet packet;
+	uint8_t channel;
+	auto start = Time::Now();
+
+	while (!pair.b->Receive(channel, packet) && Time::Now() - start < 20s)
+		pair.Update();
+
+	ASSERT_EQ(packet.GetDataSize(), message.size());
+	EXPECT_EQ(std::memcmp(packet.GetData(), message.data(), message.size()), 0);
+}
+
+TEST(UdpConnection, statistics) {
+	UdpConnection::Simulation simulation;
+	simulation.packetLoss = 0.25f;
+	simulation.latency = Time::Milliseconds(20);
+	ConnectionPair pair(simulation);
+
+	// Keep both sides sending, so there is a steady stream of acknowledgements.
+	for (uint32_t i = 0; i < 500; i++) {
+		char data[32] = {};
+		pair.a->Send(0, data, sizeof(data));
+		pair.b->Send(0, data, sizeof(data));
+		pair.Update();
+	}
+
+	// Each round trip is two simulated latencies.
+	EXPECT_GT(pair.a->GetRoundTripTime(), Time::Milliseconds(35));
+	EXPECT_LT(pair.a->GetRoundTripTime(), Time::Milliseconds(80));
+	EXPECT_GT(pair.a->GetPacketLoss(), 0.05f);
+	EXPECT_LT(pair.a->GetPacketLoss(), 0.6f);
+	EXPECT_GT(pair.a->GetSentDatagrams(), 400u);
+}